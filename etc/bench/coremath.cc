@@ -0,0 +1,120 @@
+/*
+	coremath.cc - Throughput and accuracy of the fast CoreMath kernels against libm
+
+	Built by make bench, run as bin/bench/coremath. Errors are measured in ulp of the
+	double result against __float128 references, then the exact tier's __float128 results
+	are checked against libquadmath.
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <quadmath.h>
+
+#include "core/CoreMath.hh"
+
+namespace {
+	typedef std::chrono::steady_clock Clock;
+	typedef void (*kernel_t)(const double*, double*, size_t);
+	const size_t ELEMENTS = 1 << 20;
+	const int ROUNDS = 20;
+
+	double Ulp(double got, __float128 reference) {
+		if(std::isnan(got) && isnanq(reference))
+			return 0;
+		const double rounded = static_cast<double>(reference);
+		if(std::isinf(got) && rounded == got)
+			return 0;
+		if(rounded == 0 && got == 0)
+			return 0;
+		int exponent;
+		std::frexp((rounded == 0) ? got : rounded, &exponent);
+		const double ulp = std::max(std::ldexp(1.0, exponent - 53), 4.9e-324);
+		return static_cast<double>(fabsq(static_cast<__float128>(got) - reference)) / ulp;
+	}
+
+	double QuadUlp(__float128 got, __float128 reference) {
+		if(isnanq(got) && isnanq(reference))
+			return 0;
+		if(got == reference)
+			return 0;
+		int exponent;
+		frexpq(reference, &exponent);
+		return static_cast<double>(fabsq(got - reference) / ldexpq(1, exponent - 113));
+	}
+
+	double Nanoseconds(Clock::time_point start, Clock::time_point end, size_t n) {
+		return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(n);
+	}
+
+	void Bench(const char* name, kernel_t kernel, __float128 (*reference)(__float128), double (*libm)(double),
+		long double (*libml)(long double), double low, double high) {
+		std::mt19937_64 rng(1);
+		std::uniform_real_distribution<double> uniform(low, high);
+		std::vector<double> in(ELEMENTS), out(ELEMENTS);
+		for(double& x : in)
+			x = uniform(rng);
+
+		kernel(in.data(), out.data(), ELEMENTS);
+		double worst = 0;
+		for(size_t i = 0; i < ELEMENTS; i++)
+			worst = std::max(worst, Ulp(out[i], reference(in[i])));
+
+		const Clock::time_point start = Clock::now();
+		for(int r = 0; r < ROUNDS; r++)
+			kernel(in.data(), out.data(), ELEMENTS);
+		const Clock::time_point fast = Clock::now();
+		volatile double sum = 0;
+		for(int r = 0; r < ROUNDS; r++) {
+			for(size_t i = 0; i < ELEMENTS; i++)
+				sum = sum + libm(in[i]);
+		}
+		const Clock::time_point double_end = Clock::now();
+		volatile long double lsum = 0;
+		for(size_t i = 0; i < ELEMENTS; i++)
+			lsum = lsum + libml(in[i]);
+		const Clock::time_point end = Clock::now();
+		std::printf("%-4s [%g,%g]  max %5.2f ulp  fast %6.2f ns/elem  libm double %6.2f ns  long double %6.2f ns\n", name, low, high, worst,
+			Nanoseconds(start, fast, ROUNDS * ELEMENTS), Nanoseconds(fast, double_end, ROUNDS * ELEMENTS), Nanoseconds(double_end, end, ELEMENTS));
+	}
+
+	typedef Mt::objects::BasicScalar<__float128> Quad;
+
+	/*
+		The exact tier at quad precision against libquadmath, which is itself within about an
+		ulp, so a correct result shows up as up to an ulp or so
+	*/
+	void CheckQuad(const char* name, Quad (*exact)(Quad const&), __float128 (*reference)(__float128), double low, double high) {
+		const size_t samples = 20000;
+		std::mt19937_64 rng(2);
+		std::uniform_real_distribution<double> uniform(low, high);
+		double worst = 0;
+		const Clock::time_point start = Clock::now();
+		for(size_t i = 0; i < samples; i++) {
+			// Fills the bits below the double's mantissa as well
+			const __float128 x = static_cast<__float128>(uniform(rng)) * (1 + ldexpq(uniform(rng) / high, -60));
+			worst = std::max(worst, QuadUlp(exact(Quad(x)).GetInternal(), reference(x)));
+		}
+		const Clock::time_point end = Clock::now();
+		std::printf("%-4s [%g,%g]  quad tier max %5.2f ulp against libquadmath  %8.1f ns/elem\n", name, low, high, worst,
+			Nanoseconds(start, end, samples));
+	}
+}
+
+int main(void) {
+	using namespace Mt::core::CoreMath;
+	Bench("sin", &Kernels::Sin, &sinq, &::sin, &::sinl, -100, 100);
+	Bench("cos", &Kernels::Cos, &cosq, &::cos, &::cosl, -100, 100);
+	Bench("tan", &Kernels::Tan, &tanq, &::tan, &::tanl, -100, 100);
+	Bench("exp", &Kernels::Exp, &expq, &::exp, &::expl, -700, 700);
+	Bench("ln", &Kernels::Ln, &logq, &::log, &::logl, 0.5, 2);
+	CheckQuad("sin", &Sin<__float128>, &sinq, -100, 100);
+	CheckQuad("cos", &Cos<__float128>, &cosq, -100, 100);
+	CheckQuad("tan", &Tan<__float128>, &tanq, -100, 100);
+	CheckQuad("exp", &Exp<__float128>, &expq, -700, 700);
+	CheckQuad("ln", &Ln<__float128>, &logq, 1e-3, 1e3);
+	CheckQuad("sqrt", &Sqrt<__float128>, &sqrtq, 1e-3, 1e3);
+	return 0;
+}
@@ -0,0 +1,14 @@
+#!/bin/bash
+# Times every SML benchmark here under the tree walker and the bytecode VM
+# Usage: etc/bench/engines.sh [mt binary], from the top of the tree
+
+MT=${1:-bin/mt}
+DIR=$(dirname "$0")
+TIMEFORMAT=%R
+
+for script in "$DIR"/*.sml; do
+	for engine in tree bytecode; do
+		seconds=$( { time printf '!engine %s\n!run %s\n!exit\n' "$engine" "$script" | "$MT" > /dev/null 2>&1; } 2>&1 )
+		printf '%-12s %-9s %ss\n' "$(basename "$script" .sml)" "$engine" "$seconds"
+	done
+done
@@ -0,0 +1,89 @@
+/*
+	hpn.cc - Throughput of the multi-precision floats behind _MT_USE_LIB_HPN
+
+	Built by make bench, run as bin/bench/hpn [iterations]
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "core/HPN.hh"
+
+namespace {
+	typedef std::chrono::steady_clock Clock;
+
+	double Nanoseconds(Clock::time_point start, Clock::time_point end, size_t n) {
+		return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(n);
+	}
+
+	/*
+		A dependent chain of multiplies and subtractions, then divisions, so the compiler
+		cannot hoist or drop any of them
+	*/
+	template <int Bits>
+	void Bench(size_t iterations) {
+		typedef Mt::core::hpn::MPFloat<Bits> F;
+		F a = sqrt(F(2)), b = sqrt(F(3)), c;
+		const Clock::time_point start = Clock::now();
+		for(size_t i = 0; i < iterations; i++) {
+			c = a * b;
+			a = c - a;
+		}
+		const Clock::time_point middle = Clock::now();
+		const size_t divisions = iterations / 100 + 1;
+		for(size_t i = 0; i < divisions; i++)
+			c = c / b;
+		const Clock::time_point end = Clock::now();
+		// Keeps the result live, a and c shrink past what a long double holds
+		volatile bool zero = (c == F(0));
+		(void)zero;
+		std::printf("%5d bit  mul+sub %10.1f ns  div %10.1f ns\n", Bits, Nanoseconds(start, middle, iterations),
+			Nanoseconds(middle, end, divisions));
+	}
+
+	/*
+		The NTT only runs on operands of FFT_THRESHOLD limbs and up, wider than any MPFloat, so its
+		products are checked here against Karatsuba and the schoolbook, with random limbs and all
+		ones limbs that make every convolution sum as large as it gets
+	*/
+	size_t CheckProducts(void) {
+		using namespace Mt::core::hpn;
+		std::mt19937 random(42);
+		const size_t sizes[][2] = { { FFT_THRESHOLD, FFT_THRESHOLD }, { 1500, 1500 }, { 4096, 4096 }, { 3001, 1100 } };
+		size_t mismatches = 0;
+		for(auto const& size : sizes) {
+			for(int fill = 0; fill < 2; fill++) {
+				const size_t na = size[0], nb = size[1];
+				std::vector<limb_t> a(na), b(nb), fast(na + nb), slow(na + nb);
+				for(limb_t& limb : a)
+					limb = fill ? ~limb_t(0) : static_cast<limb_t>(random());
+				for(limb_t& limb : b)
+					limb = fill ? ~limb_t(0) : static_cast<limb_t>(random());
+				const Clock::time_point start = Clock::now();
+				MulFFT(fast.data(), a.data(), na, b.data(), nb);
+				const Clock::time_point middle = Clock::now();
+				if(na == nb)
+					MulKaratsuba(slow.data(), a.data(), b.data(), nb);
+				else
+					MulSchoolbook(slow.data(), a.data(), na, b.data(), nb);
+				const Clock::time_point end = Clock::now();
+				const bool same = (fast == slow);
+				mismatches += same ? 0 : 1;
+				std::printf("%5zu x %-5zu limbs %-9s  ntt %10.1f us  %-10s %10.1f us  %s\n", na, nb, fill ? "all ones" : "random",
+					Nanoseconds(start, middle, 1000), (na == nb) ? "karatsuba" : "schoolbook", Nanoseconds(middle, end, 1000),
+					same ? "ok" : "MISMATCH");
+			}
+		}
+		return mismatches;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+	Bench<256>(iterations);
+	Bench<512>(iterations);
+	Bench<4096>(iterations);
+	return (CheckProducts() == 0) ? 0 : 1;
+}
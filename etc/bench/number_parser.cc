@@ -0,0 +1,86 @@
+/*
+	number_parser.cc - NumberParser against atof and strtold on a million literals
+
+	Built by make bench, run as bin/bench/number_parser [literals]
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/NumberParser.hh"
+
+namespace {
+	typedef std::chrono::steady_clock Clock;
+	const int ROUNDS = 5;
+
+	double Atof(std::string const& s) {
+		return std::atof(s.c_str());
+	}
+
+	double Strtold(std::string const& s) {
+		return static_cast<double>(std::strtold(s.c_str(), nullptr));
+	}
+
+	double ParseDouble(std::string const& s) {
+		return Mt::core::NumberParser::Parse<double>(s.data(), s.data() + s.size());
+	}
+
+	double ParseLongDouble(std::string const& s) {
+		return static_cast<double>(Mt::core::NumberParser::Parse<long double>(s.data(), s.data() + s.size()));
+	}
+
+	void Run(const char* name, double (*parse)(std::string const&), std::vector<std::string> const& literals) {
+		double sum = 0;
+		const Clock::time_point start = Clock::now();
+		for(int r = 0; r < ROUNDS; r++) {
+			for(std::string const& s : literals)
+				sum += parse(s);
+		}
+		const Clock::time_point end = Clock::now();
+		std::printf("  %-20s %7.1f ns/literal  (%g)\n", name,
+			std::chrono::duration<double, std::nano>(end - start).count() / (ROUNDS * static_cast<double>(literals.size())), sum);
+	}
+
+	/*
+		Checks the results are the correctly rounded ones before timing anything
+	*/
+	size_t Mismatches(std::vector<std::string> const& literals) {
+		size_t bad = 0;
+		for(std::string const& s : literals) {
+			const double d = Mt::core::NumberParser::Parse<double>(s.data(), s.data() + s.size()), rd = std::strtod(s.c_str(), nullptr);
+			const long double ld = Mt::core::NumberParser::Parse<long double>(s.data(), s.data() + s.size()), rld = std::strtold(s.c_str(), nullptr);
+			bad += (std::memcmp(&d, &rd, sizeof(d)) != 0 || ld != rld) ? 1 : 0;
+		}
+		return bad;
+	}
+
+	void Bench(const char* name, std::vector<std::string> const& literals) {
+		std::printf("%s, %zu literals, %zu mismatches against strtod/strtold\n", name, literals.size(), Mismatches(literals));
+		Run("atof", &Atof, literals);
+		Run("Parse<double>", &ParseDouble, literals);
+		Run("strtold", &Strtold, literals);
+		Run("Parse<long double>", &ParseLongDouble, literals);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+	std::mt19937_64 rng(7);
+	std::uniform_real_distribution<double> uniform(-1e6, 1e6);
+	std::vector<std::string> shorter, mixed;
+	char buffer[64];
+	for(size_t i = 0; i < count; i++) {
+		std::snprintf(buffer, sizeof(buffer), "%.6f", uniform(rng));
+		shorter.push_back(buffer);
+		// Half full 17 digit literals, a third of everything tiny
+		std::snprintf(buffer, sizeof(buffer), (i % 2) ? "%.17g" : "%.6f", uniform(rng) * ((i % 3) ? 1 : 1e-20));
+		mixed.push_back(buffer);
+	}
+	Bench("Short literals (%.6f)", shorter);
+	Bench("Mixed 17 digit and tiny literals", mixed);
+	return 0;
+}
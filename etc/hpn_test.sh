@@ -0,0 +1,14 @@
+#!/bin/bash
+# Checks that a multi-precision build (make hpn) evaluates the quad tier in its own float
+# Usage: etc/hpn_test.sh [mt binary], from the top of the tree
+
+MT=${1:-bin/mt}
+
+# __float128 gives 1.0/3 at most 36 significant digits, anything longer came from the HPN float
+line=$(printf '!precision quad\n1.0/3\n!exit\n' | "$MT" 2>&1 | grep -a '1.0/3 = ')
+digits=$(printf '%s' "${line#*= }" | sed -e 's/e.*//' -e 's/[^0-9]//g' -e 's/^0*//')
+if [ "${#digits}" -le 34 ]; then
+	echo "FAIL: 1.0/3 at quad printed ${#digits} digits: ${line#*= }"
+	exit 1
+fi
+echo "ok: 1.0/3 at quad printed ${#digits} digits"
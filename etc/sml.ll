@@ -56,12 +56,14 @@
 [ \t\r]+				{ yylloc->step(); }
 \n 						{ yylloc->lines(yyleng); yylloc->step(); }
 
+"ret"					return TOKEN(token::TRETURN);
 [a-zA-Z_][a-zA-Z0-9_]*	SAVE_TOKEN; return token::TIDENTIFIER;
 
-[0-9]+\.[0-9]*			SAVE_TOKEN; return token::TSCALAR;
-[0-9]+					SAVE_TOKEN; return token::TSCALAR;
+[0-9]+\.[0-9]*([eE][\+\-]?[0-9]+)?	yylval->expr = new Mt::core::lang::NScalar(yytext, yytext + yyleng); return token::TSCALAR;
+[0-9]+[eE][\+\-]?[0-9]+	yylval->expr = new Mt::core::lang::NScalar(yytext, yytext + yyleng); return token::TSCALAR;
+[0-9]+					yylval->expr = new Mt::core::lang::NInteger(yytext, yytext + yyleng); return token::TINTEGER;
 
-[0-9]+[\+\-][0-9]+i 	SAVE_TOKEN; return token::TCOMPLEX;
+[0-9]+(\.[0-9]*)?[\+\-][0-9]+(\.[0-9]*)?i	yylval->expr = new Mt::core::lang::NComplex(yytext, yytext + yyleng); return token::TCOMPLEX;
 
 "="						return TOKEN(token::TEQUAL);
 ":="					return TOKEN(token::TASSIGN);
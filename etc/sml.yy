@@ -46,10 +46,12 @@
 
 %token END	     0
 %token <boolean> TTRUE TFALSE
-%token <string> TIDENTIFIER TSCALAR TLIST TCOMPLEX
+%token <string> TIDENTIFIER TLIST
+%token <expr> TINTEGER TSCALAR TCOMPLEX
 %token <token>  TCEQ TEQUAL TASSIGN TNEQUAL TCLT TCLE TCGT TCGE
 %token <token> TLPAREN TRPAREN TLBRACE TRBRACE TCOMMA TDOT
 %token <token> TPLUS TMINUS TMUL TDIV TMOD TPEQUAL TMEQUAL TDEQUAL TMUEQUAL TMOEQUAL TPOW TROOT TSRO
+%token <token> TRETURN
 
 %type <ident> ident
 %type <expr> numeric expr
@@ -94,6 +96,7 @@ stmts : stmt { $$ = new Mt::core::lang::NBlock(); $$->statements.push_back($<stm
 */
 stmt : var_decl | func_decl //| list_decl
 	 | expr { $$ = new Mt::core::lang::NExpressionStatement(*$1); }
+	 | TRETURN expr { $$ = new Mt::core::lang::NReturnStatement(*$2); }
 	 ;
 
 /*
@@ -104,13 +107,16 @@ block : TLBRACE stmts TRBRACE { $$ = $2; }
 
 /*
 	Numeric types (Mt::INumeric/Mt::IScalar)
+	Integer - Any whole number, kept exact
 	Scalar - Any numeric that is not complex
 	Complex - Any complex number as represented by X[+-]Yi
 */
-numeric : TSCALAR { $$ = new Mt::core::lang::NScalar((mtfloat_t)atof($1->c_str())); delete $1; }
-		| TMINUS TSCALAR { $$ = new Mt::core::lang::NScalar(-(mtfloat_t)atof($2->c_str())); delete $2; }
-		| TCOMPLEX { $$ = new Mt::core::lang::NComplex(*$1); delete $1; }
-		| TMINUS TCOMPLEX { $$ = new Mt::core::lang::NComplex(*$2); delete $2; }
+numeric : TINTEGER { $$ = $1; }
+		| TMINUS TINTEGER { static_cast<Mt::core::lang::NInteger*>($2)->Negate(); $$ = $2; }
+		| TSCALAR { $$ = $1; }
+		| TMINUS TSCALAR { static_cast<Mt::core::lang::NScalar*>($2)->Negate(); $$ = $2; }
+		| TCOMPLEX { $$ = $1; }
+		| TMINUS TCOMPLEX { static_cast<Mt::core::lang::NComplex*>($2)->Negate(); $$ = $2; }
 		;
 
 /*
@@ -0,0 +1,1110 @@
+/*
+	Builtins.cc - Builtin function implementations and their perfect hash table
+*/
+#include "core/lang/Builtins.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+#include "core/CoreMath.hh"
+#include "core/Integration.hh"
+#include "core/ODE.hh"
+#include "core/Random.hh"
+#include "core/NumberFormatter.hh"
+#include "core/lang/Function.hh"
+#include "core/symbolic/Dual.hh"
+#include "core/symbolic/Solver.hh"
+#include "objects/Integer.hh"
+#include "objects/Rational.hh"
+#include "objects/List.hh"
+#include "objects/Matrix.hh"
+
+using Mt::objects::Scalar;
+using Mt::objects::List;
+using Mt::objects::Matrix;
+using Mt::core::symbolic::Dual;
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace Builtins {
+				namespace {
+					// Exact powers past this go through floats, the digits grow linearly with the exponent
+					const int64_t EXACT_POW_LIMIT = 4096;
+					// Integer powers of floats up to this are done by squaring, the rounding error grows with the exponent's bits
+					const int64_t SQUARING_POW_LIMIT = 32;
+					// Points roots samples its interval at, and solve when the ends do not bracket a root
+					const size_t ROOT_SAMPLES = 256;
+					// Starting points minimize spreads over a box
+					const size_t MULTI_STARTS = 32;
+					// Halton sequence bases, one per dimension of a box
+					const unsigned HALTON_BASES[] = { 2, 3, 5, 7, 11, 13 };
+					// Most rows ode and stiff sample a solution at, and most members in an ensemble
+					const size_t MAX_SAMPLES = 1u << 16;
+					const size_t MAX_MEMBERS = 1u << 20;
+					// The stiff solver is second order, at the default tolerances it would take more steps than stiffness saves
+					const long double STIFF_RELATIVE_TOLERANCE = 1e-7L;
+					const long double STIFF_ABSOLUTE_TOLERANCE = 1e-9L;
+					// Largest random fill, and seeds stay below 2^53 so every one of them is exact in a double
+					const size_t MAX_ELEMENTS = 1u << 24;
+					const size_t MAX_SEED = static_cast<size_t>(1) << 53;
+					// Numeric engines and dual numbers work in long double, their results claim no more digits than that
+					const PRECISION ENGINE_TIER = PRECISION::EXTENDED;
+					// Lists and matrices hold mtfloat_t, so a result folded from their elements is good for its digits
+#if defined(_MT_USE_LIB_QUADMATH_) || defined(_MT_USE_LIB_HPN)
+					const PRECISION ELEMENT_TIER = PRECISION::QUAD;
+#else
+					const PRECISION ELEMENT_TIER = PRECISION::EXTENDED;
+#endif
+
+					/*
+						Float version of a real argument, exact numbers are rounded to the session tier
+					*/
+					Value AsFloat(Value const& v, CallContext& context) {
+						return v.IsExact() ? v.ToScalar(context.precision) : v;
+					}
+
+					List<Scalar> const& AsList(Value const& v) {
+						return *static_cast<List<Scalar>*>(v.object);
+					}
+
+					Matrix<Scalar> const& AsMatrix(Value const& v) {
+						return *static_cast<Matrix<Scalar>*>(v.object);
+					}
+
+					/*
+						Moves a freshly built object into the pool and returns a handle to it
+					*/
+					template <class C>
+					Value Own(C object, CallContext& context) {
+						return Value::MakeObject(context.pool.Make<C>(std::move(object)));
+					}
+
+					/*
+						The narrower of a tier and the widest one a result can claim
+					*/
+					PRECISION Narrowest(PRECISION p, PRECISION widest) {
+						return (p > widest) ? widest : p;
+					}
+
+					/*
+						CoreMath functions of real arguments, each one is instantiated once per precision
+						tier by ApplyReal
+					*/
+					struct SinKernel {
+						template <class F>
+						static F Real(F x) {
+							return CoreMath::Sin(Mt::objects::BasicScalar<F>(x)).GetInternal();
+						}
+					};
+
+					struct SqrtKernel {
+						template <class F>
+						static F Real(F x) {
+							return CoreMath::Sqrt(Mt::objects::BasicScalar<F>(x)).GetInternal();
+						}
+					};
+
+					struct PowKernel {
+						template <class F>
+						static F Real(F x, F y) {
+							return CoreMath::Pow(Mt::objects::BasicScalar<F>(x), Mt::objects::BasicScalar<F>(y)).GetInternal();
+						}
+					};
+
+					struct NrtKernel {
+						template <class F>
+						static F Real(F x, F y) {
+							return CoreMath::Nrt(Mt::objects::BasicScalar<F>(x), Mt::objects::BasicScalar<F>(y)).GetInternal();
+						}
+					};
+
+					/*
+						Applies a CoreMath function to a real argument, computed in the argument's own tier
+					*/
+					template <class Kernel>
+					Value ApplyReal(Value const& arg, CallContext& context) {
+						Value x = AsFloat(arg, context);
+						switch(x.precision) {
+							case PRECISION::DOUBLE:
+								return Value::MakeScalar(Kernel::Real(x.d[0]));
+#if defined(_MT_HAS_QUAD)
+							case PRECISION::QUAD:
+								return Value::MakeScalar(Kernel::Real(x.q[0]));
+#endif
+							default:
+								return Value::MakeScalar(Kernel::Real(x.e[0]));
+						}
+					}
+
+					/*
+						Two argument version, computed in the wider of the two tiers
+					*/
+					template <class Kernel>
+					Value ApplyReal(Value const& lhs, Value const& rhs, CallContext& context) {
+						Value x = AsFloat(lhs, context);
+						Value y = AsFloat(rhs, context);
+						switch(Precision::Promote(x.precision, y.precision)) {
+							case PRECISION::DOUBLE:
+								return Value::MakeScalar(Kernel::Real(x.d[0], y.d[0]));
+#if defined(_MT_HAS_QUAD)
+							case PRECISION::QUAD:
+								return Value::MakeScalar(Kernel::Real(x.Get<mtquad_t>(0), y.Get<mtquad_t>(0)));
+#endif
+							default:
+								return Value::MakeScalar(Kernel::Real(x.Get<long double>(0), y.Get<long double>(0)));
+						}
+					}
+
+					/*
+						A dual argument as is, a real one as a constant
+					*/
+					Dual AsDual(Value const& v, CallContext& context) {
+						if(v.type == TYPE::DUAL)
+							return *static_cast<Dual*>(v.object);
+						return Dual(AsFloat(v, context).Get<long double>(0));
+					}
+
+					/*
+						|re + im i| scaled by the larger part so the squares can not overflow, for the tiers
+						without a hypot of their own
+					*/
+					template <class F>
+					F Modulus(F re, F im) {
+						F a = (re < 0) ? -re : re;
+						F b = (im < 0) ? -im : im;
+						if(a < b)
+							std::swap(a, b);
+						// Zero, infinite or NaN
+						if(a == 0 || (a - a) != 0)
+							return a;
+						const F t = b / a;
+						return a * SqrtKernel::Real(static_cast<F>(1) + (t * t));
+					}
+
+					void PrintRowOperation(std::string const& text) {
+						std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+						std::cout << std::endl;
+					}
+
+					Value Abs(Value const* args, size_t, CallContext& context) {
+						Value const& x = args[0];
+						switch(x.type) {
+							case TYPE::INTEGER:
+							case TYPE::RATIONAL: {
+								if(!x.big && x.i[0] >= 0)
+									return x;
+								if(!x.big && x.i[0] != INT64_MIN) {
+									Value r(x);
+									r.i[0] = -r.i[0];
+									return r;
+								}
+								Mt::objects::Rational r = x.ToRational();
+								return Value::FromRational(r.GetNumerator().IsNegative() ? -r : r, context.pool);
+							} case TYPE::DUAL: {
+								Dual const& d = *static_cast<Dual*>(x.object);
+								return Own(d.Chain(std::fabs(d.value), (d.value < 0.0L) ? -1.0L : 1.0L), context);
+							} case TYPE::COMPLEX:
+								// Modulus
+								switch(x.precision) {
+									case PRECISION::DOUBLE:
+										return Value::MakeScalar(std::hypot(x.d[0], x.d[1]));
+#if defined(_MT_HAS_QUAD)
+									case PRECISION::QUAD:
+										return Value::MakeScalar(Modulus(x.q[0], x.q[1]));
+#endif
+									default:
+										return Value::MakeScalar(std::hypot(x.e[0], x.e[1]));
+								}
+							default:
+								switch(x.precision) {
+									case PRECISION::DOUBLE:
+										return Value::MakeScalar(std::fabs(x.d[0]));
+									case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+										return Value::MakeScalar((x.q[0] < 0) ? -x.q[0] : x.q[0]);
+#endif
+									default:
+										return Value::MakeScalar(std::fabs(x.e[0]));
+								}
+						}
+					}
+
+					Value Sin(Value const* args, size_t, CallContext& context) {
+						switch(args[0].type) {
+							case TYPE::LIST:
+								return Own(CoreMath::Sin(AsList(args[0])), context);
+							case TYPE::MATRIX:
+								return Own(CoreMath::Sin(AsMatrix(args[0])), context);
+							case TYPE::DUAL:
+								return Own(CoreMath::Sin(AsDual(args[0], context)), context);
+							default:
+								return ApplyReal<SinKernel>(args[0], context);
+						}
+					}
+
+					Value Sqrt(Value const* args, size_t, CallContext& context) {
+						switch(args[0].type) {
+							case TYPE::LIST:
+								return Own(CoreMath::Sqrt(AsList(args[0])), context);
+							case TYPE::MATRIX:
+								return Own(CoreMath::Sqrt(AsMatrix(args[0])), context);
+							case TYPE::DUAL:
+								return Own(CoreMath::Sqrt(AsDual(args[0], context)), context);
+							default:
+								return ApplyReal<SqrtKernel>(args[0], context);
+						}
+					}
+
+					/*
+						Integer powers of exact numbers stay exact, by binary exponentiation on rationals
+					*/
+					Value ExactPow(Value const& base, int64_t n, CallContext& context) {
+						Mt::objects::Rational b = base.ToRational();
+						if(n < 0 && b.IsZero()) {
+							std::cerr << "Error: Division by zero" << std::endl;
+							return Value();
+						}
+						Mt::objects::Rational result(Mt::objects::Integer(1));
+						for(uint64_t e = (n < 0) ? static_cast<uint64_t>(-n) : static_cast<uint64_t>(n); e != 0; e >>= 1) {
+							if(e & 1)
+								result = result * b;
+							if(e > 1)
+								b = b * b;
+						}
+						if(n < 0)
+							result = Mt::objects::Rational(Mt::objects::Integer(1)) / result;
+						return Value::FromRational(result, context.pool);
+					}
+
+					/*
+						Small integer powers of a float by binary exponentiation in the result's tier, a few
+						multiplications instead of a trip through mtfloat_t
+					*/
+					template <class F>
+					Value SquaringPow(F b, int64_t n) {
+						F result = 1;
+						for(uint64_t e = (n < 0) ? static_cast<uint64_t>(-n) : static_cast<uint64_t>(n); e != 0; e >>= 1) {
+							if(e & 1)
+								result *= b;
+							if(e > 1)
+								b *= b;
+						}
+						return Value::MakeScalar((n < 0) ? F(1) / result : result);
+					}
+
+					Value Pow(Value const* args, size_t, CallContext& context) {
+						Value const& base = args[0];
+						Value const& power = args[1];
+						if(base.type == TYPE::DUAL || power.type == TYPE::DUAL) {
+							if(base.type == TYPE::LIST || base.type == TYPE::MATRIX) {
+								std::cerr << "Error: pow can not differentiate through lists or matrices" << std::endl;
+								return Value();
+							}
+							return Own(CoreMath::Pow(AsDual(base, context), AsDual(power, context)), context);
+						}
+						if(base.IsExact() && power.type == TYPE::INTEGER && !power.big && power.i[0] >= -EXACT_POW_LIMIT && power.i[0] <= EXACT_POW_LIMIT)
+							return ExactPow(base, power.i[0], context);
+						if(base.type == TYPE::SCALAR && power.type == TYPE::INTEGER && !power.big && power.i[0] >= -SQUARING_POW_LIMIT && power.i[0] <= SQUARING_POW_LIMIT) {
+							// The integer power would be rounded to the session tier, so that is the widest the result can be
+							switch(Precision::Promote(base.precision, context.precision)) {
+								case PRECISION::DOUBLE:
+									return SquaringPow(base.d[0], power.i[0]);
+#if defined(_MT_HAS_QUAD)
+								case PRECISION::QUAD:
+									return SquaringPow(base.Get<mtquad_t>(0), power.i[0]);
+#endif
+								default:
+									return SquaringPow(base.Get<long double>(0), power.i[0]);
+							}
+						}
+						Scalar exponent(AsFloat(power, context).Get<mtfloat_t>(0));
+						switch(base.type) {
+							case TYPE::LIST:
+								return Own(CoreMath::Pow(AsList(base), exponent), context);
+							case TYPE::MATRIX:
+								try {
+									return Own(CoreMath::Pow(AsMatrix(base), exponent), context);
+								} catch(std::exception& ex) {
+									std::cerr << "Error: " << ex.what() << std::endl;
+									return Value();
+								}
+							default:
+								return ApplyReal<PowKernel>(base, power, context);
+						}
+					}
+
+					Value Nrt(Value const* args, size_t, CallContext& context) {
+						if(args[0].type == TYPE::DUAL || args[1].type == TYPE::DUAL) {
+							if(args[0].type == TYPE::LIST || args[0].type == TYPE::MATRIX) {
+								std::cerr << "Error: nrt can not differentiate through lists or matrices" << std::endl;
+								return Value();
+							}
+							return Own(CoreMath::Nrt(AsDual(args[0], context), AsDual(args[1], context)), context);
+						}
+						Scalar root(AsFloat(args[1], context).Get<mtfloat_t>(0));
+						switch(args[0].type) {
+							case TYPE::LIST:
+								return Own(CoreMath::Nrt(AsList(args[0]), root), context);
+							case TYPE::MATRIX:
+								return Own(CoreMath::Nrt(AsMatrix(args[0]), root), context);
+							default:
+								return ApplyReal<NrtKernel>(args[0], args[1], context);
+						}
+					}
+
+					/*
+						Sum of a list
+					*/
+					Value Lsum(Value const* args, size_t, CallContext& context) {
+						List<Scalar> const& list = AsList(args[0]);
+						const mtfloat_t* data = list.Data();
+						mtfloat_t sum = static_cast<mtfloat_t>(0.0L);
+						for(int i = 0; i < list.GetSize(); i++)
+							sum = sum + data[i];
+						return Value::MakeScalar(sum, Narrowest(context.precision, ELEMENT_TIER));
+					}
+
+					/*
+						Sort by value, returns a sorted copy with NaNs at the end
+					*/
+					Value Sbv(Value const* args, size_t, CallContext& context) {
+						List<Scalar> sorted(AsList(args[0]));
+						std::sort(sorted.Data(), sorted.Data() + sorted.GetSize(), [](mtfloat_t const& a, mtfloat_t const& b) {
+							return (a < b) || ((a == a) && (b != b));
+						});
+						return Own(std::move(sorted), context);
+					}
+
+					/*
+						Solve matrix by Gaussian elimination, returns the reduced row echelon form. Pivots
+						are picked by largest magnitude, anything below rounding noise counts as zero. A
+						nonzero second argument prints each row operation.
+					*/
+					Value Smge(Value const* args, size_t count, CallContext& context) {
+						bool verbose = (count > 1) && (AsFloat(args[1], context).Get<mtfloat_t>(0) != static_cast<mtfloat_t>(0.0L));
+						Matrix<Scalar> m(AsMatrix(args[0]));
+						const int rows = m.GetRows();
+						const int cols = m.GetColumns();
+						mtfloat_t* a = m.Data();
+						mtfloat_t zero = static_cast<mtfloat_t>(0.0L);
+						auto magnitude = [&zero](mtfloat_t const& v) { return (v < zero) ? -v : v; };
+
+						mtfloat_t largest = zero;
+						for(int i = 0; i < rows * cols; i++)
+							largest = std::max(largest, magnitude(a[i]));
+						mtfloat_t tolerance = largest * static_cast<mtfloat_t>(static_cast<long double>(LDBL_EPSILON) * std::max(rows, cols));
+
+						std::string text;
+						int pivotRow = 0;
+						for(int col = 0; col < cols && pivotRow < rows; col++) {
+							int best = pivotRow;
+							for(int r = pivotRow + 1; r < rows; r++) {
+								if(magnitude(a[(r * cols) + col]) > magnitude(a[(best * cols) + col]))
+									best = r;
+							}
+							if(!(magnitude(a[(best * cols) + col]) > tolerance)) {
+								for(int r = pivotRow; r < rows; r++)
+									a[(r * cols) + col] = zero;
+								continue;
+							}
+							if(best != pivotRow) {
+								std::swap_ranges(a + (best * cols), a + ((best + 1) * cols), a + (pivotRow * cols));
+								if(verbose)
+									PrintRowOperation("R" + std::to_string(pivotRow + 1) + " <-> R" + std::to_string(best + 1));
+							}
+							mtfloat_t* pivot = a + (pivotRow * cols);
+							mtfloat_t scale = pivot[col];
+							if(scale != static_cast<mtfloat_t>(1.0L)) {
+								for(int c = col; c < cols; c++)
+									pivot[c] = pivot[c] / scale;
+								if(verbose) {
+									text = "R" + std::to_string(pivotRow + 1) + " = R" + std::to_string(pivotRow + 1) + " / ";
+									NumberFormatter::Append(text, scale);
+									PrintRowOperation(text);
+								}
+							}
+							pivot[col] = static_cast<mtfloat_t>(1.0L);
+							for(int r = 0; r < rows; r++) {
+								mtfloat_t* row = a + (r * cols);
+								mtfloat_t factor = row[col];
+								if(r == pivotRow || factor == zero)
+									continue;
+								for(int c = col; c < cols; c++)
+									row[c] = row[c] - (factor * pivot[c]);
+								row[col] = zero;
+								if(verbose) {
+									text = "R" + std::to_string(r + 1) + " = R" + std::to_string(r + 1) + " - ";
+									NumberFormatter::Append(text, factor);
+									text += " * R" + std::to_string(pivotRow + 1);
+									PrintRowOperation(text);
+								}
+							}
+							pivotRow++;
+						}
+						return Own(std::move(m), context);
+					}
+
+					/*
+						Reads what an SML function returned to a numeric engine as a real number, prints
+						why not otherwise
+					*/
+					bool Returned(Value y, Value const& function, PRECISION precision, long double& value) {
+						if(y.IsExact())
+							y = y.ToScalar(precision);
+						if(y.type != TYPE::SCALAR) {
+							if(!y.IsNone())
+								std::cerr << "Error: " << static_cast<Function*>(function.object)->GetName() << " has to return a real number here" << std::endl;
+							return false;
+						}
+						value = y.Get<long double>(0);
+						return true;
+					}
+
+					/*
+						An SML function for the numeric engines, every point is one call into the evaluator.
+						Forks get an evaluator of their own so worker threads never share scratch state.
+					*/
+					class SMLFunction : public BatchFunction {
+					private:
+						Value function;
+						FunctionCaller& caller;
+						std::unique_ptr<FunctionCaller> owned;
+						size_t dimension;
+						PRECISION precision;
+					public:
+						SMLFunction(Value const& fn, FunctionCaller& c, size_t n, PRECISION p) : function(fn), caller(c), dimension(n), precision(p) { }
+						SMLFunction(Value const& fn, std::unique_ptr<FunctionCaller> c, size_t n, PRECISION p) : function(fn), caller(*c), owned(std::move(c)), dimension(n), precision(p) { }
+
+						bool Evaluate(const long double* points, long double* values, size_t count) override {
+							Value args[MAX_ARITY];
+							for(size_t i = 0; i < count; i++) {
+								for(size_t d = 0; d < this->dimension; d++)
+									args[d] = Value::MakeScalar(static_cast<mtfloat_t>(points[(i * this->dimension) + d]), this->precision);
+								if(!Returned(this->caller.Call(this->function, args, this->dimension), this->function, this->precision, values[i]))
+									return false;
+							}
+							return true;
+						}
+
+						std::unique_ptr<BatchFunction> Fork(void) override {
+							std::unique_ptr<FunctionCaller> c = this->caller.Fork();
+							if(!c)
+								return nullptr;
+							return std::unique_ptr<BatchFunction>(new SMLFunction(this->function, std::move(c), this->dimension, this->precision));
+						}
+					};
+
+					/*
+						Returns true if the builtin can call the function argument with arity arguments,
+						prints why not otherwise
+					*/
+					bool Callable(Value const& fn, size_t arity, const char* builtin, CallContext& context) {
+						if(context.caller == nullptr) {
+							std::cerr << "Error: " << builtin << " can not call functions here" << std::endl;
+							return false;
+						}
+						Function const& f = *static_cast<Function*>(fn.object);
+						if(f.GetArity() != arity) {
+							std::cerr << "Error: " << builtin << " needs a function of " << arity << " argument(s) here, " << f.GetName() << " takes " << f.GetArity() << std::endl;
+							return false;
+						}
+						return true;
+					}
+
+					long double Real(Value const& v, CallContext& context) {
+						return AsFloat(v, context).Get<long double>(0);
+					}
+
+					/*
+						Definite integral of an SML function, integrate(F, a, b) over an interval and
+						integrate(F, a1, b1, a2, b2, ...) over a box with one pair of bounds per parameter
+						of F. An extra last argument sets the relative tolerance.
+					*/
+					Value Integrate(Value const* args, size_t count, CallContext& context) {
+						const size_t dimension = (count - 1) / 2;
+						if(!Callable(args[0], dimension, "integrate", context))
+							return Value();
+						long double lower[Integration::MAX_DIMENSION];
+						long double upper[Integration::MAX_DIMENSION];
+						for(size_t d = 0; d < dimension; d++) {
+							lower[d] = Real(args[1 + (2 * d)], context);
+							upper[d] = Real(args[2 + (2 * d)], context);
+							if(!std::isfinite(lower[d]) || !std::isfinite(upper[d])) {
+								std::cerr << "Error: integrate needs finite bounds" << std::endl;
+								return Value();
+							}
+						}
+						Integration::Options options;
+						if(count % 2 == 0) {
+							options.relativeTolerance = Real(args[count - 1], context);
+							if(!(options.relativeTolerance > 0.0L)) {
+								std::cerr << "Error: integrate needs a positive tolerance" << std::endl;
+								return Value();
+							}
+						}
+						SMLFunction f(args[0], *context.caller, dimension, context.precision);
+						Integration::Result result;
+						if(!Integration::Integrate(f, lower, upper, dimension, options, result))
+							return Value();
+						if(!result.converged) {
+							std::string text = "Warning: integrate did not reach the tolerance, estimated error ";
+							NumberFormatter::Append(text, result.error);
+							std::cerr << text << std::endl;
+						}
+						return Value::MakeScalar(static_cast<mtfloat_t>(result.value), Narrowest(context.precision, ENGINE_TIER));
+					}
+
+					// integrate takes the function, a pair of bounds per dimension and an optional tolerance
+					static_assert(2 + (2 * Integration::MAX_DIMENSION) == MAX_ARITY, "MAX_ARITY has to fit integrate");
+
+					/*
+						Reports how a solver ended, returns false if there is no result to return
+					*/
+					bool Report(symbolic::STATUS status, const char* builtin) {
+						switch(status) {
+							case symbolic::STATUS::FAILED:
+								return false;
+							case symbolic::STATUS::STALLED:
+								std::cerr << "Warning: " << builtin << " did not converge, the result is the best point found" << std::endl;
+								return true;
+							default:
+								return true;
+						}
+					}
+
+					/*
+						A point as a scalar in one dimension and as a list of its coordinates otherwise
+					*/
+					Value Point(std::vector<long double> const& x, CallContext& context) {
+						if(x.size() == 1)
+							return Value::MakeScalar(static_cast<mtfloat_t>(x[0]), Narrowest(context.precision, ENGINE_TIER));
+						List<Scalar> point;
+						point.Reserve(static_cast<int>(x.size()));
+						for(long double v : x)
+							point.Add(Scalar(static_cast<mtfloat_t>(v)));
+						return Own(std::move(point), context);
+					}
+
+					/*
+						Root of a function of one argument, solve(F, x0) by Newton's method from x0 and
+						solve(F, a, b) by Brent's method in [a, b]. When F has the same sign at both ends
+						the interval is sampled for a sign change, the leftmost root found is returned.
+					*/
+					Value Solve(Value const* args, size_t count, CallContext& context) {
+						if(!Callable(args[0], 1, "solve", context))
+							return Value();
+						SMLFunction f(args[0], *context.caller, 1, context.precision);
+						symbolic::SolverOptions options;
+						symbolic::Solution solution;
+						symbolic::STATUS status;
+						if(count == 2) {
+							status = symbolic::Newton(f, Real(args[1], context), options, solution);
+						} else {
+							long double a = Real(args[1], context), b = Real(args[2], context);
+							status = symbolic::Brent(f, a, b, options, solution);
+							if(status == symbolic::STATUS::NO_BRACKET) {
+								std::vector<long double> roots;
+								status = symbolic::Roots(f, a, b, ROOT_SAMPLES, options, roots);
+								if(status != symbolic::STATUS::FAILED && roots.empty()) {
+									std::cerr << "Error: solve found no sign change in the interval" << std::endl;
+									return Value();
+								}
+								if(!roots.empty())
+									solution.x.assign(1, roots[0]);
+							}
+						}
+						if(!Report(status, "solve"))
+							return Value();
+						return Point(solution.x, context);
+					}
+
+					/*
+						Every root of a function of one argument in [a, b] it changes sign at, as a list
+					*/
+					Value Roots(Value const* args, size_t, CallContext& context) {
+						if(!Callable(args[0], 1, "roots", context))
+							return Value();
+						SMLFunction f(args[0], *context.caller, 1, context.precision);
+						std::vector<long double> roots;
+						if(!Report(symbolic::Roots(f, Real(args[1], context), Real(args[2], context), ROOT_SAMPLES, symbolic::SolverOptions(), roots), "roots"))
+							return Value();
+						List<Scalar> list;
+						list.Reserve(static_cast<int>(roots.size()));
+						for(long double r : roots)
+							list.Add(Scalar(static_cast<mtfloat_t>(r)));
+						return Own(std::move(list), context);
+					}
+
+					/*
+						Local minimum of an SML function. minimize(F, x1, ..., xn) runs L-BFGS from the
+						given point, minimize(F, a1, b1, ..., an, bn) runs it from MULTI_STARTS points
+						spread over the box in parallel and returns the lowest minimum found.
+					*/
+					Value Minimize(Value const* args, size_t count, CallContext& context) {
+						const size_t arity = static_cast<Function*>(args[0].object)->GetArity();
+						if(arity == 0 || (count - 1 != arity && count - 1 != 2 * arity)) {
+							std::cerr << "Error: minimize takes a starting point or a pair of bounds for each argument of the function" << std::endl;
+							return Value();
+						}
+						if(!Callable(args[0], arity, "minimize", context))
+							return Value();
+						SMLFunction f(args[0], *context.caller, arity, context.precision);
+						symbolic::SolverOptions options;
+						symbolic::Solution solution;
+						symbolic::STATUS status;
+						if(count - 1 == arity) {
+							std::vector<long double> start(arity);
+							for(size_t i = 0; i < arity; i++)
+								start[i] = Real(args[1 + i], context);
+							status = symbolic::LBFGS(f, start.data(), arity, options, solution);
+						} else {
+							// Halton points cover the box evenly without clumping, and the same every run
+							std::vector<long double> starts(MULTI_STARTS * arity);
+							for(size_t k = 0; k < MULTI_STARTS; k++) {
+								for(size_t i = 0; i < arity; i++) {
+									long double lo = Real(args[1 + (2 * i)], context), hi = Real(args[2 + (2 * i)], context);
+									long double u = 0.0L, scale = 1.0L;
+									for(size_t index = k + 1; index != 0; index /= HALTON_BASES[i]) {
+										scale /= HALTON_BASES[i];
+										u += scale * static_cast<long double>(index % HALTON_BASES[i]);
+									}
+									starts[(k * arity) + i] = lo + ((hi - lo) * u);
+								}
+							}
+							status = symbolic::MultiStart(f, starts.data(), MULTI_STARTS, arity, options, solution);
+						}
+						if(!Report(status, "minimize"))
+							return Value();
+						return Point(solution.x, context);
+					}
+
+					/*
+						Local minimum of an SML function by the Nelder-Mead simplex method, for functions
+						that are not smooth enough for minimize. nelder(F, x1, ..., xn) starts at the point.
+					*/
+					Value Nelder(Value const* args, size_t count, CallContext& context) {
+						if(!Callable(args[0], count - 1, "nelder", context))
+							return Value();
+						SMLFunction f(args[0], *context.caller, count - 1, context.precision);
+						std::vector<long double> start(count - 1);
+						for(size_t i = 0; i + 1 < count; i++)
+							start[i] = Real(args[1 + i], context);
+						symbolic::Solution solution;
+						if(!Report(symbolic::NelderMead(f, start.data(), count - 1, symbolic::SolverOptions(), solution), "nelder"))
+							return Value();
+						return Point(solution.x, context);
+					}
+
+					/*
+						A system of SML functions for the ODE solvers, component i of dy/dt is function i
+						called with t, the state and the parameters
+					*/
+					class SMLSystem : public ODE::System {
+					private:
+						std::vector<Value> functions;
+						FunctionCaller& caller;
+						std::unique_ptr<FunctionCaller> owned;
+						size_t parameterCount;
+						PRECISION precision;
+					public:
+						SMLSystem(Value const* fns, size_t n, size_t parameters, FunctionCaller& c, PRECISION p) : functions(fns, fns + n), caller(c),
+							parameterCount(parameters), precision(p) { }
+						SMLSystem(std::vector<Value> const& fns, size_t parameters, std::unique_ptr<FunctionCaller> c, PRECISION p) : functions(fns), caller(*c),
+							owned(std::move(c)), parameterCount(parameters), precision(p) { }
+
+						bool Evaluate(const long double* t, const long double* y, const long double* p, long double* dydt, size_t count, size_t stride) override {
+							const size_t n = this->functions.size();
+							Value args[MAX_ARITY];
+							for(size_t m = 0; m < count; m++) {
+								args[0] = Value::MakeScalar(static_cast<mtfloat_t>(t[m]), this->precision);
+								for(size_t i = 0; i < n; i++)
+									args[1 + i] = Value::MakeScalar(static_cast<mtfloat_t>(y[(i * stride) + m]), this->precision);
+								for(size_t j = 0; j < this->parameterCount; j++)
+									args[1 + n + j] = Value::MakeScalar(static_cast<mtfloat_t>(p[(j * stride) + m]), this->precision);
+								for(size_t i = 0; i < n; i++) {
+									if(!Returned(this->caller.Call(this->functions[i], args, 1 + n + this->parameterCount), this->functions[i], this->precision, dydt[(i * stride) + m]))
+										return false;
+								}
+							}
+							return true;
+						}
+
+						std::unique_ptr<ODE::System> Fork(void) override {
+							std::unique_ptr<FunctionCaller> c = this->caller.Fork();
+							if(!c)
+								return nullptr;
+							return std::unique_ptr<ODE::System>(new SMLSystem(this->functions, this->parameterCount, std::move(c), this->precision));
+						}
+					};
+
+					/*
+						Number of leading function arguments, one per component of an ODE system
+					*/
+					size_t Components(Value const* args, size_t count) {
+						size_t n = 0;
+						while(n < count && args[n].type == TYPE::FUNCTION)
+							n++;
+						return n;
+					}
+
+					/*
+						Reads a whole number in [low, high], prints why not otherwise
+					*/
+					bool Count(Value const& v, size_t low, size_t high, const char* what, CallContext& context, size_t& count) {
+						long double x = Real(v, context);
+						if(!(x >= low && x <= high) || x != std::floor(x)) {
+							std::cerr << "Error: " << what << " has to be a whole number from " << low << " to " << high << std::endl;
+							return false;
+						}
+						count = static_cast<size_t>(x);
+						return true;
+					}
+
+					/*
+						Initial value problem shared by ode and stiff, (F1, ..., Fn, y1, ..., yn, t0, t1)
+						returns the state at t1. A sample count after t1 returns a matrix instead, one row
+						per sample time spread evenly from t0 to t1 holding t and the state, read off the
+						dense output of the one solve.
+					*/
+					Value InitialValue(Value const* args, size_t count, CallContext& context, ODE::METHOD method, const char* builtin) {
+						const size_t n = Components(args, count);
+						if(count != (2 * n) + 2 && count != (2 * n) + 3) {
+							std::cerr << "Error: " << builtin << " takes a function and an initial value per component, the start and end times and an optional sample count" << std::endl;
+							return Value();
+						}
+						for(size_t i = 0; i < n; i++) {
+							if(!Callable(args[i], n + 1, builtin, context))
+								return Value();
+						}
+						std::vector<long double> y(n);
+						for(size_t i = 0; i < n; i++)
+							y[i] = Real(args[n + i], context);
+						const long double t0 = Real(args[2 * n], context), t1 = Real(args[(2 * n) + 1], context);
+						if(!std::isfinite(t0) || !std::isfinite(t1)) {
+							std::cerr << "Error: " << builtin << " needs finite times" << std::endl;
+							return Value();
+						}
+						size_t samples = 0;
+						if(count == (2 * n) + 3 && !Count(args[count - 1], 2, MAX_SAMPLES, "The sample count", context, samples))
+							return Value();
+
+						ODE::Options options;
+						options.method = method;
+						if(method == ODE::METHOD::ROSENBROCK) {
+							options.relativeTolerance = STIFF_RELATIVE_TOLERANCE;
+							options.absoluteTolerance = STIFF_ABSOLUTE_TOLERANCE;
+						}
+						SMLSystem f(args, n, 0, *context.caller, context.precision);
+						ODE::Trajectory trajectory;
+						ODE::Result result;
+						if(!ODE::Solve(f, n, nullptr, 0, t0, y.data(), t1, options, trajectory, result)) {
+							if(result.failures != 0) {
+								std::string text = "Error: ";
+								text += builtin;
+								text += " could not get past t = ";
+								NumberFormatter::Append(text, trajectory.End());
+								if(method == ODE::METHOD::DORMAND_PRINCE)
+									text += ", the system may be stiff";
+								std::cerr << text << std::endl;
+							}
+							return Value();
+						}
+						if(samples == 0) {
+							trajectory.At(t1, y.data());
+							return Point(y, context);
+						}
+						Matrix<Scalar> table(static_cast<int>(samples), static_cast<int>(n + 1));
+						mtfloat_t* cells = table.Data();
+						for(size_t s = 0; s < samples; s++) {
+							long double t = (s + 1 == samples) ? t1 : t0 + (((t1 - t0) * s) / (samples - 1));
+							trajectory.At(t, y.data());
+							cells[s * (n + 1)] = static_cast<mtfloat_t>(t);
+							for(size_t i = 0; i < n; i++)
+								cells[(s * (n + 1)) + 1 + i] = static_cast<mtfloat_t>(y[i]);
+						}
+						return Own(std::move(table), context);
+					}
+
+					/*
+						ode(F1, ..., Fn, y1, ..., yn, t0, t1) by Dormand-Prince, Fi(t, y1, ..., yn) is
+						dyi/dt. Scalar equations are ode(F, y, t0, t1).
+					*/
+					Value Ode(Value const* args, size_t count, CallContext& context) {
+						return InitialValue(args, count, context, ODE::METHOD::DORMAND_PRINCE, "ode");
+					}
+
+					/*
+						Same arguments as ode, solved by the Rosenbrock method for stiff systems
+					*/
+					Value Stiff(Value const* args, size_t count, CallContext& context) {
+						return InitialValue(args, count, context, ODE::METHOD::ROSENBROCK, "stiff");
+					}
+
+					/*
+						ensemble(F1, ..., Fn, y1, ..., yn, t0, t1, p0, p1, members) solves the system for
+						members values of a parameter spread evenly over [p0, p1], Fi(t, y1, ..., yn, p)
+						is dyi/dt. Members are solved in parallel blocks and the states at t1 come back as
+						a list, or a matrix with a row per member for systems.
+					*/
+					Value Ensemble(Value const* args, size_t count, CallContext& context) {
+						const size_t n = Components(args, count);
+						if(count != (2 * n) + 5) {
+							std::cerr << "Error: ensemble takes a function and an initial value per component, the start and end times, the parameter range and the member count" << std::endl;
+							return Value();
+						}
+						for(size_t i = 0; i < n; i++) {
+							if(!Callable(args[i], n + 2, "ensemble", context))
+								return Value();
+						}
+						const long double t0 = Real(args[2 * n], context), t1 = Real(args[(2 * n) + 1], context);
+						const long double p0 = Real(args[(2 * n) + 2], context), p1 = Real(args[(2 * n) + 3], context);
+						if(!std::isfinite(t0) || !std::isfinite(t1) || !std::isfinite(p0) || !std::isfinite(p1)) {
+							std::cerr << "Error: ensemble needs finite times and parameters" << std::endl;
+							return Value();
+						}
+						size_t members;
+						if(!Count(args[count - 1], 1, MAX_MEMBERS, "The member count", context, members))
+							return Value();
+
+						std::vector<long double> y0(n * members), parameters(members), y1(n * members);
+						for(size_t i = 0; i < n; i++)
+							std::fill(y0.begin() + (i * members), y0.begin() + ((i + 1) * members), Real(args[n + i], context));
+						for(size_t m = 0; m < members; m++)
+							parameters[m] = (members == 1) ? p0 : p0 + (((p1 - p0) * m) / (members - 1));
+						SMLSystem f(args, n, 1, *context.caller, context.precision);
+						ODE::Result result;
+						if(!ODE::Ensemble(f, n, 1, members, t0, y0.data(), parameters.data(), &t1, 1, ODE::Options(), y1.data(), result))
+							return Value();
+						if(result.failures != 0)
+							std::cerr << "Warning: ensemble could not finish " << result.failures << " member(s), their states are NaN" << std::endl;
+						if(n == 1) {
+							List<Scalar> list;
+							list.Reserve(static_cast<int>(members));
+							for(long double v : y1)
+								list.Add(Scalar(static_cast<mtfloat_t>(v)));
+							return Own(std::move(list), context);
+						}
+						Matrix<Scalar> table(static_cast<int>(members), static_cast<int>(n));
+						mtfloat_t* cells = table.Data();
+						for(size_t m = 0; m < members; m++) {
+							for(size_t i = 0; i < n; i++)
+								cells[(m * n) + i] = static_cast<mtfloat_t>(y1[(i * members) + m]);
+						}
+						return Own(std::move(table), context);
+					}
+
+					/*
+						Shared by uniform and normal, (seed, n) fills a list and (seed, rows, columns) a
+						matrix in row major order. The same seed gives the same numbers at any precision
+						and thread count.
+					*/
+					Value RandomFill(Value const* args, size_t count, CallContext& context, Random::DISTRIBUTION distribution) {
+						size_t seed, rows, columns = 1;
+						if(!Count(args[0], 0, MAX_SEED, "The seed", context, seed) || !Count(args[1], 1, MAX_ELEMENTS, "The size", context, rows))
+							return Value();
+						if(count == 3 && !Count(args[2], 1, MAX_ELEMENTS / rows, "The column count", context, columns))
+							return Value();
+						std::vector<long double> values(rows * columns);
+						Random::Fill(Philox(seed), distribution, values.data(), values.size());
+						if(count == 2) {
+							List<Scalar> list;
+							list.Reserve(static_cast<int>(rows));
+							for(long double v : values)
+								list.Add(Scalar(static_cast<mtfloat_t>(v)));
+							return Own(std::move(list), context);
+						}
+						Matrix<Scalar> m(static_cast<int>(rows), static_cast<int>(columns));
+						mtfloat_t* cells = m.Data();
+						for(size_t i = 0; i < values.size(); i++)
+							cells[i] = static_cast<mtfloat_t>(values[i]);
+						return Own(std::move(m), context);
+					}
+
+					/*
+						Uniform random numbers in [0, 1), uniform(seed, n) or uniform(seed, rows, columns)
+					*/
+					Value Uniform(Value const* args, size_t count, CallContext& context) {
+						return RandomFill(args, count, context, Random::UNIFORM);
+					}
+
+					/*
+						Standard normal random numbers, normal(seed, n) or normal(seed, rows, columns)
+					*/
+					Value Normal(Value const* args, size_t count, CallContext& context) {
+						return RandomFill(args, count, context, Random::NORMAL);
+					}
+
+					// grad and jacobian seed one direction per argument of the function
+					static_assert(MAX_ARITY - 1 <= Dual::MAX_DIRECTIONS, "Dual needs a direction per argument");
+
+					/*
+						Calls fn once with the point seeded as dual numbers, direction d along argument d,
+						and reads the derivatives of its result into row. A real result is a function
+						that does not depend on its arguments here.
+					*/
+					bool Differentiate(Value const& fn, Value const* seeds, size_t n, const char* builtin, CallContext& context, long double* row) {
+						Value y = context.caller->Call(fn, seeds, n);
+						if(y.type == TYPE::DUAL) {
+							Dual const& d = *static_cast<Dual*>(y.object);
+							for(size_t i = 0; i < n; i++)
+								row[i] = d.tangent[i];
+							return true;
+						}
+						if(y.type == TYPE::SCALAR || y.IsExact()) {
+							std::fill(row, row + n, 0.0L);
+							return true;
+						}
+						if(!y.IsNone())
+							std::cerr << "Error: " << builtin << " needs " << static_cast<Function*>(fn.object)->GetName() << " to return a real number" << std::endl;
+						return false;
+					}
+
+					/*
+						Seeds the point args[0 .. n - 1] as dual numbers in the pool
+					*/
+					void Seed(Value const* args, size_t n, CallContext& context, Value* seeds) {
+						for(size_t i = 0; i < n; i++)
+							seeds[i] = Own(Dual(Real(args[i], context), i), context);
+					}
+
+					/*
+						Gradient of a real function at a point by forward mode differentiation, grad(F, x1,
+						..., xn). Every partial comes out of the same single call of F, a scalar in one
+						dimension and a list otherwise.
+					*/
+					Value Grad(Value const* args, size_t count, CallContext& context) {
+						const size_t n = count - 1;
+						if(!Callable(args[0], n, "grad", context))
+							return Value();
+						Value seeds[MAX_ARITY];
+						Seed(args + 1, n, context, seeds);
+						std::vector<long double> gradient(n);
+						if(!Differentiate(args[0], seeds, n, "grad", context, gradient.data()))
+							return Value();
+						return Point(gradient, context);
+					}
+
+					/*
+						Jacobian of F1, ..., Fm at a point, jacobian(F1, ..., Fm, x1, ..., xn) is an m by n
+						matrix with one call of each function
+					*/
+					Value Jacobian(Value const* args, size_t count, CallContext& context) {
+						const size_t m = Components(args, count);
+						const size_t n = count - m;
+						if(n == 0) {
+							std::cerr << "Error: jacobian needs a point after the functions" << std::endl;
+							return Value();
+						}
+						for(size_t i = 0; i < m; i++) {
+							if(!Callable(args[i], n, "jacobian", context))
+								return Value();
+						}
+						Value seeds[MAX_ARITY];
+						Seed(args + m, n, context, seeds);
+						std::vector<long double> rows(m * n);
+						for(size_t i = 0; i < m; i++) {
+							if(!Differentiate(args[i], seeds, n, "jacobian", context, rows.data() + (i * n)))
+								return Value();
+						}
+						Matrix<Scalar> jacobian(static_cast<int>(m), static_cast<int>(n));
+						mtfloat_t* cells = jacobian.Data();
+						for(size_t i = 0; i < rows.size(); i++)
+							cells[i] = static_cast<mtfloat_t>(rows[i]);
+						return Own(std::move(jacobian), context);
+					}
+
+					// A box takes two arguments per dimension, there is a Halton base for each
+					static_assert(sizeof(HALTON_BASES) / sizeof(HALTON_BASES[0]) >= (MAX_ARITY - 1) / 2, "minimize needs a Halton base per dimension");
+
+					/*
+						The table and its perfect hash. Slots are the top SLOT_BITS bits of a seeded 32 bit
+						FNV-1a hash of the name, the seed was picked so that no two names share a slot. The
+						static_assert below catches a new name that collides, pick a new HASH_SEED (or
+						widen SLOT_BITS) when it fires.
+					*/
+					constexpr Builtin TABLE[] = {
+						{ "abs", &Abs, 1, 1, { ARG_NUMBER | ARG_DUAL, 0 }, PURE },
+						{ "sin", &Sin, 1, 1, { ARG_REAL | ARG_LIST | ARG_MATRIX | ARG_DUAL, 0 }, PURE },
+						{ "pow", &Pow, 2, 2, { ARG_REAL | ARG_LIST | ARG_MATRIX | ARG_DUAL, ARG_REAL | ARG_DUAL }, PURE },
+						{ "nrt", &Nrt, 2, 2, { ARG_REAL | ARG_LIST | ARG_MATRIX | ARG_DUAL, ARG_REAL | ARG_DUAL }, PURE },
+						{ "sqrt", &Sqrt, 1, 1, { ARG_REAL | ARG_LIST | ARG_MATRIX | ARG_DUAL, 0 }, PURE },
+						{ "lsum", &Lsum, 1, 1, { ARG_LIST, 0 }, PURE },
+						{ "sbv", &Sbv, 1, 1, { ARG_LIST, 0 }, PURE },
+						{ "smge", &Smge, 1, 2, { ARG_MATRIX, ARG_REAL }, PURE },
+						{ "integrate", &Integrate, 3, MAX_ARITY, { ARG_FUNCTION, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL,
+							ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "solve", &Solve, 2, 3, { ARG_FUNCTION, ARG_REAL, ARG_REAL }, PURE },
+						{ "roots", &Roots, 3, 3, { ARG_FUNCTION, ARG_REAL, ARG_REAL }, PURE },
+						{ "minimize", &Minimize, 2, MAX_ARITY, { ARG_FUNCTION, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL,
+							ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "nelder", &Nelder, 2, MAX_ARITY, { ARG_FUNCTION, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL,
+							ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "ode", &Ode, 4, MAX_ARITY, { ARG_FUNCTION, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL,
+							ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "stiff", &Stiff, 4, MAX_ARITY, { ARG_FUNCTION, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL,
+							ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "ensemble", &Ensemble, 7, MAX_ARITY - 1, { ARG_FUNCTION, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL,
+							ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, 0 }, PURE },
+						{ "uniform", &Uniform, 2, 3, { ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "normal", &Normal, 2, 3, { ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "grad", &Grad, 2, MAX_ARITY, { ARG_FUNCTION, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL,
+							ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL, ARG_REAL }, PURE },
+						{ "jacobian", &Jacobian, 2, MAX_ARITY, { ARG_FUNCTION, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL,
+							ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL,
+							ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL, ARG_FUNCTION | ARG_REAL }, PURE },
+					};
+					constexpr size_t COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+
+					constexpr uint32_t HASH_SEED = 2166137405u;
+					constexpr uint32_t SLOT_BITS = 5;
+					constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+
+					constexpr uint32_t Hash(const char* s, size_t n, uint32_t h = HASH_SEED) {
+						return (n == 0) ? h : Hash(s + 1, n - 1, (h ^ static_cast<uint8_t>(*s)) * 16777619u);
+					}
+
+					constexpr size_t Length(const char* s) {
+						return (*s == '\0') ? 0 : 1 + Length(s + 1);
+					}
+
+					constexpr uint32_t Slot(uint32_t hash) {
+						return hash >> (32 - SLOT_BITS);
+					}
+
+					// Index of the builtin in the given slot, -1 for an empty slot
+					constexpr int IndexOf(uint32_t slot, size_t i = 0) {
+						return (i == COUNT) ? -1 : ((Slot(Hash(TABLE[i].name, Length(TABLE[i].name))) == slot) ? static_cast<int>(i) : IndexOf(slot, i + 1));
+					}
+
+					constexpr size_t Occupancy(uint32_t slot, size_t i = 0) {
+						return (i == COUNT) ? 0 : (((Slot(Hash(TABLE[i].name, Length(TABLE[i].name))) == slot) ? 1 : 0) + Occupancy(slot, i + 1));
+					}
+
+					constexpr bool Perfect(uint32_t slot = 0) {
+						return (slot == SLOTS) || ((Occupancy(slot) <= 1) && Perfect(slot + 1));
+					}
+
+					static_assert(Perfect(), "Two builtin names hash to the same slot, pick another HASH_SEED");
+					static_assert(SLOTS == 32, "SLOT_INDEX below lists one entry per slot");
+
+					constexpr int8_t SLOT_INDEX[SLOTS] = {
+						IndexOf(0), IndexOf(1), IndexOf(2), IndexOf(3), IndexOf(4), IndexOf(5), IndexOf(6), IndexOf(7),
+						IndexOf(8), IndexOf(9), IndexOf(10), IndexOf(11), IndexOf(12), IndexOf(13), IndexOf(14), IndexOf(15),
+						IndexOf(16), IndexOf(17), IndexOf(18), IndexOf(19), IndexOf(20), IndexOf(21), IndexOf(22), IndexOf(23),
+						IndexOf(24), IndexOf(25), IndexOf(26), IndexOf(27), IndexOf(28), IndexOf(29), IndexOf(30), IndexOf(31),
+					};
+				}
+
+				const Builtin* Find(std::string const& name) {
+					int index = SLOT_INDEX[Slot(Hash(name.data(), name.size()))];
+					if(index < 0 || name != TABLE[index].name)
+						return nullptr;
+					return &TABLE[index];
+				}
+			}
+		}
+	}
+}
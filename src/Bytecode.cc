@@ -0,0 +1,401 @@
+/*
+	Bytecode.cc - Compiles SML function bodies to register bytecode
+*/
+#include "core/lang/Bytecode.hh"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "core/lang/Parser.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace Bytecode {
+				namespace {
+					// Registers and table indices are 16 bit operands
+					const size_t MAX_OPERAND = 0xFFFF;
+
+					const char* const OPCODE_NAMES[OPCODES] = {
+						"CONSTANT", "GLOBAL", "FUNCTION", "MOVE", "ADD", "SUBTRACT", "MULTIPLY", "DIVIDE", "BUILTIN", "CALL", "RETURN", "TAILCALL",
+					};
+
+					/*
+						Adds every name assigned anywhere in expr to names
+					*/
+					void Assigned(NExpression* expr, std::vector<std::string>& names) {
+						switch(expr->type) {
+							case _NASSIGNMENT: {
+								auto nasgn = static_cast<NAssignment*>(expr);
+								names.push_back(nasgn->_lhs._name);
+								Assigned(nasgn->_rhs, names);
+								break;
+							} case _NBINARYOPERATOR: {
+								auto nbin = static_cast<NBinaryOperator*>(expr);
+								Assigned(nbin->_lhs, names);
+								Assigned(nbin->_rhs, names);
+								break;
+							} case _NMETHODCALL:
+								for(auto arg : static_cast<NMethodCall*>(expr)->_arguments)
+									Assigned(arg, names);
+								break;
+							default:
+								break;
+						}
+					}
+
+					/*! \class Compiler
+						\brief Lowers one function body
+
+						Temporaries are allocated like a stack above the named registers, an expression
+						releases everything its operands used once it has its own result. Each method
+						returns the register holding its result, -1 if the body can not be compiled.
+					*/
+					class Compiler {
+					private:
+						Program& program;
+						// Register of every parameter and every name the body assigns
+						std::map<std::string, uint16_t> locals;
+						// Names that hold a local value at this point of the body, the rest still read the globals
+						std::set<std::string> bound;
+						std::map<std::string, uint16_t> names;
+						// Registers below this are named
+						size_t named;
+						// Next free temporary
+						size_t top;
+
+						int Allocate(void) {
+							if(this->top > MAX_OPERAND)
+								return -1;
+							this->program.registers = std::max(this->program.registers, this->top + 1);
+							return static_cast<int>(this->top++);
+						}
+
+						int Target(int hint) {
+							return (hint >= 0) ? hint : this->Allocate();
+						}
+
+						void Emit(OPCODE op, int target, int a = 0, int b = 0, size_t count = 0) {
+							Instruction i;
+							i.op = op;
+							i.count = static_cast<uint8_t>(count);
+							i.target = static_cast<uint16_t>(target);
+							i.a = static_cast<uint16_t>(a);
+							i.b = static_cast<uint16_t>(b);
+							this->program.code.push_back(i);
+						}
+
+						int Name(std::string const& name) {
+							auto it = this->names.find(name);
+							if(it != this->names.end())
+								return it->second;
+							if(this->program.names.size() > MAX_OPERAND)
+								return -1;
+							this->program.names.push_back(Symbols::Intern(name));
+							return this->names[name] = static_cast<uint16_t>(this->program.names.size() - 1);
+						}
+
+						int Constant(Value const (&tiers)[TIERS], int hint) {
+							const size_t k = this->program.constants.size() / TIERS;
+							if(k > MAX_OPERAND)
+								return -1;
+							this->program.constants.insert(this->program.constants.end(), tiers, tiers + TIERS);
+							int target = this->Target(hint);
+							if(target >= 0)
+								this->Emit(CONSTANT, target, static_cast<int>(k));
+							return target;
+						}
+
+						/*
+							Makes sure the result of an expression ends up in register target
+						*/
+						bool Into(int result, int target) {
+							if(result < 0)
+								return false;
+							if(result != target)
+								this->Emit(MOVE, target, result);
+							return true;
+						}
+
+						int Load(std::string const& name, int hint) {
+							if(this->bound.count(name) != 0)
+								return this->locals[name];
+							int index = this->Name(name);
+							int target = this->Target(hint);
+							if(index < 0 || target < 0)
+								return -1;
+							this->Emit(GLOBAL, target, index);
+							return target;
+						}
+
+						int Assign(std::string const& name, NExpression* expr) {
+							const int target = this->locals[name];
+							if(!this->Into(this->Expression(expr, target), target))
+								return -1;
+							this->bound.insert(name);
+							return target;
+						}
+
+						int Call(NMethodCall* call, int hint) {
+							const Builtin* fn = call->_builtin;
+							const size_t count = call->_arguments.size();
+							// Calls copy their arguments out of the frame, so they have to fit in MAX_ARITY
+							if(count > Builtins::MAX_ARITY || (fn != nullptr && (count < fn->minArity || count > fn->maxArity)))
+								return -1;
+							const size_t save = this->top;
+							int callee = -1;
+							if(fn == nullptr) {
+								// Checked for being a function before the arguments are evaluated, like the walker
+								const int local = (this->bound.count(call->_id._name) != 0) ? this->locals[call->_id._name] : -1;
+								const int index = this->Name(call->_id._name);
+								callee = this->Allocate();
+								if(index < 0 || callee < 0 || local >= static_cast<int>(MAX_OPERAND))
+									return -1;
+								this->Emit(FUNCTION, callee, index, local + 1);
+							}
+							const int base = static_cast<int>(this->top);
+							for(size_t i = 0; i < count; i++) {
+								if(this->Allocate() < 0)
+									return -1;
+							}
+							for(size_t i = 0; i < count; i++) {
+								const int slot = base + static_cast<int>(i);
+								if(!this->Into(this->Expression(call->_arguments[i], slot), slot))
+									return -1;
+							}
+							this->top = save;
+							int target = this->Target(hint);
+							if(target < 0)
+								return -1;
+							if(fn != nullptr) {
+								this->program.builtins.push_back(fn);
+								this->Emit(BUILTIN, target, base, static_cast<int>(this->program.builtins.size() - 1), count);
+							} else {
+								this->Emit(CALL, target, base, callee, count);
+							}
+							return target;
+						}
+
+						int Binary(NBinaryOperator* nbin, int hint) {
+							OPCODE op;
+							switch(nbin->_op) {
+								case yy::SMLParser::token_type::TPLUS:
+									op = ADD;
+									break;
+								case yy::SMLParser::token_type::TMINUS:
+									op = SUBTRACT;
+									break;
+								case yy::SMLParser::token_type::TMUL:
+									op = MULTIPLY;
+									break;
+								case yy::SMLParser::token_type::TDIV:
+									op = DIVIDE;
+									break;
+								default:
+									return -1;
+							}
+							const size_t save = this->top;
+							int lhs = this->Expression(nbin->_lhs, -1);
+							int rhs = (lhs < 0) ? -1 : this->Expression(nbin->_rhs, -1);
+							if(rhs < 0)
+								return -1;
+							// Operands are read before the result is written, it may reuse their registers
+							this->top = save;
+							int target = this->Target(hint);
+							if(target >= 0)
+								this->Emit(op, target, lhs, rhs);
+							return target;
+						}
+
+						int Expression(NExpression* expr, int hint) {
+							switch(expr->type) {
+								case _NSCALAR: {
+									auto nsclr = static_cast<NScalar*>(expr);
+#if defined(_MT_HAS_QUAD)
+									const Value tiers[TIERS] = { Value::MakeScalar(nsclr->_d), Value::MakeScalar(nsclr->_e), Value::MakeScalar(nsclr->_q) };
+#else
+									const Value tiers[TIERS] = { Value::MakeScalar(nsclr->_d), Value::MakeScalar(nsclr->_e), Value::MakeScalar(nsclr->_e) };
+#endif
+									return this->Constant(tiers, hint);
+								} case _NCOMPLEX: {
+									auto ncplx = static_cast<NComplex*>(expr);
+#if defined(_MT_HAS_QUAD)
+									const Value quad = Value::MakeComplex(ncplx->_q[0], ncplx->_q[1]);
+#else
+									const Value quad = Value::MakeComplex(ncplx->_e[0], ncplx->_e[1]);
+#endif
+									const Value tiers[TIERS] = { Value::MakeComplex(ncplx->_d[0], ncplx->_d[1]), Value::MakeComplex(ncplx->_e[0], ncplx->_e[1]), quad };
+									return this->Constant(tiers, hint);
+								} case _NINTEGER: {
+									const Value n = Value::FromInteger(static_cast<NInteger*>(expr)->_i, this->program.objects);
+									const Value tiers[TIERS] = { n, n, n };
+									return this->Constant(tiers, hint);
+								} case _NIDENTIFIER:
+									return this->Load(static_cast<NIdentifier*>(expr)->_name, hint);
+								case _NASSIGNMENT: {
+									auto nasgn = static_cast<NAssignment*>(expr);
+									return this->Assign(nasgn->_lhs._name, nasgn->_rhs);
+								} case _NBINARYOPERATOR:
+									return this->Binary(static_cast<NBinaryOperator*>(expr), hint);
+								case _NMETHODCALL:
+									return this->Call(static_cast<NMethodCall*>(expr), hint);
+								default:
+									return -1;
+							}
+						}
+
+						int Statement(NStatement* statement) {
+							switch(statement->type) {
+								case _NVARIABLEDECLARATION: {
+									// A lone identifier parses as a declaration without a value, it is just a read
+									auto vardec = static_cast<NVariableDeclaration*>(statement);
+									if(vardec->_assignmentExpr == nullptr)
+										return this->Load(vardec->_id._name, -1);
+									return this->Assign(vardec->_id._name, vardec->_assignmentExpr);
+								} case _NEXPRESSIONSTATEMENT:
+									return this->Expression(static_cast<NExpressionStatement*>(statement)->_expression, -1);
+								case _NRETURNSTATEMENT: {
+									const int result = this->Expression(static_cast<NReturnStatement*>(statement)->_expression, -1);
+									if(result >= 0)
+										this->Return(result);
+									return result;
+								} default:
+									return -1;
+							}
+						}
+
+						void Return(int result) {
+							// Returning a call returns whatever the callee does, the caller's frame is no longer needed
+							std::vector<Instruction>& code = this->program.code;
+							if(!code.empty() && code.back().op == CALL && code.back().target == result)
+								code.back().op = TAILCALL;
+							this->Emit(RETURN, 0, result);
+						}
+					public:
+						Compiler(Program& p) : program(p), named(0), top(0) { }
+
+						bool Function(NFunctionDeclaration const& decl) {
+							StatementList const& body = decl._block.statements;
+							if(body.empty())
+								return false;
+							std::vector<std::string> assigned;
+							for(auto parameter : decl._arguments)
+								assigned.push_back(parameter->_id._name);
+							for(auto statement : body) {
+								if(statement->type == _NVARIABLEDECLARATION) {
+									auto vardec = static_cast<NVariableDeclaration*>(statement);
+									if(vardec->_assignmentExpr != nullptr) {
+										assigned.push_back(vardec->_id._name);
+										Assigned(vardec->_assignmentExpr, assigned);
+									}
+								} else if(statement->type == _NEXPRESSIONSTATEMENT) {
+									Assigned(static_cast<NExpressionStatement*>(statement)->_expression, assigned);
+								} else if(statement->type == _NRETURNSTATEMENT) {
+									Assigned(static_cast<NReturnStatement*>(statement)->_expression, assigned);
+								}
+							}
+							// Arguments are bound in order, a repeated parameter name takes the last one like the walker does
+							size_t next = decl._arguments.size();
+							for(size_t i = 0; i < assigned.size(); i++) {
+								if(i < decl._arguments.size()) {
+									this->locals[assigned[i]] = static_cast<uint16_t>(i);
+									this->bound.insert(assigned[i]);
+								} else if(this->locals.count(assigned[i]) == 0) {
+									if(next > MAX_OPERAND)
+										return false;
+									this->locals[assigned[i]] = static_cast<uint16_t>(next++);
+								}
+							}
+							this->named = next;
+							this->top = next;
+							this->program.registers = next;
+							int result = -1;
+							for(auto statement : body) {
+								result = this->Statement(statement);
+								if(result < 0)
+									return false;
+								this->top = this->named;
+							}
+							// A body that does not end in ret returns its last statement
+							if(body.back()->type != _NRETURNSTATEMENT)
+								this->Return(result);
+							return true;
+						}
+					};
+				}
+
+				void Program::Format(std::string& out) const {
+					auto reg = [&out](uint16_t r) {
+						out += 'r';
+						out += std::to_string(r);
+					};
+					for(size_t pc = 0; pc < this->code.size(); pc++) {
+						Instruction const& i = this->code[pc];
+						out += std::to_string(pc);
+						out += '\t';
+						out += OPCODE_NAMES[i.op];
+						out += '\t';
+						switch(i.op) {
+							case CONSTANT:
+								reg(i.target);
+								out += ", ";
+								this->constants[(i.a * TIERS) + PRECISION::EXTENDED].Format(out);
+								break;
+							case GLOBAL:
+							case FUNCTION:
+								reg(i.target);
+								out += ", ";
+								if(i.op == FUNCTION && i.b != 0)
+									reg(static_cast<uint16_t>(i.b - 1));
+								else
+									out += Symbols::Name(this->names[i.a]);
+								break;
+							case MOVE:
+								reg(i.target);
+								out += ", ";
+								reg(i.a);
+								break;
+							case BUILTIN:
+							case CALL:
+							case TAILCALL:
+								reg(i.target);
+								out += ", ";
+								if(i.op == BUILTIN)
+									out += this->builtins[i.b]->name;
+								else
+									reg(i.b);
+								out += '(';
+								for(uint16_t arg = 0; arg < i.count; arg++) {
+									if(arg != 0)
+										out += ", ";
+									reg(static_cast<uint16_t>(i.a + arg));
+								}
+								out += ')';
+								break;
+							case RETURN:
+								reg(i.a);
+								break;
+							default:
+								reg(i.target);
+								out += ", ";
+								reg(i.a);
+								out += ", ";
+								reg(i.b);
+								break;
+						}
+						out += '\n';
+					}
+				}
+
+				std::unique_ptr<Program> Compile(NFunctionDeclaration const& decl) {
+					std::unique_ptr<Program> program(new Program());
+					Compiler compiler(*program);
+					if(!compiler.Function(decl))
+						return nullptr;
+					return program;
+				}
+			}
+		}
+	}
+}
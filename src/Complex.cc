@@ -2,7 +2,10 @@
 	Complex.cc - Implementation Details for complex number class
 */
 
+#include <stdexcept>
+
 #include "objects/Complex.hh"
+#include "core/NumberParser.hh"
 
 namespace Mt {
 	namespace objects {
@@ -34,9 +37,12 @@ namespace Mt {
 			this->DerivedType = Mt::core::TYPE::COMPLEX;
 		}
 		Complex::Complex(std::string cplx) {
-			// TODO, split #[+-]#i into # and [-+]#i
+			Mt::core::NumberParser::Decimal re, im;
+			if(!Mt::core::NumberParser::ScanComplex(cplx.data(), cplx.data() + cplx.size(), re, im))
+				throw std::invalid_argument("Invalid complex \"" + cplx + "\"");
+			this->partReal = Mt::core::NumberParser::Convert<mtfloat_t>(re);
+			this->partImaginary = Mt::core::NumberParser::Convert<mtfloat_t>(im);
 			this->DerivedType = Mt::core::TYPE::COMPLEX;
-
 		}
 		// Chained constructor
 		Complex::Complex(const char * cplx) : Complex(std::string(cplx)) {
@@ -1,72 +1,845 @@
-/* 
+/*
 	CoreMath.cc - math functions
 */
 
 #include "core/CoreMath.hh"
-#include <math.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "core/HPN.hh"
 
 using Mt::objects::Scalar;
+using Mt::objects::BasicScalar;
+using Mt::objects::List;
+using Mt::objects::Matrix;
+using Mt::core::symbolic::Dual;
 
 namespace Mt{
 	namespace core {
 		namespace CoreMath{
+			namespace {
+				// Elements handled per pass, sized so the scratch buffers stay in L1
+				const size_t BLOCK = 256;
 
-			Scalar Pow(Scalar input, Scalar powr){
-				Scalar result;
+				// Adding then subtracting 1.5 * 2^52 rounds a double to the nearest integer and leaves
+				// that integer, in two's complement, in the low bits of the intermediate sum
+				const double ROUND_MAGIC = 6755399441055744.0;
 
-				mtfloat_t x = pow(input.GetInternal(), powr.GetInternal());
-				result = x;
-				return result;
+				// pi/2 split into two 33 bit parts and the rest (Cody and Waite), so k * part is exact
+				// for |k| < 2^20
+				const double TWO_OVER_PI = 0.6366197723675814;
+				const double PI_OVER_2_1 = 1.5707963267341256;
+				const double PI_OVER_2_2 = 6.077100506303966e-11;
+				const double PI_OVER_2_3 = 2.0222662487959506e-21;
+				// Past this the three part reduction loses bits, those lanes go to the exact tier
+				const double REDUCE_LIMIT = 8.0e5;
+
+				// ln 2 split into a 32 bit part and the rest
+				const double LOG2_E = 1.4426950408889634;
+				const double LN2_HI = 0.6931471803691238;
+				const double LN2_LO = 1.9082149292705877e-10;
+
+				const double EXP_OVERFLOW = 709.782712893384;
+				const double EXP_UNDERFLOW = -745.1332191019412;
+
+				const double SQRT_2 = 1.4142135623730951;
+				const double TWO_54 = 18014398509481984.0;
+				const uint64_t MANTISSA_MASK = 0x000FFFFFFFFFFFFFull;
+				const uint64_t ONE_BITS = 0x3FF0000000000000ull;
+
+				// The build passes -fno-builtin, which turns std::memcpy into a library call and keeps
+				// every loop below from vectorizing, the builtin is still inlined into a register move
+#if defined(__GNUC__) || defined(__clang__)
+#define MT_BIT_COPY __builtin_memcpy
+#else
+#define MT_BIT_COPY std::memcpy
+#endif
+				inline uint64_t Bits(double d) {
+					uint64_t u;
+					MT_BIT_COPY(&u, &d, sizeof(u));
+					return u;
+				}
+
+				inline double FromBits(uint64_t u) {
+					double d;
+					MT_BIT_COPY(&d, &u, sizeof(d));
+					return d;
+				}
+#undef MT_BIT_COPY
+
+				/*
+					c ? a : b without a branch. Floating point operations may trap, so GCC will not turn a
+					conditional one into a select and the loop around it would not vectorize, choosing
+					between the bits of two values that are both already computed avoids that.
+				*/
+				inline double Select(bool c, double a, double b) {
+					uint64_t mask = 0 - static_cast<uint64_t>(c);
+					return FromBits((Bits(a) & mask) | (Bits(b) & ~mask));
+				}
+
+				// 2^k for -1022 <= k <= 1023
+				inline double Pow2(int64_t k) {
+					return FromBits(static_cast<uint64_t>(k + 1023) << 52);
+				}
+
+				/*
+					x = k * pi/2 + r with |r| <= pi/4, returns r and leaves k mod 4 in quadrant
+				*/
+				inline double Reduce(double x, uint64_t& quadrant) {
+					double t = x * TWO_OVER_PI + ROUND_MAGIC;
+					double k = t - ROUND_MAGIC;
+					quadrant = Bits(t) & 3;
+					return ((x - k * PI_OVER_2_1) - k * PI_OVER_2_2) - k * PI_OVER_2_3;
+				}
+
+				/*
+					Taylor polynomials on [-pi/4, pi/4], the first dropped term is below 2^-56 relative
+				*/
+				inline double SinPoly(double r) {
+					double z = r * r;
+					double p = -7.647163731819816e-13 + z * 2.8114572543455206e-15;
+					p = 1.6059043836821613e-10 + z * p;
+					p = -2.505210838544172e-08 + z * p;
+					p = 2.7557319223985893e-06 + z * p;
+					p = -1.984126984126984e-04 + z * p;
+					p = 8.333333333333333e-03 + z * p;
+					p = -1.6666666666666666e-01 + z * p;
+					return r + (r * z) * p;
+				}
+
+				inline double CosPoly(double r) {
+					double z = r * r;
+					double p = -1.1470745597729725e-11 + z * 4.779477332387385e-14;
+					p = 2.08767569878681e-09 + z * p;
+					p = -2.755731922398589e-07 + z * p;
+					p = 2.48015873015873e-05 + z * p;
+					p = -1.388888888888889e-03 + z * p;
+					p = 4.1666666666666664e-02 + z * p;
+					// 1 - z/2 loses the low bits of z/2, add them back before the tail
+					double hz = 0.5 * z;
+					double w = 1.0 - hz;
+					return w + (((1.0 - w) - hz) + (z * z) * p);
+				}
+
+				struct SinBody {
+					double operator()(double x) const {
+						uint64_t q;
+						double r = Reduce(x, q);
+						double v = Select(q & 1, CosPoly(r), SinPoly(r));
+						// Keeps the sign of zero, which the polynomial loses
+						return Select(x == 0.0, x, Select(q & 2, -v, v));
+					}
+				};
+
+				struct CosBody {
+					double operator()(double x) const {
+						uint64_t q;
+						double r = Reduce(x, q);
+						double v = Select(q & 1, SinPoly(r), CosPoly(r));
+						return Select((q + 1) & 2, -v, v);
+					}
+				};
+
+				struct TanBody {
+					double operator()(double x) const {
+						uint64_t q;
+						double r = Reduce(x, q);
+						double s = SinPoly(r);
+						double c = CosPoly(r);
+						return Select(x == 0.0, x, Select(q & 1, -c / s, s / c));
+					}
+				};
+
+				/*
+					Runs a trig body over [in, in + n), lanes too large for the reduction are redone in
+					long double afterwards. Each block is copied first so in and out may alias.
+				*/
+				template <class Body>
+				void TrigKernel(const double* in, double* out, size_t n, Body body, long double (*fallback)(long double)) {
+					double saved[BLOCK];
+					for(size_t i = 0; i < n; i += BLOCK) {
+						size_t count = std::min(BLOCK, n - i);
+						std::copy(in + i, in + i + count, saved);
+						for(size_t j = 0; j < count; j++)
+							out[i + j] = body(saved[j]);
+						for(size_t j = 0; j < count; j++) {
+							if(!(saved[j] <= REDUCE_LIMIT && saved[j] >= -REDUCE_LIMIT))
+								out[i + j] = static_cast<double>(fallback(saved[j]));
+						}
+					}
+				}
+
+				long double ExactSinl(long double x) { return std::sin(x); }
+				long double ExactCosl(long double x) { return std::cos(x); }
+				long double ExactTanl(long double x) { return std::tan(x); }
+
+				/*
+					e^x = 2^k * e^r with |r| <= ln(2)/2, Taylor to r^14
+				*/
+				inline double ExpBody(double x) {
+					double xc = Select(x > 710.0, 710.0, x);
+					xc = Select(xc < -746.0, -746.0, xc);
+					double t = xc * LOG2_E + ROUND_MAGIC;
+					double k = t - ROUND_MAGIC;
+					double r = (xc - k * LN2_HI) - k * LN2_LO;
+					double p = 1.6059043836821613e-10 + r * 1.1470745597729725e-11;
+					p = 2.08767569878681e-09 + r * p;
+					p = 2.505210838544172e-08 + r * p;
+					p = 2.755731922398589e-07 + r * p;
+					p = 2.7557319223985893e-06 + r * p;
+					p = 2.48015873015873e-05 + r * p;
+					p = 1.984126984126984e-04 + r * p;
+					p = 1.388888888888889e-03 + r * p;
+					p = 8.333333333333333e-03 + r * p;
+					p = 4.1666666666666664e-02 + r * p;
+					p = 1.6666666666666666e-01 + r * p;
+					p = 0.5 + r * p;
+					p = 1.0 + r * (1.0 + r * p);
+					// 2^k can be out of range on its own near the ends, scale in two halves
+					double th = k * 0.5 + ROUND_MAGIC;
+					int64_t k1 = static_cast<int64_t>(Bits(th) - Bits(ROUND_MAGIC));
+					int64_t k2 = static_cast<int64_t>(Bits(t) - Bits(ROUND_MAGIC)) - k1;
+					double y = (p * Pow2(k1)) * Pow2(k2);
+					y = Select(x > EXP_OVERFLOW, std::numeric_limits<double>::infinity(), y);
+					y = Select(x < EXP_UNDERFLOW, 0.0, y);
+					return Select(x != x, x, y);
+				}
+
+				/*
+					ln(x) = e * ln(2) + ln(1 + f) with 1 + f in [sqrt(2)/2, sqrt(2)), the log of the
+					mantissa taken as 2 * atanh(s), s = f / (2 + f) (fdlibm's arrangement)
+				*/
+				inline double LnBody(double x) {
+					bool tiny = x < DBL_MIN;
+					double xs = Select(tiny, x * TWO_54, x);
+					uint64_t bits = Bits(xs);
+					int32_t e = static_cast<int32_t>((bits >> 52) & 0x7FF) - (tiny ? 1077 : 1023);
+					double m = FromBits((bits & MANTISSA_MASK) | ONE_BITS);
+					bool high = m > SQRT_2;
+					m = Select(high, m * 0.5, m);
+					e += high;
+					double f = m - 1.0;
+					double s = f / (2.0 + f);
+					double z = s * s;
+					double R = 0.09523809523809523 + z * 0.08695652173913043;
+					R = 0.10526315789473684 + z * R;
+					R = 0.11764705882352941 + z * R;
+					R = 0.13333333333333333 + z * R;
+					R = 0.15384615384615385 + z * R;
+					R = 0.18181818181818182 + z * R;
+					R = 0.2222222222222222 + z * R;
+					R = 0.2857142857142857 + z * R;
+					R = 0.4 + z * R;
+					R = z * (0.6666666666666666 + z * R);
+					double hfsq = 0.5 * f * f;
+					double k = static_cast<double>(e);
+					double y = k * LN2_HI - ((hfsq - (s * (hfsq + R) + k * LN2_LO)) - f);
+					y = Select(x == 0.0, -std::numeric_limits<double>::infinity(), y);
+					y = Select(x < 0.0, std::numeric_limits<double>::quiet_NaN(), y);
+					return Select(x != x || x == std::numeric_limits<double>::infinity(), x, y);
+				}
+
+				/*
+					Exact tier, evaluated in long double. Multi-precision floats use their own functions,
+					which round to within an ulp of their width.
+				*/
+				template <class F>
+				F ExactSin(F const& x) { return static_cast<F>(std::sin(static_cast<long double>(x))); }
+				template <class F>
+				F ExactCos(F const& x) { return static_cast<F>(std::cos(static_cast<long double>(x))); }
+				template <class F>
+				F ExactTan(F const& x) { return static_cast<F>(std::tan(static_cast<long double>(x))); }
+				template <class F>
+				F ExactExp(F const& x) { return static_cast<F>(std::exp(static_cast<long double>(x))); }
+				template <class F>
+				F ExactLn(F const& x) { return static_cast<F>(std::log(static_cast<long double>(x))); }
+				template <class F>
+				F ExactPow(F const& x, F const& y) { return static_cast<F>(std::pow(static_cast<long double>(x), static_cast<long double>(y))); }
+
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactSin(hpn::MPFloat<Bits> const& x) { return sin(x); }
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactCos(hpn::MPFloat<Bits> const& x) { return cos(x); }
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactTan(hpn::MPFloat<Bits> const& x) { return tan(x); }
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactExp(hpn::MPFloat<Bits> const& x) { return exp(x); }
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactLn(hpn::MPFloat<Bits> const& x) { return log(x); }
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactPow(hpn::MPFloat<Bits> const& x, hpn::MPFloat<Bits> const& y) { return pow(x, y); }
+
+				template <class F>
+				F ExactSqrt(F const& x) { return static_cast<F>(std::sqrt(static_cast<long double>(x))); }
+				template <class F>
+				F ExactCbrt(F const& x) { return static_cast<F>(std::cbrt(static_cast<long double>(x))); }
+
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactSqrt(hpn::MPFloat<Bits> const& x) { return sqrt(x); }
+				// Only called with x >= 0
+				template <int Bits>
+				hpn::MPFloat<Bits> ExactCbrt(hpn::MPFloat<Bits> const& x) { return pow(x, hpn::MPFloat<Bits>(1.0) / hpn::MPFloat<Bits>(3.0)); }
+
+#if defined(_MT_HAS_QUAD) && !defined(_MT_USE_LIB_HPN)
+				/*
+					The quad tier goes through a 128 bit MPFloat, within an ulp at 128 bits is well
+					inside half an ulp of __float128's 113. The HPN builds carry an MPFloat in that
+					tier already and take the overloads above
+				*/
+				typedef hpn::MPFloat<128> QuadWork;
+
+				mtquad_t ExactSin(mtquad_t const& x) { return static_cast<mtquad_t>(sin(QuadWork(x))); }
+				mtquad_t ExactCos(mtquad_t const& x) { return static_cast<mtquad_t>(cos(QuadWork(x))); }
+				mtquad_t ExactTan(mtquad_t const& x) { return static_cast<mtquad_t>(tan(QuadWork(x))); }
+				mtquad_t ExactExp(mtquad_t const& x) { return static_cast<mtquad_t>(exp(QuadWork(x))); }
+				mtquad_t ExactLn(mtquad_t const& x) { return static_cast<mtquad_t>(log(QuadWork(x))); }
+				mtquad_t ExactPow(mtquad_t const& x, mtquad_t const& y) { return static_cast<mtquad_t>(pow(QuadWork(x), QuadWork(y))); }
+				mtquad_t ExactSqrt(mtquad_t const& x) { return static_cast<mtquad_t>(sqrt(QuadWork(x))); }
+				mtquad_t ExactCbrt(mtquad_t const& x) { return static_cast<mtquad_t>(ExactCbrt(QuadWork(x))); }
+#endif
+
+				// Integer powers up to this go through repeated squaring, at most 2 * log2 roundings
+				const int64_t INTEGER_POW_LIMIT = 64;
+
+				/*
+					Returns true and sets n if v is a whole number that fits in an int64_t
+				*/
+				template <class F>
+				bool ToInteger(F const& v, int64_t& n) {
+					long double w = static_cast<long double>(v);
+					if(!(w > -9.2e18L && w < 9.2e18L))
+						return false;
+					n = static_cast<int64_t>(w);
+					return static_cast<F>(static_cast<long double>(n)) == v;
+				}
+
+				/*
+					x^n by binary exponentiation (Knuth, TAOCP vol. 2, 4.6.3), exact whenever every
+					intermediate power is representable
+				*/
+				template <class F>
+				F IntPow(F x, int64_t n) {
+					bool invert = n < 0;
+					uint64_t e = invert ? (0ull - static_cast<uint64_t>(n)) : static_cast<uint64_t>(n);
+					F result = static_cast<F>(1.0L);
+					while(e != 0) {
+						if(e & 1)
+							result = result * x;
+						e >>= 1;
+						if(e != 0)
+							x = x * x;
+					}
+					return invert ? static_cast<F>(1.0L) / result : result;
+				}
+
+				/*
+					A computed root y of a that is within rounding of a whole number r is replaced by r
+					when r^n == a exactly, so perfect powers give exact roots
+				*/
+				template <class F>
+				F SnapRoot(F const& y, F const& a, int64_t n) {
+					long double yl = static_cast<long double>(y);
+					long double r = std::floor(yl + 0.5L);
+					if(r == 0.0L || r > 9.2e18L || std::fabs(yl - r) > (r * 1e-9L))
+						return y;
+					F candidate = static_cast<F>(r);
+					return (IntPow(candidate, n) == a) ? candidate : y;
+				}
+
+				/*
+					Real n-th root, odd roots of negative numbers are negative
+				*/
+				template <class F>
+				F Root(F const& x, int64_t n) {
+					F zero = static_cast<F>(0.0L);
+					F inverse = static_cast<F>(1.0L) / static_cast<F>(static_cast<long double>(n));
+					// Even roots of negative numbers are not real, pow gives NaN for those
+					if(x < zero && (n % 2) == 0)
+						return ExactPow(x, inverse);
+					F a = (x < zero) ? -x : x;
+					F y = (n == 3) ? ExactCbrt(a) : ExactPow(a, inverse);
+					y = SnapRoot(y, a, n);
+					return (x < zero) ? -y : y;
+				}
+
+				/*! \struct PowPlan
+					\brief How a power or root is evaluated
+
+					Picked once from the exponent, so a whole List or Matrix runs one specialized loop
+					instead of classifying the exponent again for every element.
+				*/
+				template <class F>
+				struct PowPlan {
+					enum KIND {
+						// Pow
+						GENERAL,
+						// Binary exponentiation, n is the power
+						INTEGER,
+						// x^0.5, sqrt for positive x
+						HALF,
+						// Hardware square root
+						SQRT,
+						// n-th root, n >= 3
+						ROOT,
+					} kind;
+					int64_t n;
+					F exponent;
+				};
+
+				template <class F>
+				PowPlan<F> PlanPow(F const& exponent) {
+					PowPlan<F> plan;
+					plan.kind = PowPlan<F>::GENERAL;
+					plan.n = 0;
+					plan.exponent = exponent;
+					int64_t n;
+					if(ToInteger(exponent, n) && n >= -INTEGER_POW_LIMIT && n <= INTEGER_POW_LIMIT) {
+						plan.kind = PowPlan<F>::INTEGER;
+						plan.n = n;
+					} else if(exponent == static_cast<F>(0.5L)) {
+						plan.kind = PowPlan<F>::HALF;
+					}
+					return plan;
+				}
+
+				template <class F>
+				PowPlan<F> PlanRoot(F const& root) {
+					int64_t n;
+					if(!ToInteger(root, n) || n < 1)
+						return PlanPow(static_cast<F>(1.0L) / root);
+					PowPlan<F> plan;
+					plan.kind = (n == 1) ? PowPlan<F>::INTEGER : ((n == 2) ? PowPlan<F>::SQRT : PowPlan<F>::ROOT);
+					plan.n = n;
+					plan.exponent = static_cast<F>(1.0L) / root;
+					return plan;
+				}
+
+				template <class F>
+				void RunPlan(PowPlan<F> const& plan, F* data, size_t count) {
+					F zero = static_cast<F>(0.0L);
+					switch(plan.kind) {
+						case PowPlan<F>::INTEGER:
+							for(size_t i = 0; i < count; i++)
+								data[i] = IntPow(data[i], plan.n);
+							break;
+						case PowPlan<F>::HALF:
+							// pow and sqrt disagree on -0 and -inf, those keep going through pow
+							for(size_t i = 0; i < count; i++)
+								data[i] = (data[i] > zero) ? ExactSqrt(data[i]) : ExactPow(data[i], plan.exponent);
+							break;
+						case PowPlan<F>::SQRT:
+							for(size_t i = 0; i < count; i++)
+								data[i] = ExactSqrt(data[i]);
+							break;
+						case PowPlan<F>::ROOT:
+							for(size_t i = 0; i < count; i++)
+								data[i] = Root(data[i], plan.n);
+							break;
+						default:
+							for(size_t i = 0; i < count; i++)
+								data[i] = ExactPow(data[i], plan.exponent);
+							break;
+					}
+				}
+
+				typedef void (*kernel_t)(const double*, double*, size_t);
+				typedef mtfloat_t (*exact_t)(mtfloat_t const&);
+
+				/*
+					Applies a function to [data, data + n) in place, the fast tier narrows each block
+					to doubles, runs the kernel over it and widens the results back
+				*/
+				void Apply(mtfloat_t* data, size_t n, ACCURACY accuracy, kernel_t fast, exact_t exact) {
+					if(accuracy == ACCURACY::FAST) {
+						double buffer[BLOCK];
+						for(size_t i = 0; i < n; i += BLOCK) {
+							size_t count = std::min(BLOCK, n - i);
+							for(size_t j = 0; j < count; j++)
+								buffer[j] = static_cast<double>(data[i + j]);
+							fast(buffer, buffer, count);
+							for(size_t j = 0; j < count; j++)
+								data[i + j] = static_cast<mtfloat_t>(buffer[j]);
+						}
+						return;
+					}
+					for(size_t i = 0; i < n; i++)
+						data[i] = exact(data[i]);
+				}
+
+				/*
+					log_base(x) = ln(x) / ln(base), the reciprocal is taken once for the whole block
+				*/
+				void ApplyLog(mtfloat_t* data, size_t n, Scalar const& base, ACCURACY accuracy) {
+					Apply(data, n, accuracy, &Kernels::Ln, &ExactLn);
+					mtfloat_t scale = static_cast<mtfloat_t>(1) / ExactLn(base.GetInternal());
+					for(size_t i = 0; i < n; i++)
+						data[i] = data[i] * scale;
+				}
+
+				inline size_t Count(List<Scalar> const& l) {
+					return static_cast<size_t>(l.GetSize());
+				}
+
+				inline size_t Count(Matrix<Scalar> const& m) {
+					return static_cast<size_t>(m.GetRows()) * static_cast<size_t>(m.GetColumns());
+				}
+
+				template <class C>
+				C Map(C const& values, ACCURACY accuracy, kernel_t fast, exact_t exact) {
+					C result(values);
+					Apply(result.Data(), Count(result), accuracy, fast, exact);
+					return result;
+				}
+
+				template <class C>
+				C MapLog(C const& values, Scalar const& base, ACCURACY accuracy) {
+					C result(values);
+					ApplyLog(result.Data(), Count(result), base, accuracy);
+					return result;
+				}
+			}
+
+			namespace Kernels {
+				void Sin(const double* in, double* out, size_t n) {
+					TrigKernel(in, out, n, SinBody(), &ExactSinl);
+				}
+
+				void Cos(const double* in, double* out, size_t n) {
+					TrigKernel(in, out, n, CosBody(), &ExactCosl);
+				}
+
+				void Tan(const double* in, double* out, size_t n) {
+					TrigKernel(in, out, n, TanBody(), &ExactTanl);
+				}
+
+				void Exp(const double* in, double* out, size_t n) {
+					for(size_t i = 0; i < n; i++)
+						out[i] = ExpBody(in[i]);
+				}
+
+				void Ln(const double* in, double* out, size_t n) {
+					for(size_t i = 0; i < n; i++)
+						out[i] = LnBody(in[i]);
+				}
+
+				void Sqrt(const double* in, double* out, size_t n) {
+					// sqrtsd is correctly rounded, this tier only differs in width
+					for(size_t i = 0; i < n; i++)
+						out[i] = std::sqrt(in[i]);
+				}
+			}
+
+			Scalar Pow(Scalar input, Scalar powr){
+				mtfloat_t x = input.GetInternal();
+				RunPlan(PlanPow(powr.GetInternal()), &x, 1);
+				return Scalar(x);
 			}
 
 			//roots
 			Scalar Nrt(Scalar input, Scalar root){
-				Scalar s((mtfloat_t)1);
-				return Pow(input, (s/root));
+				mtfloat_t x = input.GetInternal();
+				RunPlan(PlanRoot(root.GetInternal()), &x, 1);
+				return Scalar(x);
 			}
 
 			Scalar Sqrt(Scalar input) {
-				Scalar s((mtfloat_t)2);
-				return Nrt(input,s);
+				return Scalar(ExactSqrt(input.GetInternal()));
+			}
+
+			Scalar Cbrt(Scalar input) {
+				return Scalar(Root<mtfloat_t>(input.GetInternal(), 3));
+			}
+
+			Matrix<Scalar> Pow(Matrix<Scalar> const& base, Scalar power) {
+				int64_t n;
+				if(base.GetRows() != base.GetColumns())
+					throw std::invalid_argument("Only square matrices can be raised to a power");
+				if(!ToInteger(power.GetInternal(), n) || n < 0)
+					throw std::domain_error("Matrix powers need a non negative integer exponent");
+				if(n == 0) {
+					Matrix<Scalar> identity(base.GetRows());
+					for(int i = 0; i < base.GetRows(); i++)
+						identity.GetAtLocation(i, i) = static_cast<mtfloat_t>(1.0L);
+					return identity;
+				}
+				// Square and multiply, log2(n) squarings plus one product per set bit
+				Matrix<Scalar> square(base);
+				Matrix<Scalar> result;
+				bool empty = true;
+				uint64_t e = static_cast<uint64_t>(n);
+				while(e != 0) {
+					if(e & 1) {
+						result = empty ? square : (result * square);
+						empty = false;
+					}
+					e >>= 1;
+					if(e != 0)
+						square = square * square;
+				}
+				return result;
 			}
 
 			// trig functions
 			//opp = opposite side
 			//hyp = hypotenuse
-			//adj = adjacent 
+			//adj = adjacent
 			Scalar Sin(Scalar opp, Scalar hyp) {
-				return hyp;
+				return opp / hyp;
 			}
 
 			Scalar Cos(Scalar adj, Scalar hyp) {
-				return hyp;
+				return adj / hyp;
 			}
 
 			Scalar Tan(Scalar opp, Scalar adj) {
-				return adj;
+				return opp / adj;
 			}
 
 			Scalar Csc(Scalar hyp, Scalar opp) {
-				return hyp;
+				return hyp / opp;
 			}
 
 			Scalar Sec(Scalar hyp, Scalar adj) {
-				return hyp;
+				return hyp / adj;
 			}
 
 			Scalar Cot(Scalar adj, Scalar opp) {
-				return adj;
+				return adj / opp;
+			}
+
+			Scalar Sin(Scalar angle) {
+				return Scalar(ExactSin(angle.GetInternal()));
+			}
+
+			Scalar Cos(Scalar angle) {
+				return Scalar(ExactCos(angle.GetInternal()));
+			}
+
+			Scalar Tan(Scalar angle) {
+				return Scalar(ExactTan(angle.GetInternal()));
+			}
+
+			Scalar Exp(Scalar input) {
+				return Scalar(ExactExp(input.GetInternal()));
 			}
 
 			//logs
 			Scalar Ln(Scalar logable) {
-				return logable;
+				return Scalar(ExactLn(logable.GetInternal()));
 			}
 
 			Scalar Log(Scalar logable,Scalar base) {
-				return logable;
+				return Scalar(ExactLn(logable.GetInternal()) / ExactLn(base.GetInternal()));
+			}
+
+			// a single value in its own tier
+			template <class F>
+			BasicScalar<F> Pow(BasicScalar<F> const& input, BasicScalar<F> const& powr) {
+				F x = input.GetInternal();
+				RunPlan(PlanPow(powr.GetInternal()), &x, 1);
+				return BasicScalar<F>(x);
+			}
+
+			template <class F>
+			BasicScalar<F> Nrt(BasicScalar<F> const& input, BasicScalar<F> const& root) {
+				F x = input.GetInternal();
+				RunPlan(PlanRoot(root.GetInternal()), &x, 1);
+				return BasicScalar<F>(x);
+			}
+
+			template <class F>
+			BasicScalar<F> Sqrt(BasicScalar<F> const& input) {
+				return BasicScalar<F>(ExactSqrt(input.GetInternal()));
+			}
+
+			template <class F>
+			BasicScalar<F> Sin(BasicScalar<F> const& angle) {
+				return BasicScalar<F>(ExactSin(angle.GetInternal()));
+			}
+
+			template <class F>
+			BasicScalar<F> Cos(BasicScalar<F> const& angle) {
+				return BasicScalar<F>(ExactCos(angle.GetInternal()));
+			}
+
+			template <class F>
+			BasicScalar<F> Tan(BasicScalar<F> const& angle) {
+				return BasicScalar<F>(ExactTan(angle.GetInternal()));
+			}
+
+			template <class F>
+			BasicScalar<F> Exp(BasicScalar<F> const& input) {
+				return BasicScalar<F>(ExactExp(input.GetInternal()));
+			}
+
+			template <class F>
+			BasicScalar<F> Ln(BasicScalar<F> const& logable) {
+				return BasicScalar<F>(ExactLn(logable.GetInternal()));
+			}
+
+#define MT_CORE_MATH_TIER(F) \
+			template BasicScalar<F> Pow(BasicScalar<F> const&, BasicScalar<F> const&); \
+			template BasicScalar<F> Nrt(BasicScalar<F> const&, BasicScalar<F> const&); \
+			template BasicScalar<F> Sqrt(BasicScalar<F> const&); \
+			template BasicScalar<F> Sin(BasicScalar<F> const&); \
+			template BasicScalar<F> Cos(BasicScalar<F> const&); \
+			template BasicScalar<F> Tan(BasicScalar<F> const&); \
+			template BasicScalar<F> Exp(BasicScalar<F> const&); \
+			template BasicScalar<F> Ln(BasicScalar<F> const&);
+			// The same tiers Scalar.cc instantiates BasicScalar for
+			MT_CORE_MATH_TIER(double)
+			MT_CORE_MATH_TIER(long double)
+#if defined(_MT_HAS_QUAD)
+			MT_CORE_MATH_TIER(mtquad_t)
+#endif
+#undef MT_CORE_MATH_TIER
+
+			// elementwise
+			List<Scalar> Pow(List<Scalar> const& values, Scalar power) {
+				List<Scalar> result(values);
+				RunPlan(PlanPow(power.GetInternal()), result.Data(), Count(result));
+				return result;
+			}
+
+			List<Scalar> Nrt(List<Scalar> const& values, Scalar root) {
+				List<Scalar> result(values);
+				RunPlan(PlanRoot(root.GetInternal()), result.Data(), Count(result));
+				return result;
+			}
+
+			List<Scalar> Sqrt(List<Scalar> const& values, ACCURACY accuracy) {
+				return Map(values, accuracy, &Kernels::Sqrt, &ExactSqrt);
+			}
+
+			List<Scalar> Cbrt(List<Scalar> const& values) {
+				return Nrt(values, Scalar(static_cast<mtfloat_t>(3.0L)));
+			}
+
+			Matrix<Scalar> Nrt(Matrix<Scalar> const& values, Scalar root) {
+				Matrix<Scalar> result(values);
+				RunPlan(PlanRoot(root.GetInternal()), result.Data(), Count(result));
+				return result;
+			}
+
+			Matrix<Scalar> Sqrt(Matrix<Scalar> const& values, ACCURACY accuracy) {
+				return Map(values, accuracy, &Kernels::Sqrt, &ExactSqrt);
+			}
+
+			Matrix<Scalar> Cbrt(Matrix<Scalar> const& values) {
+				return Nrt(values, Scalar(static_cast<mtfloat_t>(3.0L)));
+			}
+
+			List<Scalar> Sin(List<Scalar> const& angles, ACCURACY accuracy) {
+				return Map(angles, accuracy, &Kernels::Sin, &ExactSin);
+			}
+
+			List<Scalar> Cos(List<Scalar> const& angles, ACCURACY accuracy) {
+				return Map(angles, accuracy, &Kernels::Cos, &ExactCos);
+			}
+
+			List<Scalar> Tan(List<Scalar> const& angles, ACCURACY accuracy) {
+				return Map(angles, accuracy, &Kernels::Tan, &ExactTan);
+			}
+
+			List<Scalar> Exp(List<Scalar> const& values, ACCURACY accuracy) {
+				return Map(values, accuracy, &Kernels::Exp, &ExactExp);
+			}
+
+			List<Scalar> Ln(List<Scalar> const& values, ACCURACY accuracy) {
+				return Map(values, accuracy, &Kernels::Ln, &ExactLn);
+			}
+
+			List<Scalar> Log(List<Scalar> const& values, Scalar base, ACCURACY accuracy) {
+				return MapLog(values, base, accuracy);
+			}
+
+			Matrix<Scalar> Sin(Matrix<Scalar> const& angles, ACCURACY accuracy) {
+				return Map(angles, accuracy, &Kernels::Sin, &ExactSin);
+			}
+
+			Matrix<Scalar> Cos(Matrix<Scalar> const& angles, ACCURACY accuracy) {
+				return Map(angles, accuracy, &Kernels::Cos, &ExactCos);
+			}
+
+			Matrix<Scalar> Tan(Matrix<Scalar> const& angles, ACCURACY accuracy) {
+				return Map(angles, accuracy, &Kernels::Tan, &ExactTan);
+			}
+
+			Matrix<Scalar> Exp(Matrix<Scalar> const& values, ACCURACY accuracy) {
+				return Map(values, accuracy, &Kernels::Exp, &ExactExp);
+			}
+
+			Matrix<Scalar> Ln(Matrix<Scalar> const& values, ACCURACY accuracy) {
+				return Map(values, accuracy, &Kernels::Ln, &ExactLn);
+			}
+
+			Matrix<Scalar> Log(Matrix<Scalar> const& values, Scalar base, ACCURACY accuracy) {
+				return MapLog(values, base, accuracy);
+			}
+
+			// dual numbers, f(x + x'e) = f(x) + f'(x)x'e
+			namespace {
+				inline Scalar At(long double x) {
+					return Scalar(static_cast<mtfloat_t>(x));
+				}
+
+				inline long double Of(Scalar const& s) {
+					return static_cast<long double>(s.GetInternal());
+				}
+			}
+
+			Dual Pow(Dual const& input, Dual const& powr) {
+				const long double x = input.value, p = powr.value;
+				const long double f = Of(Pow(At(x), At(p)));
+				Dual result = input.Chain(f, (p == 0.0L) ? 0.0L : p * std::pow(x, p - 1.0L));
+				// d(x^p)/dp = x^p ln(x), which only matters when the power is not a constant
+				if(!powr.IsConstant() && f != 0.0L) {
+					const double scale = static_cast<double>(f * std::log(x));
+					for(size_t i = 0; i < Dual::MAX_DIRECTIONS; i++)
+						result.tangent[i] += scale * powr.tangent[i];
+				}
+				return result;
+			}
+
+			Dual Nrt(Dual const& input, Dual const& root) {
+				if(!root.IsConstant())
+					return Pow(input, Dual(1.0L) / root);
+				const long double f = Of(Nrt(At(input.value), At(root.value)));
+				return input.Chain(f, f / (root.value * input.value));
+			}
+
+			Dual Sqrt(Dual const& input) {
+				const long double f = Of(Sqrt(At(input.value)));
+				return input.Chain(f, 0.5L / f);
 			}
 
+			Dual Sin(Dual const& angle) {
+				return angle.Chain(Of(Sin(At(angle.value))), Of(Cos(At(angle.value))));
+			}
+
+			Dual Cos(Dual const& angle) {
+				return angle.Chain(Of(Cos(At(angle.value))), -Of(Sin(At(angle.value))));
+			}
+
+			Dual Tan(Dual const& angle) {
+				const long double f = Of(Tan(At(angle.value)));
+				return angle.Chain(f, 1.0L + (f * f));
+			}
+
+			Dual Exp(Dual const& input) {
+				const long double f = Of(Exp(At(input.value)));
+				return input.Chain(f, f);
+			}
+
+			Dual Ln(Dual const& logable) {
+				return logable.Chain(Of(Ln(At(logable.value))), 1.0L / logable.value);
+			}
 		}
 	}
 }
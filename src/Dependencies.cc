@@ -0,0 +1,298 @@
+/*
+	Dependencies.cc - Which definitions and statements read which globals
+*/
+#include "core/lang/Dependencies.hh"
+
+#include <algorithm>
+
+#include "core/lang/Function.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace {
+				/*! \class Reads
+					\brief Collects the globals an expression reads
+				*/
+				class Reads {
+				private:
+					SymbolTable const& globals;
+					// Function bodies already walked, so recursion does not loop
+					std::vector<NFunctionDeclaration const*> seen;
+				public:
+					std::vector<Symbol> symbols;
+					// The SML functions called on the way, directly or from another body
+					std::vector<Symbol> calls;
+					// Globals handed to a call as a value, what it calls them with is not known
+					std::vector<Symbol> values;
+					// False if a builtin with effects is called on the way
+					bool pure;
+
+					explicit Reads(SymbolTable const& gst) : globals(gst), pure(true) { }
+
+					/*
+						Adds the globals the function bound to the symbol reads, if it is bound to one
+					*/
+					void Callee(Symbol symbol) {
+						Value const* v = this->globals.Find(symbol);
+						if(v != nullptr && v->type == TYPE::FUNCTION)
+							this->Body(static_cast<Function*>(v->object)->declaration);
+					}
+
+					/*
+						Adds the globals a function body reads whenever it is called. A body only sees its
+						own locals, a function defined in it does not see the enclosing ones.
+					*/
+					void Body(NFunctionDeclaration const& decl) {
+						if(std::find(this->seen.begin(), this->seen.end(), &decl) != this->seen.end())
+							return;
+						this->seen.push_back(&decl);
+						// A name the body assigns is local from then on, before that it still reads the global
+						std::vector<Symbol> locals;
+						for(auto parameter : decl._arguments)
+							locals.push_back(parameter->_id._symbol);
+						for(auto statement : decl._block.statements) {
+							switch(statement->type) {
+								case _NVARIABLEDECLARATION: {
+									auto vardec = static_cast<NVariableDeclaration const*>(statement);
+									if(vardec->_assignmentExpr == nullptr) {
+										this->Expression(&vardec->_id, &locals);
+									} else {
+										this->Expression(vardec->_assignmentExpr, &locals);
+										locals.push_back(vardec->_id._symbol);
+									}
+									break;
+								} case _NEXPRESSIONSTATEMENT:
+									this->Expression(static_cast<NExpressionStatement const*>(statement)->_expression, &locals);
+									break;
+								case _NRETURNSTATEMENT:
+									this->Expression(static_cast<NReturnStatement const*>(statement)->_expression, &locals);
+									break;
+								case _NFUNCTIONDECLARATION: {
+									// What it reads is read whenever it is called, wherever it ends up
+									auto nested = static_cast<NFunctionDeclaration const*>(statement);
+									this->Body(*nested);
+									locals.push_back(nested->_id._symbol);
+									break;
+								} default:
+									break;
+							}
+						}
+					}
+
+					/*
+						Adds what expr reads, false if it assigns anything. In a function body assignments
+						only ever bind locals, those go into locals instead.
+					*/
+					bool Expression(NExpression const* expr, std::vector<Symbol>* locals = nullptr) {
+						switch(expr->type) {
+							case _NIDENTIFIER: {
+								const Symbol symbol = static_cast<NIdentifier const*>(expr)->_symbol;
+								if(locals == nullptr || std::find(locals->begin(), locals->end(), symbol) == locals->end()) {
+									this->symbols.push_back(symbol);
+									// A function read as a value is called by whatever it is handed to
+									Value const* v = this->globals.Find(symbol);
+									if(v != nullptr && v->type == TYPE::FUNCTION) {
+										this->calls.push_back(symbol);
+										this->Callee(symbol);
+									}
+								}
+								return true;
+							} case _NASSIGNMENT: {
+								auto nasgn = static_cast<NAssignment const*>(expr);
+								if(locals == nullptr || !this->Expression(nasgn->_rhs, locals))
+									return false;
+								locals->push_back(nasgn->_lhs._symbol);
+								return true;
+							} case _NBINARYOPERATOR: {
+								auto nbin = static_cast<NBinaryOperator const*>(expr);
+								return this->Expression(nbin->_lhs, locals) && this->Expression(nbin->_rhs, locals);
+							} case _NMETHODCALL: {
+								auto ncall = static_cast<NMethodCall const*>(expr);
+								const Symbol callee = ncall->_id._symbol;
+								if(ncall->_builtin != nullptr) {
+									this->pure = this->pure && ncall->_builtin->pure;
+								} else if(locals == nullptr || std::find(locals->begin(), locals->end(), callee) == locals->end()) {
+									this->symbols.push_back(callee);
+									this->calls.push_back(callee);
+									this->Callee(callee);
+								}
+								for(size_t i = 0; i < ncall->_arguments.size(); i++) {
+									NExpression const* arg = ncall->_arguments[i];
+									if(!this->Expression(arg, locals))
+										return false;
+									// Only where a function may go, an SML function may call any of its parameters
+									const bool callable = ncall->_builtin == nullptr || (i < Builtins::MAX_ARITY && (ncall->_builtin->signature[i] & Builtins::ARG_FUNCTION) != 0);
+									if(callable && arg->type == _NIDENTIFIER) {
+										const Symbol value = static_cast<NIdentifier const*>(arg)->_symbol;
+										if(locals == nullptr || std::find(locals->begin(), locals->end(), value) == locals->end())
+											this->values.push_back(value);
+									}
+								}
+								return true;
+							} case _NBLOCK:
+								return false;
+							default:
+								return true;
+						}
+					}
+				};
+			}
+
+			size_t Schedule::Plan(std::vector<NStatement*> const& statements, size_t first, SymbolTable const& globals, std::vector<size_t>& levels) {
+				struct Access {
+					std::vector<Symbol> reads;
+					bool binds;
+					Symbol bound;
+				};
+				std::vector<Access> planned;
+				levels.clear();
+				for(size_t i = first; i < statements.size(); i++) {
+					NExpression const* expr = nullptr;
+					Access access{ std::vector<Symbol>(), false, 0 };
+					if(statements[i]->type == _NVARIABLEDECLARATION) {
+						auto vardec = static_cast<NVariableDeclaration const*>(statements[i]);
+						expr = vardec->_assignmentExpr;
+						access.binds = true;
+						access.bound = vardec->_id._symbol;
+					} else if(statements[i]->type == _NEXPRESSIONSTATEMENT) {
+						expr = static_cast<NExpressionStatement const*>(statements[i])->_expression;
+					}
+					// Function definitions and anything that assigns on the way wait for everything before them
+					Reads reads(globals);
+					if(expr == nullptr || !reads.Expression(expr) || !reads.pure)
+						break;
+					// A function bound earlier in the plan is not in the globals yet, so what its body reads is not
+					// known. That goes for a name handed to a call too, it may be bound to a function.
+					bool stale = false;
+					for(Access const& before : planned) {
+						stale = stale || (before.binds && (std::find(reads.calls.begin(), reads.calls.end(), before.bound) != reads.calls.end()
+							|| std::find(reads.values.begin(), reads.values.end(), before.bound) != reads.values.end()));
+					}
+					if(stale)
+						break;
+					std::sort(reads.symbols.begin(), reads.symbols.end());
+					reads.symbols.erase(std::unique(reads.symbols.begin(), reads.symbols.end()), reads.symbols.end());
+					access.reads = std::move(reads.symbols);
+					// One level above everything that binds what it reads, reads what it binds or binds the same name
+					size_t level = 0;
+					for(size_t j = 0; j < planned.size(); j++) {
+						Access const& before = planned[j];
+						const bool waits = (before.binds && std::binary_search(access.reads.begin(), access.reads.end(), before.bound))
+							|| (access.binds && (std::binary_search(before.reads.begin(), before.reads.end(), access.bound) || (before.binds && before.bound == access.bound)));
+						if(waits)
+							level = std::max(level, levels[j] + 1);
+					}
+					planned.push_back(std::move(access));
+					levels.push_back(level);
+				}
+				return planned.size();
+			}
+
+			bool DependencyGraph::Define(NVariableDeclaration* statement, std::string const& input, SymbolTable const& globals) {
+				const Symbol symbol = statement->_id._symbol;
+				Reads reads(globals);
+				if(statement->_assignmentExpr == nullptr || !reads.Expression(statement->_assignmentExpr)
+					|| std::find(reads.symbols.begin(), reads.symbols.end(), symbol) != reads.symbols.end()) {
+					this->Forget(symbol);
+					return false;
+				}
+				std::sort(reads.symbols.begin(), reads.symbols.end());
+				reads.symbols.erase(std::unique(reads.symbols.begin(), reads.symbols.end()), reads.symbols.end());
+				// Recomputing a definition records it again, it keeps its place. The input may be the old definition's.
+				auto it = this->definitions.find(symbol);
+				const unsigned long long order = (it != this->definitions.end() && it->second.statement == statement) ? it->second.order : this->next++;
+				std::string line(input);
+				this->Forget(symbol);
+				for(Symbol read : reads.symbols)
+					this->readers[read].push_back(symbol);
+				this->definitions[symbol] = Definition{ statement, std::move(line), std::move(reads.symbols), order };
+				return true;
+			}
+
+			void DependencyGraph::Forget(Symbol symbol) {
+				auto it = this->definitions.find(symbol);
+				if(it == this->definitions.end())
+					return;
+				for(Symbol read : it->second.reads) {
+					std::vector<Symbol>& r = this->readers[read];
+					r.erase(std::remove(r.begin(), r.end(), symbol), r.end());
+				}
+				this->definitions.erase(it);
+			}
+
+			std::vector<Symbol> DependencyGraph::Dependents(std::vector<Symbol> const& changed, std::vector<Symbol>& cyclic) const {
+				// Everything that reads a changed name, directly or through another definition
+				std::vector<Symbol> affected;
+				std::vector<Symbol> pending(changed);
+				while(!pending.empty()) {
+					const Symbol symbol = pending.back();
+					pending.pop_back();
+					auto it = this->readers.find(symbol);
+					if(it == this->readers.end())
+						continue;
+					for(Symbol reader : it->second) {
+						if(std::find(changed.begin(), changed.end(), reader) == changed.end() && std::find(affected.begin(), affected.end(), reader) == affected.end()) {
+							affected.push_back(reader);
+							pending.push_back(reader);
+						}
+					}
+				}
+				// Kahn's algorithm over the affected definitions, the earliest defined goes first among those that are ready
+				std::unordered_map<Symbol, size_t> waiting;
+				for(Symbol symbol : affected) {
+					size_t count = 0;
+					for(Symbol read : this->definitions.at(symbol).reads)
+						count += (std::find(affected.begin(), affected.end(), read) != affected.end()) ? 1 : 0;
+					waiting[symbol] = count;
+				}
+				std::vector<Symbol> order;
+				for(;;) {
+					const Symbol* ready = nullptr;
+					for(Symbol const& symbol : affected) {
+						if(waiting[symbol] == 0 && (ready == nullptr || this->definitions.at(symbol).order < this->definitions.at(*ready).order))
+							ready = &symbol;
+					}
+					if(ready == nullptr)
+						break;
+					const Symbol symbol = *ready;
+					order.push_back(symbol);
+					waiting.erase(symbol);
+					affected.erase(std::find(affected.begin(), affected.end(), symbol));
+					auto it = this->readers.find(symbol);
+					if(it != this->readers.end()) {
+						for(Symbol reader : it->second) {
+							auto w = waiting.find(reader);
+							if(w != waiting.end())
+								w->second--;
+						}
+					}
+				}
+				// What is left reads itself through the others
+				std::sort(affected.begin(), affected.end(), [this](Symbol a, Symbol b) {
+					return this->definitions.at(a).order < this->definitions.at(b).order;
+				});
+				cyclic = affected;
+				return order;
+			}
+
+			NVariableDeclaration* DependencyGraph::Statement(Symbol symbol) const {
+				auto it = this->definitions.find(symbol);
+				return (it != this->definitions.end()) ? it->second.statement : nullptr;
+			}
+
+			std::string const& DependencyGraph::Input(Symbol symbol) const {
+				return this->definitions.at(symbol).input;
+			}
+
+			size_t DependencyGraph::Size(void) const {
+				return this->definitions.size();
+			}
+
+			void DependencyGraph::Clear(void) {
+				this->definitions.clear();
+				this->readers.clear();
+			}
+		}
+	}
+}
@@ -0,0 +1,221 @@
+/*
+	Dispatch.cc - Binary operator dispatch on the types of both operands
+*/
+#include "core/lang/Dispatch.hh"
+
+#include <stdexcept>
+#include <utility>
+
+#include "core/lang/Arithmetic.hh"
+#include "objects/List.hh"
+#include "objects/Matrix.hh"
+
+using Mt::objects::Scalar;
+using Mt::objects::List;
+using Mt::objects::Matrix;
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace Dispatch {
+				namespace {
+					typedef List<Scalar> ScalarList;
+					typedef Matrix<Scalar> ScalarMatrix;
+
+					const char* NAMES[OPERATORS] = { "addition", "subtraction", "multiplication", "division" };
+
+					/*
+						A real number as a complex one in the same tier
+					*/
+					Value Complexify(Value const& v) {
+						Value c(v);
+						c.type = TYPE::COMPLEX;
+						switch(c.precision) {
+							case PRECISION::DOUBLE:
+								c.d[1] = 0.0;
+								break;
+							case PRECISION::EXTENDED:
+								c.e[1] = 0.0L;
+								break;
+							default:
+								c.q[1] = 0;
+								break;
+						}
+						return c;
+					}
+
+					/*
+						Element value of a real operand mixed with a collection
+					*/
+					mtfloat_t Element(Value const& v, CallContext& context) {
+						return (v.IsExact() ? v.ToScalar(context.precision) : v).Get<mtfloat_t>(0);
+					}
+
+					inline size_t Count(ScalarList const& l) {
+						return static_cast<size_t>(l.GetSize());
+					}
+
+					inline size_t Count(ScalarMatrix const& m) {
+						return static_cast<size_t>(m.GetRows()) * static_cast<size_t>(m.GetColumns());
+					}
+
+					inline bool SameShape(ScalarList const& a, ScalarList const& b) {
+						return a.GetSize() == b.GetSize();
+					}
+
+					inline bool SameShape(ScalarMatrix const& a, ScalarMatrix const& b) {
+						return a.GetRows() == b.GetRows() && a.GetColumns() == b.GetColumns();
+					}
+
+					template <class Kernel>
+					Value Float(Value const& lhs, Value const& rhs, CallContext&) {
+						return Arithmetic::ApplyKernel<Kernel>(lhs, rhs);
+					}
+
+					/*
+						Any mix of floats and exact numbers, exact ones are rounded to the other side's
+						tier and a real meeting a complex number becomes one
+					*/
+					template <class Kernel>
+					Value Mixed(Value const& lhs, Value const& rhs, CallContext&) {
+						Value a = lhs.IsExact() ? lhs.ToScalar(rhs.precision) : lhs;
+						Value b = rhs.IsExact() ? rhs.ToScalar(lhs.precision) : rhs;
+						if(a.type != b.type) {
+							if(a.type == TYPE::SCALAR)
+								a = Complexify(a);
+							else
+								b = Complexify(b);
+						}
+						return Arithmetic::ApplyKernel<Kernel>(a, b);
+					}
+
+					template <class Kernel>
+					Value Exact(Value const& lhs, Value const& rhs, CallContext& context) {
+						return Arithmetic::ApplyExact<Kernel>(lhs, rhs, context.pool);
+					}
+
+					template <class Kernel>
+					Value WithDual(Value const& lhs, Value const& rhs, CallContext& context) {
+						return Arithmetic::ApplyDual<Kernel>(lhs, rhs, context.precision, context.pool);
+					}
+
+					/*
+						Collection op real, the real is applied to every element
+					*/
+					template <class Kernel, class C>
+					Value EachLeft(Value const& lhs, Value const& rhs, CallContext& context) {
+						C result(*static_cast<C*>(lhs.object));
+						typename C::element_type* data = result.Data();
+						const mtfloat_t s = Element(rhs, context);
+						for(size_t i = 0; i < Count(result); i++)
+							Kernel::Scalar(data[i], s, data[i]);
+						return Value::MakeObject(context.pool.Make<C>(std::move(result)));
+					}
+
+					/*
+						Real op collection
+					*/
+					template <class Kernel, class C>
+					Value EachRight(Value const& lhs, Value const& rhs, CallContext& context) {
+						C result(*static_cast<C*>(rhs.object));
+						typename C::element_type* data = result.Data();
+						const mtfloat_t s = Element(lhs, context);
+						for(size_t i = 0; i < Count(result); i++)
+							Kernel::Scalar(s, data[i], data[i]);
+						return Value::MakeObject(context.pool.Make<C>(std::move(result)));
+					}
+
+					/*
+						Two collections of the same shape, element by element
+					*/
+					template <class Kernel, class C>
+					Value Elementwise(Value const& lhs, Value const& rhs, CallContext& context) {
+						C const& b = *static_cast<C*>(rhs.object);
+						if(!SameShape(*static_cast<C*>(lhs.object), b)) {
+							std::cerr << "Error: The operands are of different sizes" << std::endl;
+							return Value();
+						}
+						C result(*static_cast<C*>(lhs.object));
+						typename C::element_type* data = result.Data();
+						const typename C::element_type* other = b.Data();
+						for(size_t i = 0; i < Count(result); i++)
+							Kernel::Scalar(data[i], other[i], data[i]);
+						return Value::MakeObject(context.pool.Make<C>(std::move(result)));
+					}
+
+					Value MatrixProduct(Value const& lhs, Value const& rhs, CallContext& context) {
+						try {
+							ScalarMatrix product = (*static_cast<ScalarMatrix*>(lhs.object)) * (*static_cast<ScalarMatrix*>(rhs.object));
+							return Value::MakeObject(context.pool.Make<ScalarMatrix>(std::move(product)));
+						} catch(std::exception& ex) {
+							std::cerr << "Error: " << ex.what() << std::endl;
+							return Value();
+						}
+					}
+
+					constexpr bool IsReal(TYPE t) {
+						return t == TYPE::SCALAR || t == TYPE::INTEGER || t == TYPE::RATIONAL;
+					}
+
+					constexpr bool IsExact(TYPE t) {
+						return t == TYPE::INTEGER || t == TYPE::RATIONAL;
+					}
+
+					constexpr bool IsNumber(TYPE t) {
+						return IsReal(t) || t == TYPE::COMPLEX;
+					}
+
+					/*
+						The handler for the operator and a pair of operand types, nullptr if they do not
+						combine. Evaluated by the compiler for every slot of the table.
+					*/
+					template <class Kernel>
+					constexpr handler_t Slot(OPERATOR op, TYPE a, TYPE b) {
+						return (a == b && (a == TYPE::SCALAR || a == TYPE::COMPLEX)) ? &Float<Kernel>
+							: (IsExact(a) && IsExact(b)) ? &Exact<Kernel>
+							: (IsNumber(a) && IsNumber(b)) ? &Mixed<Kernel>
+							: ((a == TYPE::DUAL && (b == TYPE::DUAL || IsReal(b))) || (IsReal(a) && b == TYPE::DUAL)) ? &WithDual<Kernel>
+							: (a == TYPE::LIST && b == TYPE::LIST) ? &Elementwise<Kernel, ScalarList>
+							: (a == TYPE::LIST && IsReal(b)) ? &EachLeft<Kernel, ScalarList>
+							: (IsReal(a) && b == TYPE::LIST) ? &EachRight<Kernel, ScalarList>
+							: (a == TYPE::MATRIX && IsReal(b)) ? &EachLeft<Kernel, ScalarMatrix>
+							: (IsReal(a) && b == TYPE::MATRIX) ? &EachRight<Kernel, ScalarMatrix>
+							// Matrices add element by element but multiply as matrices, there is no matrix division
+							: (a == TYPE::MATRIX && b == TYPE::MATRIX && (op == ADD || op == SUBTRACT)) ? &Elementwise<Kernel, ScalarMatrix>
+							: (a == TYPE::MATRIX && b == TYPE::MATRIX && op == MULTIPLY) ? &MatrixProduct
+							: nullptr;
+					}
+				}
+
+				static_assert(TYPES == 10, "Every Mt::core::TYPE needs a row and a column in the table");
+#define MT_DISPATCH_ROW(kernel, op, a) { \
+					Slot<kernel>(op, a, TYPE::SCALAR), Slot<kernel>(op, a, TYPE::COMPLEX), Slot<kernel>(op, a, TYPE::LIST), \
+					Slot<kernel>(op, a, TYPE::SET), Slot<kernel>(op, a, TYPE::MATRIX), Slot<kernel>(op, a, TYPE::NONE), \
+					Slot<kernel>(op, a, TYPE::INTEGER), Slot<kernel>(op, a, TYPE::RATIONAL), Slot<kernel>(op, a, TYPE::FUNCTION), \
+					Slot<kernel>(op, a, TYPE::DUAL) }
+#define MT_DISPATCH_OPERATOR(kernel, op) { \
+					MT_DISPATCH_ROW(kernel, op, TYPE::SCALAR), MT_DISPATCH_ROW(kernel, op, TYPE::COMPLEX), MT_DISPATCH_ROW(kernel, op, TYPE::LIST), \
+					MT_DISPATCH_ROW(kernel, op, TYPE::SET), MT_DISPATCH_ROW(kernel, op, TYPE::MATRIX), MT_DISPATCH_ROW(kernel, op, TYPE::NONE), \
+					MT_DISPATCH_ROW(kernel, op, TYPE::INTEGER), MT_DISPATCH_ROW(kernel, op, TYPE::RATIONAL), MT_DISPATCH_ROW(kernel, op, TYPE::FUNCTION), \
+					MT_DISPATCH_ROW(kernel, op, TYPE::DUAL) }
+				// A constant initializer, so the table is in the binary as it is and nothing fills it at startup
+				handler_t table[OPERATORS][TYPES][TYPES] = {
+					MT_DISPATCH_OPERATOR(Arithmetic::AddKernel, ADD),
+					MT_DISPATCH_OPERATOR(Arithmetic::MinusKernel, SUBTRACT),
+					MT_DISPATCH_OPERATOR(Arithmetic::MultiplyKernel, MULTIPLY),
+					MT_DISPATCH_OPERATOR(Arithmetic::DivideKernel, DIVIDE),
+				};
+#undef MT_DISPATCH_OPERATOR
+#undef MT_DISPATCH_ROW
+
+				void Register(OPERATOR op, TYPE lhs, TYPE rhs, handler_t handler) {
+					table[op][lhs][rhs] = handler;
+				}
+
+				const char* Name(OPERATOR op) {
+					return NAMES[op];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,84 @@
+/*
+	Dual.cc - Dual numbers for forward mode automatic differentiation
+*/
+#include "core/symbolic/Dual.hh"
+
+namespace Mt {
+	namespace core {
+		namespace symbolic {
+			Dual::Dual(long double v) : Mt::core::INumeric(), value(v) {
+				this->DerivedType = TYPE::DUAL;
+				for(size_t i = 0; i < MAX_DIRECTIONS; i++)
+					this->tangent[i] = 0.0;
+			}
+
+			Dual::Dual(long double v, size_t direction) : Dual(v) {
+				this->tangent[direction] = 1.0;
+			}
+
+			Dual::Dual(Dual const& other) : Mt::core::INumeric(), value(other.value) {
+				this->DerivedType = TYPE::DUAL;
+				for(size_t i = 0; i < MAX_DIRECTIONS; i++)
+					this->tangent[i] = other.tangent[i];
+			}
+
+			Dual::~Dual(void) {
+
+			}
+
+			Dual& Dual::operator=(Dual const& rhs) {
+				this->value = rhs.value;
+				for(size_t i = 0; i < MAX_DIRECTIONS; i++)
+					this->tangent[i] = rhs.tangent[i];
+				return *this;
+			}
+
+			Dual Dual::Chain(long double f, long double df) const {
+				Dual r(f);
+				const double scale = static_cast<double>(df);
+				for(size_t i = 0; i < MAX_DIRECTIONS; i++)
+					r.tangent[i] = scale * this->tangent[i];
+				return r;
+			}
+
+			bool Dual::IsConstant(void) const {
+				bool constant = true;
+				for(size_t i = 0; i < MAX_DIRECTIONS; i++)
+					constant = constant && (this->tangent[i] == 0.0);
+				return constant;
+			}
+
+			Dual operator+(Dual const& a, Dual const& b) {
+				Dual r(a.value + b.value);
+				for(size_t i = 0; i < Dual::MAX_DIRECTIONS; i++)
+					r.tangent[i] = a.tangent[i] + b.tangent[i];
+				return r;
+			}
+
+			Dual operator-(Dual const& a, Dual const& b) {
+				Dual r(a.value - b.value);
+				for(size_t i = 0; i < Dual::MAX_DIRECTIONS; i++)
+					r.tangent[i] = a.tangent[i] - b.tangent[i];
+				return r;
+			}
+
+			// (ab)' = a'b + ab'
+			Dual operator*(Dual const& a, Dual const& b) {
+				Dual r(a.value * b.value);
+				const double x = static_cast<double>(a.value), y = static_cast<double>(b.value);
+				for(size_t i = 0; i < Dual::MAX_DIRECTIONS; i++)
+					r.tangent[i] = (a.tangent[i] * y) + (x * b.tangent[i]);
+				return r;
+			}
+
+			// (a/b)' = (a' - (a/b)b') / b
+			Dual operator/(Dual const& a, Dual const& b) {
+				Dual r(a.value / b.value);
+				const double q = static_cast<double>(r.value), y = static_cast<double>(b.value);
+				for(size_t i = 0; i < Dual::MAX_DIRECTIONS; i++)
+					r.tangent[i] = (a.tangent[i] - (q * b.tangent[i])) / y;
+				return r;
+			}
+		}
+	}
+}
@@ -3,11 +3,212 @@
 */
 #include "core/lang/EvaluationEngine.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <streambuf>
+#include <utility>
+
+#include <pthread.h>
+
+#include "core/Config.hh"
+#include "core/NumberFormatter.hh"
+#include "core/WorkerPool.hh"
+#include "core/lang/Arithmetic.hh"
+#include "objects/Integer.hh"
+#include "objects/Rational.hh"
 
 namespace Mt {
 	namespace core {
 		namespace lang {
-			EvaluationEngine::EvaluationEngine(void) : debug_evaluation(false) {
+			namespace {
+				/*
+					Reads a positive count from the configuration, warns and returns the default if the
+					setting is not one
+				*/
+				unsigned long long CountSetting(const char* name, unsigned long long fallback) {
+					if(!Mt::core::Config::GetInstance()->CfgHasValue(name))
+						return fallback;
+					std::string value = Mt::core::Config::GetInstance()->GetCfgValue(name);
+					char* end = nullptr;
+					unsigned long long count = std::strtoull(value.c_str(), &end, 10);
+					if(value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' || count == 0) {
+						std::cerr << "Warning: Unknown " << name << " \"" << value << "\", using " << fallback << std::endl;
+						return fallback;
+					}
+					return count;
+				}
+
+				// Stack assumed when the thread's can not be asked for, what a secondary thread gets on macOS
+				const size_t DEFAULT_STACK_SIZE = 512 * 1024;
+
+				/*
+					How much of the calling thread's stack calls that nest on it may use. Half of it, the
+					builtins and whatever runs below the outermost call need the rest.
+				*/
+				size_t StackBudget(void) {
+					size_t size = 0;
+#if defined(__linux__)
+					pthread_attr_t attr;
+					if(pthread_getattr_np(pthread_self(), &attr) == 0) {
+						pthread_attr_getstacksize(&attr, &size);
+						pthread_attr_destroy(&attr);
+					}
+#elif defined(__APPLE__)
+					size = pthread_get_stacksize_np(pthread_self());
+#endif
+					return ((size != 0) ? size : DEFAULT_STACK_SIZE) / 2;
+				}
+
+				/*
+					Fast path of the bytecode machine. Two scalars of the same tier are combined in place,
+					a scalar and an inline integer go through the kernel with the integer rounded to the
+					scalar's tier as the dispatch table would. Returns false for anything else, which goes
+					through the dispatch table.
+				*/
+				template <class Kernel>
+				inline bool ApplyScalar(Value const& lhs, Value const& rhs, Value& result) {
+					if(lhs.type == Mt::core::TYPE::SCALAR && rhs.type == Mt::core::TYPE::SCALAR && lhs.precision == rhs.precision) {
+						// The kernel takes its operands by value, result may be either of them
+						switch(lhs.precision) {
+							case PRECISION::DOUBLE:
+								Kernel::Scalar(lhs.d[0], rhs.d[0], result.d[0]);
+								break;
+							case PRECISION::EXTENDED:
+								Kernel::Scalar(lhs.e[0], rhs.e[0], result.e[0]);
+								break;
+							default:
+								Kernel::Scalar(lhs.q[0], rhs.q[0], result.q[0]);
+								break;
+						}
+						result.type = Mt::core::TYPE::SCALAR;
+						result.precision = lhs.precision;
+						result.big = false;
+						return true;
+					}
+					if(lhs.type == Mt::core::TYPE::SCALAR) {
+						if(rhs.type == Mt::core::TYPE::SCALAR)
+							result = Arithmetic::ApplyKernel<Kernel>(lhs, rhs);
+						else if(rhs.type == Mt::core::TYPE::INTEGER && !rhs.big)
+							result = Arithmetic::ApplyKernel<Kernel>(lhs, rhs.ToScalar(lhs.precision));
+						else
+							return false;
+						return true;
+					}
+					if(rhs.type == Mt::core::TYPE::SCALAR && lhs.type == Mt::core::TYPE::INTEGER && !lhs.big) {
+						result = Arithmetic::ApplyKernel<Kernel>(lhs.ToScalar(rhs.precision), rhs);
+						return true;
+					}
+					return false;
+				}
+
+				/*
+					What a statement printed while it was evaluated side by side with others, each chunk
+					tagged with whether it went to std::cerr
+				*/
+				typedef std::vector<std::pair<bool, std::string>> Output;
+				// Output of the statement the thread is evaluating, nullptr if it is not evaluating one
+				thread_local Output* redirected = nullptr;
+
+				/*! \class Capture
+					\brief Takes the place of a standard stream's buffer while statements run side by side
+
+					Threads evaluating a statement write into its Output, anything else goes straight
+					through to the buffer it replaced. The stream gets its buffer back when this goes.
+				*/
+				class Capture : public std::streambuf {
+				private:
+					std::ostream& stream;
+					std::streambuf* original;
+					const bool error;
+				protected:
+					std::streamsize xsputn(const char* s, std::streamsize n) override {
+						if(redirected == nullptr)
+							return this->original->sputn(s, n);
+						if(redirected->empty() || redirected->back().first != this->error)
+							redirected->emplace_back(this->error, std::string());
+						redirected->back().second.append(s, static_cast<size_t>(n));
+						return n;
+					}
+
+					int_type overflow(int_type c) override {
+						if(traits_type::eq_int_type(c, traits_type::eof()))
+							return traits_type::not_eof(c);
+						const char ch = traits_type::to_char_type(c);
+						return (this->xsputn(&ch, 1) == 1) ? c : traits_type::eof();
+					}
+
+					int sync(void) override {
+						return (redirected == nullptr) ? this->original->pubsync() : 0;
+					}
+				public:
+					Capture(std::ostream& s, bool err) : stream(s), original(s.rdbuf()), error(err) {
+						this->stream.rdbuf(this);
+					}
+
+					~Capture(void) {
+						this->stream.rdbuf(this->original);
+					}
+				};
+			}
+
+			EvaluationEngine::EvaluationEngine(void) : debug_evaluation(false), precision(PRECISION::EXTENDED), evaluation_depth(0), call_depth(0), stack_base(nullptr), globals(nullptr), bytecode(true),
+				memoize(false), memo_size(CFG_DEF_MEMO_SIZE), memoizing(false), native(false), native_threshold(CFG_DEF_NATIVE_THRESHOLD), reactive(DependencyGraph::OFF), parallel(false), frames(0) {
+				if(Mt::core::Config::GetInstance()->CfgHasValue("numeric_precision")) {
+					if(!Precision::FromString(Mt::core::Config::GetInstance()->GetCfgValue("numeric_precision"), this->precision))
+						std::cerr << "Warning: Unknown numeric_precision \"" << Mt::core::Config::GetInstance()->GetCfgValue("numeric_precision") << "\", using " << Precision::ToString(this->precision) << std::endl;
+				} else {
+					Precision::FromString(CFG_DEF_NUM_PRC, this->precision);
+				}
+				NumberFormatter::Style style;
+				std::string notation = Mt::core::Config::GetInstance()->CfgHasValue("numeric_notation") ? Mt::core::Config::GetInstance()->GetCfgValue("numeric_notation") : CFG_DEF_NUM_FMT;
+				if(!NumberFormatter::NotationFromString(notation, style.notation))
+					std::cerr << "Warning: Unknown numeric_notation \"" << notation << "\", using " << CFG_DEF_NUM_FMT << std::endl;
+				std::string align = Mt::core::Config::GetInstance()->CfgHasValue("numeric_align") ? Mt::core::Config::GetInstance()->GetCfgValue("numeric_align") : CFG_DEF_NUM_ALG;
+				if(!NumberFormatter::AlignmentFromString(align, style.alignment))
+					std::cerr << "Warning: Unknown numeric_align \"" << align << "\", using " << CFG_DEF_NUM_ALG << std::endl;
+				NumberFormatter::SetStyle(style);
+				std::string engine = Mt::core::Config::GetInstance()->CfgHasValue("evaluation_engine") ? Mt::core::Config::GetInstance()->GetCfgValue("evaluation_engine") : CFG_DEF_EVL_ENG;
+				if(engine == "tree")
+					this->bytecode = false;
+				else if(engine != "bytecode")
+					std::cerr << "Warning: Unknown evaluation_engine \"" << engine << "\", using " << CFG_DEF_EVL_ENG << std::endl;
+				this->max_depth = static_cast<size_t>(CountSetting("max_scope_depth", CFG_DEF_MAX_SCP_DEP));
+				std::string memo = Mt::core::Config::GetInstance()->CfgHasValue("memoize_sml") ? Mt::core::Config::GetInstance()->GetCfgValue("memoize_sml") : CFG_DEF_MEMO_SML;
+				if(memo == "yes")
+					this->SetMemoize(true);
+				else if(memo != "no")
+					std::cerr << "Warning: Unknown memoize_sml \"" << memo << "\", using " << CFG_DEF_MEMO_SML << std::endl;
+				this->memo_size = static_cast<size_t>(CountSetting("memo_size", CFG_DEF_MEMO_SIZE));
+				std::string native_sml = Mt::core::Config::GetInstance()->CfgHasValue("native_sml") ? Mt::core::Config::GetInstance()->GetCfgValue("native_sml") : CFG_DEF_NATIVE_SML;
+				if(native_sml == "yes")
+					this->native = true;
+				else if(native_sml != "no")
+					std::cerr << "Warning: Unknown native_sml \"" << native_sml << "\", using " << CFG_DEF_NATIVE_SML << std::endl;
+				this->native_threshold = CountSetting("native_threshold", CFG_DEF_NATIVE_THRESHOLD);
+				this->compiler = std::make_shared<Native::Compiler>(
+					Mt::core::Config::GetInstance()->CfgHasValue("native_compiler") ? Mt::core::Config::GetInstance()->GetCfgValue("native_compiler") : CFG_DEF_NATIVE_CXX,
+					Mt::core::Config::GetInstance()->CfgHasValue("native_dir") ? Mt::core::Config::GetInstance()->GetCfgValue("native_dir") : CFG_DEF_NATIVE_DIR);
+				std::string reactive_sml = Mt::core::Config::GetInstance()->CfgHasValue("reactive_sml") ? Mt::core::Config::GetInstance()->GetCfgValue("reactive_sml") : CFG_DEF_REACTIVE_SML;
+				if(reactive_sml == "yes")
+					this->reactive = DependencyGraph::ON;
+				else if(reactive_sml == "dry")
+					this->reactive = DependencyGraph::DRY;
+				else if(reactive_sml != "no")
+					std::cerr << "Warning: Unknown reactive_sml \"" << reactive_sml << "\", using " << CFG_DEF_REACTIVE_SML << std::endl;
+				std::string parallel_sml = Mt::core::Config::GetInstance()->CfgHasValue("parallel_sml") ? Mt::core::Config::GetInstance()->GetCfgValue("parallel_sml") : CFG_DEF_PARALLEL_SML;
+				if(parallel_sml == "yes")
+					this->parallel = true;
+				else if(parallel_sml != "no")
+					std::cerr << "Warning: Unknown parallel_sml \"" << parallel_sml << "\", using " << CFG_DEF_PARALLEL_SML << std::endl;
+			}
+
+			EvaluationEngine::EvaluationEngine(EvaluationEngine const* parent) : debug_evaluation(parent->debug_evaluation), precision(parent->precision),
+				evaluation_depth(0), call_depth(0), max_depth(parent->max_depth), stack_base(nullptr), globals(parent->globals),
+				bytecode(parent->bytecode), memoize(parent->memoize), memoized(parent->memoized), memo_size(parent->memo_size), memoizing(parent->memoizing),
+				native(parent->native), native_threshold(parent->native_threshold), compiler(parent->compiler), reactive(DependencyGraph::OFF), parallel(false), frames(0) {
 
 			}
 
@@ -19,6 +220,182 @@ namespace Mt {
 				this->debug_evaluation = !this->debug_evaluation;
 			}
 
+			void EvaluationEngine::SetPrecision(PRECISION p) {
+				this->precision = p;
+			}
+
+			PRECISION EvaluationEngine::GetPrecision(void) {
+				return this->precision;
+			}
+
+			void EvaluationEngine::SetBytecode(bool enabled) {
+				this->bytecode = enabled;
+			}
+
+			bool EvaluationEngine::GetBytecode(void) {
+				return this->bytecode;
+			}
+
+			void EvaluationEngine::SetMemoize(bool enabled) {
+				this->memoize = enabled;
+				this->memoizing = enabled;
+				for(auto const& setting : this->memoized)
+					this->memoizing = this->memoizing || setting.second;
+			}
+
+			void EvaluationEngine::SetMemoize(std::string const& function, bool enabled) {
+				this->memoized[Symbols::Intern(function)] = enabled;
+				this->SetMemoize(this->memoize);
+			}
+
+			void EvaluationEngine::SetMemoSize(size_t size) {
+				this->memo_size = size;
+				for(auto& memo : this->memos)
+					memo.second.SetCapacity(size);
+			}
+
+			void EvaluationEngine::ClearMemos(void) {
+				for(auto& memo : this->memos)
+					memo.second.Clear();
+			}
+
+			void EvaluationEngine::PrintMemoStatistics(void) {
+				std::cout << "Memoization: " << (this->memoize ? "on" : "off") << ", " << this->memo_size << " result(s) per function" << std::endl;
+				std::vector<std::pair<std::string, Memo const*>> caches;
+				for(auto const& memo : this->memos)
+					caches.emplace_back(memo.first->_id._name, &memo.second);
+				std::sort(caches.begin(), caches.end());
+				for(auto const& cache : caches) {
+					Memo const& memo = *cache.second;
+					const unsigned long long lookups = memo.GetHits() + memo.GetMisses();
+					std::cout << cache.first << ": " << memo.GetHits() << " hit(s), " << memo.GetMisses() << " miss(es), ";
+					if(lookups != 0) {
+						const unsigned long long permille = (1000 * memo.GetHits()) / lookups;
+						std::cout << (permille / 10) << '.' << (permille % 10) << "% hit rate, ";
+					}
+					std::cout << memo.GetSkipped() << " uncacheable, " << memo.Size() << " cached";
+					if(memo.purity == Memo::IMPURE)
+						std::cout << ", not pure";
+					std::cout << std::endl;
+				}
+			}
+
+			void EvaluationEngine::SetNative(bool enabled) {
+				this->native = enabled;
+			}
+
+			void EvaluationEngine::PrintNativeStatistics(void) {
+				std::cout << "Native compilation: " << (this->native ? "on" : "off") << ", after " << this->native_threshold << " call(s), "
+					<< this->compiler->GetLoaded() << " kernel(s) loaded, " << this->compiler->GetBuilt() << " built this session" << std::endl;
+				std::vector<std::pair<std::string, Profile const*>> hot;
+				for(auto const& profile : this->profiles)
+					hot.emplace_back(profile.first->_id._name, &profile.second);
+				std::sort(hot.begin(), hot.end());
+				for(auto const& function : hot) {
+					size_t kernels = 0;
+					for(auto const& kernel : function.second->kernels)
+						kernels += (kernel.second.entry != nullptr) ? 1 : 0;
+					std::cout << function.first << ": " << function.second->calls << " call(s), " << kernels << " native kernel(s)";
+					if(kernels != function.second->kernels.size())
+						std::cout << ", " << (function.second->kernels.size() - kernels) << " signature(s) interpreted";
+					std::cout << std::endl;
+				}
+			}
+
+			void EvaluationEngine::SetReactive(DependencyGraph::MODE mode) {
+				// Globals bound while it is off would be overwritten by the definitions they replaced
+				if(mode == DependencyGraph::OFF)
+					this->dependencies.Clear();
+				this->reactive = mode;
+			}
+
+			void EvaluationEngine::SetParallel(bool enabled) {
+				this->parallel = enabled;
+			}
+
+			bool EvaluationEngine::GetParallel(void) {
+				return this->parallel;
+			}
+
+			void EvaluationEngine::PrintReactive(void) {
+				static const char* const MODES[] = { "off", "on", "dry run" };
+				std::cout << "Reactive: " << MODES[this->reactive] << ", " << this->dependencies.Size() << " definition(s) recorded" << std::endl;
+			}
+
+			void EvaluationEngine::PrintDependents(std::string const& name) {
+				std::vector<Symbol> cyclic;
+				std::vector<Symbol> order = this->dependencies.Dependents(std::vector<Symbol>(1, Symbols::Intern(name)), cyclic);
+				if(order.empty() && cyclic.empty()) {
+					std::cout << "Nothing recorded reads " << name << std::endl;
+					return;
+				}
+				if(!order.empty()) {
+					std::cout << "Changing " << name << " would recompute";
+					for(size_t i = 0; i < order.size(); i++)
+						std::cout << ((i == 0) ? " " : ", ") << Symbols::Name(order[i]);
+					std::cout << std::endl;
+				}
+				for(Symbol symbol : cyclic)
+					std::cout << Symbols::Name(symbol) << " reads itself through other definitions and would be left as it is" << std::endl;
+			}
+
+			void EvaluationEngine::Propagate(NVariableDeclaration* definition, SymbolTable& GST, std::string const& input) {
+				std::vector<Symbol> roots;
+				roots.swap(this->changed);
+				std::sort(roots.begin(), roots.end());
+				roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+				for(Symbol symbol : roots) {
+					if(definition != nullptr && symbol == definition->_id._symbol)
+						this->dependencies.Define(definition, input, GST);
+					else
+						this->dependencies.Forget(symbol);
+				}
+				std::vector<Symbol> cyclic;
+				std::vector<Symbol> order = this->dependencies.Dependents(roots, cyclic);
+				for(Symbol symbol : cyclic)
+					std::cerr << "Warning: " << Symbols::Name(symbol) << " reads itself through other definitions, it was not recomputed" << std::endl;
+				if(order.empty())
+					return;
+				if(this->reactive == DependencyGraph::DRY) {
+					std::cout << "Would recompute";
+					for(size_t i = 0; i < order.size(); i++)
+						std::cout << ((i == 0) ? " " : ", ") << Symbols::Name(order[i]);
+					std::cout << std::endl;
+					return;
+				}
+				for(Symbol symbol : order) {
+					NVariableDeclaration* statement = this->dependencies.Statement(symbol);
+					Value res = this->ProcessExpression(statement->_assignmentExpr, GST);
+					// The error has been printed, the global keeps its value
+					if(res.IsNone())
+						continue;
+					GST.Bind(symbol, this->Persist(symbol, res));
+					this->GlobalsChanged();
+					// The functions it calls may have changed, and with them what it reads
+					this->dependencies.Define(statement, this->dependencies.Input(symbol), GST);
+					this->PrintResult(res, this->dependencies.Input(symbol));
+				}
+				this->changed.clear();
+			}
+
+			Memo* EvaluationEngine::MemoFor(Function const& fn) {
+				auto setting = this->memoized.find(fn.declaration._id._symbol);
+				if(!(setting != this->memoized.end() ? setting->second : this->memoize) || this->globals == nullptr)
+					return nullptr;
+				auto it = this->memos.find(&fn.declaration);
+				if(it == this->memos.end())
+					it = this->memos.emplace(&fn.declaration, Memo(this->memo_size)).first;
+				Memo& memo = it->second;
+				// Purity depends on the functions the body calls, which only change along with the globals
+				if(memo.purity == Memo::UNKNOWN)
+					memo.purity = Memo::Pure(fn.declaration, *this->globals) ? Memo::PURE : Memo::IMPURE;
+				return (memo.purity == Memo::PURE) ? &memo : nullptr;
+			}
+
+			void EvaluationEngine::GlobalsChanged(void) {
+				this->ClearMemos();
+			}
+
 			std::string EvaluationEngine::GetNameFromMagik(MAGIK m) {
 				switch(m) {
 					case _NROOT:
@@ -49,6 +426,10 @@ namespace Mt {
 						return "NFunctionDeclaration";
 					case _NLISTDECLARATION:
 						return "NListDeclaration";
+					case _NINTEGER:
+						return "NInteger";
+					case _NRETURNSTATEMENT:
+						return "NReturnStatement";
 					default:
 						return "<<UNKNOWN>>";
 				}
@@ -101,195 +482,780 @@ namespace Mt {
 				}
 			}
 
-			Mt::core::IMtObject* EvaluationEngine::ProcessExpression(NExpression* expr, std::map<std::string, Mt::core::IMtObject>& GST) {
+			Value EvaluationEngine::ProcessExpression(NExpression* expr, SymbolTable& GST) {
+				// The MAGIK tag already tells us what the node is, so static_cast is enough here
 				switch(expr->type) {
 					case _NBLOCK: {
-						auto blk = dynamic_cast<NBlock*>(expr);
+						auto blk = static_cast<NBlock*>(expr);
 						this->Evaluate(blk, GST);
 						break;
 					} case _NBINARYOPERATOR: {
-						auto nbin = dynamic_cast<NBinaryOperator*>(expr);
+						auto nbin = static_cast<NBinaryOperator*>(expr);
 						if(this->debug_evaluation)
 							std::cout << "Binary Operation at " << nbin << " has operator of " << this->GetTokenName(static_cast<yy::SMLParser::token_type>(nbin->_op)) << std::endl;
-						auto lhs = this->ProcessExpression(&(nbin->_lhs), GST);
-						auto rhs = this->ProcessExpression(&(nbin->_rhs), GST);
-						return this->DoBinaryOperation(rhs, lhs, static_cast<yy::SMLParser::token_type>(nbin->_op), GST);
+						Value lhs = this->ProcessExpression(nbin->_lhs, GST);
+						Value rhs = this->ProcessExpression(nbin->_rhs, GST);
+						return this->DoBinaryOperation(lhs, rhs, static_cast<yy::SMLParser::token_type>(nbin->_op), GST);
 					} case _NMETHODCALL: {
-						break;
+						auto ncall = static_cast<NMethodCall*>(expr);
+						const Builtin* fn = ncall->_builtin;
+						size_t count = ncall->_arguments.size();
+						if(fn == nullptr) {
+							// Not a builtin, so it has to be a function bound to a symbol
+							Value const* sym = this->Lookup(ncall->_id._symbol, GST);
+							if(sym == nullptr || sym->type != TYPE::FUNCTION) {
+								std::cerr << "Error: Unknown function \"" << ncall->_id._name << "\"" << std::endl;
+								break;
+							}
+							Value callee = *sym;
+							std::vector<Value> args(count);
+							for(size_t i = 0; i < count; i++) {
+								args[i] = this->ProcessExpression(ncall->_arguments[i], GST);
+								if(args[i].IsNone())
+									return Value();
+							}
+							if(this->debug_evaluation)
+								std::cout << "Expression at " << expr << " is a call to function " << ncall->_id._name << " with " << count << " argument(s)" << std::endl;
+							return this->CallFunction(*static_cast<Function*>(callee.object), args.data(), count);
+						}
+						if(count < fn->minArity || count > fn->maxArity) {
+							std::cerr << "Error: " << fn->name << " takes " << static_cast<int>(fn->minArity);
+							if(fn->maxArity != fn->minArity)
+								std::cerr << " to " << static_cast<int>(fn->maxArity);
+							std::cerr << " argument(s), got " << count << std::endl;
+							break;
+						}
+						if(this->debug_evaluation)
+							std::cout << "Expression at " << expr << " is a call to builtin " << fn->name << " with " << count << " argument(s)" << std::endl;
+						Value args[Builtins::MAX_ARITY];
+						for(size_t i = 0; i < count; i++) {
+							args[i] = this->ProcessExpression(ncall->_arguments[i], GST);
+							if(args[i].IsNone())
+								return Value();
+							if(!Builtins::Accepts(fn->signature[i], args[i])) {
+								std::cerr << "Error: Argument " << (i + 1) << " of " << fn->name << " has an unsupported type" << std::endl;
+								return Value();
+							}
+						}
+						CallContext context(this->temporaries, this->precision, this);
+						return fn->function(args, count, context);
+					} case _NASSIGNMENT: {
+						auto nasgn = static_cast<NAssignment*>(expr);
+						Value res = this->ProcessExpression(nasgn->_rhs, GST);
+						if(!res.IsNone())
+							this->Bind(nasgn->_lhs._symbol, res, GST);
+						return res;
 					} case _NIDENTIFIER: {
+						auto nident = static_cast<NIdentifier*>(expr);
 						if(this->debug_evaluation)
-					  		std::cout << "Expression at " << expr << " is a NIdentifier with value \"" << dynamic_cast<NIdentifier*>(expr)->_name << "\"" << std::endl;
-						break;
+							std::cout << "Expression at " << expr << " is a NIdentifier with value \"" << nident->_name << "\"" << std::endl;
+						Value const* sym = this->Lookup(nident->_symbol, GST);
+						if(sym == nullptr) {
+							std::cerr << "Error: Unknown identifier \"" << nident->_name << "\"" << std::endl;
+							break;
+						}
+						return *sym;
 					} case _NCOMPLEX: {
+						auto ncplx = static_cast<NComplex*>(expr);
+						if(this->debug_evaluation)
+							std::cout << "Expression at " << expr << " is a NComplex with value " << ncplx->_c << std::endl;
+						// Literals are already correctly rounded for every tier, take the session's one
+						switch(this->precision) {
+							case PRECISION::DOUBLE:
+								return Value::MakeComplex(ncplx->_d[0], ncplx->_d[1]);
+							case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+								return Value::MakeComplex(ncplx->_q[0], ncplx->_q[1]);
+#endif
+							default:
+								return Value::MakeComplex(ncplx->_e[0], ncplx->_e[1]);
+						}
+					} case _NINTEGER: {
+						auto nint = static_cast<NInteger*>(expr);
 						if(this->debug_evaluation)
-					  		std::cout << "Expression at " << expr << " is a NComplex with value " << dynamic_cast<NComplex*>(expr)->_c << std::endl;
-						return &(dynamic_cast<NComplex*>(expr)->_c);
+							std::cout << "Expression at " << expr << " is a NInteger with value " << nint->_i << std::endl;
+						return Value::FromInteger(nint->_i, this->temporaries);
 					} case _NSCALAR: {
-					  	if(this->debug_evaluation)
-					  		std::cout << "Expression at " << expr << " is a NScalar with value " << dynamic_cast<NScalar*>(expr)->_s << std::endl;
-					  	return &(dynamic_cast<NScalar*>(expr)->_s);
-					}
+						auto nsclr = static_cast<NScalar*>(expr);
+						if(this->debug_evaluation)
+							std::cout << "Expression at " << expr << " is a NScalar with value " << nsclr->_s << std::endl;
+						switch(this->precision) {
+							case PRECISION::DOUBLE:
+								return Value::MakeScalar(nsclr->_d);
+							case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+								return Value::MakeScalar(nsclr->_q);
+#endif
+							default:
+								return Value::MakeScalar(nsclr->_e);
+						}
+					} default:
+						break;
 				}
-				return nullptr;
+				return Value();
 			}
 
-			Mt::core::IMtObject* EvaluationEngine::DoBinaryOperation(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs, yy::SMLParser::token_type oper, std::map<std::string, Mt::core::IMtObject>& GST) {
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+			Value EvaluationEngine::DoBinaryOperation(Value const& lhs, Value const& rhs, yy::SMLParser::token_type oper, SymbolTable& GST) {
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+				// Propagate errors from either side without complaining twice
+				if(lhs.IsNone() || rhs.IsNone())
+					return Value();
 				switch(oper) {
 					case yy::SMLParser::token_type::TPLUS: {
 						if(this->debug_evaluation)
 							std::cout << "NBinaryOperation is addition." << std::endl;
-						return this->BinaryAdd(lhs, rhs);
+						return this->Binary(Dispatch::ADD, lhs, rhs);
 					}
 					case yy::SMLParser::token_type::TMINUS: {
 						if(this->debug_evaluation)
 							std::cout << "NBinaryOperation is subtraction." << std::endl;
-						return this->BinaryMinus(lhs, rhs);
+						return this->Binary(Dispatch::SUBTRACT, lhs, rhs);
 					}
 					case yy::SMLParser::token_type::TMUL: {
 						if(this->debug_evaluation)
 							std::cout << "NBinaryOperation is multiplication." << std::endl;
-						return this->BinaryMultiply(lhs, rhs);
+						return this->Binary(Dispatch::MULTIPLY, lhs, rhs);
 					}
 					case yy::SMLParser::token_type::TDIV: {
 						if(this->debug_evaluation)
 							std::cout << "NBinaryOperation is division." << std::endl;
-						return this->BinaryDivied(lhs, rhs);
+						return this->Binary(Dispatch::DIVIDE, lhs, rhs);
+					}
+					case yy::SMLParser::token_type::TPOW: {
+						if(this->debug_evaluation)
+							std::cout << "NBinaryOperation is exponentiation." << std::endl;
+						return this->BinaryPower(lhs, rhs);
 					}
+					default:
+						std::cerr << "Error: Unsupported operator " << this->GetTokenName(oper) << std::endl;
+						break;
 				}
-				return nullptr;
+				return Value();
 			}
 
-			Mt::core::IMtObject* EvaluationEngine::BinaryAdd(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs) {
-				switch(lhs->DerivedType) {
-					case Mt::core::TYPE::SCALAR: {
-						auto _lhs = dynamic_cast<Mt::objects::Scalar*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Scalar*>(rhs);
-						auto retval = new Mt::objects::Scalar((*_lhs)+(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Addition result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::COMPLEX: {
-						auto _lhs = dynamic_cast<Mt::objects::Complex*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Complex*>(rhs);
-						auto retval = new Mt::objects::Complex((*_lhs)+(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Addition result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::MATRIX: {
-
-					} case Mt::core::TYPE::SET: {
+			Value EvaluationEngine::Binary(Dispatch::OPERATOR op, Value const& lhs, Value const& rhs) {
+				Dispatch::handler_t handler = Dispatch::Find(op, lhs.type, rhs.type);
+				if(handler == nullptr) {
+					if(lhs.type == rhs.type)
+						std::cerr << "Error: The " << Dispatch::Name(op) << " of this type is not supported" << std::endl;
+					else
+						std::cerr << "Error: Type mismatch in " << Dispatch::Name(op) << std::endl;
+					return Value();
+				}
+				// Floats divide by zero as IEEE says, everything else can not
+				if(op == Dispatch::DIVIDE && rhs.IsExactZero() && !lhs.IsFloat()) {
+					std::cerr << "Error: Division by zero" << std::endl;
+					return Value();
+				}
+				CallContext context(this->temporaries, this->precision, this);
+				Value retval = handler(lhs, rhs, context);
+				if(this->debug_evaluation)
+					std::cout << "Result of the " << Dispatch::Name(op) << ": " << retval << " (" << Precision::ToString(retval.precision) << ")" << std::endl;
+				return retval;
+			}
 
-					} case Mt::core::TYPE::LIST: {
-						break;
+			Value EvaluationEngine::BinaryPower(Value const& lhs, Value const& rhs) {
+				// a ^ b means pow(a, b), the builtin already knows every type that can be raised
+				static const Builtin* pow = Builtins::Find("pow");
+				Value args[2] = { lhs, rhs };
+				for(size_t i = 0; i < 2; i++) {
+					if(!Builtins::Accepts(pow->signature[i], args[i])) {
+						std::cerr << "Error: The exponentiation of this type is not supported" << std::endl;
+						return Value();
 					}
 				}
-				return nullptr;
+				CallContext context(this->temporaries, this->precision, this);
+				Value retval = pow->function(args, 2, context);
+				if(this->debug_evaluation)
+					std::cout << "Exponentiation result: " << retval << " (" << Precision::ToString(retval.precision) << ")" << std::endl;
+				return retval;
 			}
 
-			Mt::core::IMtObject* EvaluationEngine::BinaryMinus(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs) {
-				switch(lhs->DerivedType) {
-					case Mt::core::TYPE::SCALAR: {
-						auto _lhs = dynamic_cast<Mt::objects::Scalar*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Scalar*>(rhs);
-						auto retval = new Mt::objects::Scalar((*_lhs)-(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Subtraction result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::COMPLEX: {
-						auto _lhs = dynamic_cast<Mt::objects::Complex*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Complex*>(rhs);
-						auto retval = new Mt::objects::Complex((*_lhs)-(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Subtraction result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::MATRIX: {
+			Value const* EvaluationEngine::Lookup(Symbol symbol, SymbolTable& GST) {
+				Value const* sym = GST.Find(symbol);
+				if(sym != nullptr || this->globals == nullptr || this->globals == &GST)
+					return sym;
+				return this->globals->Find(symbol);
+			}
 
-					} case Mt::core::TYPE::SET: {
+			void EvaluationEngine::Bind(Symbol symbol, Value const& val, SymbolTable& GST) {
+				// Locals only live as long as the call, what they reference lives in the temporaries
+				if(this->call_depth != 0) {
+					GST.Bind(symbol, val);
+					return;
+				}
+				GST.Bind(symbol, this->Persist(symbol, val));
+				this->GlobalsChanged();
+				if(this->reactive != DependencyGraph::OFF)
+					this->changed.push_back(symbol);
+			}
 
-					} case Mt::core::TYPE::LIST: {
-						break;
+			void EvaluationEngine::DefineFunction(NFunctionDeclaration const& decl, SymbolTable& GST) {
+				if(Builtins::Find(decl._id._name) != nullptr) {
+					std::cerr << "Error: \"" << decl._id._name << "\" is a builtin function" << std::endl;
+					return;
+				}
+				if(this->debug_evaluation)
+					std::cout << "NFunctionDeclaration with Identifier of \"" << decl._id._name << "\" and " << decl._arguments.size() << " parameter(s)" << std::endl;
+				Function* function = this->temporaries.Make<Function>(decl);
+				if(this->debug_evaluation) {
+					Function const& fn = *function;
+					if(fn.program) {
+						std::string listing;
+						fn.program->Format(listing);
+						std::cout << fn.GetName() << " compiled to " << fn.program->code.size() << " instruction(s) over " << fn.program->registers << " register(s)" << std::endl << listing;
+					} else {
+						std::cout << fn.GetName() << " runs on the tree walker" << std::endl;
 					}
 				}
-				return nullptr;
-			}	
+				this->Bind(decl._id._symbol, Value::MakeObject(function), GST);
+			}
 
-			Mt::core::IMtObject* EvaluationEngine::BinaryMultiply(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs) {
-				switch(lhs->DerivedType) {
-					case Mt::core::TYPE::SCALAR: {
-						auto _lhs = dynamic_cast<Mt::objects::Scalar*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Scalar*>(rhs);
-						auto retval = new Mt::objects::Scalar((*_lhs)*(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Multiplication result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::COMPLEX: {
-						auto _lhs = dynamic_cast<Mt::objects::Complex*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Complex*>(rhs);
-						auto retval = new Mt::objects::Complex((*_lhs)*(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Multiplication result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::MATRIX: {
+			Value EvaluationEngine::CallFunction(Function const& fn, Value const* args, size_t count) {
+				if(count != fn.GetArity()) {
+					std::cerr << "Error: " << fn.GetName() << " takes " << fn.GetArity() << " argument(s), got " << count << std::endl;
+					return Value();
+				}
+				if(this->call_depth >= this->max_depth) {
+					std::cerr << "Error: Calls nested deeper than " << this->max_depth << " in " << fn.GetName() << std::endl;
+					return Value();
+				}
+				// Walked bodies and builtins calling back into SML nest on the C++ stack, which may run out before max_scope_depth
+				static thread_local const size_t budget = StackBudget();
+				const char here = 0;
+				const bool outermost = (this->stack_base == nullptr);
+				if(outermost) {
+					this->stack_base = &here;
+				} else {
+					const uintptr_t a = reinterpret_cast<uintptr_t>(this->stack_base);
+					const uintptr_t b = reinterpret_cast<uintptr_t>(&here);
+					if(((a > b) ? a - b : b - a) > budget) {
+						std::cerr << "Error: Calls nested deeper than the stack allows in " << fn.GetName() << std::endl;
+						return Value();
+					}
+				}
+				Memo* memo = this->memoizing ? this->MemoFor(fn) : nullptr;
+				Value result;
+				if(memo == nullptr || !memo->Find(args, count, result)) {
+					result = this->Invoke(fn, args, count);
+					if(memo != nullptr && !result.IsNone())
+						memo->Store(args, count, result);
+				}
+				if(outermost)
+					this->stack_base = nullptr;
+				return result;
+			}
 
-					} case Mt::core::TYPE::SET: {
+			bool EvaluationEngine::CallNative(Function const& fn, Value const* args, size_t count, Value& result) {
+				// Kernels are translated from the bytecode
+				if(!fn.program)
+					return false;
+				Profile& profile = this->profiles[&fn.declaration];
+				uint64_t signature;
+				if(++profile.calls < this->native_threshold || !Native::Signature(args, count, this->precision, signature))
+					return false;
+				auto it = std::find_if(profile.kernels.begin(), profile.kernels.end(), [signature](std::pair<uint64_t, Native::Kernel> const& kernel) {
+					return kernel.first == signature;
+				});
+				if(it == profile.kernels.end()) {
+					profile.kernels.emplace_back(signature, this->compiler->Compile(*fn.program, fn.GetName(), count, signature));
+					it = profile.kernels.end() - 1;
+				}
+				if(it->second.entry == nullptr)
+					return false;
+				result = it->second.Run(args, count);
+				return true;
+			}
 
-					} case Mt::core::TYPE::LIST: {
-						break;
+			Value EvaluationEngine::Invoke(Function const& fn, Value const* args, size_t count) {
+				// Traces come from the walker, so debugging always takes that path
+				Value compiled;
+				if(this->native && !this->debug_evaluation && this->CallNative(fn, args, count, compiled))
+					return compiled;
+				if(fn.program && this->bytecode && !this->debug_evaluation)
+					return this->Execute(fn, args, count);
+				// Whatever the call allocates is released when it returns, except what it returns
+				const ObjectPool::Mark mark = this->temporaries.GetMark();
+				SymbolTable locals;
+				for(size_t i = 0; i < count; i++)
+					locals.Bind(fn.declaration._arguments[i]->_id._symbol, args[i]);
+				this->call_depth++;
+				Value result;
+				bool returned = false;
+				for(auto statement : fn.declaration._block.statements) {
+					switch(statement->type) {
+						case _NVARIABLEDECLARATION: {
+							// A lone identifier parses as a declaration without a value, it is just a read
+							auto vardec = static_cast<NVariableDeclaration*>(statement);
+							if(vardec->_assignmentExpr == nullptr) {
+								result = this->ProcessExpression(&(vardec->_id), locals);
+							} else {
+								result = this->ProcessExpression(vardec->_assignmentExpr, locals);
+								if(!result.IsNone())
+									this->Bind(vardec->_id._symbol, result, locals);
+							}
+							break;
+						} case _NEXPRESSIONSTATEMENT: {
+							result = this->ProcessExpression(static_cast<NExpressionStatement*>(statement)->_expression, locals);
+							break;
+						} case _NFUNCTIONDECLARATION: {
+							auto fdecl = static_cast<NFunctionDeclaration*>(statement);
+							this->DefineFunction(*fdecl, locals);
+							Value const* sym = this->Lookup(fdecl->_id._symbol, locals);
+							result = (sym != nullptr) ? *sym : Value();
+							break;
+						} case _NRETURNSTATEMENT: {
+							result = this->ProcessExpression(static_cast<NReturnStatement*>(statement)->_expression, locals);
+							returned = true;
+							break;
+						} default:
+							std::cerr << "Error: Unsupported statement in " << fn.GetName() << ": " << this->GetNameFromMagik(statement->type) << std::endl;
+							result = Value();
 					}
+					if(returned || result.IsNone())
+						break;
 				}
-				return nullptr;
+				this->call_depth--;
+				if(fn.declaration._block.statements.empty())
+					std::cerr << "Error: " << fn.GetName() << " has no statements to return a value from" << std::endl;
+				return this->Unwind(mark, result);
 			}
 
-			Mt::core::IMtObject* EvaluationEngine::BinaryDivied(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs) {
-				switch(lhs->DerivedType) {
-					case Mt::core::TYPE::SCALAR: {
-						auto _lhs = dynamic_cast<Mt::objects::Scalar*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Scalar*>(rhs);
-						auto retval = new Mt::objects::Scalar((*_lhs)/(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Division result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::COMPLEX: {
-						auto _lhs = dynamic_cast<Mt::objects::Complex*>(lhs);
-						auto _rhs = dynamic_cast<Mt::objects::Complex*>(rhs);
-						auto retval = new Mt::objects::Complex((*_lhs)/(*_rhs));
-						if(this->debug_evaluation)
-							std::cout << "Division result: " << retval << std::endl;
-						return retval;
-					} case Mt::core::TYPE::MATRIX: {
+			Value EvaluationEngine::Unwind(ObjectPool::Mark const& mark, Value const& result) {
+				Value escaped = result;
+				this->Carry(mark, &escaped, 1);
+				return escaped;
+			}
 
-					} case Mt::core::TYPE::SET: {
+			void EvaluationEngine::Carry(ObjectPool::Mark const& mark, Value* values, size_t count) {
+				// Everything that escapes is copied out before any of the arena space is reused
+				Mt::core::IMtObject* copies[Builtins::MAX_ARITY];
+				for(size_t i = 0; i < count; i++) {
+					Value const& v = values[i];
+					copies[i] = (v.IsInline() || v.IsNone() || !this->temporaries.Since(mark, v.object)) ? nullptr : v.CloneObject();
+				}
+				this->temporaries.Release(mark);
+				for(size_t i = 0; i < count; i++) {
+					if(copies[i] != nullptr)
+						values[i] = Value::MakeObject(this->temporaries.Adopt(copies[i]));
+				}
+			}
 
-					} case Mt::core::TYPE::LIST: {
-						break;
+			void EvaluationEngine::PushFrame(Function const& fn, Value const* args, size_t count, Memo* memo) {
+				Bytecode::Program const& program = *fn.program;
+				const size_t base = this->frames;
+				// The register stack only ever grows, frames are not cleared since every register is
+				// written before it is read
+				if(base + program.registers > this->registers.size())
+					this->registers.resize(std::max(2 * this->registers.size(), base + program.registers));
+				this->frames = base + program.registers;
+				std::copy(args, args + count, this->registers.data() + base);
+				this->calls.push_back(Frame{ &program, program.code.data(), base, this->temporaries.GetMark(), this->tails.size(), memo, this->keys.size() });
+				if(memo != nullptr)
+					this->keys.insert(this->keys.end(), args, args + count);
+				this->tails.push_back(&program);
+				this->call_depth++;
+			}
+
+			/*
+				GCC and clang take the address of a label, so every handler jumps straight to the next
+				one instead of going back through a switch. That is an extension -Wpedantic objects to.
+			*/
+#if defined(__GNUC__)
+#define MT_THREADED_DISPATCH
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+			Value EvaluationEngine::Execute(Function const& fn, Value const* args, size_t count) {
+				using namespace Bytecode;
+				// Frames below this one belong to whoever called into SML from a builtin
+				const size_t floor = this->calls.size();
+				this->PushFrame(fn, args, count);
+				// State of the innermost frame, reloaded whenever it changes or a call can move the registers
+				Program const* program;
+				const Instruction* ip;
+				Value* r;
+				const Value* constants;
+				Value operands[Builtins::MAX_ARITY];
+#define LOAD() program = this->calls.back().program; ip = this->calls.back().ip; \
+				r = this->registers.data() + this->calls.back().base; constants = program->constants.data() + this->precision
+				LOAD();
+#if defined(MT_THREADED_DISPATCH)
+				static void* const HANDLERS[OPCODES] = {
+					&&HANDLER_CONSTANT, &&HANDLER_GLOBAL, &&HANDLER_FUNCTION, &&HANDLER_MOVE, &&HANDLER_ADD, &&HANDLER_SUBTRACT,
+					&&HANDLER_MULTIPLY, &&HANDLER_DIVIDE, &&HANDLER_BUILTIN, &&HANDLER_CALL, &&HANDLER_RETURN, &&HANDLER_TAILCALL,
+				};
+#define HANDLER(op) HANDLER_##op:
+#define DISPATCH() goto *HANDLERS[ip->op]
+				DISPATCH();
+#else
+#define HANDLER(op) case op:
+#define DISPATCH() continue
+				for(;;) switch(ip->op) {
+#endif
+#define NEXT() ip++; DISPATCH()
+				HANDLER(CONSTANT)
+					r[ip->target] = constants[ip->a * TIERS];
+					NEXT();
+				HANDLER(GLOBAL) {
+					Value const* sym = (this->globals != nullptr) ? this->globals->Find(program->names[ip->a]) : nullptr;
+					if(sym == nullptr) {
+						std::cerr << "Error: Unknown identifier \"" << Symbols::Name(program->names[ip->a]) << "\"" << std::endl;
+						goto fail;
+					}
+					r[ip->target] = *sym;
+					NEXT();
+				} HANDLER(FUNCTION) {
+					Value const* callee = nullptr;
+					if(ip->b != 0) {
+						callee = &r[ip->b - 1];
+					} else if(this->globals != nullptr) {
+						callee = this->globals->Find(program->names[ip->a]);
+					}
+					if(callee == nullptr || callee->type != TYPE::FUNCTION) {
+						std::cerr << "Error: Unknown function \"" << Symbols::Name(program->names[ip->a]) << "\"" << std::endl;
+						goto fail;
+					}
+					r[ip->target] = *callee;
+					NEXT();
+				} HANDLER(MOVE)
+					r[ip->target] = r[ip->a];
+					NEXT();
+				HANDLER(ADD)
+					if(!ApplyScalar<Arithmetic::AddKernel>(r[ip->a], r[ip->b], r[ip->target]) && (r[ip->target] = this->Binary(Dispatch::ADD, r[ip->a], r[ip->b])).IsNone())
+						goto fail;
+					NEXT();
+				HANDLER(SUBTRACT)
+					if(!ApplyScalar<Arithmetic::MinusKernel>(r[ip->a], r[ip->b], r[ip->target]) && (r[ip->target] = this->Binary(Dispatch::SUBTRACT, r[ip->a], r[ip->b])).IsNone())
+						goto fail;
+					NEXT();
+				HANDLER(MULTIPLY)
+					if(!ApplyScalar<Arithmetic::MultiplyKernel>(r[ip->a], r[ip->b], r[ip->target]) && (r[ip->target] = this->Binary(Dispatch::MULTIPLY, r[ip->a], r[ip->b])).IsNone())
+						goto fail;
+					NEXT();
+				HANDLER(DIVIDE)
+					if(!ApplyScalar<Arithmetic::DivideKernel>(r[ip->a], r[ip->b], r[ip->target]) && (r[ip->target] = this->Binary(Dispatch::DIVIDE, r[ip->a], r[ip->b])).IsNone())
+						goto fail;
+					NEXT();
+				HANDLER(BUILTIN) {
+					// Arity was checked by the compiler, the argument types can only be checked now
+					const Builtin* builtin = program->builtins[ip->b];
+					for(size_t i = 0; i < ip->count; i++) {
+						operands[i] = r[ip->a + i];
+						if(!Builtins::Accepts(builtin->signature[i], operands[i])) {
+							std::cerr << "Error: Argument " << (i + 1) << " of " << builtin->name << " has an unsupported type" << std::endl;
+							goto fail;
+						}
+					}
+					CallContext context(this->temporaries, this->precision, this);
+					Value y = builtin->function(operands, ip->count, context);
+					r = this->registers.data() + this->calls.back().base;
+					if(y.IsNone())
+						goto fail;
+					r[ip->target] = y;
+					NEXT();
+				} HANDLER(CALL) {
+					Function const& callee = *static_cast<Function*>(r[ip->b].object);
+					std::copy(r + ip->a, r + ip->a + ip->count, operands);
+					if(callee.program && callee.GetArity() == ip->count && this->call_depth < this->max_depth) {
+						// A memoized call is answered from the cache, or its frame stores the result when it returns
+						Memo* memo = this->memoizing ? this->MemoFor(callee) : nullptr;
+						Value y;
+						if(memo != nullptr && memo->Find(operands, ip->count, y)) {
+							r[ip->target] = y;
+							NEXT();
+						}
+						if(this->native && this->CallNative(callee, operands, ip->count, y)) {
+							if(memo != nullptr)
+								memo->Store(operands, ip->count, y);
+							r[ip->target] = y;
+							NEXT();
+						}
+						this->calls.back().ip = ip;
+						this->PushFrame(callee, operands, ip->count, memo);
+						LOAD();
+						DISPATCH();
+					}
+					// CallFunction reports the arity and depth errors and walks the bodies that did not compile
+					Value y = this->CallFunction(callee, operands, ip->count);
+					r = this->registers.data() + this->calls.back().base;
+					if(y.IsNone())
+						goto fail;
+					r[ip->target] = y;
+					NEXT();
+				} HANDLER(TAILCALL) {
+					Function const& callee = *static_cast<Function*>(r[ip->b].object);
+					std::copy(r + ip->a, r + ip->a + ip->count, operands);
+					const bool compiled = callee.program && callee.GetArity() == ip->count;
+					// A result from the cache or a native kernel is there straight away, the RETURN that follows hands it back
+					Memo* memo = (compiled && this->memoizing) ? this->MemoFor(callee) : nullptr;
+					Value y;
+					if(memo != nullptr && memo->Find(operands, ip->count, y)) {
+						r[ip->target] = y;
+						NEXT();
 					}
+					if(this->native && compiled && this->CallNative(callee, operands, ip->count, y)) {
+						if(memo != nullptr)
+							memo->Store(operands, ip->count, y);
+						r[ip->target] = y;
+						NEXT();
+					}
+					Frame& frame = this->calls.back();
+					// A callee the caller made goes with the caller's temporaries, so it gets a frame of its own, as
+					// does a memoized one since its frame stores the result
+					if(compiled && (memo != nullptr || this->temporaries.Since(frame.mark, &callee))) {
+						if(this->call_depth < this->max_depth) {
+							frame.ip = ip;
+							this->PushFrame(callee, operands, ip->count, memo);
+							LOAD();
+							DISPATCH();
+						}
+					} else if(compiled) {
+						Program const& next = *callee.program;
+						// Without conditionals a body that comes back around in tail position never returns
+						if(std::find(this->tails.begin() + static_cast<std::ptrdiff_t>(frame.chain), this->tails.end(), &next) != this->tails.end()) {
+							std::cerr << "Error: " << callee.GetName() << " tail calls itself and never returns" << std::endl;
+							goto fail;
+						}
+						this->tails.push_back(&next);
+						// The caller's temporaries go, except what the arguments still reference
+						this->Carry(frame.mark, operands, ip->count);
+						if(frame.base + next.registers > this->registers.size())
+							this->registers.resize(std::max(2 * this->registers.size(), frame.base + next.registers));
+						this->frames = frame.base + next.registers;
+						std::copy(operands, operands + ip->count, this->registers.data() + frame.base);
+						frame.program = &next;
+						frame.ip = next.code.data();
+						LOAD();
+						DISPATCH();
+					}
+					y = this->CallFunction(callee, operands, ip->count);
+					r = this->registers.data() + this->calls.back().base;
+					if(y.IsNone())
+						goto fail;
+					r[ip->target] = y;
+					NEXT();
+				} HANDLER(RETURN) {
+					Frame const& frame = this->calls.back();
+					Value result = this->Unwind(frame.mark, r[ip->a]);
+					if(frame.memo != nullptr) {
+						frame.memo->Store(this->keys.data() + frame.key, this->keys.size() - frame.key, result);
+						this->keys.resize(frame.key);
+					}
+					this->frames = frame.base;
+					this->tails.resize(frame.chain);
+					this->calls.pop_back();
+					this->call_depth--;
+					if(this->calls.size() == floor)
+						return result;
+					LOAD();
+					r[ip->target] = result;
+					NEXT();
+				}
+#if !defined(MT_THREADED_DISPATCH)
+				default:
+					goto fail;
 				}
-				return nullptr;
+#endif
+#undef LOAD
+#undef HANDLER
+#undef DISPATCH
+#undef NEXT
+			fail:
+				// The calls that did not return are abandoned along with everything they created
+				this->temporaries.Release(this->calls[floor].mark);
+				this->frames = this->calls[floor].base;
+				this->tails.resize(this->calls[floor].chain);
+				this->keys.resize(this->calls[floor].key);
+				this->call_depth -= this->calls.size() - floor;
+				this->calls.erase(this->calls.begin() + static_cast<std::ptrdiff_t>(floor), this->calls.end());
+				return Value();
 			}
+#if defined(MT_THREADED_DISPATCH)
+#undef MT_THREADED_DISPATCH
+#pragma GCC diagnostic pop
+#endif
 
-			void EvaluationEngine::PrintResult(Mt::core::IMtObject* res, std::string input) {
-				switch(res->DerivedType) {
-					case Mt::core::TYPE::SCALAR: {
-						auto _res = dynamic_cast<Mt::objects::Scalar*>(res);
-						std::cout << input << " = " << *_res << std::endl;
-						delete _res;
-						break;
-					} case Mt::core::TYPE::COMPLEX: {
-						auto _res = dynamic_cast<Mt::objects::Complex*>(res);
-						std::cout << input << " = " << *_res << std::endl;
-						delete _res;
-						break;
-					} case Mt::core::TYPE::MATRIX: {
+			Value EvaluationEngine::Call(Value const& function, Value const* args, size_t count) {
+				if(function.type != TYPE::FUNCTION) {
+					std::cerr << "Error: Called value is not a function" << std::endl;
+					return Value();
+				}
+				return this->CallFunction(*static_cast<Function*>(function.object), args, count);
+			}
+
+			std::unique_ptr<FunctionCaller> EvaluationEngine::Fork(void) {
+				return std::unique_ptr<FunctionCaller>(new EvaluationEngine(this));
+			}
 
-					} case Mt::core::TYPE::SET: {
+			Value EvaluationEngine::EvaluateConstant(NExpression* expr, PRECISION tier) {
+				SymbolTable none;
+				PRECISION session = this->precision;
+				this->precision = tier;
+				Value result = this->ProcessExpression(expr, none);
+				this->precision = session;
+				return result;
+			}
 
-					} case Mt::core::TYPE::LIST: {
+			Value EvaluationEngine::Persist(Symbol symbol, Value const& val) {
+				Mt::core::IMtObject* copy = val.CloneObject();
+				if(symbol >= this->persistent.size()) {
+					if(copy == nullptr)
+						return val;
+					this->persistent.resize(symbol + 1);
+				}
+				// Copy before releasing the old object, val may well reference it
+				this->persistent[symbol].reset(copy);
+				if(copy == nullptr)
+					return val;
+				return Value::MakeObject(copy);
+			}
+
+			void EvaluationEngine::PrintResult(Value const& res, std::string const& input) {
+				// Nothing to print if the expression failed or had no result
+				if(res.IsNone())
+					return;
+				this->output.clear();
+				this->output += input;
+				this->output += " = ";
+				res.Format(this->output);
+				this->output += '\n';
+				std::cout.write(this->output.data(), static_cast<std::streamsize>(this->output.size()));
+				std::cout.flush();
+			}
+
+			void EvaluationEngine::Statement(NStatement* statement, SymbolTable& GST, std::string const& rawInput) {
+				if(this->debug_evaluation) {
+					std::cout << "Evaluating statement at " << statement << " of type " << this->GetNameFromMagik(statement->type) << std::endl;
+				}
+				this->changed.clear();
+				switch(statement->type) {
+					case _NVARIABLEDECLARATION: {
+						auto vardec = static_cast<NVariableDeclaration*>(statement);
+						if(this->debug_evaluation)
+							std::cout << "NVariableDeclaration with Identifier of \"" << vardec->_id._name << "\" " << std::endl;
+						if(vardec->_assignmentExpr == nullptr) {
+
+						} else {
+							Value res = this->ProcessExpression(vardec->_assignmentExpr, GST);
+							if(!res.IsNone()) {
+								GST.Bind(vardec->_id._symbol, this->Persist(vardec->_id._symbol, res));
+								this->GlobalsChanged();
+								this->PrintResult(res, rawInput);
+								if(this->reactive != DependencyGraph::OFF)
+									this->changed.push_back(vardec->_id._symbol);
+							}
+						}
+						break;
+					} case _NEXPRESSIONSTATEMENT: {
+						auto expr = static_cast<NExpressionStatement*>(statement);
+						if(this->debug_evaluation)
+							std::cout << "Expression " << expr << " is of type " << this->GetNameFromMagik(expr->_expression->type) << std::endl;
+						this->PrintResult(this->ProcessExpression(expr->_expression, GST), rawInput);
+						break;
+					} case _NFUNCTIONDECLARATION: {
+						this->DefineFunction(*static_cast<NFunctionDeclaration*>(statement), GST);
 						break;
+					} case _NLISTDECLARATION: {
+						
+						break;
+					} case _NRETURNSTATEMENT: {
+						std::cerr << "Error: ret outside of a function" << std::endl;
+						break;
+					} default:
+						std::cerr << "Unknown statement type: " << this->GetNameFromMagik(statement->type) << std::endl;
+				}
+				// Only a top level statement changes what the definitions read, nested blocks are part of one
+				if(this->reactive != DependencyGraph::OFF && this->evaluation_depth == 1 && !this->changed.empty())
+					this->Propagate((statement->type == _NVARIABLEDECLARATION) ? static_cast<NVariableDeclaration*>(statement) : nullptr, GST, rawInput);
+			}
+
+			void EvaluationEngine::EvaluatePlanned(std::vector<NStatement*> const& statements, size_t first, std::vector<size_t> const& levels, SymbolTable& GST, std::string const& rawInput) {
+				struct Task {
+					NStatement* statement;
+					Value result;
+					Output output;
+				};
+				std::vector<Task> tasks(levels.size());
+				const size_t depth = *std::max_element(levels.begin(), levels.end()) + 1;
+				std::vector<size_t> width(depth, 0);
+				for(size_t t = 0; t < tasks.size(); t++) {
+					tasks[t].statement = statements[first + t];
+					width[levels[t]]++;
+				}
+				// A worker more than the widest level has statements would only ever sleep
+				WorkerPool workers(std::min<size_t>(WorkerPool::Workers(0), *std::max_element(width.begin(), width.end())));
+				std::vector<std::unique_ptr<EvaluationEngine>> forks;
+				for(size_t w = 0; w < workers.Size(); w++)
+					forks.emplace_back(new EvaluationEngine(this));
+				Capture out(std::cout, false);
+				Capture err(std::cerr, true);
+				std::vector<size_t> level;
+				std::atomic<size_t> next(0);
+				size_t printed = 0;
+				for(size_t l = 0; l < depth; l++) {
+					level.clear();
+					for(size_t t = 0; t < tasks.size(); t++) {
+						if(levels[t] == l)
+							level.push_back(t);
+					}
+					next = 0;
+					workers.Run([&](size_t worker) {
+						for(size_t n = next++; n < level.size(); n = next++) {
+							Task& task = tasks[level[n]];
+							NExpression* expr = (task.statement->type == _NVARIABLEDECLARATION)
+								? static_cast<NVariableDeclaration*>(task.statement)->_assignmentExpr : static_cast<NExpressionStatement*>(task.statement)->_expression;
+							redirected = &task.output;
+							task.result = forks[worker]->ProcessExpression(expr, GST);
+							redirected = nullptr;
+						}
+					});
+					// Nothing in a level reads or binds what another one in it binds, so binding in program order is binding in any order
+					for(size_t t : level) {
+						Task& task = tasks[t];
+						if(task.result.IsNone())
+							continue;
+						if(task.statement->type == _NVARIABLEDECLARATION) {
+							const Symbol symbol = static_cast<NVariableDeclaration*>(task.statement)->_id._symbol;
+							GST.Bind(symbol, this->Persist(symbol, task.result));
+							this->GlobalsChanged();
+						}
+						// Formatted now, a later level may bind the name again before the statements ahead of this one are done
+						std::string text(rawInput);
+						text += " = ";
+						task.result.Format(text);
+						text += '\n';
+						task.output.emplace_back(false, std::move(text));
+						task.result = Value();
 					}
+					for(auto& fork : forks) {
+						fork->temporaries.Clear();
+						fork->GlobalsChanged();
+					}
+					// A statement prints once everything before it has been bound
+					for(; printed < tasks.size() && levels[printed] <= l; printed++) {
+						for(auto const& chunk : tasks[printed].output) {
+							std::ostream& stream = chunk.first ? std::cerr : std::cout;
+							stream.write(chunk.second.data(), static_cast<std::streamsize>(chunk.second.size()));
+						}
+						tasks[printed].output.clear();
+					}
+					std::cout.flush();
 				}
 			}
 
-			void EvaluationEngine::Evaluate(Mt::core::lang::NBlock* blk, std::map<std::string, Mt::core::IMtObject>& GST, std::string rawInput) {
+			void EvaluationEngine::Evaluate(Mt::core::lang::NBlock* blk, SymbolTable& GST, std::string rawInput) {
 				if(this->debug_evaluation) {
 					std::cout << "Evaluating input" << std::endl << "Performing AST sanity check" << std::endl;
 				}
@@ -301,42 +1267,33 @@ namespace Mt {
 				if(this->debug_evaluation) {
 					std::cout << "AST at " << blk << std::endl;
 					std::cout << "Current expression has " << blk->statements.size() << " statement(s)" << std::endl;
-					std::cout << "The Global Symbol Table has " << GST.size() << " symbol(s)" << std::endl;
+					std::cout << "The Global Symbol Table has " << GST.Size() << " symbol(s)" << std::endl;
 					std::cout << "Iterating over statements" << std::endl;
 				}
-				for(auto statement : blk->statements) {
-					if(this->debug_evaluation) {
-						std::cout << "Evaluating statement at " << statement << " of type " << this->GetNameFromMagik(statement->type) << std::endl;
-					}
-					switch(statement->type) {
-						case _NVARIABLEDECLARATION: {
-							auto vardec = dynamic_cast<NVariableDeclaration*>(statement);
-							if(this->debug_evaluation)
-								std::cout << "NVariableDeclaration with Identifier of \"" << vardec->_id._name << "\" " << std::endl;
-							if(vardec->_assignmentExpr == nullptr) {
-
-							} else {
-								GST[vardec->_id._name] = *this->ProcessExpression(vardec->_assignmentExpr, GST);
-								this->PrintResult(&GST[vardec->_id._name], rawInput);
-							}
-							break;
-						} case _NEXPRESSIONSTATEMENT: {
-							auto expr = dynamic_cast<NExpressionStatement*>(statement);
-							if(this->debug_evaluation)
-								std::cout << "Expression " << expr << " is of type " << this->GetNameFromMagik(expr->_expression.type) << std::endl;
-							auto res = this->ProcessExpression(&(expr->_expression), GST);
-							this->PrintResult(res, rawInput);
-							break;
-						} case _NFUNCTIONDECLARATION: {
-							
-							break;
-						} case _NLISTDECLARATION: {
-							
-							break;
-						} default:
-							std::cerr << "Unknown statement type: " << this->GetNameFromMagik(statement->type) << std::endl;
+				// Function bodies look names up here once they run out of locals
+				if(this->evaluation_depth == 0)
+					this->globals = &GST;
+				this->evaluation_depth++;
+				std::vector<size_t> levels;
+				for(size_t i = 0; i < blk->statements.size(); i++) {
+					// Reactive recomputes between statements and the debug trace follows one statement at a time
+					size_t planned = 0;
+					if(this->parallel && this->evaluation_depth == 1 && this->reactive == DependencyGraph::OFF && !this->debug_evaluation)
+						planned = Schedule::Plan(blk->statements, i, GST, levels);
+					if(planned > 1 && *std::max_element(levels.begin(), levels.end()) + 1 < planned) {
+						this->EvaluatePlanned(blk->statements, i, levels, GST, rawInput);
+						i += planned - 1;
+						continue;
 					}
+					// Nothing to run side by side, each one waits for the one before it
+					const size_t count = std::max<size_t>(planned, 1);
+					for(size_t n = 0; n < count; n++)
+						this->Statement(blk->statements[i + n], GST, rawInput);
+					i += count - 1;
 				}
+				// Everything worth keeping has been persisted into the GST by now
+				if(--this->evaluation_depth == 0)
+					this->temporaries.Clear();
 			}
 		}
 	}
@@ -0,0 +1,616 @@
+/*
+	HPN.cc - Multi-precision limb kernels
+*/
+#include "core/HPN.hh"
+#include "core/Types.hh"
+
+namespace Mt {
+	namespace core {
+		namespace hpn {
+			size_t Normalize(const limb_t* a, size_t n) {
+				while(n > 0 && a[n - 1] == 0)
+					n--;
+				return n;
+			}
+
+			int Compare(const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+				na = Normalize(a, na);
+				nb = Normalize(b, nb);
+				if(na != nb)
+					return (na < nb) ? -1 : 1;
+				for(size_t i = na; i-- > 0;) {
+					if(a[i] != b[i])
+						return (a[i] < b[i]) ? -1 : 1;
+				}
+				return 0;
+			}
+
+			limb_t Add(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+				dlimb_t carry = 0;
+				size_t i = 0;
+				for(; i < nb; i++) {
+					carry += static_cast<dlimb_t>(a[i]) + b[i];
+					r[i] = static_cast<limb_t>(carry);
+					carry >>= LIMB_BITS;
+				}
+				for(; i < na; i++) {
+					carry += a[i];
+					r[i] = static_cast<limb_t>(carry);
+					carry >>= LIMB_BITS;
+				}
+				return static_cast<limb_t>(carry);
+			}
+
+			limb_t Sub(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+				limb_t borrow = 0;
+				size_t i = 0;
+				for(; i < nb; i++) {
+					dlimb_t d = static_cast<dlimb_t>(a[i]) - b[i] - borrow;
+					r[i] = static_cast<limb_t>(d);
+					borrow = static_cast<limb_t>(d >> 63);
+				}
+				for(; i < na; i++) {
+					dlimb_t d = static_cast<dlimb_t>(a[i]) - borrow;
+					r[i] = static_cast<limb_t>(d);
+					borrow = static_cast<limb_t>(d >> 63);
+				}
+				return borrow;
+			}
+
+			limb_t ShiftLeft(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+				if(bits == 0) {
+					std::copy(a, a + n, r);
+					return 0;
+				}
+				limb_t out = 0;
+				for(size_t i = n; i-- > 0;) {
+					limb_t v = a[i];
+					if(i == n - 1)
+						out = v >> (LIMB_BITS - bits);
+					r[i] = (v << bits) | ((i > 0) ? (a[i - 1] >> (LIMB_BITS - bits)) : 0);
+				}
+				return out;
+			}
+
+			limb_t ShiftRight(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+				if(bits == 0) {
+					std::copy(a, a + n, r);
+					return 0;
+				}
+				limb_t out = (n > 0) ? (a[0] << (LIMB_BITS - bits)) : 0;
+				for(size_t i = 0; i < n; i++)
+					r[i] = (a[i] >> bits) | ((i + 1 < n) ? (a[i + 1] << (LIMB_BITS - bits)) : 0);
+				return out;
+			}
+
+			limb_t MulLimb(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+				dlimb_t carry = 0;
+				for(size_t i = 0; i < n; i++) {
+					carry += static_cast<dlimb_t>(a[i]) * b;
+					r[i] = static_cast<limb_t>(carry);
+					carry >>= LIMB_BITS;
+				}
+				return static_cast<limb_t>(carry);
+			}
+
+			limb_t DivLimb(limb_t* q, const limb_t* a, size_t n, limb_t d) {
+				dlimb_t rem = 0;
+				for(size_t i = n; i-- > 0;) {
+					rem = (rem << LIMB_BITS) | a[i];
+					q[i] = static_cast<limb_t>(rem / d);
+					rem %= d;
+				}
+				return static_cast<limb_t>(rem);
+			}
+
+			void MulSchoolbook(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+				std::fill(r, r + na + nb, 0);
+				for(size_t j = 0; j < nb; j++) {
+					dlimb_t carry = 0;
+					const dlimb_t bj = b[j];
+					if(bj == 0)
+						continue;
+					limb_t* MT_RESTRICT row = r + j;
+					for(size_t i = 0; i < na; i++) {
+						carry += static_cast<dlimb_t>(a[i]) * bj + row[i];
+						row[i] = static_cast<limb_t>(carry);
+						carry >>= LIMB_BITS;
+					}
+					row[na] = static_cast<limb_t>(carry);
+				}
+			}
+
+			void MulKaratsuba(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+				if(n < KARATSUBA_THRESHOLD) {
+					MulSchoolbook(r, a, n, b, n);
+					return;
+				}
+				// a = a1 * B^h + a0, b = b1 * B^h + b0 with the high halves the larger ones
+				const size_t h = n / 2;
+				const size_t l = n - h;
+				const limb_t* a0 = a;
+				const limb_t* a1 = a + h;
+				const limb_t* b0 = b;
+				const limb_t* b1 = b + h;
+				// z0 and z2 go straight into the result
+				MulKaratsuba(r, a0, b0, h);
+				MulKaratsuba(r + 2 * h, a1, b1, l);
+				// z1 = (a0 + a1)(b0 + b1) - z0 - z2
+				std::vector<limb_t> sa(l + 1);
+				std::vector<limb_t> sb(l + 1);
+				std::vector<limb_t> z1(2 * l + 2);
+				sa[l] = Add(sa.data(), a1, l, a0, h);
+				sb[l] = Add(sb.data(), b1, l, b0, h);
+				if(sa[l] == 0 && sb[l] == 0) {
+					MulKaratsuba(z1.data(), sa.data(), sb.data(), l);
+					z1[2 * l] = z1[2 * l + 1] = 0;
+				} else {
+					Mul(z1.data(), sa.data(), l + 1, sb.data(), l + 1);
+				}
+				Sub(z1.data(), z1.data(), 2 * l + 2, r, 2 * h);
+				Sub(z1.data(), z1.data(), 2 * l + 2, r + 2 * h, 2 * l);
+				size_t len = Normalize(z1.data(), 2 * l + 2);
+				Add(r + h, r + h, 2 * n - h, z1.data(), len);
+			}
+
+			namespace {
+				/*
+					NTT friendly primes p = k * 2^m + 1, both support transforms of up to 2^25 points and
+					their product (about 2^56) bounds the 16 bit digit convolution for up to 2^24 digits.
+				*/
+				const uint32_t NTT_P1 = 167772161u;	// 5 * 2^25 + 1
+				const uint32_t NTT_P2 = 469762049u;	// 7 * 2^26 + 1
+				const uint32_t NTT_G = 3u;
+				const size_t NTT_MAX_DIGITS = static_cast<size_t>(1) << 24;
+
+				inline uint32_t PowMod(uint64_t b, uint64_t e, uint32_t p) {
+					uint64_t r = 1;
+					b %= p;
+					while(e) {
+						if(e & 1)
+							r = (r * b) % p;
+						b = (b * b) % p;
+						e >>= 1;
+					}
+					return static_cast<uint32_t>(r);
+				}
+
+				void Transform(std::vector<uint32_t>& a, uint32_t p, bool invert) {
+					const size_t n = a.size();
+					for(size_t i = 1, j = 0; i < n; i++) {
+						size_t bit = n >> 1;
+						for(; j & bit; bit >>= 1)
+							j ^= bit;
+						j ^= bit;
+						if(i < j)
+							std::swap(a[i], a[j]);
+					}
+					for(size_t len = 2; len <= n; len <<= 1) {
+						uint32_t w = PowMod(NTT_G, (p - 1) / len, p);
+						if(invert)
+							w = PowMod(w, p - 2, p);
+						const size_t half = len / 2;
+						std::vector<uint32_t> roots(half);
+						roots[0] = 1;
+						for(size_t k = 1; k < half; k++)
+							roots[k] = static_cast<uint32_t>((static_cast<uint64_t>(roots[k - 1]) * w) % p);
+						for(size_t i = 0; i < n; i += len) {
+							for(size_t k = 0; k < half; k++) {
+								uint32_t u = a[i + k];
+								uint32_t v = static_cast<uint32_t>((static_cast<uint64_t>(a[i + k + half]) * roots[k]) % p);
+								a[i + k] = (u + v >= p) ? (u + v - p) : (u + v);
+								a[i + k + half] = (u >= v) ? (u - v) : (u + p - v);
+							}
+						}
+					}
+					if(invert) {
+						uint32_t inv = PowMod(n, p - 2, p);
+						for(size_t i = 0; i < n; i++)
+							a[i] = static_cast<uint32_t>((static_cast<uint64_t>(a[i]) * inv) % p);
+					}
+				}
+
+				void Convolve(std::vector<uint32_t> const& x, std::vector<uint32_t> const& y, std::vector<uint32_t>& out, uint32_t p) {
+					std::vector<uint32_t> fy(y);
+					out = x;
+					Transform(out, p, false);
+					Transform(fy, p, false);
+					for(size_t i = 0; i < out.size(); i++)
+						out[i] = static_cast<uint32_t>((static_cast<uint64_t>(out[i]) * fy[i]) % p);
+					Transform(out, p, true);
+				}
+			}
+
+			void MulFFT(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+				const size_t da = 2 * na;
+				const size_t db = 2 * nb;
+				if(da + db > NTT_MAX_DIGITS) {
+					// Past what the two primes can recombine exactly, fall back to the quadratic kernel
+					MulSchoolbook(r, a, na, b, nb);
+					return;
+				}
+				size_t n = 1;
+				while(n < da + db)
+					n <<= 1;
+				std::vector<uint32_t> x(n, 0);
+				std::vector<uint32_t> y(n, 0);
+				for(size_t i = 0; i < na; i++) {
+					x[2 * i] = a[i] & 0xFFFFu;
+					x[2 * i + 1] = a[i] >> 16;
+				}
+				for(size_t i = 0; i < nb; i++) {
+					y[2 * i] = b[i] & 0xFFFFu;
+					y[2 * i + 1] = b[i] >> 16;
+				}
+				std::vector<uint32_t> c1;
+				std::vector<uint32_t> c2;
+				Convolve(x, y, c1, NTT_P1);
+				Convolve(x, y, c2, NTT_P2);
+				// CRT: c = c1 + P1 * ((c2 - c1) * P1^-1 mod P2)
+				const uint64_t inv = PowMod(NTT_P1, NTT_P2 - 2, NTT_P2);
+				std::fill(r, r + na + nb, 0);
+				uint64_t carry = 0;
+				for(size_t i = 0; i < da + db; i++) {
+					uint64_t c = c1[i];
+					uint64_t t = ((static_cast<uint64_t>(c2[i]) + NTT_P2 - (c % NTT_P2)) % NTT_P2) * inv % NTT_P2;
+					// Columns stay below P1 * P2 < 2^57, so the running carry never overflows
+					carry += c + t * NTT_P1;
+					limb_t digit = static_cast<limb_t>(carry & 0xFFFFu);
+					carry >>= 16;
+					if(i & 1)
+						r[i / 2] |= digit << 16;
+					else
+						r[i / 2] = digit;
+				}
+			}
+
+			void Mul(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+				if(na < nb) {
+					std::swap(a, b);
+					std::swap(na, nb);
+				}
+				if(nb == 0) {
+					std::fill(r, r + na, 0);
+					return;
+				}
+				if(nb < KARATSUBA_THRESHOLD) {
+					MulSchoolbook(r, a, na, b, nb);
+				} else if(nb >= FFT_THRESHOLD) {
+					MulFFT(r, a, na, b, nb);
+				} else if(na == nb) {
+					MulKaratsuba(r, a, b, nb);
+				} else {
+					// Unbalanced, multiply nb sized chunks of a by b and accumulate
+					std::fill(r, r + na + nb, 0);
+					std::vector<limb_t> t(2 * nb);
+					for(size_t off = 0; off < na; off += nb) {
+						size_t chunk = std::min(nb, na - off);
+						if(chunk == nb)
+							MulKaratsuba(t.data(), a + off, b, nb);
+						else
+							Mul(t.data(), b, nb, a + off, chunk);
+						Add(r + off, r + off, na + nb - off, t.data(), chunk + nb);
+					}
+				}
+			}
+
+			void DivMod(limb_t* q, limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb) {
+				if(nb == 1) {
+					r[0] = DivLimb(q, a, na, b[0]);
+					return;
+				}
+				// Normalize so the divisor's top bit is set, then estimate each quotient limb from the
+				// top two limbs of the remainder (Knuth, TAOCP vol. 2, 4.3.1 algorithm D)
+				const int s = LeadingZeros(b[nb - 1]);
+				std::vector<limb_t> bn(nb);
+				std::vector<limb_t> an(na + 1);
+				ShiftLeft(bn.data(), b, nb, s);
+				an[na] = ShiftLeft(an.data(), a, na, s);
+				const dlimb_t base = static_cast<dlimb_t>(1) << LIMB_BITS;
+				for(size_t j = na - nb + 1; j-- > 0;) {
+					dlimb_t num = (static_cast<dlimb_t>(an[j + nb]) << LIMB_BITS) | an[j + nb - 1];
+					dlimb_t qhat = num / bn[nb - 1];
+					dlimb_t rhat = num % bn[nb - 1];
+					while(qhat >= base || (qhat * bn[nb - 2]) > ((rhat << LIMB_BITS) | an[j + nb - 2])) {
+						qhat--;
+						rhat += bn[nb - 1];
+						if(rhat >= base)
+							break;
+					}
+					// an[j .. j + nb] -= qhat * bn
+					int64_t borrow = 0;
+					dlimb_t carry = 0;
+					for(size_t i = 0; i < nb; i++) {
+						dlimb_t p = qhat * bn[i] + carry;
+						carry = p >> LIMB_BITS;
+						int64_t t = static_cast<int64_t>(an[i + j]) - borrow - static_cast<int64_t>(p & 0xFFFFFFFFu);
+						an[i + j] = static_cast<limb_t>(t);
+						borrow = (t < 0) ? 1 : 0;
+					}
+					int64_t t = static_cast<int64_t>(an[j + nb]) - borrow - static_cast<int64_t>(carry);
+					an[j + nb] = static_cast<limb_t>(t);
+					if(t < 0) {
+						// Estimate was one too large, add the divisor back
+						qhat--;
+						dlimb_t c = 0;
+						for(size_t i = 0; i < nb; i++) {
+							c += static_cast<dlimb_t>(an[i + j]) + bn[i];
+							an[i + j] = static_cast<limb_t>(c);
+							c >>= LIMB_BITS;
+						}
+						an[j + nb] += static_cast<limb_t>(c);
+					}
+					q[j] = static_cast<limb_t>(qhat);
+				}
+				ShiftRight(r, an.data(), nb, s);
+				if(s != 0)
+					r[nb - 1] |= an[nb] << (LIMB_BITS - s);
+			}
+
+			BigInt::BigInt(void) : negative(false) {
+
+			}
+
+			BigInt::BigInt(int64_t v) : negative(v < 0) {
+				uint64_t m = (v < 0) ? (0ull - static_cast<uint64_t>(v)) : static_cast<uint64_t>(v);
+				while(m != 0) {
+					this->mag.push_back(static_cast<limb_t>(m));
+					m >>= LIMB_BITS;
+				}
+			}
+
+			void BigInt::Trim(void) {
+				this->mag.resize(Normalize(this->mag.data(), this->mag.size()));
+				if(this->mag.empty())
+					this->negative = false;
+			}
+
+			BigInt BigInt::FromLimbs(const limb_t* m, size_t n, bool neg) {
+				BigInt r;
+				r.mag.assign(m, m + n);
+				r.negative = neg;
+				r.Trim();
+				return r;
+			}
+
+			bool BigInt::FromString(std::string const& str, BigInt& out) {
+				size_t pos = 0;
+				bool neg = false;
+				if(pos < str.size() && (str[pos] == '-' || str[pos] == '+')) {
+					neg = (str[pos] == '-');
+					pos++;
+				}
+				if(pos == str.size())
+					return false;
+				BigInt r;
+				// Fold in 9 digits at a time, r = r * 10^9 + chunk
+				while(pos < str.size()) {
+					limb_t chunk = 0;
+					limb_t scale = 1;
+					for(int i = 0; i < 9 && pos < str.size(); i++, pos++) {
+						if(str[pos] < '0' || str[pos] > '9')
+							return false;
+						chunk = (chunk * 10) + static_cast<limb_t>(str[pos] - '0');
+						scale *= 10;
+					}
+					r.mag.push_back(0);
+					limb_t carry = MulLimb(r.mag.data(), r.mag.data(), r.mag.size(), scale);
+					if(carry != 0)
+						r.mag.push_back(carry);
+					carry = Add(r.mag.data(), r.mag.data(), r.mag.size(), &chunk, 1);
+					if(carry != 0)
+						r.mag.push_back(carry);
+					r.Trim();
+				}
+				r.negative = neg;
+				r.Trim();
+				out = r;
+				return true;
+			}
+
+			bool BigInt::FitsInt64(void) const {
+				if(this->mag.size() > 2)
+					return false;
+				uint64_t m = 0;
+				for(size_t i = this->mag.size(); i-- > 0;)
+					m = (m << LIMB_BITS) | this->mag[i];
+				return this->negative ? (m <= (static_cast<uint64_t>(INT64_MAX) + 1)) : (m <= static_cast<uint64_t>(INT64_MAX));
+			}
+
+			int64_t BigInt::ToInt64(void) const {
+				uint64_t m = 0;
+				for(size_t i = std::min<size_t>(this->mag.size(), 2); i-- > 0;)
+					m = (m << LIMB_BITS) | this->mag[i];
+				return this->negative ? static_cast<int64_t>(0ull - m) : static_cast<int64_t>(m);
+			}
+
+			size_t BigInt::BitLength(void) const {
+				if(this->mag.empty())
+					return 0;
+				return (this->mag.size() * LIMB_BITS) - LeadingZeros(this->mag.back());
+			}
+
+			size_t BigInt::TrailingZeroBits(void) const {
+				for(size_t i = 0; i < this->mag.size(); i++) {
+					if(this->mag[i] != 0)
+						return (i * LIMB_BITS) + TrailingZeros(this->mag[i]);
+				}
+				return 0;
+			}
+
+			int BigInt::Compare(BigInt const& rhs) const {
+				if(this->negative != rhs.negative)
+					return this->negative ? -1 : 1;
+				int c = hpn::Compare(this->mag.data(), this->mag.size(), rhs.mag.data(), rhs.mag.size());
+				return this->negative ? -c : c;
+			}
+
+			BigInt BigInt::Abs(void) const {
+				BigInt r(*this);
+				r.negative = false;
+				return r;
+			}
+
+			BigInt BigInt::operator-() const {
+				BigInt r(*this);
+				if(!r.mag.empty())
+					r.negative = !r.negative;
+				return r;
+			}
+
+			BigInt BigInt::ShiftLeft(size_t bits) const {
+				if(this->mag.empty())
+					return *this;
+				BigInt r;
+				size_t limbs = bits / LIMB_BITS;
+				r.mag.assign(limbs, 0);
+				r.mag.insert(r.mag.end(), this->mag.begin(), this->mag.end());
+				r.mag.push_back(0);
+				hpn::ShiftLeft(r.mag.data() + limbs, r.mag.data() + limbs, this->mag.size() + 1, static_cast<unsigned>(bits % LIMB_BITS));
+				r.negative = this->negative;
+				r.Trim();
+				return r;
+			}
+
+			BigInt BigInt::ShiftRight(size_t bits) const {
+				size_t limbs = bits / LIMB_BITS;
+				if(limbs >= this->mag.size())
+					return BigInt();
+				BigInt r;
+				r.mag.assign(this->mag.begin() + limbs, this->mag.end());
+				hpn::ShiftRight(r.mag.data(), r.mag.data(), r.mag.size(), static_cast<unsigned>(bits % LIMB_BITS));
+				r.negative = this->negative;
+				r.Trim();
+				return r;
+			}
+
+			BigInt operator+(BigInt const& a, BigInt const& b) {
+				BigInt r;
+				if(a.negative == b.negative) {
+					BigInt const& big = (a.mag.size() >= b.mag.size()) ? a : b;
+					BigInt const& small = (a.mag.size() >= b.mag.size()) ? b : a;
+					r.mag.resize(big.mag.size() + 1);
+					r.mag[big.mag.size()] = Add(r.mag.data(), big.mag.data(), big.mag.size(), small.mag.data(), small.mag.size());
+					r.negative = a.negative;
+				} else {
+					int c = Compare(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+					if(c == 0)
+						return r;
+					BigInt const& big = (c > 0) ? a : b;
+					BigInt const& small = (c > 0) ? b : a;
+					r.mag.resize(big.mag.size());
+					Sub(r.mag.data(), big.mag.data(), big.mag.size(), small.mag.data(), small.mag.size());
+					r.negative = big.negative;
+				}
+				r.Trim();
+				return r;
+			}
+
+			BigInt operator-(BigInt const& a, BigInt const& b) {
+				return a + (-b);
+			}
+
+			BigInt operator*(BigInt const& a, BigInt const& b) {
+				BigInt r;
+				if(a.mag.empty() || b.mag.empty())
+					return r;
+				r.mag.resize(a.mag.size() + b.mag.size());
+				Mul(r.mag.data(), a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+				r.negative = (a.negative != b.negative);
+				r.Trim();
+				return r;
+			}
+
+			void BigInt::DivMod(BigInt const& a, BigInt const& b, BigInt& q, BigInt& r) {
+				if(hpn::Compare(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size()) < 0) {
+					q = BigInt();
+					r = a;
+					return;
+				}
+				BigInt qt;
+				BigInt rt;
+				qt.mag.resize(a.mag.size() - b.mag.size() + 1);
+				rt.mag.resize(b.mag.size());
+				hpn::DivMod(qt.mag.data(), rt.mag.data(), a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size());
+				qt.negative = (a.negative != b.negative);
+				rt.negative = a.negative;
+				qt.Trim();
+				rt.Trim();
+				q = qt;
+				r = rt;
+			}
+
+			BigInt operator/(BigInt const& a, BigInt const& b) {
+				BigInt q, r;
+				BigInt::DivMod(a, b, q, r);
+				return q;
+			}
+
+			BigInt operator%(BigInt const& a, BigInt const& b) {
+				BigInt q, r;
+				BigInt::DivMod(a, b, q, r);
+				return r;
+			}
+
+			BigInt BigInt::Gcd(BigInt const& x, BigInt const& y) {
+				BigInt a = x.Abs();
+				BigInt b = y.Abs();
+				// Euclidean steps close the size gap quickly, binary GCD only pays off on similar sizes
+				while(!a.IsZero() && !b.IsZero() && (a.mag.size() > b.mag.size() + 1 || b.mag.size() > a.mag.size() + 1)) {
+					if(a.mag.size() > b.mag.size())
+						a = a % b;
+					else
+						b = b % a;
+				}
+				if(a.IsZero())
+					return b;
+				if(b.IsZero())
+					return a;
+				size_t za = a.TrailingZeroBits();
+				size_t zb = b.TrailingZeroBits();
+				size_t shift = std::min(za, zb);
+				a = a.ShiftRight(za);
+				b = b.ShiftRight(zb);
+				while(!b.IsZero()) {
+					if(a.mag.size() <= 2 && b.mag.size() <= 2) {
+						// Both fit a machine word now, finish there
+						uint64_t g = hpn::Gcd(static_cast<uint64_t>(a.ToInt64()), static_cast<uint64_t>(b.ToInt64()));
+						BigInt r;
+						while(g != 0) {
+							r.mag.push_back(static_cast<limb_t>(g));
+							g >>= LIMB_BITS;
+						}
+						return r.ShiftLeft(shift);
+					}
+					b = b.ShiftRight(b.TrailingZeroBits());
+					if(a > b)
+						std::swap(a, b);
+					b = b - a;
+				}
+				return a.ShiftLeft(shift);
+			}
+
+			std::string BigInt::ToString(void) const {
+				if(this->mag.empty())
+					return "0";
+				std::vector<limb_t> w(this->mag);
+				size_t len = w.size();
+				std::string digits;
+				while(len != 0) {
+					limb_t r = DivLimb(w.data(), w.data(), len, 1000000000u);
+					len = Normalize(w.data(), len);
+					for(int i = 0; i < 9; i++) {
+						digits += static_cast<char>('0' + (r % 10));
+						r /= 10;
+						if(len == 0 && r == 0)
+							break;
+					}
+				}
+				if(this->negative)
+					digits += '-';
+				std::reverse(digits.begin(), digits.end());
+				return digits;
+			}
+		}
+	}
+}
@@ -0,0 +1,202 @@
+/*
+	Integer.cc - Implementation Details for the exact integer class
+*/
+
+#include <stdexcept>
+
+#include "objects/Integer.hh"
+
+using Mt::core::hpn::BigInt;
+
+namespace Mt {
+	namespace objects {
+		// Constructors
+		Integer::Integer(void) : Small(0), Inline(true) {
+			this->DerivedType = Mt::core::TYPE::INTEGER;
+		}
+
+		Integer::Integer(int64_t val) : Small(val), Inline(true) {
+			this->DerivedType = Mt::core::TYPE::INTEGER;
+		}
+
+		Integer::Integer(BigInt const& val) : Small(0), Big(val), Inline(false) {
+			this->DerivedType = Mt::core::TYPE::INTEGER;
+			this->Demote();
+		}
+
+		Integer::Integer(std::string const& val) : Integer(val.data(), val.data() + val.size()) {
+
+		}
+
+		Integer::Integer(const char* first, const char* last) : Small(0), Inline(true) {
+			this->DerivedType = Mt::core::TYPE::INTEGER;
+			const char* p = first;
+			bool negative = (p != last && *p == '-');
+			if(p != last && (*p == '-' || *p == '+'))
+				p++;
+			// Up to 18 digits always fit a machine word, so most literals never touch BigInt
+			if(p != last && (last - p) <= 18) {
+				int64_t v = 0;
+				for(; p != last && *p >= '0' && *p <= '9'; p++)
+					v = (v * 10) + (*p - '0');
+				if(p == last) {
+					this->Small = negative ? -v : v;
+					return;
+				}
+			}
+			this->Inline = false;
+			if(!BigInt::FromString(std::string(first, last), this->Big))
+				throw std::invalid_argument("Invalid integer \"" + std::string(first, last) + "\"");
+			this->Demote();
+		}
+
+		Integer::Integer(Integer const& i) : INumeric(), Small(i.Small), Big(i.Big), Inline(i.Inline) {
+			this->DerivedType = Mt::core::TYPE::INTEGER;
+		}
+
+		Integer::Integer(Integer&& i) : INumeric(), Small(i.Small), Big(std::move(i.Big)), Inline(i.Inline) {
+			this->DerivedType = Mt::core::TYPE::INTEGER;
+		}
+
+		// Destructor
+		Integer::~Integer(void) {
+
+		}
+
+		/*!
+			Moves a Big value back into Small if it fits
+		*/
+		void Integer::Demote(void) {
+			if(!this->Inline && this->Big.FitsInt64()) {
+				this->Small = this->Big.ToInt64();
+				this->Big = BigInt();
+				this->Inline = true;
+			}
+		}
+
+		// Misc methods
+		bool Integer::IsSmall(void) const {
+			return this->Inline;
+		}
+
+		int64_t Integer::GetSmall(void) const {
+			return this->Small;
+		}
+
+		BigInt Integer::ToBig(void) const {
+			return this->Inline ? BigInt(this->Small) : this->Big;
+		}
+
+		bool Integer::IsZero(void) const {
+			return this->Inline && this->Small == 0;
+		}
+
+		bool Integer::IsNegative(void) const {
+			return this->Inline ? (this->Small < 0) : this->Big.IsNegative();
+		}
+
+		bool Integer::IsOne(void) const {
+			return this->Inline && this->Small == 1;
+		}
+
+		std::string Integer::ToString(void) const {
+			return this->Inline ? std::to_string(this->Small) : this->Big.ToString();
+		}
+
+		Integer Integer::Gcd(Integer const& a, Integer const& b) {
+			if(a.Inline && b.Inline && a.Small != INT64_MIN && b.Small != INT64_MIN) {
+				uint64_t x = static_cast<uint64_t>((a.Small < 0) ? -a.Small : a.Small);
+				uint64_t y = static_cast<uint64_t>((b.Small < 0) ? -b.Small : b.Small);
+				return Integer(static_cast<int64_t>(Mt::core::hpn::Gcd(x, y)));
+			}
+			return Integer(BigInt::Gcd(a.ToBig(), b.ToBig()));
+		}
+
+		// Operator overloads
+		Integer& Integer::operator=(Integer const& rhs) {
+			this->Small = rhs.Small;
+			this->Big = rhs.Big;
+			this->Inline = rhs.Inline;
+			return *this;
+		}
+
+		// Basic Arithmetic operations, each tries the machine word first
+		Integer Integer::operator+(Integer const& rhs) const {
+			int64_t r;
+			if(this->Inline && rhs.Inline && !Mt::core::hpn::AddOverflow(this->Small, rhs.Small, r))
+				return Integer(r);
+			return Integer(this->ToBig() + rhs.ToBig());
+		}
+
+		Integer Integer::operator-(Integer const& rhs) const {
+			int64_t r;
+			if(this->Inline && rhs.Inline && !Mt::core::hpn::SubOverflow(this->Small, rhs.Small, r))
+				return Integer(r);
+			return Integer(this->ToBig() - rhs.ToBig());
+		}
+
+		Integer Integer::operator*(Integer const& rhs) const {
+			int64_t r;
+			if(this->Inline && rhs.Inline && !Mt::core::hpn::MulOverflow(this->Small, rhs.Small, r))
+				return Integer(r);
+			return Integer(this->ToBig() * rhs.ToBig());
+		}
+
+		Integer Integer::operator/(Integer const& rhs) const {
+			if(rhs.IsZero())
+				throw std::domain_error("Integer division by zero");
+			if(this->Inline && rhs.Inline && !(this->Small == INT64_MIN && rhs.Small == -1))
+				return Integer(this->Small / rhs.Small);
+			return Integer(this->ToBig() / rhs.ToBig());
+		}
+
+		Integer Integer::operator%(Integer const& rhs) const {
+			if(rhs.IsZero())
+				throw std::domain_error("Integer division by zero");
+			if(this->Inline && rhs.Inline)
+				return Integer((rhs.Small == -1) ? 0 : (this->Small % rhs.Small));
+			return Integer(this->ToBig() % rhs.ToBig());
+		}
+
+		Integer Integer::operator-() const {
+			if(this->Inline && this->Small != INT64_MIN)
+				return Integer(-this->Small);
+			return Integer(-this->ToBig());
+		}
+
+		// Comparison operators
+		bool Integer::operator==(Integer const& rhs) const {
+			// Values are always demoted when they fit, so a small and a big value are never equal
+			if(this->Inline != rhs.Inline)
+				return false;
+			return this->Inline ? (this->Small == rhs.Small) : (this->Big == rhs.Big);
+		}
+
+		bool Integer::operator!=(Integer const& rhs) const {
+			return !(*this == rhs);
+		}
+
+		bool Integer::operator>(Integer const& rhs) const {
+			return rhs < *this;
+		}
+
+		bool Integer::operator<(Integer const& rhs) const {
+			if(this->Inline && rhs.Inline)
+				return this->Small < rhs.Small;
+			return this->ToBig() < rhs.ToBig();
+		}
+
+		bool Integer::operator>=(Integer const& rhs) const {
+			return !(*this < rhs);
+		}
+
+		bool Integer::operator<=(Integer const& rhs) const {
+			return !(rhs < *this);
+		}
+
+		// Stream overloads
+		std::ostream& operator<<(std::ostream& os, const Integer& i) {
+			return (os << i.ToString());
+		}
+	}
+}
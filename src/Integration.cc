@@ -0,0 +1,339 @@
+/*
+	Integration.cc - Adaptive numerical integration
+*/
+#include "core/Integration.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "core/WorkerPool.hh"
+
+namespace Mt {
+	namespace core {
+		namespace Integration {
+			namespace {
+				const long double DEFAULT_ABSOLUTE_TOLERANCE = 1e-13L;
+				const long double DEFAULT_RELATIVE_TOLERANCE = 1e-10L;
+				const size_t DEFAULT_MAX_EVALUATIONS = 4000000;
+				// Regions each worker refines per round
+				const size_t REGIONS_PER_WORKER = 8;
+
+				// Gauss-Kronrod 7-15 nodes on [-1, 1], outermost first, the odd ones are the Gauss nodes
+				const long double XGK[8] = {
+					0.991455371120812639206854697526329L, 0.949107912342758524526189684047851L,
+					0.864864423359769072789712788640926L, 0.741531185599394439863864773280788L,
+					0.586087235467691130294144845693013L, 0.405845151377397166906606412076961L,
+					0.207784955007898467600689403773245L, 0.000000000000000000000000000000000L,
+				};
+				const long double WGK[8] = {
+					0.022935322010529224963732008058970L, 0.063092092629978553290700663189204L,
+					0.104790010322250183839876322541518L, 0.140653259715525918745189590510238L,
+					0.169004726639267902826583426598550L, 0.190350578064785409913256402421014L,
+					0.204432940075298892414161999234649L, 0.209482141084727828012999174891714L,
+				};
+				// Gauss weights of XGK[1], XGK[3], XGK[5] and the center
+				const long double WG[4] = {
+					0.129484966168869693270611432679082L, 0.279705391489276667901467771423780L,
+					0.381830050505118944950369775488975L, 0.417959183673469387755102040816327L,
+				};
+
+				// Genz-Malik generators, sqrt(9/70), sqrt(9/10) and sqrt(9/19)
+				const long double LAMBDA2 = 0.3585685828003180919906451539079374954541L;
+				const long double LAMBDA4 = 0.9486832980505137995996680633298155601159L;
+				const long double LAMBDA5 = 0.6882472016116852977216287342936235251269L;
+				// LAMBDA2^2 / LAMBDA4^2, weighs the two second differences against each other
+				const long double DIFFERENCE_RATIO = 1.0L / 7.0L;
+
+				struct Region {
+					long double value;
+					long double error;
+					// Axis the next bisection splits
+					size_t axis;
+					long double center[MAX_DIMENSION];
+					long double half[MAX_DIMENSION];
+				};
+
+				struct ByError {
+					bool operator()(Region const& a, Region const& b) const {
+						return a.error < b.error;
+					}
+				};
+
+				/*
+					QUADPACK's error scaling, |K - G| is a very pessimistic bound for smooth integrands
+					and nothing is trusted below the rounding noise of the sum
+				*/
+				long double ScaleError(long double error, long double resabs, long double resasc) {
+					if(resasc != 0.0L && error != 0.0L)
+						error = resasc * std::min(1.0L, std::pow((200.0L * error) / resasc, 1.5L));
+					if(resabs > LDBL_MIN / (50.0L * LDBL_EPSILON))
+						error = std::max(50.0L * LDBL_EPSILON * resabs, error);
+					return error;
+				}
+
+				/*
+					Gauss-Kronrod 7-15 rule on an interval
+				*/
+				struct Kronrod {
+					size_t Points(void) const {
+						return 15;
+					}
+
+					void Nodes(Region const& r, long double* out) const {
+						for(int j = 0; j < 7; j++) {
+							out[j] = r.center[0] - (r.half[0] * XGK[j]);
+							out[7 + j] = r.center[0] + (r.half[0] * XGK[j]);
+						}
+						out[14] = r.center[0];
+					}
+
+					void Estimate(Region& r, const long double* fx) const {
+						long double fc = fx[14];
+						long double resk = WGK[7] * fc;
+						long double resg = WG[3] * fc;
+						long double resabs = std::fabs(resk);
+						for(int j = 0; j < 7; j++) {
+							long double sum = fx[j] + fx[7 + j];
+							resk += WGK[j] * sum;
+							resabs += WGK[j] * (std::fabs(fx[j]) + std::fabs(fx[7 + j]));
+							if(j % 2 == 1)
+								resg += WG[j / 2] * sum;
+						}
+						long double mean = resk * 0.5L;
+						long double resasc = WGK[7] * std::fabs(fc - mean);
+						for(int j = 0; j < 7; j++)
+							resasc += WGK[j] * (std::fabs(fx[j] - mean) + std::fabs(fx[7 + j] - mean));
+						long double width = std::fabs(r.half[0]);
+						r.value = resk * r.half[0];
+						r.error = ScaleError(std::fabs((resk - resg) * width), resabs * width, resasc * width);
+						r.axis = 0;
+					}
+				};
+
+				/*
+					Degree 7 Genz-Malik rule on a box, the embedded degree 5 rule gives the error and
+					the fourth differences along each axis pick the axis to split
+				*/
+				class GenzMalik {
+				private:
+					size_t dimension;
+					size_t points;
+					// Degree 7 weights of the center, the two axis point sets, the axis pairs and the corners
+					long double w[5];
+					// Degree 5 weights, the corners are not part of it
+					long double v[4];
+				public:
+					explicit GenzMalik(size_t n) : dimension(n), points(1 + (4 * n) + (2 * n * (n - 1)) + (static_cast<size_t>(1) << n)) {
+						long double d = static_cast<long double>(n);
+						this->w[0] = (12824.0L - (9120.0L * d) + (400.0L * d * d)) / 19683.0L;
+						this->w[1] = 980.0L / 6561.0L;
+						this->w[2] = (1820.0L - (400.0L * d)) / 19683.0L;
+						this->w[3] = 200.0L / 19683.0L;
+						this->w[4] = 6859.0L / (19683.0L * static_cast<long double>(static_cast<size_t>(1) << n));
+						this->v[0] = (729.0L - (950.0L * d) + (50.0L * d * d)) / 729.0L;
+						this->v[1] = 245.0L / 486.0L;
+						this->v[2] = (265.0L - (100.0L * d)) / 1458.0L;
+						this->v[3] = 25.0L / 729.0L;
+					}
+
+					size_t Points(void) const {
+						return this->points;
+					}
+
+					void Nodes(Region const& r, long double* out) const {
+						const size_t n = this->dimension;
+						long double* p = out;
+						auto next = [&p, &r, n](void) {
+							long double* q = p;
+							std::copy(r.center, r.center + n, q);
+							p += n;
+							return q;
+						};
+						next();
+						for(size_t i = 0; i < n; i++) {
+							next()[i] -= LAMBDA2 * r.half[i];
+							next()[i] += LAMBDA2 * r.half[i];
+							next()[i] -= LAMBDA4 * r.half[i];
+							next()[i] += LAMBDA4 * r.half[i];
+						}
+						for(size_t i = 0; i < n; i++) {
+							for(size_t j = i + 1; j < n; j++) {
+								for(int s = 0; s < 4; s++) {
+									long double* q = next();
+									q[i] += ((s & 1) ? LAMBDA4 : -LAMBDA4) * r.half[i];
+									q[j] += ((s & 2) ? LAMBDA4 : -LAMBDA4) * r.half[j];
+								}
+							}
+						}
+						for(size_t c = 0; c < (static_cast<size_t>(1) << n); c++) {
+							long double* q = next();
+							for(size_t i = 0; i < n; i++)
+								q[i] += (((c >> i) & 1) ? LAMBDA5 : -LAMBDA5) * r.half[i];
+						}
+					}
+
+					void Estimate(Region& r, const long double* fx) const {
+						const size_t n = this->dimension;
+						long double f0 = fx[0];
+						long double sum2 = 0.0L, sum3 = 0.0L, sum4 = 0.0L, sum5 = 0.0L;
+						long double largest = -1.0L;
+						size_t axis = 0;
+						for(size_t i = 0; i < n; i++) {
+							const long double* f = fx + 1 + (4 * i);
+							long double inner = f[0] + f[1];
+							long double outer = f[2] + f[3];
+							sum2 += inner;
+							sum3 += outer;
+							// Ties go to the widest axis, so flat integrands still get split evenly
+							long double difference = std::fabs((inner - (2.0L * f0)) - (DIFFERENCE_RATIO * (outer - (2.0L * f0))));
+							if(difference > largest || (difference == largest && std::fabs(r.half[i]) > std::fabs(r.half[axis]))) {
+								largest = difference;
+								axis = i;
+							}
+						}
+						size_t k = 1 + (4 * n);
+						for(size_t end = k + (2 * n * (n - 1)); k < end; k++)
+							sum4 += fx[k];
+						for(; k < this->points; k++)
+							sum5 += fx[k];
+						long double volume = 1.0L;
+						for(size_t i = 0; i < n; i++)
+							volume *= 2.0L * r.half[i];
+						long double degree7 = volume * ((this->w[0] * f0) + (this->w[1] * sum2) + (this->w[2] * sum3) + (this->w[3] * sum4) + (this->w[4] * sum5));
+						long double degree5 = volume * ((this->v[0] * f0) + (this->v[1] * sum2) + (this->v[2] * sum3) + (this->v[3] * sum4));
+						r.value = degree7;
+						r.error = std::fabs(degree7 - degree5);
+						r.axis = axis;
+					}
+				};
+
+				template <class Rule>
+				bool Adapt(Rule const& rule, std::vector<Integrand*> const& integrands, WorkerPool& workers, size_t dimension,
+						Region const& box, Options const& options, Result& result) {
+					const size_t points = rule.Points();
+					std::vector<Region> heap;
+					std::vector<Region> batch(1, box);
+					std::vector<long double> nodes;
+					std::vector<long double> values;
+					std::atomic<bool> failed(false);
+
+					// Each worker takes a contiguous share of the batch and evaluates all of its nodes in one call
+					std::function<void(size_t)> estimate = [&](size_t worker) {
+						size_t first = (batch.size() * worker) / workers.Size();
+						size_t last = (batch.size() * (worker + 1)) / workers.Size();
+						if(first == last || failed)
+							return;
+						long double* x = nodes.data() + (first * points * dimension);
+						long double* fx = values.data() + (first * points);
+						try {
+							for(size_t i = first; i < last; i++)
+								rule.Nodes(batch[i], x + ((i - first) * points * dimension));
+							if(!integrands[worker]->Evaluate(x, fx, (last - first) * points)) {
+								failed = true;
+								return;
+							}
+						} catch(std::exception& ex) {
+							// Nothing may escape a worker thread
+							std::cerr << "Error: " << ex.what() << std::endl;
+							failed = true;
+							return;
+						}
+						for(size_t i = first; i < last; i++)
+							rule.Estimate(batch[i], fx + ((i - first) * points));
+					};
+
+					long double total = 0.0L;
+					long double error = 0.0L;
+					result.evaluations = 0;
+					for(;;) {
+						nodes.resize(batch.size() * points * dimension);
+						values.resize(batch.size() * points);
+						workers.Run(estimate);
+						if(failed)
+							return false;
+						result.evaluations += batch.size() * points;
+						for(auto const& r : batch) {
+							total += r.value;
+							error += r.error;
+							heap.push_back(r);
+							std::push_heap(heap.begin(), heap.end(), ByError());
+						}
+						long double tolerance = std::max(options.absoluteTolerance, options.relativeTolerance * std::fabs(total));
+						if(error <= tolerance || !std::isfinite(total) || !std::isfinite(error))
+							break;
+						if(result.evaluations + (2 * points) > options.maxEvaluations)
+							break;
+						// Bisect the worst regions, but no more of them than it takes to get the rest within tolerance
+						size_t limit = std::min(workers.Size() * REGIONS_PER_WORKER, (options.maxEvaluations - result.evaluations) / (2 * points));
+						long double remaining = error;
+						batch.clear();
+						while(!heap.empty() && batch.size() < (2 * limit) && (batch.empty() || remaining > tolerance)) {
+							std::pop_heap(heap.begin(), heap.end(), ByError());
+							Region parent = heap.back();
+							heap.pop_back();
+							total -= parent.value;
+							error -= parent.error;
+							remaining -= parent.error;
+							Region lower = parent, upper = parent;
+							size_t axis = parent.axis;
+							lower.half[axis] = upper.half[axis] = parent.half[axis] * 0.5L;
+							lower.center[axis] = parent.center[axis] - lower.half[axis];
+							upper.center[axis] = parent.center[axis] + upper.half[axis];
+							batch.push_back(lower);
+							batch.push_back(upper);
+						}
+					}
+					// Sum again from scratch, the running totals have picked up rounding on the way
+					result.value = 0.0L;
+					result.error = 0.0L;
+					for(auto const& r : heap) {
+						result.value += r.value;
+						result.error += r.error;
+					}
+					result.converged = (result.error <= std::max(options.absoluteTolerance, options.relativeTolerance * std::fabs(result.value)));
+					return true;
+				}
+			}
+
+			Options::Options(void) : absoluteTolerance(DEFAULT_ABSOLUTE_TOLERANCE), relativeTolerance(DEFAULT_RELATIVE_TOLERANCE),
+				maxEvaluations(DEFAULT_MAX_EVALUATIONS), threads(0) {
+
+			}
+
+			bool Integrate(Integrand& f, const long double* lower, const long double* upper, size_t dimension, Options const& options, Result& result) {
+				if(dimension == 0 || dimension > MAX_DIMENSION)
+					return false;
+				Region box;
+				box.value = 0.0L;
+				box.error = 0.0L;
+				box.axis = 0;
+				bool empty = false;
+				for(size_t i = 0; i < dimension; i++) {
+					box.center[i] = (lower[i] + upper[i]) * 0.5L;
+					box.half[i] = (upper[i] - lower[i]) * 0.5L;
+					empty = empty || (box.half[i] == 0.0L);
+				}
+				if(empty) {
+					result.value = 0.0L;
+					result.error = 0.0L;
+					result.evaluations = 0;
+					result.converged = true;
+					return true;
+				}
+
+				std::vector<std::unique_ptr<Integrand>> forks;
+				std::vector<Integrand*> integrands = f.ForkWorkers(WorkerPool::Workers(options.threads), forks);
+				WorkerPool workers(integrands.size());
+				if(dimension == 1)
+					return Adapt(Kronrod(), integrands, workers, dimension, box, options, result);
+				return Adapt(GenzMalik(dimension), integrands, workers, dimension, box, options, result);
+			}
+		}
+	}
+}
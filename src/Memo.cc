@@ -0,0 +1,200 @@
+/*
+	Memo.cc - Result cache for pure SML functions
+*/
+#include "core/lang/Memo.hh"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "core/lang/Function.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace {
+				// Bytes of a long double that hold the number, the x87 format leaves the rest of it undefined
+				const size_t LONG_DOUBLE_BYTES = (std::numeric_limits<long double>::digits == 64) ? 10 : sizeof(long double);
+				const size_t QUAD_BYTES = std::is_same<mtquad_t, long double>::value ? LONG_DOUBLE_BYTES : sizeof(mtquad_t);
+
+				inline void Append(std::string& key, void const* bytes, size_t n) {
+					key.append(static_cast<const char*>(bytes), n);
+				}
+
+				/*
+					Writes the arguments into key, false if one of them is not an inline number
+				*/
+				bool Encode(Value const* args, size_t count, std::string& key) {
+					key.clear();
+					for(size_t i = 0; i < count; i++) {
+						Value const& v = args[i];
+						if(!v.IsInline())
+							return false;
+						key += static_cast<char>(v.type);
+						key += static_cast<char>(v.precision);
+						if(v.IsExact()) {
+							Append(key, v.i, sizeof(v.i));
+							continue;
+						}
+						const int parts = (v.type == TYPE::COMPLEX) ? 2 : 1;
+						for(int part = 0; part < parts; part++) {
+							switch(v.precision) {
+								case PRECISION::DOUBLE:
+									Append(key, &v.d[part], sizeof(double));
+									break;
+								case PRECISION::EXTENDED:
+									Append(key, &v.e[part], LONG_DOUBLE_BYTES);
+									break;
+								default:
+									Append(key, &v.q[part], QUAD_BYTES);
+									break;
+							}
+						}
+					}
+					return true;
+				}
+
+				class Purity {
+				private:
+					SymbolTable const& globals;
+					// Functions being checked are taken to be pure, so recursion does not loop
+					std::vector<NFunctionDeclaration const*> seen;
+
+					bool Name(Symbol symbol) {
+						// Locals that shadow a global function are checked as that function, which is only ever stricter
+						Value const* v = this->globals.Find(symbol);
+						return v == nullptr || v->type != TYPE::FUNCTION || this->Body(static_cast<Function*>(v->object)->declaration);
+					}
+
+					bool Expression(NExpression const* expr) {
+						switch(expr->type) {
+							case _NINTEGER:
+							case _NSCALAR:
+							case _NCOMPLEX:
+								return true;
+							case _NIDENTIFIER:
+								return this->Name(static_cast<NIdentifier const*>(expr)->_symbol);
+							case _NASSIGNMENT:
+								// Assignments in a body only ever bind locals
+								return this->Expression(static_cast<NAssignment const*>(expr)->_rhs);
+							case _NBINARYOPERATOR: {
+								auto nbin = static_cast<NBinaryOperator const*>(expr);
+								return this->Expression(nbin->_lhs) && this->Expression(nbin->_rhs);
+							} case _NMETHODCALL: {
+								auto ncall = static_cast<NMethodCall const*>(expr);
+								if(ncall->_builtin != nullptr ? !ncall->_builtin->pure : !this->Name(ncall->_id._symbol))
+									return false;
+								for(auto arg : ncall->_arguments) {
+									if(!this->Expression(arg))
+										return false;
+								}
+								return true;
+							} default:
+								return false;
+						}
+					}
+				public:
+					explicit Purity(SymbolTable const& gst) : globals(gst) { }
+
+					bool Body(NFunctionDeclaration const& decl) {
+						if(std::find(this->seen.begin(), this->seen.end(), &decl) != this->seen.end())
+							return true;
+						this->seen.push_back(&decl);
+						for(auto statement : decl._block.statements) {
+							switch(statement->type) {
+								case _NVARIABLEDECLARATION: {
+									auto vardec = static_cast<NVariableDeclaration const*>(statement);
+									if(!this->Expression(vardec->_assignmentExpr != nullptr ? vardec->_assignmentExpr : &vardec->_id))
+										return false;
+									break;
+								} case _NEXPRESSIONSTATEMENT:
+									if(!this->Expression(static_cast<NExpressionStatement const*>(statement)->_expression))
+										return false;
+									break;
+								case _NRETURNSTATEMENT:
+									if(!this->Expression(static_cast<NReturnStatement const*>(statement)->_expression))
+										return false;
+									break;
+								default:
+									// Functions defined in a body are new objects on every call
+									return false;
+							}
+						}
+						return true;
+					}
+				};
+			}
+
+			Memo::Memo(size_t cap) : capacity(cap), hits(0), misses(0), skipped(0), purity(UNKNOWN) {
+
+			}
+
+			bool Memo::Find(Value const* args, size_t count, Value& result) {
+				if(!Encode(args, count, this->key)) {
+					this->skipped++;
+					return false;
+				}
+				auto it = this->index.find(this->key);
+				if(it == this->index.end()) {
+					this->misses++;
+					return false;
+				}
+				this->hits++;
+				this->entries.splice(this->entries.begin(), this->entries, it->second);
+				result = it->second->result;
+				return true;
+			}
+
+			void Memo::Store(Value const* args, size_t count, Value const& result) {
+				// The callee may have been this function too, so the key from Find is gone
+				if(this->capacity == 0 || !result.IsInline() || !Encode(args, count, this->key) || this->index.count(this->key) != 0)
+					return;
+				if(this->entries.size() == this->capacity) {
+					this->index.erase(this->entries.back().key);
+					this->entries.pop_back();
+				}
+				this->entries.push_front(Entry{ this->key, result });
+				this->index.emplace(this->key, this->entries.begin());
+			}
+
+			void Memo::Clear(void) {
+				this->entries.clear();
+				this->index.clear();
+				this->purity = UNKNOWN;
+			}
+
+			void Memo::SetCapacity(size_t cap) {
+				this->capacity = cap;
+				while(this->entries.size() > this->capacity) {
+					this->index.erase(this->entries.back().key);
+					this->entries.pop_back();
+				}
+			}
+
+			size_t Memo::GetCapacity(void) const {
+				return this->capacity;
+			}
+
+			size_t Memo::Size(void) const {
+				return this->entries.size();
+			}
+
+			unsigned long long Memo::GetHits(void) const {
+				return this->hits;
+			}
+
+			unsigned long long Memo::GetMisses(void) const {
+				return this->misses;
+			}
+
+			unsigned long long Memo::GetSkipped(void) const {
+				return this->skipped;
+			}
+
+			bool Memo::Pure(NFunctionDeclaration const& decl, SymbolTable const& globals) {
+				return Purity(globals).Body(decl);
+			}
+		}
+	}
+}
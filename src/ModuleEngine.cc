@@ -113,8 +113,27 @@ namespace Mt {
 				// Tell us to unload the module by name
 				this->UnloadModule(mod.first);
 			}
+			for(auto& object : this->Objects)
+				dlclose(object.second);
+			this->Objects.clear();
 			return true;
 		}
+
+		void* ModuleEngine::LoadSymbol(std::string const& path, std::string const& symbol) {
+			auto it = this->Objects.find(path);
+			if(it == this->Objects.end()) {
+				M_HANDLE handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+				if(!handle) {
+					std::cout << "Error loading '" << path << "'. " << dlerror() << std::endl;
+					return nullptr;
+				}
+				it = this->Objects.emplace(path, handle).first;
+			}
+			void* address = dlsym(it->second, symbol.c_str());
+			if(address == nullptr)
+				std::cout << "Error: '" << path << "' has no symbol '" << symbol << "'" << std::endl;
+			return address;
+		}
 #elif defined(_WIN32) // Windows implementation 
 		bool ModuleEngine::LoadModule(std::string module) {
 #if defined(DEBUG) | defined(_DEBUG)
@@ -189,8 +208,27 @@ namespace Mt {
 			for(auto& mod : this->Modules) {
 				this->UnloadModule(mod.first);
 			}
+			for(auto& object : this->Objects)
+				FreeLibrary(object.second);
+			this->Objects.clear();
 			return true;
 		}
+
+		void* ModuleEngine::LoadSymbol(std::string const& path, std::string const& symbol) {
+			auto it = this->Objects.find(path);
+			if(it == this->Objects.end()) {
+				M_HANDLE handle = LoadLibrary(path.c_str());
+				if(!handle) {
+					std::cout << "Error loading '" << path << "'" << std::endl;
+					return nullptr;
+				}
+				it = this->Objects.emplace(path, handle).first;
+			}
+			void* address = reinterpret_cast<void*>(GetProcAddress(it->second, symbol.c_str()));
+			if(address == nullptr)
+				std::cout << "Error: '" << path << "' has no symbol '" << symbol << "'" << std::endl;
+			return address;
+		}
 #endif
 
 
@@ -68,8 +68,14 @@ auto main(int argc, char* argv[], char* env[]) -> int {
 		// TODO: RE-ENABLE
 		// Define a new REPL
 		Mt::frontend::REPL repl;
-		// Start the REPL up.
-		repl.Start();
+		if(Mt::core::Config::GetInstance()->ArgHasValue("run")) {
+			// Run the file through it and quit, no prompt
+			if(!repl.Run(Mt::core::Config::GetInstance()->GetArgValue("run")))
+				std::cerr << "Error: Unable to read '" << Mt::core::Config::GetInstance()->GetArgValue("run") << "'" << std::endl;
+		} else {
+			// Start the REPL up.
+			repl.Start();
+		}
 	}
 	// Assuming we reach this point naturally, lets use our one unified exit point.
 	Term(SIGTERM);
@@ -0,0 +1,613 @@
+/*
+	Native.cc - Compiles hot SML functions to native code through the host compiler
+*/
+#include "core/lang/Native.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "core/CoreMath.hh"
+#include "core/ModuleEngine.hh"
+#include "core/lang/Arithmetic.hh"
+
+using Mt::objects::Scalar;
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace Native {
+				namespace {
+					// Kernels are built like this, the floats have to round exactly as they do in Mt
+					const char* const FLAGS = "-std=c++11 -O2 -ffp-contract=off -fno-fast-math -shared -fPIC";
+					const char* const ENTRY = "MtNativeKernel";
+					// Integer powers pow does by squaring, as Mt::core::lang::Builtins does
+					const int64_t SQUARING_POW_LIMIT = 32;
+					const int64_t EXACT_POW_LIMIT = 4096;
+					// Bits of a signature below the complex argument flags
+					const unsigned TIER_BITS = 2;
+
+					long double HostSin(long double x) {
+						return static_cast<long double>(CoreMath::Sin(Scalar(static_cast<mtfloat_t>(x))).GetInternal());
+					}
+
+					long double HostSqrt(long double x) {
+						return static_cast<long double>(CoreMath::Sqrt(Scalar(static_cast<mtfloat_t>(x))).GetInternal());
+					}
+
+					long double HostPow(long double x, long double p) {
+						return static_cast<long double>(CoreMath::Pow(Scalar(static_cast<mtfloat_t>(x)), Scalar(static_cast<mtfloat_t>(p))).GetInternal());
+					}
+
+					long double HostNrt(long double x, long double r) {
+						return static_cast<long double>(CoreMath::Nrt(Scalar(static_cast<mtfloat_t>(x)), Scalar(static_cast<mtfloat_t>(r))).GetInternal());
+					}
+
+					const Host HOST = { &HostSin, &HostSqrt, &HostPow, &HostNrt };
+
+					/*
+						Kernels of Mt::core::lang::Arithmetic for complex numbers, written out the same way so
+						the generated code rounds the same way
+					*/
+					const char* const PRELUDE =
+						"#include <cmath>\n"
+						"#include <cstdint>\n"
+						"\n"
+						"namespace {\n"
+						"\tstruct Host {\n"
+						"\t\tlong double (*sin)(long double);\n"
+						"\t\tlong double (*sqrt)(long double);\n"
+						"\t\tlong double (*pow)(long double, long double);\n"
+						"\t\tlong double (*nrt)(long double, long double);\n"
+						"\t};\n"
+						"\n"
+						"\tinline void Add(F a, F b, F c, F d, F& re, F& im) {\n"
+						"\t\tre = a + c;\n"
+						"\t\tim = b + d;\n"
+						"\t}\n"
+						"\n"
+						"\tinline void Subtract(F a, F b, F c, F d, F& re, F& im) {\n"
+						"\t\tre = a - c;\n"
+						"\t\tim = b - d;\n"
+						"\t}\n"
+						"\n"
+						"\tinline void Multiply(F a, F b, F c, F d, F& re, F& im) {\n"
+						"\t\tre = (a * c) - (b * d);\n"
+						"\t\tim = (a * d) + (b * c);\n"
+						"\t}\n"
+						"\n"
+						"\tinline void Divide(F a, F b, F c, F d, F& re, F& im) {\n"
+						"\t\tF denom = (c * c) + (d * d);\n"
+						"\t\tre = ((a * c) + (b * d)) / denom;\n"
+						"\t\tim = ((b * c) - (a * d)) / denom;\n"
+						"\t}\n"
+						"\n"
+						"\tinline F SquaringPow(F b, int64_t n) {\n"
+						"\t\tF result = 1;\n"
+						"\t\tfor(uint64_t e = (n < 0) ? static_cast<uint64_t>(-n) : static_cast<uint64_t>(n); e != 0; e >>= 1) {\n"
+						"\t\t\tif(e & 1)\n"
+						"\t\t\t\tresult *= b;\n"
+						"\t\t\tif(e > 1)\n"
+						"\t\t\t\tb *= b;\n"
+						"\t\t}\n"
+						"\t\treturn (n < 0) ? F(1) / result : result;\n"
+						"\t}\n"
+						"}\n"
+						"\n";
+
+					/*
+						64 bit FNV-1a, shared objects are named by the hash of their source
+					*/
+					uint64_t Hash(std::string const& text) {
+						uint64_t hash = 14695981039346656037ULL;
+						for(char c : text) {
+							hash ^= static_cast<unsigned char>(c);
+							hash *= 1099511628211ULL;
+						}
+						return hash;
+					}
+
+					/*
+						Stamp of a shared object, the hash of its bytes. Empty if it can not be read.
+					*/
+					std::string Stamp(std::string const& path) {
+						std::ifstream in(path, std::ios::binary);
+						if(!in.is_open())
+							return std::string();
+						const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+						char text[17];
+						std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(Hash(bytes)));
+						return text;
+					}
+
+					/*
+						True if nobody but the user can have written the file or directory, whatever is
+						loaded from there runs as the user. That goes for every directory above it too,
+						whoever can write to one of those can swap out what is below it. They have to be
+						the user's or root's, writable by others only if they are sticky like /tmp.
+					*/
+					bool Trusted(std::string const& path) {
+#if defined(_WIN32)
+						// Owners and ACLs are not checked here, so nothing already on disk is trusted
+						(void)path;
+						return false;
+#else
+						struct stat st;
+						if(stat(path.c_str(), &st) != 0 || st.st_uid != getuid() || (st.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+							return false;
+						char* resolved = realpath(path.c_str(), nullptr);
+						if(resolved == nullptr)
+							return false;
+						std::string above(resolved);
+						std::free(resolved);
+						for(size_t slash = above.rfind('/'); slash != std::string::npos; slash = above.rfind('/')) {
+							above.resize((slash == 0) ? 1 : slash);
+							if(stat(above.c_str(), &st) != 0 || (st.st_uid != getuid() && st.st_uid != 0))
+								return false;
+							if((st.st_mode & (S_IWGRP | S_IWOTH)) != 0 && (st.st_mode & S_ISVTX) == 0)
+								return false;
+							if(slash == 0)
+								break;
+						}
+						return true;
+#endif
+					}
+
+					/*
+						Creates the directory and any missing above it, writable by the user only
+					*/
+					void MakeDirectories(std::string const& path) {
+						for(size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+							const std::string part = path.substr(0, slash);
+#if defined(_WIN32)
+							_mkdir(part.c_str());
+#else
+							mkdir(part.c_str(), 0700);
+#endif
+							if(slash == std::string::npos)
+								break;
+						}
+					}
+
+					/*! \class Translator
+						\brief Lowers one specialization of a compiled body to C++
+
+						The body is a straight line, so the kind of every register after every instruction
+						is known. Exact numbers are never given a register of their own, arithmetic on
+						them is done here and they are rounded to the tier where a float meets them like
+						the dispatch table would.
+					*/
+					class Translator {
+					private:
+						enum KIND {
+							UNSET,
+							REAL,
+							COMPLEX,
+							EXACT,
+						};
+						Bytecode::Program const& program;
+						PRECISION tier;
+						// Exact results too big to be held inline
+						ObjectPool pool;
+						std::vector<KIND> kinds;
+						// The constant an EXACT register holds
+						std::vector<Value> exact;
+						std::string body;
+
+						/*
+							A float of the tier as a C++ literal, false if it has none
+						*/
+						bool Literal(Value const& v, int part, std::string& out) {
+							char text[64];
+							long double x = v.Get<long double>(part);
+							if(!std::isfinite(x))
+								return false;
+							if(this->tier == PRECISION::DOUBLE)
+								std::snprintf(text, sizeof(text), "%.17g", v.d[part]);
+							else
+								std::snprintf(text, sizeof(text), "%.21Lg", x);
+							out = text;
+							// Without a point -0 would be the integer zero
+							if(out.find_first_of(".e") == std::string::npos)
+								out += ".0";
+							if(this->tier != PRECISION::DOUBLE)
+								out += 'L';
+							out = "(" + out + ")";
+							return true;
+						}
+
+						/*
+							The real part of register r, or all of it, as an expression
+						*/
+						bool Real(uint16_t r, std::string& out) {
+							switch(this->kinds[r]) {
+								case REAL:
+								case COMPLEX:
+									out = "r" + std::to_string(r);
+									return true;
+								case EXACT:
+									return this->Literal(this->exact[r].ToScalar(this->tier), 0, out);
+								default:
+									return false;
+							}
+						}
+
+						bool Imaginary(uint16_t r, std::string& out) {
+							out = (this->kinds[r] == COMPLEX) ? ("i" + std::to_string(r)) : std::string("ZERO");
+							return true;
+						}
+
+						void Line(std::string const& line) {
+							this->body += '\t';
+							this->body += line;
+							this->body += '\n';
+						}
+
+						bool Binary(Bytecode::Instruction const& i) {
+							static const char* const SYMBOLS[] = { "+", "-", "*", "/" };
+							static const char* const KERNELS[] = { "Add", "Subtract", "Multiply", "Divide" };
+							const int op = i.op - Bytecode::ADD;
+							const KIND lhs = this->kinds[i.a];
+							const KIND rhs = this->kinds[i.b];
+							if(lhs == EXACT && rhs == EXACT) {
+								// The interpreter reports the division by zero
+								if(i.op == Bytecode::DIVIDE && this->exact[i.b].IsExactZero())
+									return false;
+								Value const& x = this->exact[i.a];
+								Value const& y = this->exact[i.b];
+								switch(i.op) {
+									case Bytecode::ADD:
+										this->exact[i.target] = Arithmetic::ApplyExact<Arithmetic::AddKernel>(x, y, this->pool);
+										break;
+									case Bytecode::SUBTRACT:
+										this->exact[i.target] = Arithmetic::ApplyExact<Arithmetic::MinusKernel>(x, y, this->pool);
+										break;
+									case Bytecode::MULTIPLY:
+										this->exact[i.target] = Arithmetic::ApplyExact<Arithmetic::MultiplyKernel>(x, y, this->pool);
+										break;
+									default:
+										this->exact[i.target] = Arithmetic::ApplyExact<Arithmetic::DivideKernel>(x, y, this->pool);
+										break;
+								}
+								this->kinds[i.target] = EXACT;
+								return true;
+							}
+							std::string a, b;
+							if(!this->Real(i.a, a) || !this->Real(i.b, b))
+								return false;
+							const std::string target = std::to_string(i.target);
+							if(lhs != COMPLEX && rhs != COMPLEX) {
+								this->Line("r" + target + " = " + a + " " + SYMBOLS[op] + " " + b + ";");
+								this->kinds[i.target] = REAL;
+								return true;
+							}
+							// A real meeting a complex number becomes one with a zero imaginary part
+							std::string c, d;
+							this->Imaginary(i.a, c);
+							this->Imaginary(i.b, d);
+							this->Line(std::string(KERNELS[op]) + "(" + a + ", " + c + ", " + b + ", " + d + ", re, im);");
+							this->Line("r" + target + " = re;");
+							this->Line("i" + target + " = im;");
+							this->kinds[i.target] = COMPLEX;
+							return true;
+						}
+
+						/*
+							Calls back into the host in mtfloat_t, the arguments are floats of the tier or exact
+							numbers rounded to it
+						*/
+						bool Host(Bytecode::Instruction const& i, std::string const& function) {
+							// Through long double the result would be rounded twice on the way to a double
+							if(!std::is_same<mtfloat_t, long double>::value && this->tier != PRECISION::EXTENDED)
+								return false;
+							std::string call = "r" + std::to_string(i.target) + " = static_cast<F>(host->" + function + "(";
+							for(uint16_t arg = 0; arg < i.count; arg++) {
+								std::string x;
+								if(this->kinds[i.a + arg] == COMPLEX || !this->Real(static_cast<uint16_t>(i.a + arg), x))
+									return false;
+								call += (arg != 0) ? ", " : "";
+								call += "static_cast<long double>(" + x + ")";
+							}
+							this->Line(call + "));");
+							this->kinds[i.target] = REAL;
+							return true;
+						}
+
+						bool Builtin(Bytecode::Instruction const& i) {
+							const std::string name = this->program.builtins[i.b]->name;
+							const std::string target = std::to_string(i.target);
+							const uint16_t x = i.a;
+							if(name == "abs") {
+								// The absolute value of an exact number stays exact, of a complex one it is the modulus
+								if(this->kinds[x] == REAL)
+									this->Line("r" + target + " = std::fabs(r" + std::to_string(x) + ");");
+								else if(this->kinds[x] == COMPLEX)
+									this->Line("r" + target + " = std::hypot(r" + std::to_string(x) + ", i" + std::to_string(x) + ");");
+								else
+									return false;
+								this->kinds[i.target] = REAL;
+								return true;
+							} else if(name == "sin" || name == "sqrt" || name == "nrt") {
+								return this->Host(i, name);
+							} else if(name == "pow") {
+								const uint16_t p = static_cast<uint16_t>(i.a + 1);
+								Value const& power = this->exact[p];
+								const bool integer = this->kinds[p] == EXACT && power.type == TYPE::INTEGER && !power.big;
+								if(this->kinds[x] == EXACT && integer && power.i[0] >= -EXACT_POW_LIMIT && power.i[0] <= EXACT_POW_LIMIT)
+									return false;
+								if(this->kinds[x] == REAL && integer && power.i[0] >= -SQUARING_POW_LIMIT && power.i[0] <= SQUARING_POW_LIMIT) {
+									this->Line("r" + target + " = SquaringPow(r" + std::to_string(x) + ", " + std::to_string(power.i[0]) + ");");
+									this->kinds[i.target] = REAL;
+									return true;
+								}
+								return this->Host(i, name);
+							}
+							return false;
+						}
+					public:
+						Translator(Bytecode::Program const& p, PRECISION t) : program(p), tier(t), kinds(p.registers, UNSET), exact(p.registers) { }
+
+						bool Body(std::string const& name, size_t arity, uint64_t signature, std::string& source, bool& complex) {
+							using namespace Bytecode;
+							const uint64_t flags = signature >> TIER_BITS;
+							size_t in = 0;
+							for(size_t arg = 0; arg < arity; arg++) {
+								const std::string r = std::to_string(arg);
+								this->Line("r" + r + " = a[" + std::to_string(in++) + "];");
+								this->kinds[arg] = REAL;
+								if(flags & (static_cast<uint64_t>(1) << arg)) {
+									this->Line("i" + r + " = a[" + std::to_string(in++) + "];");
+									this->kinds[arg] = COMPLEX;
+								}
+							}
+							for(Instruction const& i : this->program.code) {
+								const std::string target = std::to_string(i.target);
+								switch(i.op) {
+									case CONSTANT: {
+										Value const& k = this->program.constants[(i.a * TIERS) + this->tier];
+										std::string re, im;
+										if(k.IsExact()) {
+											this->exact[i.target] = k;
+											this->kinds[i.target] = EXACT;
+										} else if(k.IsFloat() && k.precision == this->tier && this->Literal(k, 0, re)) {
+											this->Line("r" + target + " = " + re + ";");
+											this->kinds[i.target] = REAL;
+											if(k.type == TYPE::COMPLEX) {
+												if(!this->Literal(k, 1, im))
+													return false;
+												this->Line("i" + target + " = " + im + ";");
+												this->kinds[i.target] = COMPLEX;
+											}
+										} else {
+											return false;
+										}
+										break;
+									} case MOVE:
+										if(this->kinds[i.a] == UNSET)
+											return false;
+										if(this->kinds[i.a] != EXACT)
+											this->Line("r" + target + " = r" + std::to_string(i.a) + ";");
+										if(this->kinds[i.a] == COMPLEX)
+											this->Line("i" + target + " = i" + std::to_string(i.a) + ";");
+										this->kinds[i.target] = this->kinds[i.a];
+										this->exact[i.target] = this->exact[i.a];
+										break;
+									case ADD:
+									case SUBTRACT:
+									case MULTIPLY:
+									case DIVIDE:
+										if(!this->Binary(i))
+											return false;
+										break;
+									case BUILTIN:
+										if(!this->Builtin(i))
+											return false;
+										break;
+									case RETURN: {
+										const KIND kind = this->kinds[i.a];
+										if(kind != REAL && kind != COMPLEX)
+											return false;
+										this->Line("y[0] = r" + std::to_string(i.a) + ";");
+										if(kind == COMPLEX)
+											this->Line("y[1] = i" + std::to_string(i.a) + ";");
+										complex = (kind == COMPLEX);
+										source = "// " + name + " for " + Precision::ToString(this->tier) + " arguments, generated by Mt\n";
+										source += (this->tier == PRECISION::DOUBLE) ? "typedef double F;\n" : "typedef long double F;\n";
+										source += PRELUDE;
+										source += "extern \"C\" void " + std::string(ENTRY) + "(const void* in, void* out, Host const* host) {\n";
+										source += "\tconst F* a = static_cast<const F*>(in);\n\tF* y = static_cast<F*>(out);\n";
+										source += "\tconst F ZERO = 0;\n\tF re, im;\n";
+										for(size_t r = 0; r < this->program.registers; r++)
+											source += "\tF r" + std::to_string(r) + " = 0, i" + std::to_string(r) + " = 0;\n";
+										source += this->body;
+										source += "\t(void)host;\n\t(void)ZERO;\n\t(void)re;\n\t(void)im;\n}\n";
+										return true;
+									} default:
+										// Globals and calls to other SML functions
+										return false;
+								}
+							}
+							return false;
+						}
+					};
+
+					template <class F>
+					Value RunTier(Kernel const& kernel, Value const* args, size_t count) {
+						F in[2 * Builtins::MAX_ARITY];
+						F out[2];
+						size_t n = 0;
+						for(size_t i = 0; i < count; i++) {
+							in[n++] = args[i].Get<F>(0);
+							if(args[i].type == TYPE::COMPLEX)
+								in[n++] = args[i].Get<F>(1);
+						}
+						kernel.entry(in, out, &HOST);
+						return kernel.complex ? Value::MakeComplex(out[0], out[1]) : Value::MakeScalar(out[0]);
+					}
+				}
+
+				Value Kernel::Run(Value const* args, size_t count) const {
+					if(this->tier == PRECISION::DOUBLE)
+						return RunTier<double>(*this, args, count);
+					return RunTier<long double>(*this, args, count);
+				}
+
+				bool Signature(Value const* args, size_t count, PRECISION tier, uint64_t& signature) {
+					if(tier != PRECISION::DOUBLE && tier != PRECISION::EXTENDED)
+						return false;
+					signature = static_cast<uint64_t>(tier);
+					for(size_t i = 0; i < count; i++) {
+						if(!args[i].IsFloat() || args[i].precision != tier)
+							return false;
+						if(args[i].type == TYPE::COMPLEX)
+							signature |= static_cast<uint64_t>(1) << (i + TIER_BITS);
+					}
+					return true;
+				}
+
+				bool Translate(Bytecode::Program const& program, std::string const& name, size_t arity, uint64_t signature, std::string& source, bool& complex) {
+					const PRECISION tier = static_cast<PRECISION>(signature & ((1u << TIER_BITS) - 1));
+					return Translator(program, tier).Body(name, arity, signature, source, complex);
+				}
+
+				Compiler::Compiler(std::string const& cxx, std::string const& dir) : command(cxx), directory(dir), claimed(false), built(0) {
+					if(!this->directory.empty())
+						return;
+#if defined(_WIN32)
+					const char* local = std::getenv("LOCALAPPDATA");
+					this->directory = (local != nullptr && local[0] != '\0') ? std::string(local) + "/mt/native" : "native";
+#else
+					const char* cache = std::getenv("XDG_CACHE_HOME");
+					const char* home = std::getenv("HOME");
+					if(cache != nullptr && cache[0] == '/')
+						this->directory = std::string(cache) + "/mt/native";
+					else if(home != nullptr && home[0] != '\0')
+						this->directory = std::string(home) + "/.cache/mt/native";
+					else
+						this->directory = "native";
+#endif
+				}
+
+				Kernel Compiler::Compile(Bytecode::Program const& program, std::string const& name, size_t arity, uint64_t signature) {
+					Kernel kernel{ nullptr, static_cast<PRECISION>(signature & ((1u << TIER_BITS) - 1)), false };
+					std::string source;
+					if(!Translate(program, name, arity, signature, source, kernel.complex))
+						return kernel;
+					const uint64_t hash = Hash(this->command + ' ' + FLAGS + '\n' + source);
+					{
+						std::unique_lock<std::mutex> guard(this->lock);
+						// A kernel another thread is building is waited for, not built twice
+						this->ready.wait(guard, [this, hash] { return this->building.count(hash) == 0; });
+						auto it = this->loaded.find(hash);
+						if(it != this->loaded.end()) {
+							kernel.entry = it->second;
+							return kernel;
+						}
+						if(!this->Claim()) {
+							std::cerr << "Warning: " << this->directory << " can be written by others, " << name << " stays on the bytecode machine" << std::endl;
+							this->loaded[hash] = nullptr;
+							return kernel;
+						}
+						this->building.insert(hash);
+					}
+					// Other threads get on with their calls while the host compiler runs
+					bool fresh = false;
+					const std::string object = this->Build(hash, name, source, fresh);
+					std::lock_guard<std::mutex> guard(this->lock);
+					if(!object.empty())
+						kernel.entry = reinterpret_cast<entry_t>(Mt::core::ModuleEngine::GetInstance()->LoadSymbol(object, ENTRY));
+					this->loaded[hash] = kernel.entry;
+					this->built += fresh ? 1 : 0;
+					this->building.erase(hash);
+					this->ready.notify_all();
+					return kernel;
+				}
+
+				bool Compiler::Claim(void) {
+					if(this->claimed)
+						return true;
+#if defined(_WIN32)
+					// Cached kernels are never loaded here, each session builds into a directory only it has made
+					MakeDirectories(this->directory);
+					for(unsigned attempt = 0; attempt < 64 && !this->claimed; attempt++) {
+						const std::string session = this->directory + "/" + std::to_string(_getpid()) + "-" + std::to_string(attempt);
+						if(_mkdir(session.c_str()) == 0) {
+							this->directory = session;
+							this->claimed = true;
+						}
+					}
+#else
+					MakeDirectories(this->directory);
+					this->claimed = Trusted(this->directory);
+#endif
+					return this->claimed;
+				}
+
+				std::string Compiler::Build(uint64_t hash, std::string const& name, std::string const& source, bool& fresh) {
+					char stem[17];
+					std::snprintf(stem, sizeof(stem), "%016llx", static_cast<unsigned long long>(hash));
+					const std::string path = this->directory + "/" + stem;
+					const std::string object = path + ".moe";
+					// A cached object is only loaded as the build that stamped it left it
+					std::string stamp;
+					std::getline(std::ifstream(path + ".stamp"), stamp);
+					if(Trusted(object) && !stamp.empty() && stamp == Stamp(object))
+						return object;
+#if defined(_WIN32)
+					const std::string partial = path + "." + std::to_string(_getpid());
+#else
+					const std::string partial = path + "." + std::to_string(getpid());
+#endif
+					// Everything is written under names of its own first, so a session that looks at the same time never loads half of it
+					std::ofstream(partial + ".cc") << source;
+					const std::string build = this->command + " " + FLAGS + " -o " + partial + ".moe " + partial + ".cc > " + partial + ".log 2>&1";
+					if(std::system(build.c_str()) != 0) {
+						std::cerr << "Warning: Could not compile " << name << " to native code, see " << partial << ".log" << std::endl;
+						std::remove((partial + ".cc").c_str());
+						std::remove((partial + ".moe").c_str());
+						return std::string();
+					}
+					std::ofstream(partial + ".stamp") << Stamp(partial + ".moe") << std::endl;
+					if(std::rename((partial + ".moe").c_str(), object.c_str()) != 0 || std::rename((partial + ".stamp").c_str(), (path + ".stamp").c_str()) != 0) {
+						std::cerr << "Warning: Could not move " << name << "'s native code to " << object << std::endl;
+						std::remove((partial + ".moe").c_str());
+						std::remove((partial + ".stamp").c_str());
+						std::remove((partial + ".cc").c_str());
+						std::remove((partial + ".log").c_str());
+						return std::string();
+					}
+					std::rename((partial + ".cc").c_str(), (path + ".cc").c_str());
+					std::remove((partial + ".log").c_str());
+					fresh = true;
+					return object;
+				}
+
+				size_t Compiler::GetLoaded(void) {
+					std::lock_guard<std::mutex> guard(this->lock);
+					size_t count = 0;
+					for(auto const& entry : this->loaded)
+						count += (entry.second != nullptr) ? 1 : 0;
+					return count;
+				}
+
+				size_t Compiler::GetBuilt(void) {
+					std::lock_guard<std::mutex> guard(this->lock);
+					return this->built;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,627 @@
+/*
+	NumberFormatter.cc - Shortest round trip float formatting for result output
+*/
+#include "core/NumberFormatter.hh"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using Mt::core::hpn::BigInt;
+using Mt::core::hpn::limb_t;
+using Mt::core::hpn::MulWide;
+
+namespace Mt {
+	namespace core {
+		namespace NumberFormatter {
+			namespace {
+				Style currentStyle;
+
+				// Significant digits kept, the multi-precision floats need more than binary128's 36
+#if defined(_MT_USE_LIB_HPN)
+				const int MAX_DIGITS = (mtfloat_t::DIGITS > 128) ? static_cast<int>((static_cast<int64_t>(mtfloat_t::DIGITS) * 30103) / 100000) + 3 : 48;
+#else
+				const int MAX_DIGITS = 48;
+#endif
+
+				/*
+					Shortest decimal form of a float, value = digits * 10^exponent
+				*/
+				struct DecimalDigits {
+					char digits[MAX_DIGITS];
+					int count;
+					int64_t exponent;
+					bool negative;
+				};
+
+				// e == 0 ? 1 : ceil(log2(5^e)), floor(log10(2^e)) and floor(log10(5^e)), exact for 0 <= e <= 32768
+				inline int32_t Pow5Bits(int32_t e) {
+					return static_cast<int32_t>(((static_cast<uint64_t>(e) * 163391164108059ull) >> 46) + 1);
+				}
+
+				inline int32_t Log10Pow2(int32_t e) {
+					return static_cast<int32_t>((static_cast<uint64_t>(e) * 169464822037455ull) >> 49);
+				}
+
+				inline int32_t Log10Pow5(int32_t e) {
+					return static_cast<int32_t>((static_cast<uint64_t>(e) * 196742565691928ull) >> 48);
+				}
+
+				/*
+					Copies the low n 64 bit words of a non negative BigInt
+				*/
+				void ToWords(BigInt const& v, uint64_t* w, size_t n) {
+					std::vector<limb_t> const& m = v.Magnitude();
+					for(size_t i = 0; i < n; i++) {
+						uint64_t lo = (2 * i < m.size()) ? m[2 * i] : 0;
+						uint64_t hi = (2 * i + 1 < m.size()) ? m[2 * i + 1] : 0;
+						w[i] = lo | (hi << 32);
+					}
+				}
+
+				/*
+					The two Ryu tables for a given precision, 5^i truncated to Bits bits and
+					2^(ceil(log2(5^i)) - 1 + Bits) / 5^i rounded up, built from BigInt on first use
+				*/
+				template <int Bits, size_t Words>
+				class Pow5Table {
+					private:
+						std::vector<uint64_t> positive;
+						std::vector<uint64_t> inverse;
+					public:
+						static const int BITCOUNT = Bits;
+
+						Pow5Table(size_t size) : positive(size * Words, 0), inverse(size * Words, 0) {
+							BigInt p(1);
+							for(size_t i = 0; i < size; i++) {
+								int64_t len = static_cast<int64_t>(p.BitLength());
+								int64_t shift = len - Bits;
+								ToWords((shift >= 0) ? p.ShiftRight(static_cast<size_t>(shift)) : p.ShiftLeft(static_cast<size_t>(-shift)), &this->positive[i * Words], Words);
+								ToWords((BigInt(1).ShiftLeft(static_cast<size_t>(len - 1 + Bits)) / p) + BigInt(1), &this->inverse[i * Words], Words);
+								p = p * BigInt(5);
+							}
+						}
+
+						const uint64_t* Positive(int32_t i) const {
+							return &this->positive[static_cast<size_t>(i) * Words];
+						}
+
+						const uint64_t* Inverse(int32_t i) const {
+							return &this->inverse[static_cast<size_t>(i) * Words];
+						}
+				};
+
+				/*
+					Ryu over 64 bit mantissas with 125 bit tables, enough for double
+				*/
+				struct Narrow {
+					typedef uint64_t uint_type;
+					typedef Pow5Table<125, 2> table_type;
+
+					static table_type const& Table(void) {
+						// Covers every exponent a double can have
+						static const table_type table(342);
+						return table;
+					}
+
+					/*
+						(m * mul) >> j with mul two words, j >= 64
+					*/
+					static uint64_t MulShift(uint64_t m, const uint64_t* mul, int32_t j) {
+						uint64_t b0hi, b0lo, b2hi, b2lo;
+						MulWide(m, mul[0], b0hi, b0lo);
+						MulWide(m, mul[1], b2hi, b2lo);
+						uint64_t w1 = b0hi + b2lo;
+						uint64_t w2 = b2hi + ((w1 < b0hi) ? 1 : 0);
+						int32_t s = j - 64;
+						if(s == 0)
+							return w1;
+						if(s < 64)
+							return (w1 >> s) | (w2 << (64 - s));
+						return w2 >> (s - 64);
+					}
+				};
+
+#if defined(__SIZEOF_INT128__)
+				__extension__ typedef unsigned __int128 uint128_t;
+
+				/*
+					Ryu over 128 bit mantissas with 249 bit tables, enough for x87 extended and binary128
+				*/
+				struct Wide {
+					typedef uint128_t uint_type;
+					typedef Pow5Table<249, 4> table_type;
+
+					static table_type const& Table(void) {
+						// Covers every exponent of a 15 bit exponent format, about 300KiB
+						static const table_type table(4970);
+						return table;
+					}
+
+					/*
+						(m * mul) >> j with mul four words, j > 128
+					*/
+					static uint128_t MulShift(uint128_t m, const uint64_t* mul, int32_t j) {
+						uint64_t a[2] = { static_cast<uint64_t>(m), static_cast<uint64_t>(m >> 64) };
+						uint64_t p[6] = { 0, 0, 0, 0, 0, 0 };
+						for(int i = 0; i < 2; i++) {
+							uint64_t carry = 0;
+							for(int k = 0; k < 4; k++) {
+								uint128_t t = static_cast<uint128_t>(a[i]) * mul[k] + p[i + k] + carry;
+								p[i + k] = static_cast<uint64_t>(t);
+								carry = static_cast<uint64_t>(t >> 64);
+							}
+							p[i + 4] = carry;
+						}
+						int32_t word = j / 64;
+						int32_t bit = j % 64;
+						uint64_t r[2];
+						for(int i = 0; i < 2; i++) {
+							uint64_t lo = (word + i < 6) ? p[word + i] : 0;
+							uint64_t hi = (word + i + 1 < 6) ? p[word + i + 1] : 0;
+							r[i] = (bit == 0) ? lo : ((lo >> bit) | (hi << (64 - bit)));
+						}
+						return (static_cast<uint128_t>(r[1]) << 64) | r[0];
+					}
+				};
+#endif
+
+				/*
+					v / d for small constant divisors, the 128 bit version does long division on 32 bit
+					pieces because a plain 128 bit divide is a slow library call
+				*/
+				inline uint64_t DivBy(uint64_t v, uint32_t d) {
+					return v / d;
+				}
+
+#if defined(__SIZEOF_INT128__)
+				inline uint128_t DivBy(uint128_t v, uint32_t d) {
+					uint64_t hi = static_cast<uint64_t>(v >> 64);
+					uint64_t lo = static_cast<uint64_t>(v);
+					if(hi == 0)
+						return lo / d;
+					uint64_t limbs[4] = { lo & 0xFFFFFFFFull, lo >> 32, hi & 0xFFFFFFFFull, hi >> 32 };
+					uint64_t r = 0;
+					for(int i = 3; i >= 0; i--) {
+						uint64_t cur = (r << 32) | limbs[i];
+						limbs[i] = cur / d;
+						r = cur % d;
+					}
+					return (static_cast<uint128_t>((limbs[3] << 32) | limbs[2]) << 64) | ((limbs[1] << 32) | limbs[0]);
+				}
+#endif
+
+				template <class U>
+				inline bool MultipleOfPowerOf5(U value, int32_t p) {
+					int32_t count = 0;
+					for(; value != 0 && count < p; count++) {
+						U div = DivBy(value, 5);
+						if(value - (div * 5) != 0)
+							break;
+						value = div;
+					}
+					return count >= p;
+				}
+
+				template <class U>
+				inline bool MultipleOfPowerOf2(U value, int32_t p) {
+					return (value & ((static_cast<U>(1) << p) - 1)) == 0;
+				}
+
+				/*
+					Ryu (Adams, PLDI 2018). The value is m2 * 2^e2, mmShift is false only when the gap
+					to the next float below is half the gap above (m2 is an exact power of two above the
+					smallest normal). Produces the shortest output * 10^e10 that rounds back to the value,
+					closest to it when there is a choice.
+				*/
+				template <class R>
+				void Ryu(typename R::uint_type m2, int32_t e2, bool mmShift, typename R::uint_type& output, int32_t& e10) {
+					typedef typename R::uint_type U;
+					const int32_t UBITS = static_cast<int32_t>(sizeof(U) * 8);
+					const int32_t BITCOUNT = R::table_type::BITCOUNT;
+					e2 -= 2;
+					const bool acceptBounds = (m2 & 1) == 0;
+					const U mv = 4 * m2;
+					const U mmOffset = mmShift ? 2 : 1;
+					U vr, vp, vm;
+					bool vmIsTrailingZeros = false;
+					bool vrIsTrailingZeros = false;
+					if(e2 >= 0) {
+						const int32_t q = Log10Pow2(e2) - ((e2 > 3) ? 1 : 0);
+						e10 = q;
+						const int32_t k = BITCOUNT + Pow5Bits(q) - 1;
+						const int32_t i = -e2 + q + k;
+						const uint64_t* pow5 = R::Table().Inverse(q);
+						vr = R::MulShift(mv, pow5, i);
+						vp = R::MulShift(mv + 2, pow5, i);
+						vm = R::MulShift(mv - mmOffset, pow5, i);
+						// Only one of mp, mv and mm can be a multiple of 5, if any
+						if(q <= UBITS / 2) {
+							if(mv - (DivBy(mv, 5) * 5) == 0)
+								vrIsTrailingZeros = MultipleOfPowerOf5(mv, q);
+							else if(acceptBounds)
+								vmIsTrailingZeros = MultipleOfPowerOf5(mv - mmOffset, q);
+							else
+								vp -= MultipleOfPowerOf5(mv + 2, q) ? 1 : 0;
+						}
+					} else {
+						const int32_t q = Log10Pow5(-e2) - ((-e2 > 1) ? 1 : 0);
+						e10 = q + e2;
+						const int32_t i = -e2 - q;
+						const int32_t k = Pow5Bits(i) - BITCOUNT;
+						const int32_t j = q - k;
+						const uint64_t* pow5 = R::Table().Positive(i);
+						vr = R::MulShift(mv, pow5, j);
+						vp = R::MulShift(mv + 2, pow5, j);
+						vm = R::MulShift(mv - mmOffset, pow5, j);
+						if(q <= 1) {
+							// mv has at least 2 trailing zero bits, so vr is exact
+							vrIsTrailingZeros = true;
+							if(acceptBounds)
+								vmIsTrailingZeros = mmShift;
+							else
+								--vp;
+						} else if(q < UBITS - 1) {
+							vrIsTrailingZeros = MultipleOfPowerOf2(mv, q);
+						}
+					}
+					// Drop digits while the interval still contains more than one candidate
+					int32_t removed = 0;
+					int lastRemovedDigit = 0;
+					if(vmIsTrailingZeros || vrIsTrailingZeros) {
+						for(;;) {
+							const U vpDiv10 = DivBy(vp, 10);
+							const U vmDiv10 = DivBy(vm, 10);
+							if(vpDiv10 <= vmDiv10)
+								break;
+							const int vmMod10 = static_cast<int>(vm - vmDiv10 * 10);
+							const U vrDiv10 = DivBy(vr, 10);
+							const int vrMod10 = static_cast<int>(vr - vrDiv10 * 10);
+							vmIsTrailingZeros &= (vmMod10 == 0);
+							vrIsTrailingZeros &= (lastRemovedDigit == 0);
+							lastRemovedDigit = vrMod10;
+							vr = vrDiv10;
+							vp = vpDiv10;
+							vm = vmDiv10;
+							removed++;
+						}
+						if(vmIsTrailingZeros) {
+							for(;;) {
+								const U vmDiv10 = DivBy(vm, 10);
+								const int vmMod10 = static_cast<int>(vm - vmDiv10 * 10);
+								if(vmMod10 != 0)
+									break;
+								const U vrDiv10 = DivBy(vr, 10);
+								const int vrMod10 = static_cast<int>(vr - vrDiv10 * 10);
+								vrIsTrailingZeros &= (lastRemovedDigit == 0);
+								lastRemovedDigit = vrMod10;
+								vr = vrDiv10;
+								vp = DivBy(vp, 10);
+								vm = vmDiv10;
+								removed++;
+							}
+						}
+						// Exactly halfway, round to even
+						if(vrIsTrailingZeros && lastRemovedDigit == 5 && (vr & 1) == 0)
+							lastRemovedDigit = 4;
+						output = vr + ((((vr == vm) && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5) ? 1 : 0);
+					} else {
+						// The common case, no exact ties to worry about
+						bool roundUp = false;
+						for(;;) {
+							const U vpDiv10 = DivBy(vp, 10);
+							const U vmDiv10 = DivBy(vm, 10);
+							if(vpDiv10 <= vmDiv10)
+								break;
+							const U vrDiv10 = DivBy(vr, 10);
+							roundUp = (vr - vrDiv10 * 10) >= 5;
+							vr = vrDiv10;
+							vp = vpDiv10;
+							vm = vmDiv10;
+							removed++;
+						}
+						output = vr + (((vr == vm) || roundUp) ? 1 : 0);
+					}
+					e10 += removed;
+				}
+
+				/*
+					Writes the decimal digits of v into buf, returns the count
+				*/
+				int WriteDigits(char* buf, uint64_t v) {
+					char tmp[20];
+					int n = 0;
+					do {
+						tmp[n++] = static_cast<char>('0' + (v % 10));
+						v /= 10;
+					} while(v != 0);
+					for(int i = 0; i < n; i++)
+						buf[i] = tmp[n - 1 - i];
+					return n;
+				}
+
+#if defined(__SIZEOF_INT128__)
+				int WriteDigits(char* buf, uint128_t v) {
+					if(v <= 0xFFFFFFFFFFFFFFFFull)
+						return WriteDigits(buf, static_cast<uint64_t>(v));
+					// Peel off 9 digits at a time until the rest fits a machine word
+					const uint32_t chunk = 1000000000;
+					uint128_t high = DivBy(v, chunk);
+					uint64_t low = static_cast<uint64_t>(v - (high * chunk));
+					int n = WriteDigits(buf, high);
+					for(int i = 8; i >= 0; i--) {
+						buf[n + i] = static_cast<char>('0' + (low % 10));
+						low /= 10;
+					}
+					return n + 9;
+				}
+#endif
+
+				/*
+					Appends the digits in the current notation
+				*/
+				void Layout(std::string& out, DecimalDigits const& d) {
+					if(d.negative)
+						out += '-';
+					int64_t sci = d.exponent + d.count - 1;
+					NOTATION n = currentStyle.notation;
+					if(n == NOTATION::GENERAL)
+						n = (sci >= -7 && sci < 21) ? NOTATION::FIXED : NOTATION::SCIENTIFIC;
+					if(n == NOTATION::SCIENTIFIC) {
+						out += d.digits[0];
+						if(d.count > 1) {
+							out += '.';
+							out.append(d.digits + 1, static_cast<size_t>(d.count - 1));
+						}
+						out += 'e';
+						out += (sci < 0) ? '-' : '+';
+						uint64_t mag = static_cast<uint64_t>((sci < 0) ? -sci : sci);
+						if(mag < 10)
+							out += '0';
+						char buf[20];
+						out.append(buf, static_cast<size_t>(WriteDigits(buf, mag)));
+					} else if(sci < 0) {
+						out += "0.";
+						out.append(static_cast<size_t>(-sci - 1), '0');
+						out.append(d.digits, static_cast<size_t>(d.count));
+					} else if(sci + 1 >= d.count) {
+						out.append(d.digits, static_cast<size_t>(d.count));
+						out.append(static_cast<size_t>(sci + 1 - d.count), '0');
+					} else {
+						out.append(d.digits, static_cast<size_t>(sci + 1));
+						out += '.';
+						out.append(d.digits + sci + 1, static_cast<size_t>(d.count - sci - 1));
+					}
+				}
+
+				/*
+					Handles zero, infinity and NaN, returns false for finite non zero values
+				*/
+				template <class F>
+				bool AppendSpecial(std::string& out, F value) {
+					if(value != value) {
+						out += "nan";
+						return true;
+					}
+					if(value - value != value - value) {
+						out += (value < 0) ? "-inf" : "inf";
+						return true;
+					}
+					if(value == 0) {
+						DecimalDigits d;
+						d.digits[0] = '0';
+						d.count = 1;
+						d.exponent = 0;
+						d.negative = (static_cast<F>(1) / value) < 0;
+						Layout(out, d);
+						return true;
+					}
+					return false;
+				}
+
+				template <class R>
+				void AppendRyu(std::string& out, typename R::uint_type m2, int32_t e2, bool mmShift, bool negative) {
+					typename R::uint_type output;
+					int32_t e10;
+					Ryu<R>(m2, e2, mmShift, output, e10);
+					DecimalDigits d;
+					d.count = WriteDigits(d.digits, output);
+					d.exponent = e10;
+					d.negative = negative;
+					Layout(out, d);
+				}
+
+#if defined(__SIZEOF_INT128__)
+				/*
+					Splits a finite non zero value into m2 * 2^e2 with m2 below 2^digits, using only
+					frexp and ldexp so it works for any long double layout
+				*/
+				void Decompose(long double value, int digits, int minExponent, uint128_t& m2, int32_t& e2, bool& mmShift) {
+					int exp;
+					long double frac = std::frexp(std::fabs(value), &exp);
+					// Take the mantissa in two exact pieces in case it is wider than 64 bits
+					long double top = std::ldexp(frac, 64);
+					uint64_t hi = static_cast<uint64_t>(top);
+					int rest = digits - 64;
+					m2 = hi;
+					if(rest > 0) {
+						long double low = std::ldexp(top - static_cast<long double>(hi), rest);
+						m2 = (m2 << rest) | static_cast<uint64_t>(low);
+					} else {
+						m2 >>= -rest;
+					}
+					e2 = exp - digits;
+					if(exp < minExponent) {
+						// Subnormal, the spacing is fixed at the minimum exponent
+						m2 >>= (minExponent - exp);
+						e2 += (minExponent - exp);
+					}
+					mmShift = (m2 != (static_cast<uint128_t>(1) << (digits - 1))) || (exp <= minExponent);
+				}
+#endif
+			}
+
+			Style const& GetStyle(void) {
+				return currentStyle;
+			}
+
+			void SetStyle(Style const& style) {
+				currentStyle = style;
+			}
+
+			bool NotationFromString(std::string const& name, NOTATION& n) {
+				if(name == "scientific") {
+					n = NOTATION::SCIENTIFIC;
+				} else if(name == "fixed") {
+					n = NOTATION::FIXED;
+				} else if(name == "general") {
+					n = NOTATION::GENERAL;
+				} else {
+					return false;
+				}
+				return true;
+			}
+
+			bool AlignmentFromString(std::string const& name, ALIGNMENT& a) {
+				if(name == "left") {
+					a = ALIGNMENT::LEFT;
+				} else if(name == "right") {
+					a = ALIGNMENT::RIGHT;
+				} else {
+					return false;
+				}
+				return true;
+			}
+
+			void Append(std::string& out, double value) {
+				if(AppendSpecial(out, value))
+					return;
+				uint64_t bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				const uint64_t ieeeMantissa = bits & ((static_cast<uint64_t>(1) << 52) - 1);
+				const int32_t ieeeExponent = static_cast<int32_t>((bits >> 52) & 0x7FF);
+				uint64_t m2;
+				int32_t e2;
+				if(ieeeExponent == 0) {
+					m2 = ieeeMantissa;
+					e2 = 1 - 1023 - 52;
+				} else {
+					m2 = ieeeMantissa | (static_cast<uint64_t>(1) << 52);
+					e2 = ieeeExponent - 1023 - 52;
+				}
+				AppendRyu<Narrow>(out, m2, e2, (ieeeMantissa != 0) || (ieeeExponent <= 1), (bits >> 63) != 0);
+			}
+
+			void Append(std::string& out, long double value) {
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+				Append(out, static_cast<double>(value));
+#elif defined(__SIZEOF_INT128__)
+				if(AppendSpecial(out, value))
+					return;
+				uint128_t m2;
+				int32_t e2;
+				bool mmShift;
+				Decompose(value, LDBL_MANT_DIG, LDBL_MIN_EXP, m2, e2, mmShift);
+				AppendRyu<Wide>(out, m2, e2, mmShift, value < 0);
+#else
+				// Without 128 bit integers fall back to enough digits to round trip
+				char buf[64];
+				int n = std::snprintf(buf, sizeof(buf), "%.*Le", LDBL_DIG + 3, value);
+				AppendDecimalText(out, std::string(buf, static_cast<size_t>(n)));
+#endif
+			}
+
+#if defined(_MT_HAS_QUAD) && !defined(_MT_USE_LIB_HPN)
+			void Append(std::string& out, mtquad_t value) {
+				if(AppendSpecial(out, value))
+					return;
+				// IEEE binary128, 112 stored mantissa bits and a 15 bit exponent
+				uint64_t words[2];
+				std::memcpy(words, &value, sizeof(words));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+				uint64_t lo = words[1], hi = words[0];
+#else
+				uint64_t lo = words[0], hi = words[1];
+#endif
+				const uint128_t ieeeMantissa = (static_cast<uint128_t>(hi & ((static_cast<uint64_t>(1) << 48) - 1)) << 64) | lo;
+				const int32_t ieeeExponent = static_cast<int32_t>((hi >> 48) & 0x7FFF);
+				uint128_t m2;
+				int32_t e2;
+				if(ieeeExponent == 0) {
+					m2 = ieeeMantissa;
+					e2 = 1 - 16383 - 112;
+				} else {
+					m2 = ieeeMantissa | (static_cast<uint128_t>(1) << 112);
+					e2 = ieeeExponent - 16383 - 112;
+				}
+				AppendRyu<Wide>(out, m2, e2, (ieeeMantissa != 0) || (ieeeExponent <= 1), (hi >> 63) != 0);
+			}
+#endif
+
+			void AppendDecimalText(std::string& out, std::string const& text) {
+				DecimalDigits d;
+				d.count = 0;
+				d.exponent = 0;
+				d.negative = false;
+				size_t i = 0;
+				if(i < text.size() && (text[i] == '-' || text[i] == '+'))
+					d.negative = (text[i++] == '-');
+				int64_t fraction = 0;
+				bool point = false;
+				bool any = false;
+				for(; i < text.size(); i++) {
+					char c = text[i];
+					if(c == '.' && !point) {
+						point = true;
+						continue;
+					}
+					if(c < '0' || c > '9')
+						break;
+					any = true;
+					if(point)
+						fraction++;
+					// Leading zeros are dropped
+					if(d.count == 0 && c == '0')
+						continue;
+					// Anything past the buffer is beyond round trip precision, only its position matters
+					if(d.count == static_cast<int>(sizeof(d.digits))) {
+						fraction--;
+						continue;
+					}
+					d.digits[d.count++] = c;
+				}
+				if(!any) {
+					// inf, nan and anything else that is not a number
+					out += text;
+					return;
+				}
+				int64_t exp10 = 0;
+				if(i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+					exp10 = std::strtoll(text.c_str() + i + 1, nullptr, 10);
+				}
+				if(d.count == 0) {
+					d.digits[d.count++] = '0';
+					fraction = 0;
+					exp10 = 0;
+				}
+				while(d.count > 1 && d.digits[d.count - 1] == '0') {
+					d.count--;
+					fraction--;
+				}
+				d.exponent = exp10 - fraction;
+				Layout(out, d);
+			}
+
+			void AppendPadded(std::string& out, const char* text, size_t length, size_t width, ALIGNMENT alignment) {
+				size_t pad = (width > length) ? (width - length) : 0;
+				if(alignment == ALIGNMENT::RIGHT)
+					out.append(pad, ' ');
+				out.append(text, length);
+				if(alignment == ALIGNMENT::LEFT)
+					out.append(pad, ' ');
+			}
+		}
+	}
+}
@@ -0,0 +1,501 @@
+/*
+	NumberParser.cc - Exact decimal to binary conversion for numeric literals
+*/
+#include "core/NumberParser.hh"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "core/HPN.hh"
+
+using Mt::core::hpn::BigInt;
+using Mt::core::hpn::limb_t;
+using Mt::core::hpn::MulWide;
+
+namespace Mt {
+	namespace core {
+		namespace NumberParser {
+			namespace {
+				// Explicit exponents are saturated here, far past anything any float type can hold
+				const int64_t EXPONENT_LIMIT = static_cast<int64_t>(1) << 40;
+				// Range of the 128 bit power of five table used by Eisel-Lemire
+				const int64_t POW5_MIN = -342;
+				const int64_t POW5_MAX = 308;
+
+				inline bool IsDigit(char c) {
+					return c >= '0' && c <= '9';
+				}
+
+				inline int LeadingZeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+					return __builtin_clzll(x);
+#else
+					int n = 0;
+					while(!(x & 0x8000000000000000ull)) { x <<= 1; n++; }
+					return n;
+#endif
+				}
+
+				std::vector<BigInt> BuildSmallPowers5(void) {
+					std::vector<BigInt> table(1, BigInt(1));
+					for(int64_t k = 1; k <= -POW5_MIN; k++)
+						table.push_back(table.back() * BigInt(5));
+					return table;
+				}
+
+				/*
+					Returns 5^n, powers in the range of ordinary literals come from a table built on first
+					use, anything larger is computed into storage
+				*/
+				BigInt const& Pow5(int64_t n, BigInt& storage) {
+					static const std::vector<BigInt> table = BuildSmallPowers5();
+					if(n <= -POW5_MIN)
+						return table[static_cast<size_t>(n)];
+					BigInt result(1);
+					BigInt base(5);
+					while(n > 0) {
+						if(n & 1)
+							result = result * base;
+						n >>= 1;
+						if(n > 0)
+							base = base * base;
+					}
+					storage = result;
+					return storage;
+				}
+
+				/*
+					Splits a BigInt holding exactly 128 bits into two words
+				*/
+				void Split128(BigInt const& v, uint64_t& hi, uint64_t& lo) {
+					std::vector<limb_t> const& m = v.Magnitude();
+					lo = static_cast<uint64_t>(m[0]) | (static_cast<uint64_t>(m[1]) << 32);
+					hi = static_cast<uint64_t>(m[2]) | (static_cast<uint64_t>(m[3]) << 32);
+				}
+
+				/*
+					128 bit approximations of 5^q for q in [POW5_MIN, POW5_MAX], normalized so the top
+					bit is set. Positive powers are truncated, negative powers are 2^b / 5^-q rounded up
+					while that fits, exactly as the Eisel-Lemire error analysis expects.
+				*/
+				std::vector<uint64_t> BuildPowers5(void) {
+					std::vector<uint64_t> table(static_cast<size_t>(2 * (POW5_MAX - POW5_MIN + 1)));
+					BigInt storage;
+					for(int64_t q = POW5_MIN; q < 0; q++) {
+						BigInt const& power = Pow5(-q, storage);
+						int64_t z = static_cast<int64_t>(power.BitLength());
+						BigInt c;
+						if(q >= -27) {
+							c = (BigInt(1).ShiftLeft(static_cast<size_t>(z + 127)) / power) + BigInt(1);
+						} else {
+							c = (BigInt(1).ShiftLeft(static_cast<size_t>(2 * z + 128)) / power) + BigInt(1);
+							c = c.ShiftRight(c.BitLength() - 128);
+						}
+						size_t index = static_cast<size_t>(2 * (q - POW5_MIN));
+						Split128(c, table[index], table[index + 1]);
+					}
+					for(int64_t q = 0; q <= POW5_MAX; q++) {
+						BigInt const& p5 = Pow5(q, storage);
+						size_t len = p5.BitLength();
+						BigInt c = (len < 128) ? p5.ShiftLeft(128 - len) : p5.ShiftRight(len - 128);
+						size_t index = static_cast<size_t>(2 * (q - POW5_MIN));
+						Split128(c, table[index], table[index + 1]);
+					}
+					return table;
+				}
+
+				std::vector<uint64_t> const& Powers5(void) {
+					// Built on first use, about 10KiB
+					static const std::vector<uint64_t> table = BuildPowers5();
+					return table;
+				}
+
+				/*
+					Eisel-Lemire, w * 10^q correctly rounded to a double. Returns false in the rare
+					case where 128 bits of 5^q are not enough to decide the rounding.
+				*/
+				bool EiselLemire(uint64_t w, int64_t q, bool negative, double& out) {
+					const int MANTISSA_BITS = 52;
+					const int64_t MINIMUM_EXPONENT = -1023;
+					const int64_t INFINITE_POWER = 0x7FF;
+					uint64_t mantissa;
+					int64_t power2;
+					if(w == 0 || q < POW5_MIN) {
+						mantissa = 0;
+						power2 = 0;
+					} else if(q > POW5_MAX) {
+						mantissa = 0;
+						power2 = INFINITE_POWER;
+					} else {
+						int lz = LeadingZeros64(w);
+						w <<= lz;
+						std::vector<uint64_t> const& table = Powers5();
+						size_t index = static_cast<size_t>(2 * (q - POW5_MIN));
+						uint64_t hi, lo;
+						MulWide(w, table[index], hi, lo);
+						const uint64_t precisionMask = 0xFFFFFFFFFFFFFFFFull >> (MANTISSA_BITS + 3);
+						if((hi & precisionMask) == precisionMask) {
+							uint64_t hi2, lo2;
+							MulWide(w, table[index + 1], hi2, lo2);
+							lo += hi2;
+							if(hi2 > lo)
+								hi++;
+							if(lo == 0xFFFFFFFFFFFFFFFFull && (q < -27 || q > 55))
+								return false;
+						}
+						int upperbit = static_cast<int>(hi >> 63);
+						int shift = upperbit + 64 - MANTISSA_BITS - 3;
+						mantissa = hi >> shift;
+						// floor(q * log2(10)) in fixed point, + 63 for the normalization shift
+						int64_t scaled = (152170 + 65536) * q;
+						int64_t power = ((scaled >= 0) ? (scaled >> 16) : -((-scaled + 65535) >> 16)) + 63;
+						power2 = power + upperbit - lz - MINIMUM_EXPONENT;
+						if(power2 <= 0) {
+							// Subnormal, or zero if everything is below the minimum exponent
+							if(-power2 + 1 >= 64) {
+								mantissa = 0;
+								power2 = 0;
+							} else {
+								mantissa >>= -power2 + 1;
+								mantissa += (mantissa & 1);
+								mantissa >>= 1;
+								// Rounding may have carried us back into the normal range
+								power2 = (mantissa < (static_cast<uint64_t>(1) << MANTISSA_BITS)) ? 0 : 1;
+							}
+						} else {
+							// Exactly halfway between two doubles, round to even instead of up
+							if(lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == hi)
+								mantissa &= ~static_cast<uint64_t>(1);
+							mantissa += (mantissa & 1);
+							mantissa >>= 1;
+							if(mantissa >= (static_cast<uint64_t>(2) << MANTISSA_BITS)) {
+								mantissa = static_cast<uint64_t>(1) << MANTISSA_BITS;
+								power2++;
+							}
+							mantissa &= ~(static_cast<uint64_t>(1) << MANTISSA_BITS);
+							if(power2 >= INFINITE_POWER) {
+								power2 = INFINITE_POWER;
+								mantissa = 0;
+							}
+						}
+					}
+					uint64_t bits = mantissa | (static_cast<uint64_t>(power2) << MANTISSA_BITS) | (negative ? (static_cast<uint64_t>(1) << 63) : 0);
+					std::memcpy(&out, &bits, sizeof(out));
+					return true;
+				}
+
+				/*
+					Properties of each float type the conversions need
+				*/
+				template <class F>
+				struct FloatTraits;
+
+				template <>
+				struct FloatTraits<double> {
+					static const int digits = DBL_MANT_DIG;
+					static const int min_exponent = DBL_MIN_EXP;
+					static const int max_exponent10 = DBL_MAX_10_EXP + 1;
+					static const int min_exponent10 = DBL_MIN_10_EXP - DBL_DIG - 3;
+				};
+
+				template <>
+				struct FloatTraits<long double> {
+					static const int digits = LDBL_MANT_DIG;
+					static const int min_exponent = LDBL_MIN_EXP;
+					static const int max_exponent10 = LDBL_MAX_10_EXP + 1;
+					static const int min_exponent10 = LDBL_MIN_10_EXP - LDBL_DIG - 3;
+				};
+
+#if defined(_MT_HAS_QUAD) && !defined(_MT_USE_LIB_HPN)
+				// The FLT128_* macros live in quadmath.h, which Mt does not otherwise need
+				template <>
+				struct FloatTraits<mtquad_t> {
+					static const int digits = 113;
+					static const int min_exponent = -16381;
+					static const int max_exponent10 = 4932 + 1;
+					static const int min_exponent10 = -4931 - 33 - 3;
+				};
+#endif
+
+				// Multi-precision floats have a 64 bit exponent, literals are bounded well inside it
+				// to keep the power of five in the slow path a sensible size
+				template <int Bits>
+				struct FloatTraits<Mt::core::hpn::MPFloat<Bits>> {
+					static const int digits = Bits;
+					static const int min_exponent = INT_MIN / 2;
+					static const int max_exponent10 = 100000;
+					static const int min_exponent10 = -100000;
+				};
+
+				/*
+					Returns x * 2^e
+				*/
+				template <class F>
+				F ScaleB(F x, int64_t e) {
+					// Generic version for types without ldexp, steps of 2^32 are exact
+					const F up = static_cast<F>(4294967296.0);
+					const F down = static_cast<F>(1) / up;
+					for(; e >= 32; e -= 32)
+						x = x * up;
+					for(; e <= -32; e += 32)
+						x = x * down;
+					return (e >= 0) ? (x * static_cast<F>(static_cast<uint64_t>(1) << e)) : (x / static_cast<F>(static_cast<uint64_t>(1) << -e));
+				}
+
+				template <>
+				double ScaleB<double>(double x, int64_t e) {
+					return std::ldexp(x, static_cast<int>(std::max<int64_t>(std::min<int64_t>(e, INT_MAX), INT_MIN)));
+				}
+
+				template <>
+				long double ScaleB<long double>(long double x, int64_t e) {
+					return std::ldexp(x, static_cast<int>(std::max<int64_t>(std::min<int64_t>(e, INT_MAX), INT_MIN)));
+				}
+
+				/*
+					Rounds m * 2^e2 (plus a sticky bit below m) to the float type F
+				*/
+				template <class F>
+				struct Assembler {
+					static F Assemble(BigInt const& m, int64_t e2, bool sticky, bool negative) {
+						typedef FloatTraits<F> Traits;
+						int64_t len = static_cast<int64_t>(m.BitLength());
+						int64_t exp = len + e2;
+						// Subnormals have fewer mantissa bits available
+						int64_t avail = Traits::digits;
+						if(exp < Traits::min_exponent)
+							avail -= (Traits::min_exponent - exp);
+						int64_t drop = len - avail;
+						BigInt r(m);
+						if(drop > 0) {
+							if(drop > len) {
+								r = BigInt();
+							} else {
+								r = m.ShiftRight(static_cast<size_t>(drop));
+								bool half = m.ShiftRight(static_cast<size_t>(drop - 1)).IsOdd();
+								bool rest = sticky || (static_cast<int64_t>(m.TrailingZeroBits()) < drop - 1);
+								if(half && (rest || r.IsOdd()))
+									r = r + BigInt(1);
+							}
+							e2 += drop;
+						}
+						// r fits the mantissa now, so both of these are exact
+						F v = ScaleB<F>(r.ToFloat<F>(), e2);
+						return negative ? -v : v;
+					}
+				};
+
+				template <int Bits>
+				struct Assembler<Mt::core::hpn::MPFloat<Bits>> {
+					static Mt::core::hpn::MPFloat<Bits> Assemble(BigInt const& m, int64_t e2, bool sticky, bool negative) {
+						std::vector<limb_t> const& mag = m.Magnitude();
+						return Mt::core::hpn::MPFloat<Bits>::FromLimbs(mag.data(), mag.size(), e2, negative, sticky);
+					}
+				};
+
+				/*
+					Exact conversion through big integers, always correct
+				*/
+				template <class F>
+				F SlowPath(Decimal const& dec) {
+					typedef FloatTraits<F> Traits;
+					// The value is in [10^(mag10 - 1), 10^mag10)
+					int64_t mag10 = dec.count + dec.digitsExponent;
+					if(mag10 > Traits::max_exponent10)
+						return dec.negative ? -(static_cast<F>(1) / static_cast<F>(0)) : (static_cast<F>(1) / static_cast<F>(0));
+					if(mag10 < Traits::min_exponent10)
+						return dec.negative ? -static_cast<F>(0) : static_cast<F>(0);
+					BigInt n;
+					int64_t q;
+					if(dec.truncated) {
+						BigInt::FromString(dec.digits, n);
+						q = dec.digitsExponent;
+					} else {
+						limb_t w[2] = { static_cast<limb_t>(dec.mantissa), static_cast<limb_t>(dec.mantissa >> 32) };
+						n = BigInt::FromLimbs(w, 2, false);
+						q = dec.exponent;
+					}
+					BigInt m;
+					int64_t e2;
+					bool sticky = false;
+					if(q >= 0) {
+						// 10^q = 5^q * 2^q
+						BigInt storage;
+						m = n * Pow5(q, storage);
+						e2 = q;
+					} else {
+						// Long division with enough quotient bits to round, the remainder becomes the sticky bit
+						BigInt storage;
+						BigInt const& d = Pow5(-q, storage);
+						int64_t s = Traits::digits + 3 + static_cast<int64_t>(d.BitLength()) - static_cast<int64_t>(n.BitLength());
+						if(s < 0)
+							s = 0;
+						BigInt rem;
+						BigInt::DivMod(n.ShiftLeft(static_cast<size_t>(s)), d, m, rem);
+						sticky = !rem.IsZero();
+						e2 = q - s;
+					}
+					return Assembler<F>::Assemble(m, e2, sticky, dec.negative);
+				}
+
+				/*
+					Exact powers of ten for the Clinger fast path
+				*/
+				template <class F>
+				F ExactPow10(int64_t n) {
+					static std::vector<F> const table = [](void) {
+						std::vector<F> t(1, static_cast<F>(1));
+						for(int i = 1; i < 64; i++)
+							t.push_back(t.back() * static_cast<F>(10));
+						return t;
+					}();
+					return table[static_cast<size_t>(n)];
+				}
+
+				/*
+					Clinger's fast path, when both the mantissa and 10^|q| are exact in F the single
+					rounding of the multiply or divide is the correct answer
+				*/
+				template <class F>
+				bool Clinger(Decimal const& dec, F& out) {
+					const int digits = FloatTraits<F>::digits;
+					// Largest k with 5^k < 2^digits, 10^k is exact up to there
+					const int64_t maxPow = (static_cast<int64_t>(digits) * 10000) / 23220;
+					if(dec.truncated || dec.exponent < -maxPow || dec.exponent > maxPow)
+						return false;
+					if(digits < 64 && dec.mantissa > (static_cast<uint64_t>(1) << (digits & 63)))
+						return false;
+					F value = static_cast<F>(dec.mantissa);
+					value = (dec.exponent < 0) ? (value / ExactPow10<F>(-dec.exponent)) : (value * ExactPow10<F>(dec.exponent));
+					out = dec.negative ? -value : value;
+					return true;
+				}
+
+				/*
+					Fast paths tried before the slow path, double also gets Eisel-Lemire
+				*/
+				template <class F>
+				struct FastPath {
+					static bool Try(Decimal const& dec, F& out) {
+						return Clinger(dec, out);
+					}
+				};
+
+				template <int Bits>
+				struct FastPath<Mt::core::hpn::MPFloat<Bits>> {
+					static bool Try(Decimal const&, Mt::core::hpn::MPFloat<Bits>&) {
+						return false;
+					}
+				};
+
+				template <>
+				struct FastPath<double> {
+					static bool Try(Decimal const& dec, double& out) {
+						if(Clinger(dec, out))
+							return true;
+						if(!EiselLemire(dec.mantissa, dec.exponent, dec.negative, out))
+							return false;
+						if(!dec.truncated)
+							return true;
+						// The dropped digits put the value between w and w + 1, if both round the
+						// same way that is the answer
+						double upper;
+						return EiselLemire(dec.mantissa + 1, dec.exponent, dec.negative, upper) && upper == out;
+					}
+				};
+			}
+
+			const char* Scan(const char* first, const char* last, Decimal& out) {
+				out = Decimal();
+				const char* p = first;
+				if(p != last && (*p == '+' || *p == '-')) {
+					out.negative = (*p == '-');
+					p++;
+				}
+				const char* start = p;
+				bool any = false;
+				bool point = false;
+				int64_t fraction = 0;
+				for(; p != last; p++) {
+					if(*p == '.' && !point) {
+						point = true;
+						continue;
+					}
+					if(!IsDigit(*p))
+						break;
+					any = true;
+					if(point)
+						fraction++;
+					// Leading zeros are not significant
+					if(out.count == 0 && *p == '0')
+						continue;
+					out.count++;
+					if(out.count <= 19)
+						out.mantissa = (out.mantissa * 10) + static_cast<uint64_t>(*p - '0');
+					else if(*p != '0')
+						out.truncated = true;
+				}
+				if(!any)
+					return nullptr;
+				const char* end = p;
+				int64_t exp10 = 0;
+				if(p != last && (*p == 'e' || *p == 'E')) {
+					const char* e = p + 1;
+					bool negExp = false;
+					if(e != last && (*e == '+' || *e == '-')) {
+						negExp = (*e == '-');
+						e++;
+					}
+					if(e != last && IsDigit(*e)) {
+						for(; e != last && IsDigit(*e); e++) {
+							if(exp10 < EXPONENT_LIMIT)
+								exp10 = (exp10 * 10) + (*e - '0');
+						}
+						exp10 = negExp ? -exp10 : exp10;
+						end = e;
+					}
+				}
+				out.digitsExponent = exp10 - fraction;
+				out.exponent = out.digitsExponent + ((out.count > 19) ? (out.count - 19) : 0);
+				if(out.count == 0)
+					out.exponent = out.digitsExponent = 0;
+				if(out.truncated) {
+					out.digits.reserve(static_cast<size_t>(out.count));
+					for(const char* d = start; d != last && (IsDigit(*d) || *d == '.'); d++) {
+						if(*d == '.' || (out.digits.empty() && *d == '0'))
+							continue;
+						out.digits += *d;
+					}
+				}
+				return end;
+			}
+
+			template <class F>
+			F Convert(Decimal const& dec) {
+				if(dec.mantissa == 0)
+					return dec.negative ? -static_cast<F>(0) : static_cast<F>(0);
+				F out;
+				if(FastPath<F>::Try(dec, out))
+					return out;
+				return SlowPath<F>(dec);
+			}
+
+			bool ScanComplex(const char* first, const char* last, Decimal& re, Decimal& im) {
+				const char* p = Scan(first, last, re);
+				if(p == nullptr || p == last || (*p != '+' && *p != '-'))
+					return false;
+				p = Scan(p, last, im);
+				return p != nullptr && (p + 1) == last && *p == 'i';
+			}
+
+			template double Convert<double>(Decimal const& dec);
+			template long double Convert<long double>(Decimal const& dec);
+#if defined(_MT_HAS_QUAD)
+			template mtquad_t Convert<mtquad_t>(Decimal const& dec);
+#endif
+		}
+	}
+}
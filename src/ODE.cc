@@ -0,0 +1,773 @@
+/*
+	ODE.cc - Initial value problems for ordinary differential equations
+*/
+#include "core/ODE.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include "core/WorkerPool.hh"
+
+namespace Mt {
+	namespace core {
+		namespace ODE {
+			namespace {
+				const long double DEFAULT_ABSOLUTE_TOLERANCE = 1e-12L;
+				const long double DEFAULT_RELATIVE_TOLERANCE = 1e-10L;
+				const size_t DEFAULT_MAX_STEPS = 100000;
+				// Members stepped in lockstep, ensembles hand them to workers a block at a time
+				const size_t BLOCK = 64;
+				// The next step aims a little under the predicted size and changes by these factors at most
+				const long double SAFETY = 0.9L;
+				const long double MIN_FACTOR = 0.2L;
+				const long double MAX_FACTOR = 5.0L;
+				// Rows of interpolation coefficients per step
+				const size_t DENSE_ROWS = 5;
+				// Stages a step keeps a derivative for
+				const size_t STAGES = 7;
+
+				// Dormand-Prince 5(4)
+				const long double C2 = 1.0L / 5.0L, C3 = 3.0L / 10.0L, C4 = 4.0L / 5.0L, C5 = 8.0L / 9.0L;
+				const long double A21 = 1.0L / 5.0L;
+				const long double A31 = 3.0L / 40.0L, A32 = 9.0L / 40.0L;
+				const long double A41 = 44.0L / 45.0L, A42 = -56.0L / 15.0L, A43 = 32.0L / 9.0L;
+				const long double A51 = 19372.0L / 6561.0L, A52 = -25360.0L / 2187.0L, A53 = 64448.0L / 6561.0L, A54 = -212.0L / 729.0L;
+				const long double A61 = 9017.0L / 3168.0L, A62 = -355.0L / 33.0L, A63 = 46732.0L / 5247.0L, A64 = 49.0L / 176.0L, A65 = -5103.0L / 18656.0L;
+				const long double A71 = 35.0L / 384.0L, A73 = 500.0L / 1113.0L, A74 = 125.0L / 192.0L, A75 = -2187.0L / 6784.0L, A76 = 11.0L / 84.0L;
+				// Difference between the fifth and fourth order solutions
+				const long double E1 = 71.0L / 57600.0L, E3 = -71.0L / 16695.0L, E4 = 71.0L / 1920.0L, E5 = -17253.0L / 339200.0L, E6 = 22.0L / 525.0L, E7 = -1.0L / 40.0L;
+				// Hairer's fourth order continuous extension
+				const long double D1 = -12715105075.0L / 11282082432.0L, D3 = 87487479700.0L / 32700410799.0L, D4 = -10690763975.0L / 1880347072.0L,
+					D5 = 701980252875.0L / 199316789632.0L, D6 = -1453857185.0L / 822651844.0L, D7 = 69997945.0L / 29380423.0L;
+
+				// Rosenbrock 2(3), d = 1 / (2 + sqrt(2)) and e32 = 6 + sqrt(2)
+				const long double ROS_D = 0.292893218813452475599155637895150960715L;
+				const long double ROS_E32 = 7.41421356237309504880168872420969807857L;
+
+				long double Interpolate(long double r1, long double r2, long double r3, long double r4, long double r5, long double theta) {
+					const long double rest = 1.0L - theta;
+					return r1 + (theta * (r2 + (rest * (r3 + (theta * (r4 + (rest * r5)))))));
+				}
+
+				/*
+					LU factors of the n by n row major matrix a in place with partial pivoting, row c was
+					swapped with row pivots[c]
+					\return false if the matrix is singular
+				*/
+				bool Factor(long double* a, size_t* pivots, size_t n) {
+					for(size_t c = 0; c < n; c++) {
+						size_t best = c;
+						for(size_t r = c + 1; r < n; r++) {
+							if(std::fabs(a[(r * n) + c]) > std::fabs(a[(best * n) + c]))
+								best = r;
+						}
+						pivots[c] = best;
+						if(a[(best * n) + c] == 0.0L)
+							return false;
+						if(best != c)
+							std::swap_ranges(a + (c * n), a + ((c + 1) * n), a + (best * n));
+						for(size_t r = c + 1; r < n; r++) {
+							long double factor = a[(r * n) + c] / a[(c * n) + c];
+							a[(r * n) + c] = factor;
+							for(size_t k = c + 1; k < n; k++)
+								a[(r * n) + k] -= factor * a[(c * n) + k];
+						}
+					}
+					return true;
+				}
+
+				/*
+					Solves with the factors from Factor, b is overwritten with the solution
+				*/
+				void Substitute(const long double* a, const size_t* pivots, long double* b, size_t n) {
+					for(size_t c = 0; c < n; c++)
+						std::swap(b[c], b[pivots[c]]);
+					for(size_t r = 1; r < n; r++) {
+						for(size_t c = 0; c < r; c++)
+							b[r] -= a[(r * n) + c] * b[c];
+					}
+					for(size_t r = n; r-- > 0;) {
+						for(size_t c = r + 1; c < n; c++)
+							b[r] -= a[(r * n) + c] * b[c];
+						b[r] /= a[(r * n) + r];
+					}
+				}
+
+				/*
+					Members stepped together. Per member values are indexed by slot, rows of state hold
+					one value per slot. The active members are slots [0, active), a member that is done
+					trades places with the last active one so every pass runs over a dense prefix.
+				*/
+				class Block {
+				private:
+					System& f;
+					Options const& options;
+					const size_t dimension;
+					const size_t parameterCount;
+					const size_t capacity;
+					size_t active;
+					long double end;
+					long double direction;
+
+					// Per slot
+					std::vector<long double> t;
+					std::vector<long double> h;
+					std::vector<long double> stageTime;
+					std::vector<long double> error;
+					std::vector<size_t> member;
+					std::vector<size_t> steps;
+					// The last attempt was rejected, the step may not grow
+					std::vector<char> retry;
+					// The step lands on the end
+					std::vector<char> last;
+					std::vector<char> accepted;
+
+					// Rows of capacity values
+					std::vector<long double> y;
+					std::vector<long double> p;
+					std::vector<long double> next;
+					std::vector<long double> stage;
+					std::vector<long double> k;
+					std::vector<long double> dense;
+
+					// Rosenbrock only, one n by n matrix per slot
+					std::vector<long double> jacobian;
+					std::vector<long double> factors;
+					std::vector<size_t> pivots;
+					std::vector<char> singular;
+					std::vector<long double> column;
+
+					long double* K(size_t index) {
+						return this->k.data() + (index * this->dimension * this->capacity);
+					}
+
+					long double Scale(long double a, long double b) const {
+						return this->options.absoluteTolerance + (this->options.relativeTolerance * std::max(std::fabs(a), std::fabs(b)));
+					}
+
+					/*
+						Evaluates the system for every active member, anything it throws is a failure
+					*/
+					bool Evaluate(const long double* time, const long double* state, long double* dydt, Result& result) {
+						result.evaluations += this->active;
+						try {
+							return this->f.Evaluate(time, state, this->p.data(), dydt, this->active, this->capacity);
+						} catch(std::exception& ex) {
+							// Ensembles run on worker threads, nothing may escape
+							std::cerr << "Error: " << ex.what() << std::endl;
+							return false;
+						}
+					}
+
+					/*
+						Initial step size from Hairer and Wanner, a step that would change the solution
+						by about one percent according to the first two derivatives
+					*/
+					bool Start(Result& result) {
+						const size_t n = this->dimension, stride = this->capacity, count = this->active;
+						const long double* f0 = this->K(0);
+						long double* f1 = this->K(1);
+						if(!this->Evaluate(this->t.data(), this->y.data(), this->K(0), result))
+							return false;
+						std::vector<long double> d0(count, 0.0L), d1(count, 0.0L), d2(count, 0.0L);
+						for(size_t i = 0; i < n; i++) {
+							const long double* yi = &this->y[i * stride];
+							for(size_t m = 0; m < count; m++) {
+								long double scale = this->Scale(yi[m], 0.0L);
+								d0[m] += (yi[m] / scale) * (yi[m] / scale);
+								d1[m] += (f0[(i * stride) + m] / scale) * (f0[(i * stride) + m] / scale);
+							}
+						}
+						for(size_t m = 0; m < count; m++) {
+							d0[m] = std::sqrt(d0[m] / n);
+							d1[m] = std::sqrt(d1[m] / n);
+							long double h0 = (d0[m] < 1e-5L || d1[m] < 1e-5L) ? 1e-6L : 0.01L * (d0[m] / d1[m]);
+							this->h[m] = std::min(h0, std::fabs(this->end - this->t[m]));
+							this->stageTime[m] = this->t[m] + (this->direction * this->h[m]);
+						}
+						for(size_t i = 0; i < n; i++) {
+							for(size_t m = 0; m < count; m++)
+								this->stage[(i * stride) + m] = this->y[(i * stride) + m] + (this->direction * this->h[m] * f0[(i * stride) + m]);
+						}
+						if(!this->Evaluate(this->stageTime.data(), this->stage.data(), f1, result))
+							return false;
+						for(size_t i = 0; i < n; i++) {
+							for(size_t m = 0; m < count; m++) {
+								long double scale = this->Scale(this->y[(i * stride) + m], 0.0L);
+								long double change = (f1[(i * stride) + m] - f0[(i * stride) + m]) / scale;
+								d2[m] += change * change;
+							}
+						}
+						const long double order = (this->options.method == ROSENBROCK) ? 3.0L : 5.0L;
+						for(size_t m = 0; m < count; m++) {
+							long double h0 = this->h[m];
+							long double curvature = std::max(d1[m], std::sqrt(d2[m] / n) / h0);
+							long double h1 = (curvature <= 1e-15L) ? std::max(1e-6L, h0 * 1e-3L) : std::pow(0.01L / curvature, 1.0L / order);
+							this->h[m] = this->direction * std::min(std::min(100.0L * h0, h1), std::fabs(this->end - this->t[m]));
+						}
+						return true;
+					}
+
+					/*
+						Shortens the steps that would run past the end
+					*/
+					void Prepare(void) {
+						for(size_t m = 0; m < this->active; m++) {
+							long double remaining = this->end - this->t[m];
+							this->last[m] = std::fabs(this->h[m]) >= std::fabs(remaining);
+							if(this->last[m])
+								this->h[m] = remaining;
+						}
+					}
+
+					long double EndOfStep(size_t m) const {
+						return this->last[m] ? this->end : this->t[m] + this->h[m];
+					}
+
+					/*
+						Normalized RMS of the error estimate in next, error[m] for every active member
+					*/
+					void Norm(const long double* estimate) {
+						const size_t n = this->dimension, stride = this->capacity, count = this->active;
+						std::fill(this->error.begin(), this->error.begin() + count, 0.0L);
+						for(size_t i = 0; i < n; i++) {
+							for(size_t m = 0; m < count; m++) {
+								long double e = estimate[(i * stride) + m] / this->Scale(this->y[(i * stride) + m], this->next[(i * stride) + m]);
+								this->error[m] += e * e;
+							}
+						}
+						for(size_t m = 0; m < count; m++)
+							this->error[m] = std::sqrt(this->error[m] / n);
+					}
+
+					bool DormandPrince(Result& result) {
+						const size_t n = this->dimension, stride = this->capacity, count = this->active;
+						long double* k1 = this->K(0);
+						long double* k2 = this->K(1);
+						long double* k3 = this->K(2);
+						long double* k4 = this->K(3);
+						long double* k5 = this->K(4);
+						long double* k6 = this->K(5);
+						long double* k7 = this->K(6);
+						const long double* y0 = this->y.data();
+						long double* s = this->stage.data();
+						const long double* hs = this->h.data();
+
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->t[m] + (C2 * hs[m]);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = y0[i + m] + (hs[m] * (A21 * k1[i + m]));
+						}
+						if(!this->Evaluate(this->stageTime.data(), s, k2, result))
+							return false;
+
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->t[m] + (C3 * hs[m]);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = y0[i + m] + (hs[m] * ((A31 * k1[i + m]) + (A32 * k2[i + m])));
+						}
+						if(!this->Evaluate(this->stageTime.data(), s, k3, result))
+							return false;
+
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->t[m] + (C4 * hs[m]);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = y0[i + m] + (hs[m] * ((A41 * k1[i + m]) + (A42 * k2[i + m]) + (A43 * k3[i + m])));
+						}
+						if(!this->Evaluate(this->stageTime.data(), s, k4, result))
+							return false;
+
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->t[m] + (C5 * hs[m]);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = y0[i + m] + (hs[m] * ((A51 * k1[i + m]) + (A52 * k2[i + m]) + (A53 * k3[i + m]) + (A54 * k4[i + m])));
+						}
+						if(!this->Evaluate(this->stageTime.data(), s, k5, result))
+							return false;
+
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->t[m] + hs[m];
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = y0[i + m] + (hs[m] * ((A61 * k1[i + m]) + (A62 * k2[i + m]) + (A63 * k3[i + m]) + (A64 * k4[i + m]) + (A65 * k5[i + m])));
+						}
+						if(!this->Evaluate(this->stageTime.data(), s, k6, result))
+							return false;
+
+						// The fifth order solution, its derivative is the first stage of the next step
+						long double* y1 = this->next.data();
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->EndOfStep(m);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								y1[i + m] = y0[i + m] + (hs[m] * ((A71 * k1[i + m]) + (A73 * k3[i + m]) + (A74 * k4[i + m]) + (A75 * k5[i + m]) + (A76 * k6[i + m])));
+						}
+						if(!this->Evaluate(this->stageTime.data(), y1, k7, result))
+							return false;
+
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = hs[m] * ((E1 * k1[i + m]) + (E3 * k3[i + m]) + (E4 * k4[i + m]) + (E5 * k5[i + m]) + (E6 * k6[i + m]) + (E7 * k7[i + m]));
+						}
+						this->Norm(s);
+
+						long double* r1 = this->dense.data();
+						long double* r2 = r1 + (n * stride);
+						long double* r3 = r2 + (n * stride);
+						long double* r4 = r3 + (n * stride);
+						long double* r5 = r4 + (n * stride);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++) {
+								long double change = y1[i + m] - y0[i + m];
+								long double slope = (hs[m] * k1[i + m]) - change;
+								r1[i + m] = y0[i + m];
+								r2[i + m] = change;
+								r3[i + m] = slope;
+								r4[i + m] = change - (hs[m] * k7[i + m]) - slope;
+								r5[i + m] = hs[m] * ((D1 * k1[i + m]) + (D3 * k3[i + m]) + (D4 * k4[i + m]) + (D5 * k5[i + m]) + (D6 * k6[i + m]) + (D7 * k7[i + m]));
+							}
+						}
+						return true;
+					}
+
+					/*
+						Overwrites rows of b with (I - h d J)^-1 b for every active member with regular factors
+					*/
+					void SolveStage(long double* b) {
+						const size_t n = this->dimension, stride = this->capacity;
+						for(size_t m = 0; m < this->active; m++) {
+							if(this->singular[m])
+								continue;
+							for(size_t i = 0; i < n; i++)
+								this->column[i] = b[(i * stride) + m];
+							Substitute(&this->factors[m * n * n], &this->pivots[m * n], this->column.data(), n);
+							for(size_t i = 0; i < n; i++)
+								b[(i * stride) + m] = this->column[i];
+						}
+					}
+
+					bool Rosenbrock(Result& result) {
+						const size_t n = this->dimension, stride = this->capacity, count = this->active;
+						const long double root = std::sqrt(LDBL_EPSILON);
+						long double* f0 = this->K(0);
+						long double* k1 = this->K(1);
+						long double* k2 = this->K(2);
+						long double* k3 = this->K(3);
+						long double* f1 = this->K(4);
+						long double* f2 = this->K(5);
+						long double* dt = this->K(6);
+						const long double* y0 = this->y.data();
+						long double* s = this->stage.data();
+						const long double* hs = this->h.data();
+						long double* delta = this->error.data();
+
+						// Time derivative, the offsets are rounded so they are exactly what was added
+						for(size_t m = 0; m < count; m++) {
+							long double offset = this->direction * root * std::max(std::fabs(this->t[m]), std::fabs(hs[m]));
+							this->stageTime[m] = this->t[m] + offset;
+							delta[m] = this->stageTime[m] - this->t[m];
+						}
+						if(!this->Evaluate(this->stageTime.data(), y0, dt, result))
+							return false;
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								dt[i + m] = (dt[i + m] - f0[i + m]) / delta[m];
+						}
+
+						// Jacobian one column at a time, each column is one pass over the block
+						const long double floor = this->options.absoluteTolerance / this->options.relativeTolerance;
+						std::copy(this->y.begin(), this->y.end(), this->stage.begin());
+						for(size_t j = 0; j < n; j++) {
+							long double* sj = s + (j * stride);
+							for(size_t m = 0; m < count; m++) {
+								long double offset = root * std::max(std::fabs(sj[m]), floor);
+								sj[m] = y0[(j * stride) + m] + offset;
+								delta[m] = sj[m] - y0[(j * stride) + m];
+							}
+							if(!this->Evaluate(this->t.data(), s, f1, result))
+								return false;
+							for(size_t m = 0; m < count; m++) {
+								sj[m] = y0[(j * stride) + m];
+								for(size_t i = 0; i < n; i++)
+									this->jacobian[(((m * n) + i) * n) + j] = (f1[(i * stride) + m] - f0[(i * stride) + m]) / delta[m];
+							}
+						}
+						for(size_t m = 0; m < count; m++) {
+							long double* w = &this->factors[m * n * n];
+							const long double* jm = &this->jacobian[m * n * n];
+							for(size_t i = 0; i < n * n; i++)
+								w[i] = -hs[m] * ROS_D * jm[i];
+							for(size_t i = 0; i < n; i++)
+								w[(i * n) + i] += 1.0L;
+							this->singular[m] = !Factor(w, &this->pivots[m * n], n);
+						}
+
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								k1[i + m] = f0[i + m] + (hs[m] * ROS_D * dt[i + m]);
+						}
+						this->SolveStage(k1);
+
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->t[m] + (0.5L * hs[m]);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = y0[i + m] + (0.5L * hs[m] * k1[i + m]);
+						}
+						if(!this->Evaluate(this->stageTime.data(), s, f1, result))
+							return false;
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								k2[i + m] = f1[i + m] - k1[i + m];
+						}
+						this->SolveStage(k2);
+
+						long double* y1 = this->next.data();
+						for(size_t m = 0; m < count; m++)
+							this->stageTime[m] = this->EndOfStep(m);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++) {
+								k2[i + m] += k1[i + m];
+								y1[i + m] = y0[i + m] + (hs[m] * k2[i + m]);
+							}
+						}
+						if(!this->Evaluate(this->stageTime.data(), y1, f2, result))
+							return false;
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								k3[i + m] = f2[i + m] - (ROS_E32 * (k2[i + m] - f1[i + m])) - (2.0L * (k1[i + m] - f0[i + m])) + (hs[m] * ROS_D * dt[i + m]);
+						}
+						this->SolveStage(k3);
+
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++)
+								s[i + m] = (hs[m] / 6.0L) * (k1[i + m] - (2.0L * k2[i + m]) + k3[i + m]);
+						}
+						this->Norm(s);
+						for(size_t m = 0; m < count; m++) {
+							if(this->singular[m])
+								this->error[m] = std::numeric_limits<long double>::infinity();
+						}
+
+						// y0 + theta h k2 + theta (1 - theta) h (k1 - k2) / (1 - 2d)
+						long double* r1 = this->dense.data();
+						long double* r2 = r1 + (n * stride);
+						long double* r3 = r2 + (n * stride);
+						std::fill(r3 + (n * stride), r3 + (3 * n * stride), 0.0L);
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++) {
+								r1[i + m] = y0[i + m];
+								r2[i + m] = hs[m] * k2[i + m];
+								r3[i + m] = (hs[m] * (k1[i + m] - k2[i + m])) / (1.0L - (2.0L * ROS_D));
+							}
+						}
+						return true;
+					}
+
+					/*
+						Moves the member in slot a to slot b and the other way around
+					*/
+					void Swap(size_t a, size_t b) {
+						const size_t stride = this->capacity;
+						std::swap(this->t[a], this->t[b]);
+						std::swap(this->h[a], this->h[b]);
+						std::swap(this->member[a], this->member[b]);
+						std::swap(this->steps[a], this->steps[b]);
+						std::swap(this->retry[a], this->retry[b]);
+						for(size_t i = 0; i < this->dimension * stride; i += stride) {
+							std::swap(this->y[i + a], this->y[i + b]);
+							std::swap(this->k[i + a], this->k[i + b]);
+						}
+						for(size_t j = 0; j < this->parameterCount * stride; j += stride)
+							std::swap(this->p[j + a], this->p[j + b]);
+					}
+
+					/*
+						Accepts or rejects every member's step and picks its next step size. Members that
+						reached the end or had to be given up on leave the active range.
+					*/
+					template <class Observer>
+					void Advance(Observer& observer, Result& result) {
+						const size_t n = this->dimension, stride = this->capacity, count = this->active;
+						const long double exponent = (this->options.method == ROSENBROCK) ? 1.0L / 3.0L : 1.0L / 5.0L;
+						const long double* carried = this->K((this->options.method == ROSENBROCK) ? 5 : 6);
+						for(size_t m = 0; m < count; m++) {
+							this->accepted[m] = this->error[m] <= 1.0L;
+							if(this->accepted[m])
+								observer(*this, m);
+						}
+						for(size_t i = 0; i < n * stride; i += stride) {
+							for(size_t m = 0; m < count; m++) {
+								this->y[i + m] = this->accepted[m] ? this->next[i + m] : this->y[i + m];
+								this->k[i + m] = this->accepted[m] ? carried[i + m] : this->k[i + m];
+							}
+						}
+						std::vector<char> done(count, 0);
+						for(size_t m = 0; m < count; m++) {
+							const long double err = this->error[m];
+							long double factor;
+							this->steps[m]++;
+							if(this->accepted[m]) {
+								result.steps++;
+								this->t[m] = this->EndOfStep(m);
+								factor = (err == 0.0L) ? MAX_FACTOR : std::min(MAX_FACTOR, std::max(MIN_FACTOR, SAFETY * std::pow(err, -exponent)));
+								if(this->retry[m])
+									factor = std::min(1.0L, factor);
+								this->retry[m] = 0;
+								if(this->last[m]) {
+									done[m] = 1;
+									continue;
+								}
+							} else {
+								// NaN lands here too, and takes the smallest step down
+								result.rejected++;
+								factor = (err < std::numeric_limits<long double>::infinity()) ? std::max(MIN_FACTOR, SAFETY * std::pow(err, -exponent)) : MIN_FACTOR;
+								this->retry[m] = 1;
+							}
+							this->h[m] *= factor;
+							bool underflow = std::fabs(this->h[m]) <= 16.0L * LDBL_EPSILON * std::max(std::fabs(this->t[m]), LDBL_MIN);
+							if(underflow || this->steps[m] >= this->options.maxSteps) {
+								result.failures++;
+								done[m] = 1;
+							}
+						}
+						for(size_t m = count; m-- > 0;) {
+							if(done[m])
+								this->Swap(m, --this->active);
+						}
+					}
+				public:
+					Block(System& system, size_t n, size_t parameters, size_t slots, Options const& opts) : f(system), options(opts), dimension(n),
+						parameterCount(parameters), capacity(slots), active(0), end(0.0L), direction(1.0L), t(slots), h(slots), stageTime(slots),
+						error(slots), member(slots), steps(slots), retry(slots), last(slots), accepted(slots), y(n * slots), p(parameters * slots),
+						next(n * slots), stage(n * slots), k(STAGES * n * slots), dense(DENSE_ROWS * n * slots) {
+						if(opts.method == ROSENBROCK) {
+							this->jacobian.resize(n * n * slots);
+							this->factors.resize(n * n * slots);
+							this->pivots.resize(n * slots);
+							this->singular.resize(slots);
+							this->column.resize(n);
+						}
+					}
+
+					/*
+						Loads count members starting at first out of rows of stride values
+					*/
+					void Load(size_t first, size_t count, long double t0, long double t1, const long double* y0, const long double* parameters, size_t stride) {
+						this->active = (t0 == t1) ? 0 : count;
+						this->end = t1;
+						this->direction = (t1 < t0) ? -1.0L : 1.0L;
+						for(size_t m = 0; m < count; m++) {
+							this->t[m] = t0;
+							this->member[m] = first + m;
+							this->steps[m] = 0;
+							this->retry[m] = 0;
+							for(size_t i = 0; i < this->dimension; i++)
+								this->y[(i * this->capacity) + m] = y0[(i * stride) + first + m];
+							for(size_t j = 0; j < this->parameterCount; j++)
+								this->p[(j * this->capacity) + m] = parameters[(j * stride) + first + m];
+						}
+					}
+
+					size_t Member(size_t slot) const {
+						return this->member[slot];
+					}
+
+					long double Time(size_t slot) const {
+						return this->t[slot];
+					}
+
+					long double Step(size_t slot) const {
+						return this->h[slot];
+					}
+
+					long double End(size_t slot) const {
+						return this->EndOfStep(slot);
+					}
+
+					/*
+						Interpolation coefficient row of the step just taken
+					*/
+					long double Dense(size_t row, size_t component, size_t slot) const {
+						return this->dense[(((row * this->dimension) + component) * this->capacity) + slot];
+					}
+
+					/*
+						State component of the member in slot at theta of the way through its step
+					*/
+					long double Interpolate(size_t slot, size_t component, long double theta) const {
+						return ODE::Interpolate(this->Dense(0, component, slot), this->Dense(1, component, slot), this->Dense(2, component, slot),
+							this->Dense(3, component, slot), this->Dense(4, component, slot), theta);
+					}
+
+					/*
+						Steps every member to the end, observer(block, slot) sees every accepted step
+						\return false if the system failed
+					*/
+					template <class Observer>
+					bool Run(Observer& observer, Result& result) {
+						if(this->active == 0)
+							return true;
+						if(!this->Start(result))
+							return false;
+						while(this->active != 0) {
+							this->Prepare();
+							bool evaluated = (this->options.method == ROSENBROCK) ? this->Rosenbrock(result) : this->DormandPrince(result);
+							if(!evaluated)
+								return false;
+							this->Advance(observer, result);
+						}
+						return true;
+					}
+				};
+
+				void Clear(Result& result) {
+					result.steps = 0;
+					result.rejected = 0;
+					result.evaluations = 0;
+					result.failures = 0;
+				}
+			}
+
+			Options::Options(void) : method(DORMAND_PRINCE), absoluteTolerance(DEFAULT_ABSOLUTE_TOLERANCE), relativeTolerance(DEFAULT_RELATIVE_TOLERANCE),
+				maxSteps(DEFAULT_MAX_STEPS), threads(0) {
+			}
+
+			Trajectory::Trajectory(void) : dimension(0) {
+			}
+
+			size_t Trajectory::Dimension(void) const {
+				return this->dimension;
+			}
+
+			size_t Trajectory::Steps(void) const {
+				return this->times.empty() ? 0 : this->times.size() - 1;
+			}
+
+			long double Trajectory::Start(void) const {
+				return this->times.empty() ? 0.0L : this->times.front();
+			}
+
+			long double Trajectory::End(void) const {
+				return this->times.empty() ? 0.0L : this->times.back();
+			}
+
+			bool Trajectory::At(long double t, long double* y) const {
+				if(this->Steps() == 0)
+					return false;
+				const bool forward = this->times.back() >= this->times.front();
+				if(forward ? (t < this->times.front() || t > this->times.back()) : (t > this->times.front() || t < this->times.back()))
+					return false;
+				// First step that ends at or after t
+				std::vector<long double>::const_iterator it = forward
+					? std::lower_bound(this->times.begin() + 1, this->times.end(), t)
+					: std::lower_bound(this->times.begin() + 1, this->times.end(), t, std::greater<long double>());
+				const size_t step = static_cast<size_t>(it - this->times.begin()) - 1;
+				const long double length = this->times[step + 1] - this->times[step];
+				const long double theta = (length == 0.0L) ? 0.0L : (t - this->times[step]) / length;
+				const size_t n = this->dimension;
+				const long double* r = &this->coefficients[step * DENSE_ROWS * n];
+				for(size_t i = 0; i < n; i++)
+					y[i] = Interpolate(r[i], r[n + i], r[(2 * n) + i], r[(3 * n) + i], r[(4 * n) + i], theta);
+				return true;
+			}
+
+			bool Solve(System& f, size_t dimension, const long double* parameters, size_t parameterCount, long double t0, const long double* y0,
+				long double t1, Options const& options, Trajectory& trajectory, Result& result) {
+				Clear(result);
+				trajectory.dimension = dimension;
+				trajectory.times.assign(1, t0);
+				trajectory.coefficients.clear();
+				if(t0 == t1) {
+					// A step of length zero, so the start can be read back
+					trajectory.times.push_back(t0);
+					trajectory.coefficients.assign(y0, y0 + dimension);
+					trajectory.coefficients.resize(DENSE_ROWS * dimension, 0.0L);
+					return true;
+				}
+				Block block(f, dimension, parameterCount, 1, options);
+				block.Load(0, 1, t0, t1, y0, parameters, 1);
+				auto record = [&trajectory, dimension](Block const& b, size_t slot) {
+					trajectory.times.push_back(b.End(slot));
+					for(size_t row = 0; row < DENSE_ROWS; row++) {
+						for(size_t i = 0; i < dimension; i++)
+							trajectory.coefficients.push_back(b.Dense(row, i, slot));
+					}
+				};
+				if(!block.Run(record, result))
+					return false;
+				return result.failures == 0;
+			}
+
+			bool Ensemble(System& f, size_t dimension, size_t parameterCount, size_t members, long double t0, const long double* y0, const long double* parameters,
+				const long double* times, size_t sampleCount, Options const& options, long double* samples, Result& result) {
+				Clear(result);
+				std::fill(samples, samples + (sampleCount * dimension * members), std::numeric_limits<long double>::quiet_NaN());
+				if(sampleCount == 0 || members == 0)
+					return true;
+				const long double t1 = times[sampleCount - 1];
+				const long double direction = (t1 < t0) ? -1.0L : 1.0L;
+				for(size_t s = 0; s < sampleCount; s++) {
+					long double previous = (s == 0) ? t0 : times[s - 1];
+					if(!(direction * (times[s] - previous) >= 0.0L)) {
+						std::cerr << "Error: ensemble sample times have to run from the start in one direction" << std::endl;
+						return false;
+					}
+				}
+				// Samples at the start are the initial states
+				size_t first = 0;
+				for(; first < sampleCount && times[first] == t0; first++) {
+					for(size_t i = 0; i < dimension; i++)
+						std::copy(y0 + (i * members), y0 + ((i + 1) * members), samples + (((first * dimension) + i) * members));
+				}
+				std::vector<size_t> pending(members, first);
+
+				std::vector<std::unique_ptr<System>> forks;
+				std::vector<System*> systems = f.ForkWorkers(WorkerPool::Workers(options.threads), forks);
+				WorkerPool workers(systems.size());
+				std::vector<Result> results(systems.size());
+				std::atomic<size_t> nextBlock(0);
+				std::atomic<bool> failed(false);
+				const size_t blocks = (members + BLOCK - 1) / BLOCK;
+				workers.Run([&](size_t worker) {
+					Result& own = results[worker];
+					Clear(own);
+					Block block(*systems[worker], dimension, parameterCount, std::min(BLOCK, members), options);
+					auto sample = [&](Block const& b, size_t slot) {
+						const size_t index = b.Member(slot);
+						const long double start = b.Time(slot), length = b.Step(slot), stop = b.End(slot);
+						size_t& s = pending[index];
+						for(; s < sampleCount && direction * (times[s] - stop) <= 0.0L; s++) {
+							long double theta = (times[s] == stop) ? 1.0L : (times[s] - start) / length;
+							for(size_t i = 0; i < dimension; i++)
+								samples[(((s * dimension) + i) * members) + index] = b.Interpolate(slot, i, theta);
+						}
+					};
+					for(size_t i = nextBlock++; i < blocks && !failed; i = nextBlock++) {
+						const size_t begin = i * BLOCK;
+						block.Load(begin, std::min(BLOCK, members - begin), t0, t1, y0, parameters, members);
+						if(!block.Run(sample, own))
+							failed = true;
+					}
+				});
+				for(Result const& r : results) {
+					result.steps += r.steps;
+					result.rejected += r.rejected;
+					result.evaluations += r.evaluations;
+					result.failures += r.failures;
+				}
+				return !failed;
+			}
+		}
+	}
+}
@@ -0,0 +1,83 @@
+/*
+	ObjectPool.cc - Arena for the objects the evaluator creates while it works
+*/
+#include "core/lang/ObjectPool.hh"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace {
+				// Big enough for a few hundred duals or boxed integers, objects larger than this get a chunk of their own
+				const size_t CHUNK_SIZE = 64 * 1024;
+				// Every object starts on a boundary suitable for long double and __float128
+				const size_t ALIGNMENT = alignof(std::max_align_t);
+			}
+
+			ObjectPool::ObjectPool(void) : chunk(0), used(0) {
+
+			}
+
+			ObjectPool::~ObjectPool(void) {
+				this->Clear();
+			}
+
+			Mt::core::IMtObject* ObjectPool::Adopt(Mt::core::IMtObject* object) {
+				this->entries.push_back(Entry{ object, true });
+				return object;
+			}
+
+			ObjectPool::Mark ObjectPool::GetMark(void) const {
+				return Mark{ this->entries.size(), this->chunk, this->used };
+			}
+
+			void ObjectPool::Release(Mark const& mark) {
+				while(this->entries.size() > mark.objects) {
+					Entry& entry = this->entries.back();
+					if(entry.adopted)
+						delete entry.object;
+					else
+						entry.object->~IMtObject();
+					this->entries.pop_back();
+				}
+				this->chunk = mark.chunk;
+				this->used = mark.used;
+			}
+
+			void ObjectPool::Clear(void) {
+				this->Release(Mark{ 0, 0, 0 });
+			}
+
+			bool ObjectPool::Since(Mark const& mark, Mt::core::IMtObject const* object) const {
+				// Newest first, what a call returns is usually the last thing it made
+				for(size_t i = this->entries.size(); i > mark.objects; i--) {
+					if(this->entries[i - 1].object == object)
+						return true;
+				}
+				return false;
+			}
+
+			size_t ObjectPool::Size(void) const {
+				return this->entries.size();
+			}
+
+			void* ObjectPool::Allocate(size_t size) {
+				size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+				// Chunks too small for this one are skipped until the pool is released below them
+				while(this->chunk < this->chunks.size() && this->used + size > this->chunks[this->chunk].size) {
+					this->chunk++;
+					this->used = 0;
+				}
+				if(this->chunk == this->chunks.size()) {
+					const size_t bytes = std::max(CHUNK_SIZE, size);
+					this->chunks.push_back(Chunk{ std::unique_ptr<char[]>(new char[bytes]), bytes });
+				}
+				void* memory = this->chunks[this->chunk].data.get() + this->used;
+				this->used += size;
+				return memory;
+			}
+		}
+	}
+}
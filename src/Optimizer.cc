@@ -0,0 +1,192 @@
+/*
+	Optimizer.cc - Constant folding and simplification of the SML AST
+*/
+#include "core/lang/Optimizer.hh"
+
+#include "core/Config.hh"
+#include "core/lang/Parser.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace {
+				typedef yy::SMLParser::token_type token_type;
+
+				bool IsLiteral(NExpression const* expr) {
+					return expr->type == _NINTEGER || expr->type == _NSCALAR || expr->type == _NCOMPLEX;
+				}
+
+				/*
+					True if expr is an integer literal equal to n, floats never are
+				*/
+				bool IsExactLiteral(NExpression const* expr, int64_t n) {
+					if(expr->type != _NINTEGER)
+						return false;
+					Mt::objects::Integer const& i = static_cast<NInteger const*>(expr)->_i;
+					return i.IsSmall() && i.GetSmall() == n;
+				}
+			}
+
+			Optimizer::Optimizer(EvaluationEngine& eng) : engine(eng), enabled(true), eliminated(0) {
+				std::string optimize = Mt::core::Config::GetInstance()->CfgHasValue("optimize_sml") ? Mt::core::Config::GetInstance()->GetCfgValue("optimize_sml") : CFG_DEF_OPT_SML;
+				if(optimize == "no")
+					this->enabled = false;
+				else if(optimize != "yes")
+					std::cerr << "Warning: Unknown optimize_sml \"" << optimize << "\", using " << CFG_DEF_OPT_SML << std::endl;
+			}
+
+			size_t Optimizer::Run(NBlock* block) {
+				if(!this->enabled || block == nullptr)
+					return 0;
+				size_t before = this->eliminated;
+				this->Block(block);
+				return this->eliminated - before;
+			}
+
+			void Optimizer::SetEnabled(bool enable) {
+				this->enabled = enable;
+			}
+
+			bool Optimizer::GetEnabled(void) const {
+				return this->enabled;
+			}
+
+			size_t Optimizer::GetEliminated(void) const {
+				return this->eliminated;
+			}
+
+			void Optimizer::Block(NBlock* block) {
+				for(auto statement : block->statements) {
+					switch(statement->type) {
+						case _NVARIABLEDECLARATION: {
+							auto vardec = static_cast<NVariableDeclaration*>(statement);
+							if(vardec->_assignmentExpr != nullptr)
+								vardec->_assignmentExpr = this->Expression(vardec->_assignmentExpr);
+							break;
+						} case _NEXPRESSIONSTATEMENT: {
+							auto nexpr = static_cast<NExpressionStatement*>(statement);
+							nexpr->_expression = this->Expression(nexpr->_expression);
+							break;
+						} case _NRETURNSTATEMENT: {
+							auto nret = static_cast<NReturnStatement*>(statement);
+							nret->_expression = this->Expression(nret->_expression);
+							break;
+						} case _NFUNCTIONDECLARATION: {
+							this->Block(&(static_cast<NFunctionDeclaration*>(statement)->_block));
+							break;
+						} default:
+							break;
+					}
+				}
+			}
+
+			NExpression* Optimizer::Expression(NExpression* expr) {
+				switch(expr->type) {
+					case _NBINARYOPERATOR: {
+						auto nbin = static_cast<NBinaryOperator*>(expr);
+						nbin->_lhs = this->Expression(nbin->_lhs);
+						nbin->_rhs = this->Expression(nbin->_rhs);
+						NExpression* lhs = nbin->_lhs;
+						NExpression* rhs = nbin->_rhs;
+						NExpression* folded = this->Fold(nbin);
+						if(folded != nullptr) {
+							delete lhs;
+							delete rhs;
+							delete nbin;
+							this->eliminated += 2;
+							return folded;
+						}
+						// The operand that is left when the other one is an identity
+						NExpression* kept = nullptr;
+						switch(static_cast<token_type>(nbin->_op)) {
+							case token_type::TPLUS:
+								kept = IsExactLiteral(lhs, 0) ? rhs : (IsExactLiteral(rhs, 0) ? lhs : nullptr);
+								break;
+							case token_type::TMUL:
+								kept = IsExactLiteral(lhs, 1) ? rhs : (IsExactLiteral(rhs, 1) ? lhs : nullptr);
+								break;
+							case token_type::TMINUS:
+								kept = IsExactLiteral(rhs, 0) ? lhs : nullptr;
+								break;
+							case token_type::TDIV:
+							case token_type::TPOW:
+								kept = IsExactLiteral(rhs, 1) ? lhs : nullptr;
+								break;
+							default:
+								break;
+						}
+						if(kept != nullptr) {
+							delete ((kept == lhs) ? rhs : lhs);
+							delete nbin;
+							this->eliminated += 2;
+							return kept;
+						}
+						if(nbin->_op == token_type::TPOW) {
+							ExpressionList args;
+							args.push_back(lhs);
+							args.push_back(rhs);
+							auto call = new NMethodCall(*new NIdentifier("pow"), args);
+							delete nbin;
+							return call;
+						}
+						return nbin;
+					} case _NMETHODCALL: {
+						for(auto& arg : static_cast<NMethodCall*>(expr)->_arguments)
+							arg = this->Expression(arg);
+						return expr;
+					} case _NASSIGNMENT: {
+						auto nasgn = static_cast<NAssignment*>(expr);
+						nasgn->_rhs = this->Expression(nasgn->_rhs);
+						return expr;
+					} default:
+						return expr;
+				}
+			}
+
+			NExpression* Optimizer::Fold(NBinaryOperator* nbin) {
+				NExpression const* lhs = nbin->_lhs;
+				NExpression const* rhs = nbin->_rhs;
+				if(!IsLiteral(lhs) || !IsLiteral(rhs))
+					return nullptr;
+				switch(static_cast<token_type>(nbin->_op)) {
+					case token_type::TPLUS:
+					case token_type::TMINUS:
+					case token_type::TMUL:
+						break;
+					case token_type::TDIV:
+						if(IsExactLiteral(rhs, 0))
+							return nullptr;
+						break;
+					case token_type::TPOW:
+						// pow takes reals only, and negative exact powers are rationals
+						if(lhs->type == _NCOMPLEX || (rhs->type == _NINTEGER && static_cast<NInteger const*>(rhs)->_i.IsNegative()))
+							return nullptr;
+						break;
+					default:
+						return nullptr;
+				}
+				// A complex number only combines with another one
+				if((lhs->type == _NCOMPLEX) != (rhs->type == _NCOMPLEX))
+					return nullptr;
+				Value d = this->engine.EvaluateConstant(nbin, PRECISION::DOUBLE);
+				Value e = this->engine.EvaluateConstant(nbin, PRECISION::EXTENDED);
+				Value q = this->engine.EvaluateConstant(nbin, PRECISION::QUAD);
+				if(d.type != e.type || q.type != e.type)
+					return nullptr;
+				switch(e.type) {
+					case TYPE::INTEGER:
+						return new NInteger(e.ToInteger());
+					case TYPE::SCALAR:
+						return new NScalar(d.Get<double>(0), e.Get<long double>(0), q.Get<mtquad_t>(0));
+					case TYPE::COMPLEX: {
+						double dp[2] = { d.Get<double>(0), d.Get<double>(1) };
+						long double ep[2] = { e.Get<long double>(0), e.Get<long double>(1) };
+						mtquad_t qp[2] = { q.Get<mtquad_t>(0), q.Get<mtquad_t>(1) };
+						return new NComplex(dp, ep, qp);
+					} default:
+						return nullptr;
+				}
+			}
+		}
+	}
+}
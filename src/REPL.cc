@@ -3,9 +3,12 @@
 */
 #include "frontend/REPL.hh"
 
+#include <algorithm>
+#include <cstdlib>
+
 namespace Mt {
 	namespace frontend {
-		REPL::REPL(void) {
+		REPL::REPL(void) : optimizer(eengine) {
 			// set the initial line number.
 			this->LineNum = 0;
 			// create a new language driver
@@ -29,11 +32,107 @@ namespace Mt {
 			
 			else if (command == "help"){
 				std::cout << "exit     - it gets you out" << std::endl;
+				std::cout << "precision [double|extended|quad] - shows or sets the session precision tier" << std::endl;
+				std::cout << "engine [bytecode|tree] - shows or sets what runs SML function calls" << std::endl;
+				std::cout << "optimize [on|off] - shows or toggles constant folding, with the nodes it eliminated" << std::endl;
+				std::cout << "memo [on|off|clear|size N|F on|F off] - shows cache hit rates or sets memoization of pure functions" << std::endl;
+				std::cout << "native [on|off] - shows native kernels or toggles compiling hot functions with the host compiler" << std::endl;
+				std::cout << "parallel [on|off] - shows or toggles evaluating independent statements on a line side by side" << std::endl;
+				std::cout << "reactive [on|off|dry|X] - shows or sets recomputing definitions when what they read changes, or lists what X would recompute" << std::endl;
+				std::cout << "run FILE - runs the SML in FILE" << std::endl;
 #if defined(_DEBUG) || defined(DEBUG) 
 				std::cout << "dbg-sml  - toggles SML debugging" << std::endl;
 				std::cout << "dump-gst - prints out the GST" << std::endl;
 #endif
 			}
+
+			else if (command.compare(0, 9, "precision") == 0) {
+				// Everything after "precision " is the tier name
+				std::string tier = (command.length() > 10) ? command.substr(10) : "";
+				Mt::core::PRECISION p;
+				if(tier.empty()) {
+					std::cout << "Precision: " << Mt::core::Precision::ToString(this->eengine.GetPrecision()) << std::endl;
+				} else if(Mt::core::Precision::FromString(tier, p)) {
+					this->eengine.SetPrecision(p);
+					if(!Mt::core::Precision::IsNative(p))
+						std::cout << "Note: this build has no __float128 support, quad is computed as extended" << std::endl;
+					std::cout << "Precision set to " << Mt::core::Precision::ToString(p) << std::endl;
+				} else {
+					std::cout << "Unknown precision '" << tier << "', expected double, extended or quad" << std::endl;
+				}
+			}
+			else if (command.compare(0, 6, "engine") == 0) {
+				std::string engine = (command.length() > 7) ? command.substr(7) : "";
+				if(engine == "bytecode" || engine == "tree") {
+					this->eengine.SetBytecode(engine == "bytecode");
+					std::cout << "Engine set to " << engine << std::endl;
+				} else if(engine.empty()) {
+					std::cout << "Engine: " << (this->eengine.GetBytecode() ? "bytecode" : "tree") << std::endl;
+				} else {
+					std::cout << "Unknown engine '" << engine << "', expected bytecode or tree" << std::endl;
+				}
+			}
+			else if (command.compare(0, 8, "optimize") == 0) {
+				std::string state = (command.length() > 9) ? command.substr(9) : "";
+				if(state == "on" || state == "off")
+					this->optimizer.SetEnabled(state == "on");
+				else if(!state.empty())
+					std::cout << "Unknown optimizer state '" << state << "', expected on or off" << std::endl;
+				std::cout << "Optimizer: " << (this->optimizer.GetEnabled() ? "on" : "off") << ", " << this->optimizer.GetEliminated() << " node(s) eliminated" << std::endl;
+			}
+			else if (command.compare(0, 4, "memo") == 0) {
+				std::string setting = (command.length() > 5) ? command.substr(5) : "";
+				size_t space = setting.find(' ');
+				if(setting.empty()) {
+					this->eengine.PrintMemoStatistics();
+				} else if(setting == "on" || setting == "off") {
+					this->eengine.SetMemoize(setting == "on");
+					std::cout << "Memoization set to " << setting << std::endl;
+				} else if(setting == "clear") {
+					this->eengine.ClearMemos();
+				} else if(setting.compare(0, 5, "size ") == 0 && setting.find_first_not_of("0123456789", 5) == std::string::npos && setting.length() > 5) {
+					this->eengine.SetMemoSize(static_cast<size_t>(std::strtoull(setting.c_str() + 5, nullptr, 10)));
+				} else if(space != std::string::npos && (setting.substr(space + 1) == "on" || setting.substr(space + 1) == "off")) {
+					this->eengine.SetMemoize(setting.substr(0, space), setting.substr(space + 1) == "on");
+					std::cout << "Memoization of " << setting.substr(0, space) << " set to " << setting.substr(space + 1) << std::endl;
+				} else {
+					std::cout << "Unknown memo setting '" << setting << "', expected on, off, clear, size N or a function name and on or off" << std::endl;
+				}
+			}
+			else if (command.compare(0, 6, "native") == 0) {
+				std::string state = (command.length() > 7) ? command.substr(7) : "";
+				if(state == "on" || state == "off")
+					this->eengine.SetNative(state == "on");
+				else if(!state.empty())
+					std::cout << "Unknown native state '" << state << "', expected on or off" << std::endl;
+				this->eengine.PrintNativeStatistics();
+			}
+			else if (command.compare(0, 8, "parallel") == 0) {
+				std::string state = (command.length() > 9) ? command.substr(9) : "";
+				if(state == "on" || state == "off")
+					this->eengine.SetParallel(state == "on");
+				else if(!state.empty())
+					std::cout << "Unknown parallel state '" << state << "', expected on or off" << std::endl;
+				std::cout << "Parallel: " << (this->eengine.GetParallel() ? "on" : "off") << std::endl;
+			}
+			else if (command.compare(0, 8, "reactive") == 0) {
+				std::string setting = (command.length() > 9) ? command.substr(9) : "";
+				if(setting == "on")
+					this->eengine.SetReactive(Mt::core::lang::DependencyGraph::ON);
+				else if(setting == "off")
+					this->eengine.SetReactive(Mt::core::lang::DependencyGraph::OFF);
+				else if(setting == "dry")
+					this->eengine.SetReactive(Mt::core::lang::DependencyGraph::DRY);
+				// Anything else names a global
+				if(setting.empty() || setting == "on" || setting == "off" || setting == "dry")
+					this->eengine.PrintReactive();
+				else
+					this->eengine.PrintDependents(setting);
+			}
+			else if (command.compare(0, 4, "run ") == 0) {
+				if(!this->Run(command.substr(4)))
+					std::cout << "Unable to read '" << command.substr(4) << "'" << std::endl;
+			}
 #if defined(_DEBUG) || defined(DEBUG)
 			else if (command == "dbg-sml") {
 				//  Toggle the SML debugging
@@ -42,10 +141,10 @@ namespace Mt {
 				std::cout << "SML debug tracing toggled (" << std::boolalpha << this->driver->GetIfTracing() << ")" << std::endl;
 			} else if (command == "dump-gst") {
 				// Helpful during debugging to see what is in the GST
-				if(this->GlobalSymbolTable.size() != 0) {
-					for (auto& kvp : this->GlobalSymbolTable ) {
-						std::cout << kvp.first << " := " << kvp.second << std::endl;
-					}
+				if(this->GlobalSymbolTable.Size() != 0) {
+					this->GlobalSymbolTable.ForEach([](Mt::core::lang::Symbol symbol, Mt::core::lang::Value const& value) {
+						std::cout << Mt::core::lang::Symbols::Name(symbol) << " := " << value << std::endl;
+					});
 					std::cout << std::endl;
 				} else {
 					std::cout << "GST EMPTY" << std::endl;
@@ -57,6 +156,56 @@ namespace Mt {
 			}
 		}
 
+		void REPL::ProcessLine(std::string input) {
+			// If the line starts with a ! then it is an internal system command, don't pass it on.
+			if(input[0] == '!') {
+				// Pass on the command minus the bang
+				this->ProcessCommand(input.substr(1));
+				// purge the buffer, this allows for us to skip over eval
+				input.clear();
+			}
+			// Check to see if the line is empty
+			if(!input.empty()) {
+				// If not, try to parse the line
+				if(this->driver->ParseString(input, "Mt REPL")) {
+					// Lets set the current AST ptr to the new one.
+					this->ASTBlock = driver->nblk;
+					// Fold what can be folded before anything is evaluated or compiled
+					this->optimizer.Run(this->ASTBlock);
+					// Evaluate the current AST
+					this->eengine.Evaluate(this->ASTBlock, this->GlobalSymbolTable, input);
+				}
+			}
+		}
+
+		bool REPL::Run(std::string const& path) {
+			std::ifstream file(path);
+			if(!file.is_open())
+				return false;
+			std::string read;
+			std::string statement;
+			// How many { are still waiting for their }
+			long open = 0;
+			while(std::getline(file, read)) {
+				const size_t first = read.find_first_not_of(" \t\r");
+				if(first == std::string::npos || read[first] == '#')
+					continue;
+				const size_t last = read.find_last_not_of(" \t\r");
+				if(!statement.empty())
+					statement += ' ';
+				statement += read.substr(first, last - first + 1);
+				open += std::count(read.begin(), read.end(), '{') - std::count(read.begin(), read.end(), '}');
+				if(open > 0)
+					continue;
+				this->ProcessLine(statement);
+				statement.clear();
+				open = 0;
+			}
+			if(!statement.empty())
+				this->ProcessLine(statement);
+			return true;
+		}
+
 #if !defined(_DUMMY_REPL)
 		// Fancy REPL stuff, 100% broken
 		void REPL::Start(void) {
@@ -75,8 +224,11 @@ namespace Mt {
 			while(this->running) {
 				// Print the prompt in the form of mt:#> 
 				std::cout << "mt:" << this->LineNum++ << "> ";
-				// get the input from cin
-				std::getline(std::cin, strBuffLine);
+				// get the input from cin, there is nothing more to do once it is closed
+				if(!std::getline(std::cin, strBuffLine)) {
+					std::cout << std::endl;
+					break;
+				}
 #if !defined(_NOFUN)
 				// just a fun little easter egg
 				if(strBuffLine == "make") {
@@ -85,23 +237,7 @@ namespace Mt {
 					strBuffLine.clear();
 				}
 #endif	
-				// If the line starts with a ! then it is an internal system command, don't pass it on.
-				if(strBuffLine[0] == '!') {
-					// Pass on the command minus the bang
-					this->ProcessCommand(strBuffLine.substr(1));
-					// purge the buffer, this allows for us to skip over eval
-					strBuffLine.clear();
-				}
-				// Check to see if the line is empty
-				if(!strBuffLine.empty()) {
-					// If not, try to parse the line
-					if(this->driver->ParseString(strBuffLine, "Mt REPL")) {
-						// Lets set the current AST ptr to the new one.
-						this->ASTBlock = driver->nblk;
-						// Evaluate the current AST
-						this->eengine.Evaluate(this->ASTBlock, this->GlobalSymbolTable, strBuffLine);
-					}	
-				}	
+				this->ProcessLine(strBuffLine);
 			}
 		}
 #endif
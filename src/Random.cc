@@ -0,0 +1,196 @@
+/*
+	Random.cc - Counter based random numbers
+*/
+#include "core/Random.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "core/WorkerPool.hh"
+
+namespace Mt {
+	namespace core {
+		namespace {
+			// Philox4x32 multipliers and Weyl key increments
+			const uint32_t M0 = 0xD2511F53u;
+			const uint32_t M1 = 0xCD9E8D57u;
+			const uint32_t W0 = 0x9E3779B9u;
+			const uint32_t W1 = 0xBB67AE85u;
+			const size_t ROUNDS = 10;
+			const size_t WORDS = 4;
+			// Counters that go through the rounds together
+			const size_t LANES = 16;
+			// Numbers a worker takes at a time, fills under two of these stay on the calling thread
+			const size_t CHUNK = 1u << 14;
+
+			const long double TWO_PI = 6.283185307179586476925286766559005768L;
+			const long double TO_UNIT_64 = 1.0L / 18446744073709551616.0L;
+			const long double TO_UNIT_63 = 1.0L / 9223372036854775808.0L;
+			const double TO_UNIT_53 = 1.0 / 9007199254740992.0;
+
+			/*
+				Runs LANES counters through the rounds in place, word j of lane l is in c[j][l]. Each
+				round writes to separate arrays so the lane loop has no aliasing to rule out and
+				vectorizes, the 32 x 32 bit multiplies become pmuludq.
+			*/
+			void Rounds(uint32_t (&c)[WORDS][LANES], uint32_t k0, uint32_t k1) {
+				for(size_t r = 0; r < ROUNDS; r++) {
+					uint32_t x0[LANES], x1[LANES], x2[LANES], x3[LANES];
+					for(size_t l = 0; l < LANES; l++) {
+						uint64_t p0 = static_cast<uint64_t>(M0) * c[0][l];
+						uint64_t p1 = static_cast<uint64_t>(M1) * c[2][l];
+						x0[l] = static_cast<uint32_t>(p1 >> 32) ^ c[1][l] ^ k0;
+						x1[l] = static_cast<uint32_t>(p1);
+						x2[l] = static_cast<uint32_t>(p0 >> 32) ^ c[3][l] ^ k1;
+						x3[l] = static_cast<uint32_t>(p0);
+					}
+					for(size_t l = 0; l < LANES; l++) {
+						c[0][l] = x0[l];
+						c[1][l] = x1[l];
+						c[2][l] = x2[l];
+						c[3][l] = x3[l];
+					}
+					k0 += W0;
+					k1 += W1;
+				}
+			}
+
+			/*
+				Calls emit(block, c, lanes) for every batch of blocks from first to last, block + l is in
+				lane l of c for l < lanes
+			*/
+			template <class Emit>
+			void ForBlocks(uint32_t const (&key)[2], uint32_t const (&stream)[2], uint64_t first, uint64_t last, Emit emit) {
+				uint32_t c[WORDS][LANES];
+				for(uint64_t b = first;; b += LANES) {
+					for(size_t l = 0; l < LANES; l++) {
+						uint64_t index = b + l;
+						c[0][l] = static_cast<uint32_t>(index);
+						c[1][l] = static_cast<uint32_t>(index >> 32);
+						c[2][l] = stream[0];
+						c[3][l] = stream[1];
+					}
+					Rounds(c, key[0], key[1]);
+					emit(b, c, static_cast<size_t>(std::min<uint64_t>(LANES - 1, last - b)) + 1);
+					if(last - b < LANES)
+						break;
+				}
+			}
+
+			/*
+				Calls emit(i, w0, w1) for every block covering positions first to first + count - 1, w0
+				and w1 are the block's 64 bit words for positions i and i + 1 relative to first. Either
+				may fall outside [0, count) in the first and last block.
+			*/
+			template <class Emit>
+			void ForPairs(uint32_t const (&key)[2], uint32_t const (&stream)[2], uint64_t first, size_t count, Emit emit) {
+				if(count == 0)
+					return;
+				const uint64_t last = first + count - 1;
+				ForBlocks(key, stream, first / 2, last / 2, [&](uint64_t block, uint32_t const (&c)[WORDS][LANES], size_t lanes) {
+					for(size_t l = 0; l < lanes; l++) {
+						const uint64_t even = 2 * (block + l);
+						const uint64_t w0 = (static_cast<uint64_t>(c[1][l]) << 32) | c[0][l];
+						const uint64_t w1 = (static_cast<uint64_t>(c[3][l]) << 32) | c[2][l];
+						emit(static_cast<ptrdiff_t>(even - first), w0, w1);
+					}
+				});
+			}
+		}
+
+		Philox::Philox(uint64_t seed, uint64_t streamId) {
+			this->key[0] = static_cast<uint32_t>(seed);
+			this->key[1] = static_cast<uint32_t>(seed >> 32);
+			this->stream[0] = static_cast<uint32_t>(streamId);
+			this->stream[1] = static_cast<uint32_t>(streamId >> 32);
+		}
+
+		Philox Philox::Stream(uint64_t streamId) const {
+			Philox other(*this);
+			other.stream[0] = static_cast<uint32_t>(streamId);
+			other.stream[1] = static_cast<uint32_t>(streamId >> 32);
+			return other;
+		}
+
+		void Philox::Blocks(uint64_t first, uint32_t* out, size_t count) const {
+			if(count == 0)
+				return;
+			ForBlocks(this->key, this->stream, first, first + count - 1, [&](uint64_t block, uint32_t const (&c)[WORDS][LANES], size_t lanes) {
+				uint32_t* o = out + ((block - first) * WORDS);
+				for(size_t l = 0; l < lanes; l++) {
+					for(size_t j = 0; j < WORDS; j++)
+						o[(l * WORDS) + j] = c[j][l];
+				}
+			});
+		}
+
+		void Philox::Uniform(uint64_t first, long double* out, size_t count) const {
+			const ptrdiff_t n = static_cast<ptrdiff_t>(count);
+			ForPairs(this->key, this->stream, first, count, [&](ptrdiff_t i, uint64_t w0, uint64_t w1) {
+				if(i >= 0)
+					out[i] = static_cast<long double>(w0) * TO_UNIT_64;
+				if(i + 1 < n)
+					out[i + 1] = static_cast<long double>(w1) * TO_UNIT_64;
+			});
+		}
+
+		void Philox::Uniform(uint64_t first, double* out, size_t count) const {
+			const ptrdiff_t n = static_cast<ptrdiff_t>(count);
+			ForPairs(this->key, this->stream, first, count, [&](ptrdiff_t i, uint64_t w0, uint64_t w1) {
+				if(i >= 0)
+					out[i] = static_cast<double>(w0 >> 11) * TO_UNIT_53;
+				if(i + 1 < n)
+					out[i + 1] = static_cast<double>(w1 >> 11) * TO_UNIT_53;
+			});
+		}
+
+		void Philox::Normal(uint64_t first, long double* out, size_t count) const {
+			const ptrdiff_t n = static_cast<ptrdiff_t>(count);
+			ForPairs(this->key, this->stream, first, count, [&](ptrdiff_t i, uint64_t w0, uint64_t w1) {
+				// w0 goes to (0, 1] so it has a logarithm
+				const long double radius = std::sqrt(-2.0L * std::log(static_cast<long double>((w0 >> 1) + 1) * TO_UNIT_63));
+				const long double angle = TWO_PI * (static_cast<long double>(w1) * TO_UNIT_64);
+				if(i >= 0)
+					out[i] = radius * std::cos(angle);
+				if(i + 1 < n)
+					out[i + 1] = radius * std::sin(angle);
+			});
+		}
+
+		void Philox::Normal(uint64_t first, double* out, size_t count) const {
+			const ptrdiff_t n = static_cast<ptrdiff_t>(count);
+			ForPairs(this->key, this->stream, first, count, [&](ptrdiff_t i, uint64_t w0, uint64_t w1) {
+				const double radius = std::sqrt(-2.0 * std::log(static_cast<double>((w0 >> 11) + 1) * TO_UNIT_53));
+				const double angle = static_cast<double>(TWO_PI) * (static_cast<double>(w1 >> 11) * TO_UNIT_53);
+				if(i >= 0)
+					out[i] = radius * std::cos(angle);
+				if(i + 1 < n)
+					out[i + 1] = radius * std::sin(angle);
+			});
+		}
+
+		namespace Random {
+			void Fill(Philox const& generator, DISTRIBUTION distribution, long double* out, size_t count, unsigned threads) {
+				auto chunk = [&](size_t begin, size_t n) {
+					if(distribution == NORMAL)
+						generator.Normal(begin, out + begin, n);
+					else
+						generator.Uniform(begin, out + begin, n);
+				};
+				const unsigned workers = WorkerPool::Workers(threads);
+				if(count < 2 * CHUNK || workers == 1) {
+					chunk(0, count);
+					return;
+				}
+				const size_t chunks = (count + CHUNK - 1) / CHUNK;
+				WorkerPool pool(std::min<size_t>(workers, chunks));
+				std::atomic<size_t> next(0);
+				pool.Run([&](size_t) {
+					for(size_t c = next++; c < chunks; c = next++)
+						chunk(c * CHUNK, std::min(CHUNK, count - (c * CHUNK)));
+				});
+			}
+		}
+	}
+}
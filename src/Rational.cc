@@ -0,0 +1,217 @@
+/*
+	Rational.cc - Implementation Details for the exact rational class
+*/
+
+#include <stdexcept>
+
+#include "objects/Rational.hh"
+
+using Mt::core::hpn::AddOverflow;
+using Mt::core::hpn::MulOverflow;
+
+namespace Mt {
+	namespace objects {
+		namespace {
+			inline uint64_t Magnitude(int64_t v) {
+				return (v < 0) ? (0ull - static_cast<uint64_t>(v)) : static_cast<uint64_t>(v);
+			}
+
+			/*
+				a/b + c/d on machine words with b, d > 0 and both fractions reduced. Dividing by the
+				GCD of the denominators first keeps the intermediates small and means only the GCD
+				with that factor is needed to reduce the result (Knuth, TAOCP vol. 2, 4.5.1).
+				Returns false on overflow.
+			*/
+			bool SmallAdd(int64_t a, int64_t b, int64_t c, int64_t d, int64_t& n, int64_t& den) {
+				int64_t g = static_cast<int64_t>(Mt::core::hpn::Gcd(static_cast<uint64_t>(b), static_cast<uint64_t>(d)));
+				int64_t t1, t2;
+				if(MulOverflow(a, d / g, t1) || MulOverflow(c, b / g, t2) || AddOverflow(t1, t2, n) || MulOverflow(b / g, d, den))
+					return false;
+				if(n == INT64_MIN)
+					return false;
+				if(n == 0) {
+					den = 1;
+					return true;
+				}
+				int64_t g2 = static_cast<int64_t>(Mt::core::hpn::Gcd(Magnitude(n), static_cast<uint64_t>(g)));
+				n /= g2;
+				den /= g2;
+				return true;
+			}
+
+			/*
+				a/b * c/d on machine words, cross reducing before multiplying. Returns false on overflow.
+			*/
+			bool SmallMul(int64_t a, int64_t b, int64_t c, int64_t d, int64_t& n, int64_t& den) {
+				if(a == INT64_MIN || c == INT64_MIN)
+					return false;
+				int64_t g1 = static_cast<int64_t>(Mt::core::hpn::Gcd(Magnitude(a), static_cast<uint64_t>(d)));
+				int64_t g2 = static_cast<int64_t>(Mt::core::hpn::Gcd(Magnitude(c), static_cast<uint64_t>(b)));
+				if(g1 == 0) g1 = 1;
+				if(g2 == 0) g2 = 1;
+				if(MulOverflow(a / g1, c / g2, n) || MulOverflow(b / g2, d / g1, den))
+					return false;
+				if(n == 0)
+					den = 1;
+				return true;
+			}
+		}
+
+		// Constructors
+		Rational::Rational(void) : Numerator(0), Denominator(1) {
+			this->DerivedType = Mt::core::TYPE::RATIONAL;
+		}
+
+		Rational::Rational(Mt::objects::Integer const& num) : Numerator(num), Denominator(1) {
+			this->DerivedType = Mt::core::TYPE::RATIONAL;
+		}
+
+		Rational::Rational(Mt::objects::Integer const& num, Mt::objects::Integer const& den) : Numerator(num), Denominator(den) {
+			this->DerivedType = Mt::core::TYPE::RATIONAL;
+			if(den.IsZero())
+				throw std::domain_error("Rational with a zero denominator");
+			this->Normalize();
+		}
+
+		Rational::Rational(Rational const& r) : INumeric(), Numerator(r.Numerator), Denominator(r.Denominator) {
+			this->DerivedType = Mt::core::TYPE::RATIONAL;
+		}
+
+		Rational::Rational(Rational&& r) : INumeric(), Numerator(std::move(r.Numerator)), Denominator(std::move(r.Denominator)) {
+			this->DerivedType = Mt::core::TYPE::RATIONAL;
+		}
+
+		// Destructor
+		Rational::~Rational(void) {
+
+		}
+
+		/*!
+			Reduces to lowest terms and moves the sign onto the numerator
+		*/
+		void Rational::Normalize(void) {
+			if(this->Denominator.IsNegative()) {
+				this->Numerator = -this->Numerator;
+				this->Denominator = -this->Denominator;
+			}
+			if(this->Numerator.IsZero()) {
+				this->Denominator = Integer(1);
+				return;
+			}
+			Integer g = Integer::Gcd(this->Numerator, this->Denominator);
+			if(!g.IsOne()) {
+				this->Numerator = this->Numerator / g;
+				this->Denominator = this->Denominator / g;
+			}
+		}
+
+		// Misc methods
+		Mt::objects::Integer const& Rational::GetNumerator(void) const {
+			return this->Numerator;
+		}
+
+		Mt::objects::Integer const& Rational::GetDenominator(void) const {
+			return this->Denominator;
+		}
+
+		bool Rational::IsInteger(void) const {
+			return this->Denominator.IsOne();
+		}
+
+		bool Rational::IsZero(void) const {
+			return this->Numerator.IsZero();
+		}
+
+		std::string Rational::ToString(void) const {
+			if(this->IsInteger())
+				return this->Numerator.ToString();
+			return this->Numerator.ToString() + "/" + this->Denominator.ToString();
+		}
+
+		// Operator overloads
+		Rational& Rational::operator=(Rational const& rhs) {
+			this->Numerator = rhs.Numerator;
+			this->Denominator = rhs.Denominator;
+			return *this;
+		}
+
+		// Basic Arithmetic operations
+		Rational Rational::operator+(Rational const& rhs) const {
+			Rational r;
+			if(this->Numerator.IsSmall() && this->Denominator.IsSmall() && rhs.Numerator.IsSmall() && rhs.Denominator.IsSmall()) {
+				int64_t n, d;
+				if(SmallAdd(this->Numerator.GetSmall(), this->Denominator.GetSmall(), rhs.Numerator.GetSmall(), rhs.Denominator.GetSmall(), n, d)) {
+					r.Numerator = Integer(n);
+					r.Denominator = Integer(d);
+					return r;
+				}
+			}
+			return Rational((this->Numerator * rhs.Denominator) + (rhs.Numerator * this->Denominator), this->Denominator * rhs.Denominator);
+		}
+
+		Rational Rational::operator-(Rational const& rhs) const {
+			return *this + (-rhs);
+		}
+
+		Rational Rational::operator*(Rational const& rhs) const {
+			Rational r;
+			if(this->Numerator.IsSmall() && this->Denominator.IsSmall() && rhs.Numerator.IsSmall() && rhs.Denominator.IsSmall()) {
+				int64_t n, d;
+				if(SmallMul(this->Numerator.GetSmall(), this->Denominator.GetSmall(), rhs.Numerator.GetSmall(), rhs.Denominator.GetSmall(), n, d)) {
+					r.Numerator = Integer(n);
+					r.Denominator = Integer(d);
+					return r;
+				}
+			}
+			return Rational(this->Numerator * rhs.Numerator, this->Denominator * rhs.Denominator);
+		}
+
+		Rational Rational::operator/(Rational const& rhs) const {
+			if(rhs.IsZero())
+				throw std::domain_error("Rational division by zero");
+			// Multiply by the reciprocal, keeping the denominator positive
+			Rational inv;
+			inv.Numerator = rhs.Numerator.IsNegative() ? -rhs.Denominator : rhs.Denominator;
+			inv.Denominator = rhs.Numerator.IsNegative() ? -rhs.Numerator : rhs.Numerator;
+			return *this * inv;
+		}
+
+		Rational Rational::operator-() const {
+			Rational r(*this);
+			r.Numerator = -r.Numerator;
+			return r;
+		}
+
+		// Comparison operators
+		bool Rational::operator==(Rational const& rhs) const {
+			// Both sides are in lowest terms, so equal values have equal parts
+			return (this->Numerator == rhs.Numerator) && (this->Denominator == rhs.Denominator);
+		}
+
+		bool Rational::operator!=(Rational const& rhs) const {
+			return !(*this == rhs);
+		}
+
+		bool Rational::operator>(Rational const& rhs) const {
+			return rhs < *this;
+		}
+
+		bool Rational::operator<(Rational const& rhs) const {
+			// Denominators are positive so cross multiplying keeps the order
+			return (this->Numerator * rhs.Denominator) < (rhs.Numerator * this->Denominator);
+		}
+
+		bool Rational::operator>=(Rational const& rhs) const {
+			return !(*this < rhs);
+		}
+
+		bool Rational::operator<=(Rational const& rhs) const {
+			return !(rhs < *this);
+		}
+
+		// Stream overloads
+		std::ostream& operator<<(std::ostream& os, const Rational& r) {
+			return (os << r.ToString());
+		}
+	}
+}
@@ -6,147 +6,183 @@
 
 namespace Mt {
 	namespace objects {
-		Scalar::Scalar(){
+		template <class F>
+		BasicScalar<F>::BasicScalar(){
 			Internal = 0;
 			this->DerivedType = Mt::core::TYPE::SCALAR;
 		}
 
-		Scalar::Scalar(mtfloat_t num){
+		template <class F>
+		BasicScalar<F>::BasicScalar(F num){
 			Internal = num;
 			this->DerivedType = Mt::core::TYPE::SCALAR;
 		}
 
-		Scalar::Scalar(Scalar&& s){
+		template <class F>
+		BasicScalar<F>::BasicScalar(BasicScalar&& s){
 			Internal = s.Internal;
 			this->DerivedType = Mt::core::TYPE::SCALAR;
 		}
 
-		Scalar::Scalar(Scalar& s){
+		template <class F>
+		BasicScalar<F>::BasicScalar(BasicScalar& s){
 			Internal = s.Internal;
 			this->DerivedType = Mt::core::TYPE::SCALAR;
 		}
 
-		Scalar::Scalar(Scalar const& s){
+		template <class F>
+		BasicScalar<F>::BasicScalar(BasicScalar const& s){
 			Internal = s.Internal;
 			this->DerivedType = Mt::core::TYPE::SCALAR;
 		}
 
-		Scalar::~Scalar() {
+		template <class F>
+		BasicScalar<F>::~BasicScalar() {
 		
 		}
 		
-		mtfloat_t Scalar::GetInternal() {
+		template <class F>
+		F BasicScalar<F>::GetInternal() const {
 			return Internal;
 		}
 
 		/*!
 			The assignment operator, this should check for type so you cant assign a Mt::Complex to an Mt::Integer
 		*/
-		Scalar& Scalar::operator=(Scalar const& rhs){
+		template <class F>
+		BasicScalar<F>& BasicScalar<F>::operator=(BasicScalar const& rhs){
 			Internal = rhs.Internal;
 			return *this;
 		}
-		Scalar& Scalar::operator=(Scalar& rhs){
+		template <class F>
+		BasicScalar<F>& BasicScalar<F>::operator=(BasicScalar& rhs){
 			Internal = rhs.Internal;
 			return *this;
 		}
-		Scalar& Scalar::operator=(mtfloat_t const& rhs){
+		template <class F>
+		BasicScalar<F>& BasicScalar<F>::operator=(F const& rhs){
 			Internal = rhs;
 			return *this;
 		}
 
 		// Basic Arithmetic operations
-		Scalar Scalar::operator+(Scalar& rhs){
-			Scalar s(Internal + rhs.Internal);
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator+(BasicScalar& rhs){
+			BasicScalar s(Internal + rhs.Internal);
 			return s;
 		}
-		Scalar Scalar::operator-(Scalar& rhs){
-			Scalar s(Internal - rhs.Internal);
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator-(BasicScalar& rhs){
+			BasicScalar s(Internal - rhs.Internal);
 			return s;
 		}
-		Scalar Scalar::operator*(Scalar& rhs){
-			Scalar s(Internal * rhs.Internal);
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator*(BasicScalar& rhs){
+			BasicScalar s(Internal * rhs.Internal);
 			return s;
 		}
 
-		Scalar Scalar::operator/(Scalar& rhs){
-			Scalar s(Internal / rhs.Internal);
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator/(BasicScalar& rhs){
+			BasicScalar s(Internal / rhs.Internal);
 			return s;
 		}
 		
-		Scalar& Scalar::operator+=(Scalar const& rhs) {
+		template <class F>
+		BasicScalar<F>& BasicScalar<F>::operator+=(BasicScalar const& rhs) {
 			Internal += rhs.Internal;
 			return *this;
 		}
 
-		Scalar& Scalar::operator++(int){
+		template <class F>
+		BasicScalar<F>& BasicScalar<F>::operator++(int){
 			Internal++;
 			return *this;
 		}
-		Scalar& Scalar::operator--(int){
+		template <class F>
+		BasicScalar<F>& BasicScalar<F>::operator--(int){
 			Internal--;
 			return *this;
 		}
 
-		// Basic Arithmetic operations mtfloat_t
-		Scalar Scalar::operator+(mtfloat_t& rhs){
-			Scalar s(Internal + rhs);
+		// Basic Arithmetic operations on the raw float type
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator+(F& rhs){
+			BasicScalar s(Internal + rhs);
 			return s;
 		}
-		Scalar Scalar::operator-(mtfloat_t& rhs){
-			Scalar s(Internal - rhs);
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator-(F& rhs){
+			BasicScalar s(Internal - rhs);
 			return s;
 		}
-		Scalar Scalar::operator*(mtfloat_t& rhs){
-			Scalar s(Internal * rhs);
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator*(F& rhs){
+			BasicScalar s(Internal * rhs);
 			return s;
 		}
-		Scalar Scalar::operator/(mtfloat_t& rhs){
-			Scalar s(Internal / rhs);
+		template <class F>
+		BasicScalar<F> BasicScalar<F>::operator/(F& rhs){
+			BasicScalar s(Internal / rhs);
 			return s;
 		}
 
-		// Comparison Scalar::operators
-		bool Scalar::operator==(Scalar const& rhs){
+		// Comparison operators
+		template <class F>
+		bool BasicScalar<F>::operator==(BasicScalar const& rhs){
 			return Internal == rhs.Internal;
 		}
-		bool Scalar::operator!=(Scalar const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator!=(BasicScalar const& rhs){
 			return Internal != rhs.Internal;
 		}
-		bool Scalar::operator>(Scalar const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator>(BasicScalar const& rhs){
 			return Internal > rhs.Internal;
 		}
-		bool Scalar::operator<(Scalar const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator<(BasicScalar const& rhs){
 			return Internal < rhs.Internal;
 		}
-		bool Scalar::operator>=(Scalar const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator>=(BasicScalar const& rhs){
 			return Internal >= rhs.Internal;
 		}
-		bool Scalar::operator<=(Scalar const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator<=(BasicScalar const& rhs){
 			return Internal <= rhs.Internal;
 		}
-		// Comparison mtfloat_t
-		bool Scalar::operator==(mtfloat_t const& rhs){
+		// Comparison on the raw float type
+		template <class F>
+		bool BasicScalar<F>::operator==(F const& rhs){
 			return Internal == rhs;
 		}
-		bool Scalar::operator!=(mtfloat_t const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator!=(F const& rhs){
 			return Internal != rhs;
 		}
-		bool Scalar::operator>(mtfloat_t const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator>(F const& rhs){
 			return Internal > rhs;
 		}
-		bool Scalar::operator<(mtfloat_t const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator<(F const& rhs){
 			return Internal < rhs;
 		}
-		bool Scalar::operator>=(mtfloat_t const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator>=(F const& rhs){
 			return Internal >= rhs;
 		}
-		bool Scalar::operator<=(mtfloat_t const& rhs){
+		template <class F>
+		bool BasicScalar<F>::operator<=(F const& rhs){
 			return Internal <= rhs;
 		}
 
-		std::ostream& operator<<(std::ostream& os, const Scalar& sclr) {
-			return (os << sclr.Internal);
-		}
+		// One scalar per precision tier, the HPN builds' mtfloat_t is the quad tier
+		template class BasicScalar<double>;
+		template class BasicScalar<long double>;
+#if defined(_MT_HAS_QUAD)
+		template class BasicScalar<mtquad_t>;
+#endif
 	}
 }
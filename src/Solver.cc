@@ -0,0 +1,524 @@
+/*
+	Solver.cc - Numeric root finding and minimization
+*/
+#include "core/symbolic/Solver.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "core/WorkerPool.hh"
+
+namespace Mt {
+	namespace core {
+		namespace symbolic {
+			namespace {
+				const long double DEFAULT_TOLERANCE = 1e-18L;
+				const long double DEFAULT_GRADIENT_TOLERANCE = 1e-10L;
+				const size_t DEFAULT_MAX_ITERATIONS = 1000;
+				// Correction pairs L-BFGS remembers
+				const size_t LBFGS_MEMORY = 8;
+				// Armijo sufficient decrease constant
+				const long double ARMIJO = 1e-4L;
+				// Backtracking steps tried per batch, each half the one before
+				const size_t LINE_SEARCH_BATCH = 4;
+				// Relative decrease below which a minimizer is at the noise floor of the function
+				const long double STATIONARY = 16.0L * LDBL_EPSILON;
+
+				/*
+					Evaluates f and counts the points, anything f throws is reported as a failure
+				*/
+				bool Evaluate(BatchFunction& f, const long double* points, long double* values, size_t count, Solution& solution) {
+					solution.evaluations += count;
+					try {
+						return f.Evaluate(points, values, count);
+					} catch(std::exception& ex) {
+						// Solvers run on worker threads, nothing may escape
+						std::cerr << "Error: " << ex.what() << std::endl;
+						return false;
+					}
+				}
+
+				long double Scale(long double x) {
+					return std::max(1.0L, std::fabs(x));
+				}
+
+				long double Dot(const long double* a, const long double* b, size_t n) {
+					long double sum = 0.0L;
+					for(size_t i = 0; i < n; i++)
+						sum += a[i] * b[i];
+					return sum;
+				}
+
+				/*
+					Central difference gradient at x, the 2n offset points are evaluated in one batch.
+					The step is the cube root of epsilon, which balances truncation against rounding.
+				*/
+				bool Gradient(BatchFunction& f, const long double* x, size_t n, long double* g, std::vector<long double>& scratch, Solution& solution) {
+					static const long double STEP = std::cbrt(LDBL_EPSILON);
+					scratch.resize((2 * n * n) + (2 * n) + n);
+					long double* points = scratch.data();
+					long double* values = points + (2 * n * n);
+					long double* steps = values + (2 * n);
+					for(size_t i = 0; i < n; i++) {
+						long double* lo = points + (2 * i * n);
+						long double* hi = lo + n;
+						std::copy(x, x + n, lo);
+						std::copy(x, x + n, hi);
+						volatile long double shifted = x[i] + (STEP * Scale(x[i]));
+						// The step actually taken, after rounding
+						steps[i] = shifted - x[i];
+						hi[i] = x[i] + steps[i];
+						lo[i] = x[i] - steps[i];
+					}
+					if(!Evaluate(f, points, values, 2 * n, solution))
+						return false;
+					for(size_t i = 0; i < n; i++)
+						g[i] = (values[(2 * i) + 1] - values[2 * i]) / (2.0L * steps[i]);
+					return true;
+				}
+
+				long double Largest(const long double* v, size_t n) {
+					long double largest = 0.0L;
+					for(size_t i = 0; i < n; i++)
+						largest = std::max(largest, std::fabs(v[i]));
+					return largest;
+				}
+			}
+
+			SolverOptions::SolverOptions(void) : tolerance(DEFAULT_TOLERANCE), gradientTolerance(DEFAULT_GRADIENT_TOLERANCE),
+				maxIterations(DEFAULT_MAX_ITERATIONS), threads(0) {
+
+			}
+
+			STATUS Brent(BatchFunction& f, long double a, long double b, SolverOptions const& options, Solution& solution) {
+				solution.iterations = 0;
+				solution.evaluations = 0;
+				long double ends[2] = { a, b };
+				long double values[2];
+				if(!Evaluate(f, ends, values, 2, solution))
+					return FAILED;
+				long double fa = values[0], fb = values[1];
+				solution.x.assign(1, (std::fabs(fa) < std::fabs(fb)) ? a : b);
+				solution.value = std::min(std::fabs(fa), std::fabs(fb));
+				if(fa == 0.0L || fb == 0.0L) {
+					solution.value = 0.0L;
+					return CONVERGED;
+				}
+				if((fa > 0.0L) == (fb > 0.0L))
+					return NO_BRACKET;
+
+				// b is the best estimate, a the previous one and c the other end of the bracket around the root
+				long double c = a, fc = fa;
+				long double d = b - a, e = d;
+				for(; solution.iterations < options.maxIterations; solution.iterations++) {
+					if((fb > 0.0L) == (fc > 0.0L)) {
+						c = a;
+						fc = fa;
+						d = e = b - a;
+					}
+					if(std::fabs(fc) < std::fabs(fb)) {
+						a = b;
+						b = c;
+						c = a;
+						fa = fb;
+						fb = fc;
+						fc = fa;
+					}
+					long double tol = (2.0L * LDBL_EPSILON * std::fabs(b)) + (0.5L * options.tolerance * Scale(b));
+					long double m = 0.5L * (c - b);
+					if(std::fabs(m) <= tol || fb == 0.0L) {
+						solution.x.assign(1, b);
+						solution.value = fb;
+						return CONVERGED;
+					}
+					if(std::fabs(e) < tol || std::fabs(fa) <= std::fabs(fb)) {
+						// Bisect
+						d = e = m;
+					} else {
+						long double p, q;
+						long double s = fb / fa;
+						if(a == c) {
+							// Secant
+							p = 2.0L * m * s;
+							q = 1.0L - s;
+						} else {
+							// Inverse quadratic interpolation
+							long double r = fb / fc;
+							q = fa / fc;
+							p = s * ((2.0L * m * q * (q - r)) - ((b - a) * (r - 1.0L)));
+							q = (q - 1.0L) * (r - 1.0L) * (s - 1.0L);
+						}
+						if(p > 0.0L)
+							q = -q;
+						else
+							p = -p;
+						// Only trust the interpolation while it stays inside the bracket and keeps converging
+						if((2.0L * p) < std::min((3.0L * m * q) - std::fabs(tol * q), std::fabs(e * q))) {
+							e = d;
+							d = p / q;
+						} else {
+							d = e = m;
+						}
+					}
+					a = b;
+					fa = fb;
+					b += (std::fabs(d) > tol) ? d : ((m > 0.0L) ? tol : -tol);
+					if(!Evaluate(f, &b, &fb, 1, solution))
+						return FAILED;
+				}
+				solution.x.assign(1, b);
+				solution.value = fb;
+				return STALLED;
+			}
+
+			STATUS Newton(BatchFunction& f, long double x0, SolverOptions const& options, Solution& solution) {
+				// Fifth root of epsilon balances the stencil's truncation against rounding
+				static const long double STEP = std::pow(LDBL_EPSILON, 0.2L);
+				solution.iterations = 0;
+				solution.evaluations = 0;
+				long double x = x0;
+				long double points[5];
+				long double values[5];
+				for(; solution.iterations < options.maxIterations; solution.iterations++) {
+					long double h = STEP * Scale(x);
+					points[0] = x;
+					points[1] = x - (2.0L * h);
+					points[2] = x - h;
+					points[3] = x + h;
+					points[4] = x + (2.0L * h);
+					if(!Evaluate(f, points, values, 5, solution))
+						return FAILED;
+					solution.x.assign(1, x);
+					solution.value = values[0];
+					if(values[0] == 0.0L)
+						return CONVERGED;
+					long double slope = (values[1] - (8.0L * values[2]) + (8.0L * values[3]) - values[4]) / (12.0L * h);
+					long double step = values[0] / slope;
+					if(!std::isfinite(step))
+						return STALLED;
+					x -= step;
+					if(std::fabs(step) <= options.tolerance * Scale(x)) {
+						if(!Evaluate(f, &x, &solution.value, 1, solution))
+							return FAILED;
+						solution.x.assign(1, x);
+						return CONVERGED;
+					}
+				}
+				return STALLED;
+			}
+
+			STATUS Roots(BatchFunction& f, long double a, long double b, size_t samples, SolverOptions const& options, std::vector<long double>& roots) {
+				roots.clear();
+				samples = std::max<size_t>(samples, 2);
+				std::vector<std::unique_ptr<BatchFunction>> forks;
+				std::vector<BatchFunction*> functions = f.ForkWorkers(WorkerPool::Workers(options.threads), forks);
+				WorkerPool workers(functions.size());
+				std::atomic<bool> failed(false);
+
+				// Sample the interval, every worker evaluates its share of the grid in one batch
+				std::vector<long double> grid(samples + 1);
+				std::vector<long double> values(samples + 1);
+				for(size_t i = 0; i <= samples; i++)
+					grid[i] = a + ((b - a) * (static_cast<long double>(i) / static_cast<long double>(samples)));
+				workers.Run([&](size_t worker) {
+					size_t first = (grid.size() * worker) / workers.Size();
+					size_t last = (grid.size() * (worker + 1)) / workers.Size();
+					Solution counter;
+					counter.evaluations = 0;
+					if(first != last && !Evaluate(*functions[worker], grid.data() + first, values.data() + first, last - first, counter))
+						failed = true;
+				});
+				if(failed)
+					return FAILED;
+
+				std::vector<size_t> brackets;
+				for(size_t i = 0; i <= samples; i++) {
+					if(values[i] == 0.0L)
+						roots.push_back(grid[i]);
+					else if(i < samples && values[i + 1] != 0.0L && (values[i] > 0.0L) != (values[i + 1] > 0.0L))
+						brackets.push_back(i);
+				}
+
+				// Refine the brackets, workers take the next one until they are all done
+				std::vector<long double> refined(brackets.size());
+				std::atomic<size_t> next(0);
+				std::atomic<bool> stalled(false);
+				workers.Run([&](size_t worker) {
+					Solution solution;
+					for(size_t i = next++; i < brackets.size() && !failed; i = next++) {
+						STATUS status = Brent(*functions[worker], grid[brackets[i]], grid[brackets[i] + 1], options, solution);
+						if(status == FAILED)
+							failed = true;
+						else if(status != CONVERGED)
+							stalled = true;
+						else
+							refined[i] = solution.x[0];
+					}
+				});
+				if(failed)
+					return FAILED;
+				roots.insert(roots.end(), refined.begin(), refined.end());
+				std::sort(roots.begin(), roots.end());
+				return stalled ? STALLED : CONVERGED;
+			}
+
+			STATUS NelderMead(BatchFunction& f, const long double* start, size_t dimension, SolverOptions const& options, Solution& solution) {
+				const size_t n = dimension;
+				solution.iterations = 0;
+				solution.evaluations = 0;
+				// n + 1 vertices, the first is the start and each other one is a step along one axis
+				std::vector<long double> simplex((n + 1) * n);
+				std::vector<long double> values(n + 1);
+				for(size_t v = 0; v <= n; v++) {
+					std::copy(start, start + n, simplex.data() + (v * n));
+					if(v != 0)
+						simplex[(v * n) + (v - 1)] += (start[v - 1] != 0.0L) ? 0.05L * start[v - 1] : 0.00025L;
+				}
+				if(!Evaluate(f, simplex.data(), values.data(), n + 1, solution))
+					return FAILED;
+
+				std::vector<long double> centroid(n), trial(n), other(n);
+				auto vertex = [&simplex, n](size_t v) { return simplex.data() + (v * n); };
+				// Point along the line from the centroid through the worst vertex
+				auto along = [&](long double t, size_t worst, long double* out) {
+					for(size_t i = 0; i < n; i++)
+						out[i] = centroid[i] + (t * (vertex(worst)[i] - centroid[i]));
+				};
+				STATUS status = STALLED;
+				for(; solution.iterations < options.maxIterations; solution.iterations++) {
+					size_t best = 0, worst = 0, second = 0;
+					for(size_t v = 1; v <= n; v++) {
+						if(values[v] < values[best])
+							best = v;
+						if(values[v] > values[worst])
+							worst = v;
+					}
+					second = best;
+					for(size_t v = 0; v <= n; v++) {
+						if(v != worst && values[v] > values[second])
+							second = v;
+					}
+					long double spread = std::fabs(values[worst] - values[best]);
+					if(spread <= STATIONARY * (std::fabs(values[worst]) + std::fabs(values[best])) + LDBL_MIN) {
+						status = CONVERGED;
+						break;
+					}
+
+					std::fill(centroid.begin(), centroid.end(), 0.0L);
+					for(size_t v = 0; v <= n; v++) {
+						if(v == worst)
+							continue;
+						for(size_t i = 0; i < n; i++)
+							centroid[i] += vertex(v)[i];
+					}
+					for(size_t i = 0; i < n; i++)
+						centroid[i] /= static_cast<long double>(n);
+
+					long double reflected, candidate;
+					along(-1.0L, worst, trial.data());
+					if(!Evaluate(f, trial.data(), &reflected, 1, solution))
+						return FAILED;
+					if(reflected < values[best]) {
+						along(-2.0L, worst, other.data());
+						if(!Evaluate(f, other.data(), &candidate, 1, solution))
+							return FAILED;
+						if(candidate < reflected) {
+							std::copy(other.begin(), other.end(), vertex(worst));
+							values[worst] = candidate;
+						} else {
+							std::copy(trial.begin(), trial.end(), vertex(worst));
+							values[worst] = reflected;
+						}
+						continue;
+					}
+					if(reflected < values[second]) {
+						std::copy(trial.begin(), trial.end(), vertex(worst));
+						values[worst] = reflected;
+						continue;
+					}
+					// Contract towards the better of the worst vertex and its reflection
+					bool outside = reflected < values[worst];
+					along(outside ? -0.5L : 0.5L, worst, other.data());
+					if(!Evaluate(f, other.data(), &candidate, 1, solution))
+						return FAILED;
+					if(candidate < std::min(reflected, values[worst])) {
+						std::copy(other.begin(), other.end(), vertex(worst));
+						values[worst] = candidate;
+						continue;
+					}
+					// Shrink everything towards the best vertex, the n new vertices go out in one batch
+					std::vector<long double> shrunk;
+					shrunk.reserve(n * n);
+					for(size_t v = 0; v <= n; v++) {
+						if(v == best)
+							continue;
+						for(size_t i = 0; i < n; i++)
+							vertex(v)[i] = vertex(best)[i] + (0.5L * (vertex(v)[i] - vertex(best)[i]));
+						shrunk.insert(shrunk.end(), vertex(v), vertex(v) + n);
+					}
+					std::vector<long double> shrunkValues(n);
+					if(!Evaluate(f, shrunk.data(), shrunkValues.data(), n, solution))
+						return FAILED;
+					for(size_t v = 0, k = 0; v <= n; v++) {
+						if(v != best)
+							values[v] = shrunkValues[k++];
+					}
+				}
+				size_t best = static_cast<size_t>(std::min_element(values.begin(), values.end()) - values.begin());
+				solution.x.assign(vertex(best), vertex(best) + n);
+				solution.value = values[best];
+				return status;
+			}
+
+			STATUS LBFGS(BatchFunction& f, const long double* start, size_t dimension, SolverOptions const& options, Solution& solution) {
+				const size_t n = dimension;
+				solution.iterations = 0;
+				solution.evaluations = 0;
+				std::vector<long double> x(start, start + n), g(n), d(n), next(n), nextGradient(n), scratch;
+				// Correction pairs s = x' - x and y = g' - g, kept in a ring
+				std::vector<long double> s(LBFGS_MEMORY * n), y(LBFGS_MEMORY * n);
+				long double rho[LBFGS_MEMORY], alpha[LBFGS_MEMORY];
+				size_t stored = 0, newest = 0;
+
+				long double fx;
+				if(!Evaluate(f, x.data(), &fx, 1, solution) || !Gradient(f, x.data(), n, g.data(), scratch, solution))
+					return FAILED;
+				std::vector<long double> points(LINE_SEARCH_BATCH * n);
+				long double values[LINE_SEARCH_BATCH];
+				STATUS status = STALLED;
+				for(; solution.iterations < options.maxIterations; solution.iterations++) {
+					if(!std::isfinite(fx))
+						break;
+					if(Largest(g.data(), n) <= options.gradientTolerance * Scale(fx)) {
+						status = CONVERGED;
+						break;
+					}
+
+					// Two loop recursion, d = -H g
+					for(size_t i = 0; i < n; i++)
+						d[i] = -g[i];
+					for(size_t k = 0; k < stored; k++) {
+						size_t j = (newest + LBFGS_MEMORY - k) % LBFGS_MEMORY;
+						alpha[j] = rho[j] * Dot(&s[j * n], d.data(), n);
+						for(size_t i = 0; i < n; i++)
+							d[i] -= alpha[j] * y[(j * n) + i];
+					}
+					if(stored != 0) {
+						const long double* yn = &y[newest * n];
+						long double gamma = Dot(&s[newest * n], yn, n) / Dot(yn, yn, n);
+						for(size_t i = 0; i < n; i++)
+							d[i] *= gamma;
+					} else {
+						// No curvature yet, keep the first step small
+						long double norm = std::sqrt(Dot(g.data(), g.data(), n));
+						for(size_t i = 0; i < n; i++)
+							d[i] /= std::max(1.0L, norm);
+					}
+					for(size_t k = stored; k-- > 0;) {
+						size_t j = (newest + LBFGS_MEMORY - k) % LBFGS_MEMORY;
+						long double beta = rho[j] * Dot(&y[j * n], d.data(), n);
+						for(size_t i = 0; i < n; i++)
+							d[i] += (alpha[j] - beta) * s[(j * n) + i];
+					}
+					long double slope = Dot(g.data(), d.data(), n);
+					if(!(slope < 0.0L)) {
+						// Not a descent direction, forget the curvature and go downhill
+						stored = 0;
+						for(size_t i = 0; i < n; i++)
+							d[i] = -g[i];
+						slope = -Dot(g.data(), g.data(), n);
+					}
+
+					// Backtracking line search, LINE_SEARCH_BATCH step lengths per batch
+					long double t = 1.0L, accepted = 0.0L, fnext = fx;
+					while(accepted == 0.0L && t > LDBL_EPSILON) {
+						for(size_t k = 0; k < LINE_SEARCH_BATCH; k++) {
+							long double tk = t / static_cast<long double>(1u << k);
+							for(size_t i = 0; i < n; i++)
+								points[(k * n) + i] = x[i] + (tk * d[i]);
+						}
+						if(!Evaluate(f, points.data(), values, LINE_SEARCH_BATCH, solution))
+							return FAILED;
+						for(size_t k = 0; k < LINE_SEARCH_BATCH; k++) {
+							long double tk = t / static_cast<long double>(1u << k);
+							if(values[k] <= fx + (ARMIJO * tk * slope)) {
+								accepted = tk;
+								fnext = values[k];
+								std::copy(points.begin() + (k * n), points.begin() + ((k + 1) * n), next.begin());
+								break;
+							}
+						}
+						t /= static_cast<long double>(1u << LINE_SEARCH_BATCH);
+					}
+					if(accepted == 0.0L)
+						break;
+					if(!Gradient(f, next.data(), n, nextGradient.data(), scratch, solution))
+						return FAILED;
+
+					// Remember the step if it saw positive curvature, anything else would break H
+					long double sy = 0.0L, yy = 0.0L;
+					for(size_t i = 0; i < n; i++) {
+						sy += (next[i] - x[i]) * (nextGradient[i] - g[i]);
+						yy += (nextGradient[i] - g[i]) * (nextGradient[i] - g[i]);
+					}
+					if(sy > LDBL_EPSILON * yy) {
+						newest = (stored == 0) ? 0 : (newest + 1) % LBFGS_MEMORY;
+						for(size_t i = 0; i < n; i++) {
+							s[(newest * n) + i] = next[i] - x[i];
+							y[(newest * n) + i] = nextGradient[i] - g[i];
+						}
+						rho[newest] = 1.0L / sy;
+						stored = std::min(stored + 1, LBFGS_MEMORY);
+					}
+
+					bool stationary = (fx - fnext) <= STATIONARY * std::max(std::fabs(fx), std::fabs(fnext));
+					x.swap(next);
+					g.swap(nextGradient);
+					fx = fnext;
+					if(stationary) {
+						status = CONVERGED;
+						break;
+					}
+				}
+				solution.x = x;
+				solution.value = fx;
+				return status;
+			}
+
+			STATUS MultiStart(BatchFunction& f, const long double* starts, size_t count, size_t dimension, SolverOptions const& options, Solution& solution) {
+				std::vector<std::unique_ptr<BatchFunction>> forks;
+				std::vector<BatchFunction*> functions = f.ForkWorkers(WorkerPool::Workers(options.threads), forks);
+				WorkerPool workers(functions.size());
+				std::vector<Solution> solutions(count);
+				std::vector<STATUS> statuses(count, STALLED);
+				std::atomic<size_t> next(0);
+				std::atomic<bool> failed(false);
+				workers.Run([&](size_t worker) {
+					for(size_t i = next++; i < count && !failed; i = next++) {
+						statuses[i] = LBFGS(*functions[worker], starts + (i * dimension), dimension, options, solutions[i]);
+						if(statuses[i] == FAILED)
+							failed = true;
+					}
+				});
+				if(failed)
+					return FAILED;
+				size_t best = 0;
+				size_t evaluations = 0;
+				for(size_t i = 0; i < count; i++) {
+					evaluations += solutions[i].evaluations;
+					if(solutions[i].value < solutions[best].value || !(solutions[best].value == solutions[best].value))
+						best = i;
+				}
+				solution = solutions[best];
+				solution.evaluations = evaluations;
+				return statuses[best];
+			}
+		}
+	}
+}
@@ -0,0 +1,54 @@
+/*
+	Symbols.cc - Interned identifiers and the symbol tables indexed by them
+*/
+#include "core/lang/Symbols.hh"
+
+#include <deque>
+#include <unordered_map>
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			namespace Symbols {
+				namespace {
+					// A deque so the names never move and Name can hand out references
+					std::deque<std::string>& Names(void) {
+						static std::deque<std::string> names;
+						return names;
+					}
+
+					std::unordered_map<std::string, Symbol>& Index(void) {
+						static std::unordered_map<std::string, Symbol> index;
+						return index;
+					}
+				}
+
+				Symbol Intern(std::string const& name) {
+					auto it = Index().find(name);
+					if(it != Index().end())
+						return it->second;
+					Symbol symbol = static_cast<Symbol>(Names().size());
+					Names().push_back(name);
+					Index().emplace(name, symbol);
+					return symbol;
+				}
+
+				std::string const& Name(Symbol symbol) {
+					return Names()[symbol];
+				}
+			}
+
+			void SymbolTable::Bind(Symbol symbol, Value const& value) {
+				if(symbol >= this->slots.size()) {
+					if(value.IsNone())
+						return;
+					this->slots.resize(symbol + 1);
+				}
+				Value& slot = this->slots[symbol];
+				if(slot.IsNone() != value.IsNone())
+					this->bound += value.IsNone() ? -1 : 1;
+				slot = value;
+			}
+		}
+	}
+}
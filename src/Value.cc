@@ -0,0 +1,256 @@
+/*
+	Value.cc - Evaluator value boxing, conversion and printing
+*/
+#include "core/lang/Value.hh"
+
+#include "objects/Scalar.hh"
+#include "objects/Complex.hh"
+#include "objects/Integer.hh"
+#include "objects/Rational.hh"
+#include "objects/List.hh"
+#include "objects/Matrix.hh"
+#include "core/NumberFormatter.hh"
+#include "core/lang/Function.hh"
+#include "core/symbolic/Dual.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			Value Value::MakeScalar(mtfloat_t s, PRECISION p) {
+				switch(p) {
+					case PRECISION::DOUBLE:
+						return Value::MakeScalar(static_cast<double>(s));
+					case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+						return Value::MakeScalar(static_cast<mtquad_t>(s));
+#endif
+					default:
+						return Value::MakeScalar(static_cast<long double>(s));
+				}
+			}
+
+			Value Value::MakeComplex(mtfloat_t re, mtfloat_t im, PRECISION p) {
+				switch(p) {
+					case PRECISION::DOUBLE:
+						return Value::MakeComplex(static_cast<double>(re), static_cast<double>(im));
+					case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+						return Value::MakeComplex(static_cast<mtquad_t>(re), static_cast<mtquad_t>(im));
+#endif
+					default:
+						return Value::MakeComplex(static_cast<long double>(re), static_cast<long double>(im));
+				}
+			}
+
+			Value Value::ToPrecision(PRECISION p) const {
+				if(!this->IsFloat() || this->precision == p)
+					return *this;
+				Value v;
+				v.type = this->type;
+				switch(p) {
+					case PRECISION::DOUBLE:
+						v.precision = p;
+						v.d[0] = this->Get<double>(0);
+						v.d[1] = (this->type == TYPE::COMPLEX) ? this->Get<double>(1) : 0.0;
+						break;
+					case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+						v.precision = p;
+						v.q[0] = this->Get<mtquad_t>(0);
+						v.q[1] = (this->type == TYPE::COMPLEX) ? this->Get<mtquad_t>(1) : 0;
+						break;
+#endif
+					default:
+						v.precision = PRECISION::EXTENDED;
+						v.e[0] = this->Get<long double>(0);
+						v.e[1] = (this->type == TYPE::COMPLEX) ? this->Get<long double>(1) : 0.0l;
+						break;
+				}
+				return v;
+			}
+
+			Value Value::FromInteger(Mt::objects::Integer const& n, ObjectPool& pool) {
+				if(n.IsSmall())
+					return Value::MakeInteger(n.GetSmall());
+				return Value::MakeObject(pool.Make<Mt::objects::Integer>(n));
+			}
+
+			Value Value::FromRational(Mt::objects::Rational const& r, ObjectPool& pool) {
+				if(r.IsInteger())
+					return Value::FromInteger(r.GetNumerator(), pool);
+				if(r.GetNumerator().IsSmall() && r.GetDenominator().IsSmall()) {
+					Value v;
+					v.type = TYPE::RATIONAL;
+					v.i[0] = r.GetNumerator().GetSmall();
+					v.i[1] = r.GetDenominator().GetSmall();
+					return v;
+				}
+				return Value::MakeObject(pool.Make<Mt::objects::Rational>(r));
+			}
+
+			Mt::objects::Integer Value::ToInteger(void) const {
+				if(this->big)
+					return *static_cast<Mt::objects::Integer*>(this->object);
+				return Mt::objects::Integer(this->i[0]);
+			}
+
+			Mt::objects::Rational Value::ToRational(void) const {
+				if(this->type == TYPE::INTEGER)
+					return Mt::objects::Rational(this->ToInteger());
+				if(this->big)
+					return *static_cast<Mt::objects::Rational*>(this->object);
+				return Mt::objects::Rational(Mt::objects::Integer(this->i[0]), Mt::objects::Integer(this->i[1]));
+			}
+
+			Value Value::ToScalar(PRECISION p) const {
+				if(this->type == TYPE::INTEGER && !this->big) {
+					switch(p) {
+						case PRECISION::DOUBLE:
+							return Value::MakeScalar(static_cast<double>(this->i[0]));
+						case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+							return Value::MakeScalar(static_cast<mtquad_t>(this->i[0]));
+#endif
+						default:
+							return Value::MakeScalar(static_cast<long double>(this->i[0]));
+					}
+				}
+				Mt::objects::Rational r = this->ToRational();
+				switch(p) {
+					case PRECISION::DOUBLE:
+						return Value::MakeScalar(r.ToFloat<double>());
+					case PRECISION::QUAD:
+#if defined(_MT_HAS_QUAD)
+						return Value::MakeScalar(r.ToFloat<mtquad_t>());
+#endif
+					default:
+						return Value::MakeScalar(r.ToFloat<long double>());
+				}
+			}
+
+			Mt::core::IMtObject* Value::CloneObject(void) const {
+				if(this->IsInline() || this->object == nullptr)
+					return nullptr;
+				switch(this->type) {
+					case TYPE::INTEGER:
+						return new Mt::objects::Integer(*static_cast<Mt::objects::Integer*>(this->object));
+					case TYPE::RATIONAL:
+						return new Mt::objects::Rational(*static_cast<Mt::objects::Rational*>(this->object));
+					case TYPE::LIST:
+						return new Mt::objects::List<Mt::objects::Scalar>(*static_cast<Mt::objects::List<Mt::objects::Scalar>*>(this->object));
+					case TYPE::MATRIX:
+						return new Mt::objects::Matrix<Mt::objects::Scalar>(*static_cast<Mt::objects::Matrix<Mt::objects::Scalar>*>(this->object));
+					case TYPE::FUNCTION:
+						return new Function(*static_cast<Function*>(this->object));
+					case TYPE::DUAL:
+						return new Mt::core::symbolic::Dual(*static_cast<Mt::core::symbolic::Dual*>(this->object));
+					default:
+						return nullptr;
+				}
+			}
+
+			Value Value::Unbox(Mt::core::IMtObject* obj) {
+				if(obj == nullptr)
+					return Value();
+				switch(obj->DerivedType) {
+					case TYPE::SCALAR:
+						return Value::MakeScalar(static_cast<Mt::objects::Scalar*>(obj)->GetInternal(), PRECISION::EXTENDED);
+					case TYPE::COMPLEX: {
+						auto cplx = static_cast<Mt::objects::Complex*>(obj);
+						return Value::MakeComplex(cplx->GetRealPart().GetInternal(), cplx->GetImaginaryPart().GetInternal(), PRECISION::EXTENDED);
+					} default:
+						return Value::MakeObject(obj);
+				}
+			}
+
+			Mt::core::IMtObject* Value::Box(void) const {
+				switch(this->type) {
+					case TYPE::SCALAR:
+						return new Mt::objects::Scalar(this->Get<mtfloat_t>(0));
+					case TYPE::COMPLEX:
+						return new Mt::objects::Complex(Mt::objects::Scalar(this->Get<mtfloat_t>(0)), Mt::objects::Scalar(this->Get<mtfloat_t>(1)));
+					case TYPE::INTEGER:
+						if(!this->big)
+							return new Mt::objects::Integer(this->i[0]);
+						return this->object;
+					case TYPE::RATIONAL:
+						if(!this->big)
+							return new Mt::objects::Rational(Mt::objects::Integer(this->i[0]), Mt::objects::Integer(this->i[1]));
+						return this->object;
+					case TYPE::NONE:
+						return nullptr;
+					default:
+						return this->object;
+				}
+			}
+
+			void Value::Format(std::string& out) const {
+				using Mt::core::NumberFormatter::Append;
+				switch(this->type) {
+					case TYPE::SCALAR:
+					case TYPE::COMPLEX:
+						for(int part = 0; part < ((this->type == TYPE::COMPLEX) ? 2 : 1); part++) {
+							if(part == 1)
+								out += ' ';
+							switch(this->precision) {
+								case PRECISION::DOUBLE:
+									Append(out, this->d[part]);
+									break;
+								case PRECISION::QUAD:
+									Append(out, this->q[part]);
+									break;
+								default:
+									Append(out, this->e[part]);
+									break;
+							}
+						}
+						if(this->type == TYPE::COMPLEX)
+							out += 'i';
+						break;
+					case TYPE::INTEGER:
+						out += this->big ? static_cast<Mt::objects::Integer*>(this->object)->ToString() : std::to_string(this->i[0]);
+						break;
+					case TYPE::RATIONAL:
+						out += this->big ? static_cast<Mt::objects::Rational*>(this->object)->ToString() : (std::to_string(this->i[0]) + "/" + std::to_string(this->i[1]));
+						break;
+					case TYPE::LIST:
+						static_cast<Mt::objects::List<Mt::objects::Scalar>*>(this->object)->Format(out);
+						break;
+					case TYPE::MATRIX:
+						static_cast<Mt::objects::Matrix<Mt::objects::Scalar>*>(this->object)->Format(out);
+						break;
+					case TYPE::FUNCTION:
+						static_cast<Function*>(this->object)->Format(out);
+						break;
+					case TYPE::DUAL: {
+						// The value followed by its tangents up to the last live direction
+						auto dual = static_cast<Mt::core::symbolic::Dual*>(this->object);
+						size_t live = Mt::core::symbolic::Dual::MAX_DIRECTIONS;
+						while(live > 0 && dual->tangent[live - 1] == 0.0)
+							live--;
+						Append(out, dual->value);
+						out += " [";
+						for(size_t direction = 0; direction < live; direction++) {
+							if(direction > 0)
+								out += ' ';
+							Append(out, dual->tangent[direction]);
+						}
+						out += ']';
+						break;
+					} case TYPE::NONE:
+						out += "<<NONE>>";
+						break;
+					default:
+						Append(out, *this->object);
+						break;
+				}
+			}
+
+			std::ostream& operator<<(std::ostream& os, const Value& val) {
+				std::string text;
+				val.Format(text);
+				return os.write(text.data(), static_cast<std::streamsize>(text.size()));
+			}
+		}
+	}
+}
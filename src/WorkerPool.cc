@@ -0,0 +1,75 @@
+/*
+	WorkerPool.cc - Threads shared by one parallel computation
+*/
+#include "core/WorkerPool.hh"
+
+#include <algorithm>
+#include <system_error>
+
+namespace Mt {
+	namespace core {
+		namespace {
+			const unsigned MAX_WORKERS = 16;
+		}
+
+		WorkerPool::WorkerPool(size_t count) : job(nullptr), generation(0), running(0), stopping(false) {
+			for(size_t i = 1; i < count; i++) {
+				try {
+					this->threads.emplace_back(&WorkerPool::Loop, this, i);
+				} catch(std::system_error&) {
+					// Make do with the threads we got
+					break;
+				}
+			}
+		}
+
+		WorkerPool::~WorkerPool(void) {
+			{
+				std::lock_guard<std::mutex> guard(this->lock);
+				this->stopping = true;
+			}
+			this->wake.notify_all();
+			for(auto& t : this->threads)
+				t.join();
+		}
+
+		void WorkerPool::Loop(size_t worker) {
+			size_t seen = 0;
+			for(;;) {
+				{
+					std::unique_lock<std::mutex> guard(this->lock);
+					this->wake.wait(guard, [this, &seen] { return this->stopping || this->generation != seen; });
+					if(this->stopping)
+						return;
+					seen = this->generation;
+				}
+				(*this->job)(worker);
+				std::lock_guard<std::mutex> guard(this->lock);
+				if(--this->running == 0)
+					this->done.notify_one();
+			}
+		}
+
+		size_t WorkerPool::Size(void) const {
+			return this->threads.size() + 1;
+		}
+
+		void WorkerPool::Run(std::function<void(size_t)> const& task) {
+			{
+				std::lock_guard<std::mutex> guard(this->lock);
+				this->job = &task;
+				this->running = this->threads.size();
+				this->generation++;
+			}
+			this->wake.notify_all();
+			task(0);
+			std::unique_lock<std::mutex> guard(this->lock);
+			this->done.wait(guard, [this] { return this->running == 0; });
+		}
+
+		unsigned WorkerPool::Workers(unsigned requested) {
+			unsigned count = (requested != 0) ? requested : std::thread::hardware_concurrency();
+			return std::max(1u, std::min(count, MAX_WORKERS));
+		}
+	}
+}
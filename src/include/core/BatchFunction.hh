@@ -0,0 +1,50 @@
+/*
+	BatchFunction.hh - Functions evaluated a batch of points at a time
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Mt {
+	namespace core {
+		/*! \class BatchFunction
+			\brief Real function of one or more real arguments, evaluated a batch of points at a time
+
+			The numeric engines (integration, root finding, optimization) ask for all of the points
+			they need at once, so an implementation pays its per call overhead once per batch, and
+			fork one copy per worker thread.
+		*/
+		class BatchFunction {
+		public:
+			virtual ~BatchFunction(void) { }
+			/*!
+				Evaluates the function at count points, point i is points[i * dimension] onwards
+				\return false if the function failed, whatever needed the values is abandoned
+			*/
+			virtual bool Evaluate(const long double* points, long double* values, size_t count) = 0;
+			/*!
+				Returns an independent copy a worker thread can evaluate while this one is in use,
+				nullptr if the function can not be evaluated concurrently
+			*/
+			virtual std::unique_ptr<BatchFunction> Fork(void) = 0;
+
+			/*!
+				Returns this function followed by up to count - 1 forks of it, one per worker, fewer
+				if it can not be forked. The forks are owned by owned.
+			*/
+			std::vector<BatchFunction*> ForkWorkers(unsigned count, std::vector<std::unique_ptr<BatchFunction>>& owned) {
+				std::vector<BatchFunction*> functions(1, this);
+				for(unsigned i = 1; i < count; i++) {
+					std::unique_ptr<BatchFunction> fork = this->Fork();
+					if(!fork)
+						break;
+					functions.push_back(fork.get());
+					owned.push_back(std::move(fork));
+				}
+				return functions;
+			}
+		};
+	}
+}
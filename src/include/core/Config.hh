@@ -5,8 +5,19 @@
 // Configuration defaults
 #define CFG_DEF_NUM_ALG "left"
 #define CFG_DEF_NUM_FMT "scientific"
+#define CFG_DEF_NUM_PRC "extended"
+#define CFG_DEF_EVL_ENG "bytecode"
+#define CFG_DEF_OPT_SML "yes"
 #define CFG_DEF_MAX_SCP_DEP 10
 #define CFG_DEF_MAX_ITTER 5000000000
+#define CFG_DEF_MEMO_SML "no"
+#define CFG_DEF_MEMO_SIZE 4096
+#define CFG_DEF_NATIVE_SML "no"
+#define CFG_DEF_REACTIVE_SML "no"
+#define CFG_DEF_PARALLEL_SML "no"
+#define CFG_DEF_NATIVE_THRESHOLD 1000
+#define CFG_DEF_NATIVE_CXX "c++"
+#define CFG_DEF_NATIVE_DIR ""
 
 #include <map>
 #include <fstream>
@@ -1,22 +1,136 @@
+/*
+	CoreMath.hh - Core math functions
+*/
+#pragma once
+
+#include <cstddef>
+
 #include "objects/Scalar.hh"
+#include "objects/List.hh"
+#include "objects/Matrix.hh"
+#include "core/symbolic/Dual.hh"
 
 using Mt::objects::Scalar;
 
 namespace Mt{
 	namespace core{
+		/*! \namespace Mt::core::CoreMath
+			\brief Elementary functions over scalars, lists and matrices
+
+			Every function comes in two accuracy tiers. The exact tier evaluates in long double,
+			__float128 through a 128 bit MPFloat and the multi-precision floats in themselves, the
+			fast tier runs double precision polynomial kernels that are within about one ulp and
+			are written as straight branch free loops so the compiler can vectorize them.
+
+			The List and Matrix overloads apply the function to every element in one call, walking
+			the raw element storage rather than boxing each value.
+		*/
 		namespace CoreMath{
+			/*!
+				Accuracy tier a function is evaluated in
+			*/
+			enum ACCURACY {
+				// Double precision kernels, about 1 ulp
+				FAST = 0,
+				// Long double or better
+				EXACT = 1,
+			};
+
+			/*! \namespace Mt::core::CoreMath::Kernels
+				\brief Fast tier kernels over raw double arrays
+
+				Each kernel writes f(in[i]) to out[i] for i in [0, n), in and out may be the same array.
+			*/
+			namespace Kernels {
+				void Sin(const double* in, double* out, size_t n);
+				void Cos(const double* in, double* out, size_t n);
+				void Tan(const double* in, double* out, size_t n);
+				void Exp(const double* in, double* out, size_t n);
+				void Ln(const double* in, double* out, size_t n);
+				void Sqrt(const double* in, double* out, size_t n);
+			}
+
+			/*!
+				Integer powers use binary exponentiation, roots of degree 2 and 3 use sqrt and cbrt
+				and perfect powers give exact roots. Odd roots of negative numbers are negative.
+			*/
 			Scalar Pow(Scalar input, Scalar pow);
 			Scalar Nrt(Scalar input, Scalar root);
 			Scalar Sqrt(Scalar input);
+			Scalar Cbrt(Scalar input);
+			/*!
+				Matrix power by repeated squaring, the exponent has to be a non negative integer
+			*/
+			Mt::objects::Matrix<Scalar> Pow(Mt::objects::Matrix<Scalar> const& base, Scalar power);
+
+			// Ratios of the sides of a right triangle
 			Scalar Sin(Scalar opp, Scalar hyp);
 			Scalar Cos(Scalar adj, Scalar hyp);
 			Scalar Tan(Scalar opp, Scalar adj);
 			Scalar Csc(Scalar hyp, Scalar opp);
 			Scalar Sec(Scalar hyp, Scalar adj);
 			Scalar Cot(Scalar adj, Scalar opp);
+
+			// Functions of an angle in radians, exact tier
+			Scalar Sin(Scalar angle);
+			Scalar Cos(Scalar angle);
+			Scalar Tan(Scalar angle);
+
+			Scalar Exp(Scalar input);
 			Scalar Ln(Scalar logable);
 			Scalar Log(Scalar logable, Scalar base);
+
+			/*!
+				Exact tier in the width of a precision tier's own scalar, instantiated for double,
+				long double and mtquad_t, which is mtfloat_t in the HPN builds. The Scalar versions
+				above compute in mtfloat_t.
+			*/
+			template <class F> Mt::objects::BasicScalar<F> Pow(Mt::objects::BasicScalar<F> const& input, Mt::objects::BasicScalar<F> const& pow);
+			template <class F> Mt::objects::BasicScalar<F> Nrt(Mt::objects::BasicScalar<F> const& input, Mt::objects::BasicScalar<F> const& root);
+			template <class F> Mt::objects::BasicScalar<F> Sqrt(Mt::objects::BasicScalar<F> const& input);
+			template <class F> Mt::objects::BasicScalar<F> Sin(Mt::objects::BasicScalar<F> const& angle);
+			template <class F> Mt::objects::BasicScalar<F> Cos(Mt::objects::BasicScalar<F> const& angle);
+			template <class F> Mt::objects::BasicScalar<F> Tan(Mt::objects::BasicScalar<F> const& angle);
+			template <class F> Mt::objects::BasicScalar<F> Exp(Mt::objects::BasicScalar<F> const& input);
+			template <class F> Mt::objects::BasicScalar<F> Ln(Mt::objects::BasicScalar<F> const& logable);
+
+			/*!
+				Elementwise versions, returning a new collection of the same shape. Pow on a
+				Matrix is the matrix power above, not elementwise.
+			*/
+			Mt::objects::List<Scalar> Pow(Mt::objects::List<Scalar> const& values, Scalar power);
+			Mt::objects::List<Scalar> Nrt(Mt::objects::List<Scalar> const& values, Scalar root);
+			Mt::objects::List<Scalar> Sqrt(Mt::objects::List<Scalar> const& values, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::List<Scalar> Cbrt(Mt::objects::List<Scalar> const& values);
+			Mt::objects::List<Scalar> Sin(Mt::objects::List<Scalar> const& angles, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::List<Scalar> Cos(Mt::objects::List<Scalar> const& angles, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::List<Scalar> Tan(Mt::objects::List<Scalar> const& angles, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::List<Scalar> Exp(Mt::objects::List<Scalar> const& values, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::List<Scalar> Ln(Mt::objects::List<Scalar> const& values, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::List<Scalar> Log(Mt::objects::List<Scalar> const& values, Scalar base, ACCURACY accuracy = ACCURACY::EXACT);
+
+			Mt::objects::Matrix<Scalar> Nrt(Mt::objects::Matrix<Scalar> const& values, Scalar root);
+			Mt::objects::Matrix<Scalar> Sqrt(Mt::objects::Matrix<Scalar> const& values, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::Matrix<Scalar> Cbrt(Mt::objects::Matrix<Scalar> const& values);
+			Mt::objects::Matrix<Scalar> Sin(Mt::objects::Matrix<Scalar> const& angles, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::Matrix<Scalar> Cos(Mt::objects::Matrix<Scalar> const& angles, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::Matrix<Scalar> Tan(Mt::objects::Matrix<Scalar> const& angles, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::Matrix<Scalar> Exp(Mt::objects::Matrix<Scalar> const& values, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::Matrix<Scalar> Ln(Mt::objects::Matrix<Scalar> const& values, ACCURACY accuracy = ACCURACY::EXACT);
+			Mt::objects::Matrix<Scalar> Log(Mt::objects::Matrix<Scalar> const& values, Scalar base, ACCURACY accuracy = ACCURACY::EXACT);
+
+			/*!
+				Dual number versions for forward mode differentiation, the value is the exact tier
+				result above and every tangent is scaled by the derivative at that point
+			*/
+			symbolic::Dual Pow(symbolic::Dual const& input, symbolic::Dual const& pow);
+			symbolic::Dual Nrt(symbolic::Dual const& input, symbolic::Dual const& root);
+			symbolic::Dual Sqrt(symbolic::Dual const& input);
+			symbolic::Dual Sin(symbolic::Dual const& angle);
+			symbolic::Dual Cos(symbolic::Dual const& angle);
+			symbolic::Dual Tan(symbolic::Dual const& angle);
+			symbolic::Dual Exp(symbolic::Dual const& input);
+			symbolic::Dual Ln(symbolic::Dual const& logable);
 		}
 	}
 }
-
@@ -0,0 +1,1260 @@
+/*
+	HPN.hh - High precision numerics, multi-precision limb kernels and floats
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+namespace Mt {
+	namespace core {
+		/*! \namespace Mt::core::hpn
+			\brief High precision numerics
+
+			Self contained multi-precision arithmetic. The free functions work on little endian
+			arrays of 32 bit limbs (index 0 is the least significant) and are shared by every
+			multi-precision type in Mt, Mt::core::hpn::MPFloat builds the _MT_USE_LIB_HPN floats
+			on top of them.
+		*/
+		namespace hpn {
+			typedef uint32_t limb_t;
+			typedef uint64_t dlimb_t;
+#if defined(__SIZEOF_FLOAT128__)
+			__extension__ typedef __float128 quad_t;
+#endif
+			const int LIMB_BITS = 32;
+			/*!
+				Operand size in limbs at which multiplication switches from schoolbook to Karatsuba
+			*/
+			const size_t KARATSUBA_THRESHOLD = 24;
+			/*!
+				Operand size in limbs at which multiplication switches from Karatsuba to the number
+				theoretic transform
+			*/
+			const size_t FFT_THRESHOLD = 1024;
+
+			/*!
+				Returns the number of leading zero bits in a limb, 32 for zero
+			*/
+			inline int LeadingZeros(limb_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+				return (x == 0) ? LIMB_BITS : __builtin_clz(x);
+#else
+				int n = 0;
+				if(x == 0) return LIMB_BITS;
+				while(!(x & 0x80000000u)) { x <<= 1; n++; }
+				return n;
+#endif
+			}
+			/*!
+				Returns the number of trailing zero bits in a limb, 32 for zero
+			*/
+			inline int TrailingZeros(limb_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+				return (x == 0) ? LIMB_BITS : __builtin_ctz(x);
+#else
+				int n = 0;
+				if(x == 0) return LIMB_BITS;
+				while(!(x & 1u)) { x >>= 1; n++; }
+				return n;
+#endif
+			}
+
+			/*!
+				Returns the length of a without its leading zero limbs
+			*/
+			size_t Normalize(const limb_t* a, size_t n);
+			/*!
+				Compares two magnitudes, returns -1, 0 or 1
+			*/
+			int Compare(const limb_t* a, size_t na, const limb_t* b, size_t nb);
+			/*!
+				r = a + b where na >= nb, r holds na limbs, returns the carry out
+			*/
+			limb_t Add(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb);
+			/*!
+				r = a - b where a >= b and na >= nb, r holds na limbs, returns the borrow out
+			*/
+			limb_t Sub(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb);
+			/*!
+				r = a << bits for bits < 32, returns the bits shifted out of the top limb
+			*/
+			limb_t ShiftLeft(limb_t* r, const limb_t* a, size_t n, unsigned bits);
+			/*!
+				r = a >> bits for bits < 32, returns the bits shifted out of the bottom limb in the
+				high end of the returned limb
+			*/
+			limb_t ShiftRight(limb_t* r, const limb_t* a, size_t n, unsigned bits);
+			/*!
+				r = a * b for a single limb b, returns the carry out
+			*/
+			limb_t MulLimb(limb_t* r, const limb_t* a, size_t n, limb_t b);
+			/*!
+				q = a / d for a single limb d, returns the remainder
+			*/
+			limb_t DivLimb(limb_t* q, const limb_t* a, size_t n, limb_t d);
+			/*!
+				r = a * b, r holds na + nb limbs and must not alias either operand.
+				Dispatches to schoolbook, Karatsuba or the NTT based on operand size.
+			*/
+			void Mul(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb);
+			/*!
+				Quadratic r = a * b, r holds na + nb limbs
+			*/
+			void MulSchoolbook(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb);
+			/*!
+				Karatsuba r = a * b for two n limb operands, r holds 2n limbs
+			*/
+			void MulKaratsuba(limb_t* r, const limb_t* a, const limb_t* b, size_t n);
+			/*!
+				Number theoretic transform r = a * b, r holds na + nb limbs. Operands are split into
+				16 bit digits and convolved modulo two NTT primes, then recombined with the CRT.
+			*/
+			void MulFFT(limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb);
+
+			/*!
+				Knuth long division, q = a / b and r = a % b. b must be normalized (no leading zero
+				limbs) and na >= nb, q holds na - nb + 1 limbs and r holds nb limbs.
+			*/
+			void DivMod(limb_t* q, limb_t* r, const limb_t* a, size_t na, const limb_t* b, size_t nb);
+
+			/*!
+				r = a + b, returns true if the result overflowed
+			*/
+			inline bool AddOverflow(int64_t a, int64_t b, int64_t& r) {
+#if defined(__GNUC__) || defined(__clang__)
+				return __builtin_add_overflow(a, b, &r);
+#else
+				if((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b))
+					return true;
+				r = a + b;
+				return false;
+#endif
+			}
+			/*!
+				r = a - b, returns true if the result overflowed
+			*/
+			inline bool SubOverflow(int64_t a, int64_t b, int64_t& r) {
+#if defined(__GNUC__) || defined(__clang__)
+				return __builtin_sub_overflow(a, b, &r);
+#else
+				if((b < 0 && a > INT64_MAX + b) || (b > 0 && a < INT64_MIN + b))
+					return true;
+				r = a - b;
+				return false;
+#endif
+			}
+			/*!
+				r = a * b, returns true if the result overflowed
+			*/
+			inline bool MulOverflow(int64_t a, int64_t b, int64_t& r) {
+#if defined(__GNUC__) || defined(__clang__)
+				return __builtin_mul_overflow(a, b, &r);
+#else
+				if(a != 0 && b != 0) {
+					if((a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN))
+						return true;
+					if(a > 0 ? (b > 0 ? a > INT64_MAX / b : b < INT64_MIN / a) : (b > 0 ? a < INT64_MIN / b : a < INT64_MAX / b))
+						return true;
+				}
+				r = a * b;
+				return false;
+#endif
+			}
+			/*!
+				hi:lo = a * b, the full 128 bit product of two machine words
+			*/
+			inline void MulWide(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+#if defined(__SIZEOF_INT128__)
+				__extension__ typedef unsigned __int128 uint128_t;
+				uint128_t r = static_cast<uint128_t>(a) * b;
+				hi = static_cast<uint64_t>(r >> 64);
+				lo = static_cast<uint64_t>(r);
+#else
+				uint64_t aL = a & 0xFFFFFFFFull, aH = a >> 32;
+				uint64_t bL = b & 0xFFFFFFFFull, bH = b >> 32;
+				uint64_t ll = aL * bL, lh = aL * bH, hl = aH * bL, hh = aH * bH;
+				uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFull) + (hl & 0xFFFFFFFFull);
+				lo = (mid << 32) | (ll & 0xFFFFFFFFull);
+				hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+			}
+			/*!
+				Binary (Stein) GCD of two machine words
+			*/
+			inline uint64_t Gcd(uint64_t a, uint64_t b) {
+				if(a == 0) return b;
+				if(b == 0) return a;
+#if defined(__GNUC__) || defined(__clang__)
+				int shift = __builtin_ctzll(a | b);
+				a >>= __builtin_ctzll(a);
+				do {
+					b >>= __builtin_ctzll(b);
+#else
+				int shift = 0;
+				while(!((a | b) & 1)) { a >>= 1; b >>= 1; shift++; }
+				while(!(a & 1)) a >>= 1;
+				do {
+					while(!(b & 1)) b >>= 1;
+#endif
+					if(a > b)
+						std::swap(a, b);
+					b -= a;
+				} while(b != 0);
+				return a << shift;
+			}
+
+			/*! \class BigInt
+				\brief Arbitrary size signed integer
+
+				Sign and magnitude integer over a limb vector, the magnitude never has leading zero
+				limbs so zero is the empty vector. This is the overflow storage for the exact
+				Mt::objects::Integer and Mt::objects::Rational types, which keep small values in a
+				machine word and only fall back to a BigInt when that overflows.
+			*/
+			class BigInt {
+			private:
+				std::vector<limb_t> mag;
+				bool negative;
+				void Trim(void);
+			public:
+				BigInt(void);
+				BigInt(int64_t v);
+				/*!
+					Parses an optionally signed decimal string, returns false if it is not one
+				*/
+				static bool FromString(std::string const& str, BigInt& out);
+				/*!
+					Builds an integer from a magnitude
+				*/
+				static BigInt FromLimbs(const limb_t* m, size_t n, bool neg);
+
+				bool IsZero(void) const { return mag.empty(); }
+				bool IsNegative(void) const { return negative; }
+				bool IsOdd(void) const { return !mag.empty() && (mag[0] & 1u); }
+				/*!
+					Returns true if the value fits an int64_t
+				*/
+				bool FitsInt64(void) const;
+				/*!
+					Returns the value as an int64_t, only meaningful when FitsInt64 is true
+				*/
+				int64_t ToInt64(void) const;
+				/*!
+					Returns the number of bits in the magnitude
+				*/
+				size_t BitLength(void) const;
+				/*!
+					Returns the number of trailing zero bits in the magnitude, 0 for zero
+				*/
+				size_t TrailingZeroBits(void) const;
+				std::vector<limb_t> const& Magnitude(void) const { return mag; }
+				/*!
+					Compares with another integer, returns -1, 0 or 1
+				*/
+				int Compare(BigInt const& rhs) const;
+
+				BigInt Abs(void) const;
+				BigInt operator-() const;
+				BigInt ShiftLeft(size_t bits) const;
+				BigInt ShiftRight(size_t bits) const;
+
+				friend BigInt operator+(BigInt const& a, BigInt const& b);
+				friend BigInt operator-(BigInt const& a, BigInt const& b);
+				friend BigInt operator*(BigInt const& a, BigInt const& b);
+				/*!
+					Truncating division, q = a / b rounded toward zero and r = a - q * b
+				*/
+				static void DivMod(BigInt const& a, BigInt const& b, BigInt& q, BigInt& r);
+				friend BigInt operator/(BigInt const& a, BigInt const& b);
+				friend BigInt operator%(BigInt const& a, BigInt const& b);
+				/*!
+					Greatest common divisor, binary GCD with Euclidean steps while the operand sizes differ
+				*/
+				static BigInt Gcd(BigInt const& a, BigInt const& b);
+
+				friend bool operator==(BigInt const& a, BigInt const& b) { return a.Compare(b) == 0; }
+				friend bool operator!=(BigInt const& a, BigInt const& b) { return a.Compare(b) != 0; }
+				friend bool operator<(BigInt const& a, BigInt const& b) { return a.Compare(b) < 0; }
+				friend bool operator>(BigInt const& a, BigInt const& b) { return a.Compare(b) > 0; }
+				friend bool operator<=(BigInt const& a, BigInt const& b) { return a.Compare(b) <= 0; }
+				friend bool operator>=(BigInt const& a, BigInt const& b) { return a.Compare(b) >= 0; }
+
+				/*!
+					Returns the value converted to the float type F
+				*/
+				template <class F>
+				F ToFloat(void) const {
+					// Horner over the limbs, only the top 128 bits can matter for the hardware floats
+					// so the rest is folded in as a power of two
+					F r = 0;
+					const F base = static_cast<F>(4294967296.0);
+					size_t top = (mag.size() > 4) ? (mag.size() - 4) : 0;
+					for(size_t i = mag.size(); i-- > top;)
+						r = (r * base) + static_cast<F>(mag[i]);
+					for(size_t i = 0; i < top; i++)
+						r = r * base;
+					return negative ? -r : r;
+				}
+
+				/*!
+					Returns the decimal representation
+				*/
+				std::string ToString(void) const;
+				friend std::ostream& operator<<(std::ostream& os, BigInt const& b) {
+					return (os << b.ToString());
+				}
+			};
+
+			/*! \class MPFloat
+				\brief Multi-precision binary float
+
+				A float with a Bits wide mantissa and a 64 bit exponent. Addition, subtraction and
+				multiplication are correctly rounded (round to nearest, ties to even), division and
+				square root are computed with Newton iterations and are faithful to within an ulp.
+				exp, log, pow, sin, cos and tan work GUARD_BITS wider than the mantissa and round once
+				at the end, they are off by at most an ulp.
+
+				The mantissa is a normalized limb array, the value is mant / 2^Bits * 2^exponent.
+				This is the type the _MT_USE_LIB_HPN builds use for mtfloat_t.
+			*/
+			template <int Bits>
+			class MPFloat {
+				static_assert(Bits >= 64 && (Bits % LIMB_BITS) == 0, "MPFloat mantissa must be a multiple of 32 bits and at least 64");
+			public:
+				static const int LIMBS = Bits / LIMB_BITS;
+				static const int DIGITS = Bits;
+				/*!
+					Extra bits the elementary functions carry, enough for the k ln2 and q pi/2 range
+					reductions and the rounding of every series term and squaring
+				*/
+				static const int GUARD_BITS = 128;
+			private:
+				template <int> friend class MPFloat;
+				typedef MPFloat<Bits + GUARD_BITS> Wide;
+				enum KIND : uint8_t {
+					ZERO = 0,
+					FINITE = 1,
+					INFINITE = 2,
+					NOTANUMBER = 3,
+				};
+				limb_t mant[LIMBS];
+				int64_t exponent;
+				bool negative;
+				KIND kind;
+
+				void SetZero(bool neg = false) {
+					std::fill(mant, mant + LIMBS, 0);
+					exponent = 0;
+					negative = neg;
+					kind = KIND::ZERO;
+				}
+
+				void SetSpecial(KIND k, bool neg) {
+					std::fill(mant, mant + LIMBS, 0);
+					exponent = 0;
+					negative = neg;
+					kind = k;
+				}
+
+				/*
+					Rounds the n limb magnitude w, whose top bit is set, into this float.
+					sticky marks that there are nonzero bits below w.
+				*/
+				void RoundFrom(const limb_t* w, size_t n, int64_t exp, bool neg, bool sticky = false) {
+					negative = neg;
+					kind = KIND::FINITE;
+					exponent = exp;
+					if(n <= static_cast<size_t>(LIMBS)) {
+						size_t pad = LIMBS - n;
+						std::fill(mant, mant + pad, 0);
+						std::copy(w, w + n, mant + pad);
+						return;
+					}
+					size_t low = n - LIMBS;
+					std::copy(w + low, w + n, mant);
+					limb_t guard = w[low - 1];
+					bool half = (guard & 0x80000000u) != 0;
+					bool rest = sticky || ((guard & 0x7FFFFFFFu) != 0);
+					for(size_t i = 0; !rest && i < (low - 1); i++)
+						rest = (w[i] != 0);
+					if(half && (rest || (mant[0] & 1u))) {
+						limb_t one = 1;
+						if(Add(mant, mant, LIMBS, &one, 1)) {
+							// Rounded up to the next power of two
+							mant[LIMBS - 1] = 0x80000000u;
+							exponent++;
+						}
+					}
+				}
+
+				/*
+					Shifts w left until its top bit is set, adjusting exp, returns false if w is zero
+				*/
+				static bool NormalizeWide(limb_t* w, size_t n, int64_t& exp) {
+					size_t len = Normalize(w, n);
+					if(len == 0)
+						return false;
+					size_t limbShift = n - len;
+					if(limbShift != 0) {
+						std::copy_backward(w, w + len, w + n);
+						std::fill(w, w + limbShift, 0);
+						exp -= static_cast<int64_t>(limbShift) * LIMB_BITS;
+					}
+					int bits = LeadingZeros(w[n - 1]);
+					if(bits != 0) {
+						ShiftLeft(w, w, n, bits);
+						exp -= bits;
+					}
+					return true;
+				}
+
+				/*
+					|a| + |b| or |a| - |b| with the result sign neg
+				*/
+				static MPFloat AddMagnitudes(MPFloat const& x, MPFloat const& y, bool subtract, bool neg) {
+					MPFloat const* a = &x;
+					MPFloat const* b = &y;
+					int cmp = CompareMagnitude(*a, *b);
+					if(subtract && cmp == 0)
+						return MPFloat();
+					if(cmp < 0) {
+						std::swap(a, b);
+						if(subtract) neg = !neg;
+					}
+					MPFloat r;
+					int64_t diff = a->exponent - b->exponent;
+					if(diff > Bits + 2 * LIMB_BITS) {
+						r = *a;
+						r.negative = neg;
+						if(subtract) {
+							// b is below the rounding point of a, but it still pulls a down
+							limb_t w[LIMBS + 1];
+							w[0] = 0;
+							std::copy(a->mant, a->mant + LIMBS, w + 1);
+							limb_t one = 1;
+							Sub(w, w, LIMBS + 1, &one, 1);
+							int64_t exp = a->exponent;
+							NormalizeWide(w, LIMBS + 1, exp);
+							r.RoundFrom(w, LIMBS + 1, exp, neg, true);
+						}
+						return r;
+					}
+					// [guard limb][mantissa][carry limb]
+					const size_t W = LIMBS + 2;
+					limb_t wa[W];
+					limb_t wb[W];
+					wa[0] = 0;
+					std::copy(a->mant, a->mant + LIMBS, wa + 1);
+					wa[W - 1] = 0;
+					std::fill(wb, wb + W, 0);
+					bool sticky = false;
+					size_t limbShift = static_cast<size_t>(diff / LIMB_BITS);
+					unsigned bitShift = static_cast<unsigned>(diff % LIMB_BITS);
+					// Place b's mantissa shifted right by diff bits into wb[0 .. LIMBS]
+					for(size_t i = 0; i < static_cast<size_t>(LIMBS); i++) {
+						int64_t dst = static_cast<int64_t>(i) + 1 - static_cast<int64_t>(limbShift);
+						if(dst >= 0)
+							wb[dst] = b->mant[i];
+						else if(b->mant[i] != 0)
+							sticky = true;
+					}
+					if(bitShift != 0) {
+						if(wb[0] & ((1u << bitShift) - 1))
+							sticky = true;
+						ShiftRight(wb, wb, W - 1, bitShift);
+					}
+					int64_t exp = a->exponent + LIMB_BITS;
+					if(subtract) {
+						Sub(wa, wa, W, wb, W);
+						if(sticky) {
+							limb_t one = 1;
+							Sub(wa, wa, W, &one, 1);
+						}
+					} else {
+						Add(wa, wa, W, wb, W);
+					}
+					if(!NormalizeWide(wa, W, exp))
+						return MPFloat();
+					r.RoundFrom(wa, W, exp, neg, sticky);
+					return r;
+				}
+
+				static int CompareMagnitude(MPFloat const& a, MPFloat const& b) {
+					if(a.kind == KIND::ZERO || b.kind == KIND::ZERO)
+						return (a.kind == b.kind) ? 0 : ((a.kind == KIND::ZERO) ? -1 : 1);
+					if(a.exponent != b.exponent)
+						return (a.exponent < b.exponent) ? -1 : 1;
+					return Compare(a.mant, LIMBS, b.mant, LIMBS);
+				}
+
+				/*
+					Leading 64 bits of the mantissa as a long double in [0.5, 1)
+				*/
+				long double LeadingMantissa(void) const {
+					dlimb_t top = (static_cast<dlimb_t>(mant[LIMBS - 1]) << 32) | mant[LIMBS - 2];
+					return std::ldexp(static_cast<long double>(top), -64);
+				}
+
+				/*
+					Newton iteration for 1/b, doubling the number of correct bits each step
+				*/
+				static MPFloat Reciprocal(MPFloat const& b) {
+					MPFloat r(1.0l / b.LeadingMantissa());
+					r.exponent -= b.exponent;
+					r.negative = b.negative;
+					const MPFloat one(1);
+					for(int bits = 60; bits < (2 * Bits); bits *= 2)
+						r = r + (r * (one - (b * r)));
+					return r;
+				}
+
+				static MPFloat ReciprocalSqrt(MPFloat const& x) {
+					// x = m * 2^e, split e into an even part and a remainder of 0 or 1
+					int64_t half = (x.exponent >= 0) ? (x.exponent / 2) : -((-x.exponent + 1) / 2);
+					int rem = static_cast<int>(x.exponent - (2 * half));
+					MPFloat y(1.0l / std::sqrt(std::ldexp(x.LeadingMantissa(), rem)));
+					y.exponent -= half;
+					const MPFloat one(1);
+					for(int bits = 60; bits < (2 * Bits); bits *= 2) {
+						MPFloat t = (one - (x * y * y));
+						t.exponent--;
+						y = y + (y * t);
+					}
+					return y;
+				}
+
+				/*
+					x / d for a single limb d, exact but for the final rounding
+				*/
+				static MPFloat DivideBy(MPFloat const& x, limb_t d) {
+					if(x.kind != KIND::FINITE)
+						return x;
+					limb_t w[LIMBS + 1];
+					w[0] = 0;
+					std::copy(x.mant, x.mant + LIMBS, w + 1);
+					const bool sticky = DivLimb(w, w, LIMBS + 1, d) != 0;
+					MPFloat r;
+					int64_t exp = x.exponent;
+					NormalizeWide(w, LIMBS + 1, exp);
+					r.RoundFrom(w, LIMBS + 1, exp, x.negative, sticky);
+					return r;
+				}
+
+				/*
+					ln2 = 2 atanh(1/3), worked out once per width
+				*/
+				static MPFloat const& Ln2(void) {
+					static const MPFloat ln2 = [] {
+						MPFloat power = DivideBy(MPFloat(1), 3);
+						MPFloat sum;
+						for(limb_t k = 1; ; k += 2) {
+							MPFloat next = sum + DivideBy(power, k);
+							if(next == sum)
+								break;
+							sum = next;
+							power = DivideBy(power, 9);
+						}
+						return sum.ScaleB(1);
+					}();
+					return ln2;
+				}
+
+				/*
+					exp(x) for finite x below 2^61 in magnitude, x = k ln2 + r with |r| <= ln2 / 2, then
+					exp(r) = exp(r / 2^12)^(2^12) so the Taylor series converges in a few terms per bit
+				*/
+				static MPFloat ExpReduced(MPFloat const& x) {
+					const int64_t k = static_cast<int64_t>(std::nearbyint(static_cast<long double>(x) / 0.693147180559945309417232121458176568l));
+					const int squarings = 12;
+					MPFloat r = (x - (Ln2() * MPFloat(static_cast<long long>(k)))).ScaleB(-squarings);
+					MPFloat term(1);
+					MPFloat sum(1);
+					for(limb_t n = 1; ; n++) {
+						term = DivideBy(term * r, n);
+						MPFloat next = sum + term;
+						if(next == sum)
+							break;
+						sum = next;
+					}
+					for(int i = 0; i < squarings; i++)
+						sum = sum * sum;
+					return sum.ScaleB(k);
+				}
+
+				/*
+					log(x) for finite x > 0, x = m 2^e with m in [sqrt(1/2), sqrt(2)), then
+					log(m) = 2 atanh((m - 1) / (m + 1)), m - 1 is exact so values near 1 keep every bit
+				*/
+				static MPFloat LogReduced(MPFloat const& x) {
+					int64_t e = x.exponent;
+					MPFloat m = x.ScaleB(-e);
+					if(static_cast<long double>(m) < 0.707106781186547524400844362104849039l) {
+						m = m.ScaleB(1);
+						e--;
+					}
+					const MPFloat one(1);
+					MPFloat u = (m - one) / (m + one);
+					const MPFloat u2 = u * u;
+					MPFloat sum;
+					for(limb_t k = 1; ; k += 2) {
+						MPFloat next = sum + DivideBy(u, k);
+						if(next == sum)
+							break;
+						sum = next;
+						u = u * u2;
+					}
+					return sum.ScaleB(1) + (Ln2() * MPFloat(static_cast<long long>(e)));
+				}
+
+				/*
+					atan(1/n) = sum (-1)^k / ((2k + 1) n^(2k + 1)) for n below 2^16
+				*/
+				static MPFloat AtanInverse(limb_t n) {
+					MPFloat power = DivideBy(MPFloat(1), n);
+					MPFloat sum;
+					for(limb_t k = 1; ; k += 2) {
+						MPFloat term = DivideBy(power, k);
+						MPFloat next = ((k & 2) != 0) ? (sum - term) : (sum + term);
+						if(next == sum)
+							break;
+						sum = next;
+						power = DivideBy(power, n * n);
+					}
+					return sum;
+				}
+
+				/*
+					pi/2 = 8 atan(1/5) - 2 atan(1/239) (Machin), worked out once per width
+				*/
+				static MPFloat const& HalfPi(void) {
+					static const MPFloat halfPi = AtanInverse(5).ScaleB(3) - AtanInverse(239).ScaleB(1);
+					return halfPi;
+				}
+
+				static MPFloat const& TwoOverPi(void) {
+					static const MPFloat twoOverPi = MPFloat(1) / HalfPi();
+					return twoOverPi;
+				}
+
+				/*
+					Rounds to the nearest whole number, ties away from zero, and sets quadrant to that
+					number modulo 4
+				*/
+				static MPFloat Nearest(MPFloat const& x, unsigned& quadrant) {
+					quadrant = 0;
+					MPFloat r = x + (x.negative ? MPFloat(-0.5) : MPFloat(0.5));
+					if(r.kind != KIND::FINITE || r.exponent <= 0) {
+						r.SetZero(x.negative);
+						return r;
+					}
+					if(r.exponent < Bits) {
+						// Clears the bits below the binary point
+						const int64_t fraction = Bits - r.exponent;
+						for(int64_t bit = 0; bit < fraction; bit++)
+							r.mant[bit / LIMB_BITS] &= ~(static_cast<limb_t>(1) << (bit % LIMB_BITS));
+					}
+					for(int64_t bit = Bits - r.exponent, i = 0; i < 2; bit++, i++) {
+						if(bit >= 0 && bit < Bits)
+							quadrant |= ((r.mant[bit / LIMB_BITS] >> (bit % LIMB_BITS)) & 1u) << i;
+					}
+					if(r.negative)
+						quadrant = (4 - quadrant) & 3;
+					return r;
+				}
+
+				/*
+					Taylor series of sin (odd) or cos (even) for |r| <= pi/4
+				*/
+				static MPFloat SinCosSeries(MPFloat const& r, bool odd) {
+					const MPFloat r2 = r * r;
+					MPFloat term = odd ? r : MPFloat(1);
+					MPFloat sum = term;
+					for(limb_t k = odd ? 2 : 1; ; k += 2) {
+						term = -DivideBy(term * r2, k * (k + 1));
+						MPFloat next = sum + term;
+						if(next == sum)
+							break;
+						sum = next;
+					}
+					return sum;
+				}
+
+				/*
+					sin(x + shift pi/2) for finite x, x = q pi/2 + r with |r| <= pi/4. r is off by about
+					|x| / 2^Bits, called on the guarded width that keeps every bit of the result up to
+					|x| = 2^100, past that a bit is lost per doubling.
+				*/
+				static MPFloat SinReduced(MPFloat const& x, unsigned shift) {
+					unsigned quadrant;
+					// A q off by one near the midpoint only leaves |r| a little over pi/4
+					const MPFloat q = Nearest(x * TwoOverPi(), quadrant);
+					const MPFloat r = x - (q * HalfPi());
+					quadrant = (quadrant + shift) & 3;
+					const MPFloat s = SinCosSeries(r, (quadrant & 1) == 0);
+					return (quadrant & 2) ? -s : s;
+				}
+
+				void FromUnsigned(unsigned long long v, bool neg) {
+					if(v == 0) {
+						SetZero(neg);
+						return;
+					}
+					limb_t w[2] = { static_cast<limb_t>(v), static_cast<limb_t>(v >> 32) };
+					int64_t exp = 64;
+					NormalizeWide(w, 2, exp);
+					RoundFrom(w, 2, exp, neg);
+				}
+
+				void FromLongDouble(long double v) {
+					if(std::isnan(v)) {
+						SetSpecial(KIND::NOTANUMBER, false);
+					} else if(std::isinf(v)) {
+						SetSpecial(KIND::INFINITE, v < 0);
+					} else if(v == 0) {
+						SetZero(std::signbit(v));
+					} else {
+						int e;
+						long double m = std::frexp(std::fabs(v), &e);
+						unsigned long long bits = static_cast<unsigned long long>(std::ldexp(m, 64));
+						FromUnsigned(bits, v < 0);
+						exponent = e;
+					}
+				}
+
+			public:
+				MPFloat(void) {
+					SetZero();
+				}
+				MPFloat(int v) {
+					FromUnsigned((v < 0) ? (0ull - static_cast<unsigned long long>(v)) : static_cast<unsigned long long>(v), v < 0);
+				}
+				MPFloat(long v) {
+					FromUnsigned((v < 0) ? (0ull - static_cast<unsigned long long>(v)) : static_cast<unsigned long long>(v), v < 0);
+				}
+				MPFloat(long long v) {
+					FromUnsigned((v < 0) ? (0ull - static_cast<unsigned long long>(v)) : static_cast<unsigned long long>(v), v < 0);
+				}
+				MPFloat(unsigned int v) {
+					FromUnsigned(v, false);
+				}
+				MPFloat(unsigned long v) {
+					FromUnsigned(v, false);
+				}
+				MPFloat(unsigned long long v) {
+					FromUnsigned(v, false);
+				}
+				MPFloat(float v) {
+					FromLongDouble(v);
+				}
+				MPFloat(double v) {
+					FromLongDouble(v);
+				}
+				MPFloat(long double v) {
+					FromLongDouble(v);
+				}
+#if defined(__SIZEOF_FLOAT128__)
+				MPFloat(quad_t v) {
+					// Split into two long doubles, together they hold all 113 bits exactly
+					long double hi = static_cast<long double>(v);
+					long double lo = static_cast<long double>(v - static_cast<quad_t>(hi));
+					*this = MPFloat(hi) + MPFloat(lo);
+				}
+#endif
+				/*!
+					Builds the float closest to the n limb integer w times 2^exp2
+				*/
+				static MPFloat FromLimbs(const limb_t* w, size_t n, int64_t exp2, bool neg, bool sticky = false) {
+					MPFloat r;
+					std::vector<limb_t> tmp(w, w + n);
+					int64_t exp = static_cast<int64_t>(n) * LIMB_BITS + exp2;
+					if(!NormalizeWide(tmp.data(), n, exp)) {
+						r.SetZero(neg);
+						return r;
+					}
+					r.RoundFrom(tmp.data(), n, exp, neg, sticky);
+					return r;
+				}
+				/*!
+					Rounds, or widens exactly, a float of another width into this one
+				*/
+				template <int From>
+				static MPFloat Resize(MPFloat<From> const& x) {
+					MPFloat r;
+					switch(x.kind) {
+						case MPFloat<From>::KIND::ZERO:
+							r.SetZero(x.negative);
+							return r;
+						case MPFloat<From>::KIND::INFINITE:
+							r.SetSpecial(KIND::INFINITE, x.negative);
+							return r;
+						case MPFloat<From>::KIND::NOTANUMBER:
+							return NaN();
+						default:
+							return FromLimbs(x.mant, MPFloat<From>::LIMBS, x.exponent - From, x.negative);
+					}
+				}
+				/*!
+					Returns positive infinity
+				*/
+				static MPFloat Infinity(void) {
+					MPFloat r;
+					r.SetSpecial(KIND::INFINITE, false);
+					return r;
+				}
+				/*!
+					Returns a quiet NaN
+				*/
+				static MPFloat NaN(void) {
+					MPFloat r;
+					r.SetSpecial(KIND::NOTANUMBER, false);
+					return r;
+				}
+
+				bool IsZero(void) const { return kind == KIND::ZERO; }
+				bool IsNaN(void) const { return kind == KIND::NOTANUMBER; }
+				bool IsInf(void) const { return kind == KIND::INFINITE; }
+				bool IsNegative(void) const { return negative; }
+				/*!
+					Returns e such that the value is in [2^(e-1), 2^e)
+				*/
+				int64_t GetExponent(void) const { return exponent; }
+				/*!
+					Returns the normalized mantissa limbs
+				*/
+				const limb_t* GetMantissa(void) const { return mant; }
+
+				/*!
+					Returns the value times 2^n
+				*/
+				MPFloat ScaleB(int64_t n) const {
+					MPFloat r(*this);
+					if(r.kind == KIND::FINITE)
+						r.exponent += n;
+					return r;
+				}
+
+				explicit operator long double() const {
+					switch(kind) {
+						case KIND::ZERO:
+							return negative ? -0.0l : 0.0l;
+						case KIND::INFINITE:
+							return negative ? -HUGE_VALL : HUGE_VALL;
+						case KIND::NOTANUMBER:
+							return NAN;
+						default:
+							break;
+					}
+					dlimb_t top = (static_cast<dlimb_t>(mant[LIMBS - 1]) << 32) | mant[LIMBS - 2];
+					long double r;
+					if((mant[LIMBS - 3] & 0x80000000u) && (top + 1) == 0)
+						r = std::ldexp(1.0l, static_cast<int>(std::max<int64_t>(std::min<int64_t>(exponent, 1 << 20), -(1 << 20))));
+					else
+						r = std::ldexp(static_cast<long double>(top + ((mant[LIMBS - 3] >> 31) & 1u)), static_cast<int>(std::max<int64_t>(std::min<int64_t>(exponent - 64, 1 << 20), -(1 << 20))));
+					return negative ? -r : r;
+				}
+				explicit operator double() const {
+					return static_cast<double>(static_cast<long double>(*this));
+				}
+#if defined(__SIZEOF_FLOAT128__)
+				explicit operator quad_t() const {
+					long double hi = static_cast<long double>(*this);
+					long double lo = static_cast<long double>(*this - MPFloat(hi));
+					return static_cast<quad_t>(hi) + static_cast<quad_t>(lo);
+				}
+#endif
+
+				// Arithmetic
+				friend MPFloat operator+(MPFloat const& a, MPFloat const& b) {
+					if(a.kind == KIND::NOTANUMBER || b.kind == KIND::NOTANUMBER)
+						return NaN();
+					if(a.kind == KIND::INFINITE || b.kind == KIND::INFINITE) {
+						if(a.kind == KIND::INFINITE && b.kind == KIND::INFINITE && a.negative != b.negative)
+							return NaN();
+						return (a.kind == KIND::INFINITE) ? a : b;
+					}
+					if(a.kind == KIND::ZERO)
+						return b;
+					if(b.kind == KIND::ZERO)
+						return a;
+					return AddMagnitudes(a, b, a.negative != b.negative, a.negative);
+				}
+				friend MPFloat operator-(MPFloat const& a, MPFloat const& b) {
+					return a + (-b);
+				}
+				friend MPFloat operator*(MPFloat const& a, MPFloat const& b) {
+					if(a.kind == KIND::NOTANUMBER || b.kind == KIND::NOTANUMBER)
+						return NaN();
+					bool neg = (a.negative != b.negative);
+					if(a.kind == KIND::INFINITE || b.kind == KIND::INFINITE) {
+						if(a.kind == KIND::ZERO || b.kind == KIND::ZERO)
+							return NaN();
+						MPFloat r = Infinity();
+						r.negative = neg;
+						return r;
+					}
+					MPFloat r;
+					if(a.kind == KIND::ZERO || b.kind == KIND::ZERO) {
+						r.negative = neg;
+						return r;
+					}
+					limb_t p[2 * LIMBS];
+					Mul(p, a.mant, LIMBS, b.mant, LIMBS);
+					int64_t exp = a.exponent + b.exponent;
+					NormalizeWide(p, 2 * LIMBS, exp);
+					r.RoundFrom(p, 2 * LIMBS, exp, neg);
+					return r;
+				}
+				friend MPFloat operator/(MPFloat const& a, MPFloat const& b) {
+					if(a.kind == KIND::NOTANUMBER || b.kind == KIND::NOTANUMBER)
+						return NaN();
+					bool neg = (a.negative != b.negative);
+					if(b.kind == KIND::ZERO || a.kind == KIND::INFINITE) {
+						if(a.kind == KIND::ZERO || b.kind == KIND::INFINITE)
+							return NaN();
+						MPFloat r = Infinity();
+						r.negative = neg;
+						return r;
+					}
+					if(a.kind == KIND::ZERO || b.kind == KIND::INFINITE) {
+						MPFloat r;
+						r.negative = neg;
+						return r;
+					}
+					MPFloat r = Reciprocal(b);
+					MPFloat q = a * r;
+					// One correction step against the residual
+					return q + (r * (a - (b * q)));
+				}
+				MPFloat operator-() const {
+					MPFloat r(*this);
+					if(r.kind != KIND::NOTANUMBER)
+						r.negative = !r.negative;
+					return r;
+				}
+				MPFloat operator+() const {
+					return *this;
+				}
+				MPFloat& operator+=(MPFloat const& rhs) { return (*this = *this + rhs); }
+				MPFloat& operator-=(MPFloat const& rhs) { return (*this = *this - rhs); }
+				MPFloat& operator*=(MPFloat const& rhs) { return (*this = *this * rhs); }
+				MPFloat& operator/=(MPFloat const& rhs) { return (*this = *this / rhs); }
+				MPFloat& operator++() { return (*this += MPFloat(1)); }
+				MPFloat& operator--() { return (*this -= MPFloat(1)); }
+				MPFloat operator++(int) { MPFloat r(*this); *this += MPFloat(1); return r; }
+				MPFloat operator--(int) { MPFloat r(*this); *this -= MPFloat(1); return r; }
+
+				// Comparison
+				friend bool operator==(MPFloat const& a, MPFloat const& b) {
+					if(a.kind == KIND::NOTANUMBER || b.kind == KIND::NOTANUMBER)
+						return false;
+					if(a.kind == KIND::ZERO && b.kind == KIND::ZERO)
+						return true;
+					return (a.negative == b.negative) && (a.kind == b.kind) && (CompareMagnitude(a, b) == 0);
+				}
+				friend bool operator!=(MPFloat const& a, MPFloat const& b) {
+					return !(a == b);
+				}
+				friend bool operator<(MPFloat const& a, MPFloat const& b) {
+					if(a.kind == KIND::NOTANUMBER || b.kind == KIND::NOTANUMBER || a == b)
+						return false;
+					if(a.kind == KIND::ZERO)
+						return !b.negative;
+					if(b.kind == KIND::ZERO)
+						return a.negative;
+					if(a.negative != b.negative)
+						return a.negative;
+					int cmp;
+					if(a.kind == KIND::INFINITE || b.kind == KIND::INFINITE)
+						cmp = (a.kind == KIND::INFINITE) ? 1 : -1;
+					else
+						cmp = CompareMagnitude(a, b);
+					return a.negative ? (cmp > 0) : (cmp < 0);
+				}
+				friend bool operator>(MPFloat const& a, MPFloat const& b) {
+					return b < a;
+				}
+				friend bool operator<=(MPFloat const& a, MPFloat const& b) {
+					return (a < b) || (a == b);
+				}
+				friend bool operator>=(MPFloat const& a, MPFloat const& b) {
+					return (b < a) || (a == b);
+				}
+
+				// Math
+				friend MPFloat fabs(MPFloat const& x) {
+					MPFloat r(x);
+					r.negative = false;
+					return r;
+				}
+				friend MPFloat abs(MPFloat const& x) {
+					return fabs(x);
+				}
+				friend MPFloat sqrt(MPFloat const& x) {
+					if(x.kind == KIND::ZERO || x.kind == KIND::NOTANUMBER || (x.kind == KIND::INFINITE && !x.negative))
+						return x;
+					if(x.negative)
+						return NaN();
+					MPFloat y = ReciprocalSqrt(x);
+					MPFloat s = x * y;
+					// s + y(x - s^2)/2
+					MPFloat t = y * (x - (s * s));
+					t.exponent--;
+					return s + t;
+				}
+				friend MPFloat ldexp(MPFloat const& x, int n) {
+					return x.ScaleB(n);
+				}
+				friend MPFloat exp(MPFloat const& x) {
+					if(x.kind == KIND::ZERO)
+						return MPFloat(1);
+					if(x.kind == KIND::NOTANUMBER)
+						return x;
+					if(x.kind == KIND::INFINITE || x.exponent > 61)
+						return x.negative ? MPFloat() : Infinity();
+					return Resize(Wide::ExpReduced(Wide::Resize(x)));
+				}
+				friend MPFloat log(MPFloat const& x) {
+					if(x.kind == KIND::NOTANUMBER || (x.kind == KIND::INFINITE && !x.negative))
+						return x;
+					if(x.kind == KIND::ZERO)
+						return -Infinity();
+					if(x.negative)
+						return NaN();
+					return Resize(Wide::LogReduced(Wide::Resize(x)));
+				}
+				friend MPFloat sin(MPFloat const& x) {
+					if(x.kind == KIND::ZERO || x.kind == KIND::NOTANUMBER)
+						return x;
+					if(x.kind == KIND::INFINITE)
+						return NaN();
+					return Resize(Wide::SinReduced(Wide::Resize(x), 0));
+				}
+				friend MPFloat cos(MPFloat const& x) {
+					if(x.kind == KIND::ZERO)
+						return MPFloat(1);
+					if(x.kind == KIND::NOTANUMBER)
+						return x;
+					if(x.kind == KIND::INFINITE)
+						return NaN();
+					return Resize(Wide::SinReduced(Wide::Resize(x), 1));
+				}
+				friend MPFloat tan(MPFloat const& x) {
+					if(x.kind == KIND::ZERO || x.kind == KIND::NOTANUMBER)
+						return x;
+					if(x.kind == KIND::INFINITE)
+						return NaN();
+					const Wide w = Wide::Resize(x);
+					return Resize(Wide::SinReduced(w, 0) / Wide::SinReduced(w, 1));
+				}
+				friend MPFloat pow(MPFloat const& x, MPFloat const& y) {
+					if(y.kind == KIND::ZERO)
+						return MPFloat(1);
+					long long n = 0;
+					const bool integer = y.ToInteger(n);
+					if(integer && n > -(1ll << 16) && n < (1ll << 16)) {
+						// Small integer powers by repeated squaring, exact where the mantissa allows
+						Wide result(1);
+						Wide base = Wide::Resize(x);
+						unsigned long long e = (n < 0) ? static_cast<unsigned long long>(-n) : static_cast<unsigned long long>(n);
+						while(e) {
+							if(e & 1)
+								result *= base;
+							base *= base;
+							e >>= 1;
+						}
+						return Resize((n < 0) ? (Wide(1) / result) : result);
+					}
+					if(x.negative && !integer)
+						return NaN();
+					if(x.kind != KIND::FINITE || y.kind != KIND::FINITE) {
+						MPFloat r = exp(y * log(fabs(x)));
+						return (x.negative && (n & 1)) ? -r : r;
+					}
+					// y log|x| is kept wide, its rounding would be scaled by the exponent
+					const Wide t = Wide::Resize(y) * Wide::LogReduced(Wide::Resize(fabs(x)));
+					MPFloat r;
+					if(t.exponent > 61)
+						r = t.negative ? MPFloat() : Infinity();
+					else
+						r = Resize(Wide::ExpReduced(t));
+					return (x.negative && (n & 1)) ? -r : r;
+				}
+
+				/*!
+					Returns true and stores the value in n if it is an integer that fits a long long
+				*/
+				bool ToInteger(long long& n) const {
+					if(kind == KIND::ZERO) {
+						n = 0;
+						return true;
+					}
+					if(kind != KIND::FINITE || exponent <= 0 || exponent > 62)
+						return false;
+					// Every mantissa bit below the binary point must be clear
+					for(int64_t bit = 0; bit < (Bits - exponent); bit++) {
+						if((mant[static_cast<size_t>(bit / LIMB_BITS)] >> (bit % LIMB_BITS)) & 1u)
+							return false;
+					}
+					dlimb_t top = (static_cast<dlimb_t>(mant[LIMBS - 1]) << 32) | mant[LIMBS - 2];
+					long long v = static_cast<long long>(top >> (64 - exponent));
+					n = negative ? -v : v;
+					return true;
+				}
+
+				/*!
+					Returns the value formatted with the given number of significant decimal digits,
+					laid out like printf's %g
+				*/
+				std::string ToString(int digits = 6) const {
+					switch(kind) {
+						case KIND::ZERO:
+							return negative ? "-0" : "0";
+						case KIND::INFINITE:
+							return negative ? "-inf" : "inf";
+						case KIND::NOTANUMBER:
+							return "nan";
+						default:
+							break;
+					}
+					if(digits < 1)
+						digits = 1;
+					MPFloat x = fabs(*this);
+					// Decimal exponent estimate from the binary one, corrected below
+					int64_t e10 = static_cast<int64_t>(std::floor(static_cast<double>(exponent - 1) * 0.30102999566398119521));
+					std::string d;
+					for(int attempt = 0; attempt < 3; attempt++) {
+						int64_t scale = (digits - 1) - e10;
+						MPFloat p = Pow10(scale < 0 ? -scale : scale);
+						MPFloat s = (scale < 0) ? (x / p) : (x * p);
+						d = s.RoundToDecimal();
+						if(static_cast<int>(d.size()) > digits + 1 || (static_cast<int>(d.size()) == digits + 1 && d[d.size() - 1] != '0')) {
+							e10++;
+						} else if(static_cast<int>(d.size()) < digits) {
+							e10--;
+						} else {
+							if(static_cast<int>(d.size()) == digits + 1) {
+								// Rounding carried into a new digit, 9.99 -> 10.0
+								d.erase(d.size() - 1);
+								e10++;
+							}
+							break;
+						}
+					}
+					// Strip trailing zeros like %g does
+					while(d.size() > 1 && d[d.size() - 1] == '0')
+						d.erase(d.size() - 1);
+					std::string out = negative ? "-" : "";
+					if(e10 < -5 || e10 >= digits) {
+						out += d[0];
+						if(d.size() > 1)
+							out += "." + d.substr(1);
+						out += (e10 < 0) ? "e-" : "e+";
+						std::string ex = std::to_string(e10 < 0 ? -e10 : e10);
+						if(ex.size() < 2)
+							ex = "0" + ex;
+						out += ex;
+					} else if(e10 < 0) {
+						out += "0." + std::string(static_cast<size_t>(-e10 - 1), '0') + d;
+					} else if(static_cast<size_t>(e10 + 1) >= d.size()) {
+						out += d + std::string(static_cast<size_t>(e10 + 1) - d.size(), '0');
+					} else {
+						out += d.substr(0, static_cast<size_t>(e10 + 1)) + "." + d.substr(static_cast<size_t>(e10 + 1));
+					}
+					return out;
+				}
+
+				/*!
+					Returns 10^n
+				*/
+				static MPFloat Pow10(int64_t n) {
+					MPFloat result(1);
+					MPFloat base(10);
+					while(n > 0) {
+						if(n & 1)
+							result *= base;
+						base *= base;
+						n >>= 1;
+					}
+					return result;
+				}
+
+				/*!
+					Rounds a non negative value to the nearest integer and returns its decimal digits
+				*/
+				std::string RoundToDecimal(void) const {
+					if(kind != KIND::FINITE || exponent <= 0) {
+						bool up = (kind == KIND::FINITE) && (exponent == 0) && ((mant[LIMBS - 1] & 0x7FFFFFFFu) != 0 || Normalize(mant, LIMBS - 1) != 0);
+						return up ? "1" : "0";
+					}
+					// Integer part in limbs, plus the rounding bit
+					size_t intLimbs = static_cast<size_t>((exponent + LIMB_BITS - 1) / LIMB_BITS) + 1;
+					std::vector<limb_t> w(intLimbs + LIMBS, 0);
+					std::copy(mant, mant + LIMBS, w.begin());
+					// w currently holds mant * 2^0, we want mant * 2^(exponent - Bits)
+					int64_t shift = exponent - Bits;
+					bool half = false;
+					bool rest = false;
+					if(shift >= 0) {
+						size_t ls = static_cast<size_t>(shift / LIMB_BITS);
+						unsigned bs = static_cast<unsigned>(shift % LIMB_BITS);
+						std::copy_backward(w.begin(), w.begin() + LIMBS, w.begin() + LIMBS + ls);
+						std::fill(w.begin(), w.begin() + ls, 0);
+						if(bs != 0)
+							ShiftLeft(w.data(), w.data(), w.size(), bs);
+					} else {
+						int64_t rs = -shift;
+						// Work out the rounding bits before they are shifted out
+						int64_t hbit = rs - 1;
+						half = (w[static_cast<size_t>(hbit / LIMB_BITS)] >> (hbit % LIMB_BITS)) & 1u;
+						for(int64_t bit = 0; bit < hbit && !rest; bit++)
+							rest = ((w[static_cast<size_t>(bit / LIMB_BITS)] >> (bit % LIMB_BITS)) & 1u) != 0;
+						size_t ls = static_cast<size_t>(rs / LIMB_BITS);
+						unsigned bs = static_cast<unsigned>(rs % LIMB_BITS);
+						std::copy(w.begin() + ls, w.end(), w.begin());
+						std::fill(w.end() - ls, w.end(), 0);
+						if(bs != 0)
+							ShiftRight(w.data(), w.data(), w.size(), bs);
+					}
+					if(half && (rest || (w[0] & 1u))) {
+						limb_t one = 1;
+						Add(w.data(), w.data(), w.size(), &one, 1);
+					}
+					// Peel off 9 decimal digits at a time
+					std::string digits;
+					size_t len = Normalize(w.data(), w.size());
+					while(len != 0) {
+						limb_t r = DivLimb(w.data(), w.data(), len, 1000000000u);
+						len = Normalize(w.data(), len);
+						for(int i = 0; i < 9; i++) {
+							digits += static_cast<char>('0' + (r % 10));
+							r /= 10;
+							if(len == 0 && r == 0)
+								break;
+						}
+					}
+					if(digits.empty())
+						digits = "0";
+					std::reverse(digits.begin(), digits.end());
+					return digits;
+				}
+
+				friend std::ostream& operator<<(std::ostream& os, MPFloat const& x) {
+					return (os << x.ToString(static_cast<int>(os.precision())));
+				}
+			};
+		}
+	}
+}
+
+// Names used by Types.hh for the _MT_USE_LIB_HPN builds
+typedef Mt::core::hpn::MPFloat<128> __mfloat128;
+typedef Mt::core::hpn::MPFloat<256> __mfloat256;
+typedef Mt::core::hpn::MPFloat<512> __mfloat512;
+typedef Mt::core::hpn::MPFloat<4096> __mfloat4096;
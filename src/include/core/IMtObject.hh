@@ -11,6 +11,11 @@ namespace Mt {
 			LIST = 2,
 			SET = 3,
 			MATRIX = 4,
+			NONE = 5,
+			INTEGER = 6,
+			RATIONAL = 7,
+			FUNCTION = 8,
+			DUAL = 9,
 		};
 		/*! \class IMtObject
 			\brief Base Object for SML 
@@ -0,0 +1,67 @@
+/*
+	Integration.hh - Adaptive numerical integration
+*/
+#pragma once
+
+#include <cstddef>
+
+#include "core/BatchFunction.hh"
+
+namespace Mt {
+	namespace core {
+		/*! \namespace Mt::core::Integration
+			\brief Adaptive quadrature and cubature
+
+			Integrals are refined globally. Every region carries an error estimate and sits in a heap
+			ordered by it, and the regions with the largest errors are bisected first until the total
+			error is within tolerance. Refinement runs in rounds. Each round bisects a batch of the
+			worst regions, hands all of their nodes to the integrand in one call per worker thread
+			and splits the batch across the workers.
+
+			One dimensional integrals use the 7 point Gauss / 15 point Kronrod pair, boxes in higher
+			dimensions use the degree 7 Genz-Malik rule with its embedded degree 5 rule for the error.
+			Everything is computed in long double.
+		*/
+		namespace Integration {
+			// Most dimensions a box can have, the Genz-Malik rule needs 2^n + 2n^2 + 2n + 1 points
+			const size_t MAX_DIMENSION = 6;
+
+			/*!
+				Function being integrated, the points are in the box's dimension
+			*/
+			typedef Mt::core::BatchFunction Integrand;
+
+			/*! \struct Options
+				\brief Integration limits
+			*/
+			struct Options {
+				long double absoluteTolerance;
+				long double relativeTolerance;
+				// Function evaluations to give up after
+				size_t maxEvaluations;
+				// Worker threads, 0 picks one per hardware thread
+				unsigned threads;
+
+				Options(void);
+			};
+
+			/*! \struct Result
+				\brief Integral and how far it can be trusted
+			*/
+			struct Result {
+				long double value;
+				long double error;
+				size_t evaluations;
+				// The error estimate is within tolerance
+				bool converged;
+			};
+
+			/*!
+				Integrates f over the box lower[i] to upper[i], i in [0, dimension). Bounds may be given
+				in either order, swapped bounds flip the sign like they do on paper.
+				\return false if f failed to evaluate or the dimension is not supported
+			*/
+			bool Integrate(Integrand& f, const long double* lower, const long double* upper, size_t dimension, Options const& options, Result& result);
+		}
+	}
+}
@@ -78,6 +78,10 @@ namespace Mt {
 					Collection of currently loaded modules
 				*/
 				std::map<std::string, ModulePackage*> Modules;
+				/*!
+					Shared objects loaded for their symbols alone, by path
+				*/
+				std::map<std::string, M_HANDLE> Objects;
 
 #if defined(__linux__) | defined(__APPLE__)
 				/*!
@@ -132,6 +136,13 @@ namespace Mt {
 					\todo Windows Implementation
 				*/
 				bool UnloadAll(void);
+
+				/*!
+					Loads a shared object that is not a module by path and returns the address of the
+					named C symbol in it, nullptr if either can not be found. The object stays loaded
+					until ModuleEngine::UnloadAll, loading it again only looks the symbol up.
+				*/
+				void* LoadSymbol(std::string const& path, std::string const& symbol);
 		};
 	}
 }
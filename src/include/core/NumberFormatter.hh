@@ -0,0 +1,104 @@
+/*
+	NumberFormatter.hh - Shortest round trip float formatting for result output
+*/
+#pragma once
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "core/Types.hh"
+#include "core/HPN.hh"
+
+namespace Mt {
+	namespace core {
+		/*! \namespace Mt::core::NumberFormatter
+			\brief Result output formatting
+
+			Formats floats with the fewest decimal digits that still parse back to the exact same
+			value, using the Ryu algorithm (Adams, PLDI 2018) so no big number arithmetic is needed
+			per value. Everything appends into a caller owned std::string, which lets a whole result
+			be built in one reusable buffer and written out with a single write.
+
+			The layout follows the numeric_notation and numeric_align settings in mt.cfg.
+		*/
+		namespace NumberFormatter {
+			/*!
+				How the decimal exponent is written
+			*/
+			enum NOTATION {
+				// d.ddde+XX
+				SCIENTIFIC = 0,
+				// ddd.ddd, never an exponent
+				FIXED = 1,
+				// Fixed for moderate magnitudes, scientific otherwise
+				GENERAL = 2,
+			};
+
+			/*!
+				Which side of a column values are padded on
+			*/
+			enum ALIGNMENT {
+				LEFT = 0,
+				RIGHT = 1,
+			};
+
+			/*! \struct Style
+				\brief Output settings shared by everything that prints numbers
+			*/
+			struct Style {
+				NOTATION notation;
+				ALIGNMENT alignment;
+
+				Style(void) : notation(NOTATION::SCIENTIFIC), alignment(ALIGNMENT::LEFT) { }
+			};
+
+			/*!
+				Returns the process wide output style
+			*/
+			Style const& GetStyle(void);
+			void SetStyle(Style const& style);
+			/*!
+				Parses a numeric_notation value (scientific, fixed, general), returns false if unknown
+			*/
+			bool NotationFromString(std::string const& name, NOTATION& n);
+			/*!
+				Parses a numeric_align value (left, right), returns false if unknown
+			*/
+			bool AlignmentFromString(std::string const& name, ALIGNMENT& a);
+
+			/*!
+				Appends the shortest round trip representation of the value in the current notation
+			*/
+			void Append(std::string& out, double value);
+			void Append(std::string& out, long double value);
+#if defined(_MT_HAS_QUAD) && !defined(_MT_USE_LIB_HPN)
+			void Append(std::string& out, mtquad_t value);
+#endif
+			/*!
+				Appends decimal text such as "-1.25e-07" re-laid out in the current notation
+			*/
+			void AppendDecimalText(std::string& out, std::string const& text);
+			/*!
+				Multi-precision floats have no fixed width tables, they print enough digits to round trip
+			*/
+			template <int Bits>
+			void Append(std::string& out, Mt::core::hpn::MPFloat<Bits> const& value) {
+				AppendDecimalText(out, value.ToString(static_cast<int>((static_cast<int64_t>(Bits) * 30103) / 100000) + 2));
+			}
+			/*!
+				Anything that is not a float goes through its stream operator
+			*/
+			template <class T>
+			void Append(std::string& out, T const& value) {
+				std::ostringstream ss;
+				ss << value;
+				out += ss.str();
+			}
+			/*!
+				Appends [text, text + length) padded with spaces to width on the side the alignment asks for
+			*/
+			void AppendPadded(std::string& out, const char* text, size_t length, size_t width, ALIGNMENT alignment);
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/*
+	NumberParser.hh - Exact decimal to binary conversion for numeric literals
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "core/Types.hh"
+
+namespace Mt {
+	namespace core {
+		/*! \namespace Mt::core::NumberParser
+			\brief Numeric literal parsing
+
+			Converts decimal text straight from a character buffer into correctly rounded floats.
+			The text is scanned once into a Mt::core::NumberParser::Decimal which can then be
+			converted to any of the float types without touching the text again.
+
+			Each conversion tries, in order, the Clinger fast path (the mantissa and the power of
+			ten are both exact in the target type so one rounding gives the right answer), the
+			Eisel-Lemire algorithm for double, and finally an exact big integer slow path that is
+			always correct.
+		*/
+		namespace NumberParser {
+			/*! \struct Decimal
+				\brief Scanned decimal number, value = mantissa * 10^exponent
+			*/
+			struct Decimal {
+				// The first 19 significant digits
+				uint64_t mantissa;
+				int64_t exponent;
+				bool negative;
+				// Set when nonzero significant digits past the 19th had to be dropped
+				bool truncated;
+				// Every significant digit, only kept when truncated
+				std::string digits;
+				// value = digits * 10^digitsExponent, only meaningful when truncated
+				int64_t digitsExponent;
+				// Number of significant digits
+				int64_t count;
+
+				Decimal(void) : mantissa(0), exponent(0), negative(false), truncated(false), digitsExponent(0), count(0) { }
+			};
+
+			/*!
+				Scans [sign]digits[.digits][(e|E)[sign]digits] from [first, last) into out, returns
+				the end of the number or nullptr if there is no number at first
+			*/
+			const char* Scan(const char* first, const char* last, Decimal& out);
+			/*!
+				Returns the float closest to the scanned decimal, ties to even
+			*/
+			template <class F>
+			F Convert(Decimal const& dec);
+			/*!
+				Scans and converts [first, last) in one go
+			*/
+			template <class F>
+			F Parse(const char* first, const char* last) {
+				Decimal dec;
+				if(Scan(first, last, dec) == nullptr)
+					return static_cast<F>(0);
+				return Convert<F>(dec);
+			}
+			/*!
+				Scans a complex literal of the form A[+-]Bi into its real and imaginary parts,
+				returns false if [first, last) is not one
+			*/
+			bool ScanComplex(const char* first, const char* last, Decimal& re, Decimal& im);
+		}
+	}
+}
@@ -0,0 +1,148 @@
+/*
+	ODE.hh - Initial value problems for ordinary differential equations
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Mt {
+	namespace core {
+		/*! \namespace Mt::core::ODE
+			\brief Adaptive solvers for dy/dt = f(t, y, p)
+
+			Both methods run on a block of members at once. Every member of a block carries its own
+			time, step size and parameters, and steps are accepted or rejected per member, but the
+			stages are computed for the whole block in lockstep. State is stored structure of arrays,
+			component i of every member in one contiguous row, so the stage arithmetic runs down
+			rows the compiler can vectorize and the system is evaluated once per stage for the whole
+			block. A single solve is a block of one.
+
+			Dormand-Prince 5(4) is the default. The Rosenbrock method is Shampine's 2(3) pair, it is
+			linearly implicit and L-stable, so stiff systems take steps set by accuracy instead of
+			stability. Its Jacobian comes from forward differences and every stage solves with the
+			LU factors of I - h d J.
+
+			Both methods have a continuous extension, so values between steps are interpolated from
+			what the step already computed instead of forcing the solver to stop at them.
+		*/
+		namespace ODE {
+			/*! \class System
+				\brief Right hand side of a system, evaluated for a block of members at a time
+			*/
+			class System {
+			public:
+				virtual ~System(void) { }
+				/*!
+					Evaluates dy/dt for count members. Member m is at time t[m], its state component i
+					is y[i * stride + m] and its parameter j is p[j * stride + m], the derivative goes to
+					dydt in the same layout.
+					\return false if the system failed, the solve is abandoned
+				*/
+				virtual bool Evaluate(const long double* t, const long double* y, const long double* p, long double* dydt, size_t count, size_t stride) = 0;
+				/*!
+					Returns an independent copy a worker thread can evaluate while this one is in use,
+					nullptr if the system can not be evaluated concurrently
+				*/
+				virtual std::unique_ptr<System> Fork(void) = 0;
+
+				/*!
+					Returns this system followed by up to count - 1 forks of it, one per worker, fewer
+					if it can not be forked. The forks are owned by owned.
+				*/
+				std::vector<System*> ForkWorkers(unsigned count, std::vector<std::unique_ptr<System>>& owned) {
+					std::vector<System*> systems(1, this);
+					for(unsigned i = 1; i < count; i++) {
+						std::unique_ptr<System> fork = this->Fork();
+						if(!fork)
+							break;
+						systems.push_back(fork.get());
+						owned.push_back(std::move(fork));
+					}
+					return systems;
+				}
+			};
+
+			enum METHOD {
+				DORMAND_PRINCE = 0,
+				ROSENBROCK = 1,
+			};
+
+			/*! \struct Options
+				\brief Solver settings
+			*/
+			struct Options {
+				METHOD method;
+				long double absoluteTolerance;
+				long double relativeTolerance;
+				// Steps a member may take, accepted or not, before it is given up on
+				size_t maxSteps;
+				// Worker threads for ensembles, 0 picks one per hardware thread
+				unsigned threads;
+
+				Options(void);
+			};
+
+			/*! \struct Result
+				\brief What a solve cost and whether it got there
+			*/
+			struct Result {
+				size_t steps;
+				size_t rejected;
+				size_t evaluations;
+				// Members that ran out of steps or whose step size underflowed
+				size_t failures;
+			};
+
+			/*! \class Trajectory
+				\brief Dense output of a single solve
+
+				Keeps the interpolation coefficients of every accepted step, so the solution can be
+				read anywhere between the start and where the solve stopped.
+			*/
+			class Trajectory {
+			private:
+				size_t dimension;
+				// Start of every step and the end of the last one
+				std::vector<long double> times;
+				// Five rows of dimension coefficients per step
+				std::vector<long double> coefficients;
+
+				friend bool Solve(System&, size_t, const long double*, size_t, long double, const long double*, long double, Options const&, Trajectory&, Result&);
+			public:
+				Trajectory(void);
+
+				size_t Dimension(void) const;
+				size_t Steps(void) const;
+				long double Start(void) const;
+				long double End(void) const;
+				/*!
+					Writes the state at time t to y
+					\return false if t is outside the solved range
+				*/
+				bool At(long double t, long double* y) const;
+			};
+
+			/*!
+				Solves from y0 at t0 to t1 and keeps the dense output, t1 may lie before t0. The
+				parameters are handed to every evaluation of f.
+				\return false if f failed or the solve did not reach t1, the trajectory covers the
+				range that was solved either way
+			*/
+			bool Solve(System& f, size_t dimension, const long double* parameters, size_t parameterCount, long double t0, const long double* y0,
+				long double t1, Options const& options, Trajectory& trajectory, Result& result);
+			/*!
+				Solves members copies of the system from t0 to the last of the sample times, every
+				member from its own initial state and parameters, blocks of members are spread across
+				worker threads. y0 is dimension rows of members values and parameters is parameterCount
+				rows the same way. The state at every sample time goes to samples, one dimension by
+				members block per sample, times have to be in the direction of integration. Samples a
+				member did not reach are NaN.
+				\return false if f failed
+			*/
+			bool Ensemble(System& f, size_t dimension, size_t parameterCount, size_t members, long double t0, const long double* y0, const long double* parameters,
+				const long double* times, size_t sampleCount, Options const& options, long double* samples, Result& result);
+		}
+	}
+}
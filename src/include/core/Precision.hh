@@ -0,0 +1,116 @@
+/*
+	Precision.hh - Runtime selectable numeric precision tiers
+*/
+#pragma once
+
+#include <string>
+
+#include "core/Types.hh"
+
+namespace Mt {
+	namespace core {
+		/*!
+			The precision tiers that numeric values and kernels can be evaluated in, ordered so
+			that the wider of two tiers compares greater, which is what promotion relies on.
+		*/
+		enum PRECISION {
+			DOUBLE = 0,
+			EXTENDED = 1,
+			QUAD = 2,
+		};
+
+		/*! \struct PrecisionType
+			\brief Maps a precision tier to the C++ type it is computed in
+		*/
+		template <PRECISION P>
+		struct PrecisionType;
+
+		template <>
+		struct PrecisionType<PRECISION::DOUBLE> {
+			typedef double type;
+		};
+
+		template <>
+		struct PrecisionType<PRECISION::EXTENDED> {
+			typedef long double type;
+		};
+
+		template <>
+		struct PrecisionType<PRECISION::QUAD> {
+			typedef mtquad_t type;
+		};
+
+		/*! \struct PrecisionOf
+			\brief Maps a C++ floating point type back to its precision tier
+		*/
+		template <class F>
+		struct PrecisionOf;
+
+		template <>
+		struct PrecisionOf<double> {
+			static const PRECISION value = PRECISION::DOUBLE;
+		};
+
+		template <>
+		struct PrecisionOf<long double> {
+			static const PRECISION value = PRECISION::EXTENDED;
+		};
+
+#if defined(_MT_HAS_QUAD)
+		template <>
+		struct PrecisionOf<mtquad_t> {
+			static const PRECISION value = PRECISION::QUAD;
+		};
+#endif
+
+		namespace Precision {
+			/*!
+				Returns the tier that the result of mixing two tiers is computed in
+			*/
+			inline PRECISION Promote(PRECISION lhs, PRECISION rhs) {
+				return (lhs > rhs) ? lhs : rhs;
+			}
+			/*!
+				Returns true if the tier is backed by its own type in this build, without __float128
+				support the quad tier is computed as extended.
+			*/
+			inline bool IsNative(PRECISION p) {
+#if defined(_MT_HAS_QUAD)
+				const bool quad = true;
+#else
+				const bool quad = false;
+#endif
+				return quad || (p != PRECISION::QUAD);
+			}
+			/*!
+				Parses a tier name (double, extended, quad) into a tier, returns false if the name is unknown
+			*/
+			inline bool FromString(std::string name, PRECISION& p) {
+				if(name == "double") {
+					p = PRECISION::DOUBLE;
+				} else if(name == "extended" || name == "long_double") {
+					p = PRECISION::EXTENDED;
+				} else if(name == "quad") {
+					p = PRECISION::QUAD;
+				} else {
+					return false;
+				}
+				return true;
+			}
+			/*!
+				Returns the name of the given tier
+			*/
+			inline std::string ToString(PRECISION p) {
+				switch(p) {
+					case PRECISION::DOUBLE:
+						return "double";
+					case PRECISION::EXTENDED:
+						return "extended";
+					case PRECISION::QUAD:
+						return "quad";
+				}
+				return "<<UNKNOWN>>";
+			}
+		}
+	}
+}
@@ -0,0 +1,70 @@
+/*
+	Random.hh - Counter based random numbers
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Mt {
+	namespace core {
+		/*! \class Philox
+			\brief Philox4x32-10 counter based generator (Salmon et al, SC'11)
+
+			Block i of a stream is ten rounds of a bijection applied to the counter (i, stream) under
+			the key seed, so any number can be computed straight from its position without stepping
+			through the ones before it. Bulk fills split their range across worker threads freely
+			and produce the same numbers for any thread count. Parallel work that draws numbers as
+			it goes takes one stream per task, not per thread, for the same reason.
+
+			Blocks are computed several counters at a time with the lanes in separate arrays, which
+			the compiler turns into SIMD multiplies.
+		*/
+		class Philox {
+		private:
+			uint32_t key[2];
+			uint32_t stream[2];
+		public:
+			Philox(uint64_t seed, uint64_t streamId = 0);
+
+			/*!
+				Returns the generator for another stream under the same seed
+			*/
+			Philox Stream(uint64_t streamId) const;
+
+			/*!
+				Writes blocks first to first + count - 1, four words each
+			*/
+			void Blocks(uint64_t first, uint32_t* out, size_t count) const;
+			/*!
+				Uniform numbers in [0, 1) at positions first onwards. Number i is the 64 bit word i
+				of the stream scaled down, a long double keeps all 64 bits and a double the top 53.
+			*/
+			void Uniform(uint64_t first, long double* out, size_t count) const;
+			void Uniform(uint64_t first, double* out, size_t count) const;
+			/*!
+				Standard normal numbers at positions first onwards by the Box-Muller transform, the
+				even and odd numbers of a pair come from the same block
+			*/
+			void Normal(uint64_t first, long double* out, size_t count) const;
+			void Normal(uint64_t first, double* out, size_t count) const;
+		};
+
+		/*! \namespace Mt::core::Random
+			\brief Bulk fills spread across worker threads
+		*/
+		namespace Random {
+			enum DISTRIBUTION {
+				UNIFORM = 0,
+				NORMAL = 1,
+			};
+
+			/*!
+				Fills out with count numbers of the given distribution from position 0 of the stream.
+				Large fills are split across threads, 0 picks one per hardware thread, the numbers
+				do not depend on the split.
+			*/
+			void Fill(Philox const& generator, DISTRIBUTION distribution, long double* out, size_t count, unsigned threads = 0);
+		}
+	}
+}
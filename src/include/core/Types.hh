@@ -1,17 +1,44 @@
 /*
 	Types.hh - Internal type aliasing
 */
+#pragma once
 #if defined(_MT_USE_LIB_QUADMATH_)
 	#include <quadmath.h>
 	typedef __float128 mtfloat_t;
 #elif defined(_MT_USE_LIB_HPN)
+#	include "core/HPN.hh"
 #	if defined(_LIB_HPN_256)
 		typedef __mfloat256 mtfloat_t;
 #	elif defined(_LIB_HPN_512)
 		typedef __mfloat512 mtfloat_t;
+#	elif defined(_LIB_HPN_4096)
+		typedef __mfloat4096 mtfloat_t;
 #	else
 		typedef __mfloat128 mtfloat_t;
 #	endif
 #else
 	typedef long double mtfloat_t;
 #endif
+
+// Widest hardware/compiler supported float, used for the quad precision tier.
+// GCC and clang provide __float128 arithmetic without libquadmath, that is only
+// needed for the transcendental functions and printing. The multi-precision
+// builds carry their own float in that tier instead, it is wider than __float128.
+#if defined(_MT_USE_LIB_HPN)
+	#define _MT_HAS_QUAD
+	typedef mtfloat_t mtquad_t;
+#elif defined(__SIZEOF_FLOAT128__)
+	#define _MT_HAS_QUAD
+	__extension__ typedef __float128 mtquad_t;
+#else
+	typedef long double mtquad_t;
+#endif
+
+// No aliasing qualifier for pointers, spelled differently by every compiler
+#if defined(_MSC_VER)
+	#define MT_RESTRICT __restrict
+#elif defined(__GNUC__) || defined(__clang__)
+	#define MT_RESTRICT __restrict__
+#else
+	#define MT_RESTRICT
+#endif
@@ -0,0 +1,57 @@
+/*
+	WorkerPool.hh - Threads shared by one parallel computation
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Mt {
+	namespace core {
+		/*! \class WorkerPool
+			\brief Threads that stay up for one parallel computation
+
+			Run hands every worker, the calling thread included as worker 0, the same job and returns
+			once all of them are done with it, so a computation that works in rounds pays for
+			starting its threads once rather than every round.
+		*/
+		class WorkerPool {
+		private:
+			std::vector<std::thread> threads;
+			std::mutex lock;
+			std::condition_variable wake;
+			std::condition_variable done;
+			std::function<void(size_t)> const* job;
+			// Bumped for every job so a sleeping worker can tell a new one from a spurious wakeup
+			size_t generation;
+			size_t running;
+			bool stopping;
+
+			void Loop(size_t worker);
+		public:
+			/*!
+				Starts count - 1 threads, fewer if the system will not give us that many
+			*/
+			explicit WorkerPool(size_t count);
+			~WorkerPool(void);
+
+			/*!
+				Returns the number of workers, the calling thread included
+			*/
+			size_t Size(void) const;
+			/*!
+				Runs task(worker) on every worker and waits for all of them, task must not throw
+			*/
+			void Run(std::function<void(size_t)> const& task);
+
+			/*!
+				Returns the worker count for the given request, 0 asks for one per hardware thread
+			*/
+			static unsigned Workers(unsigned requested);
+		};
+	}
+}
@@ -7,13 +7,18 @@
 
 #include "objects/Scalar.hh"
 #include "objects/Complex.hh"
+#include "objects/Integer.hh"
 
 #include "core/Types.hh"
+#include "core/NumberParser.hh"
+#include "core/lang/Builtins.hh"
+#include "core/lang/Symbols.hh"
 
 #include <iostream>
 #include <vector>
 #include <map>
 #include <string>
+#include <stdexcept>
 
 
 namespace Mt {
@@ -34,7 +39,9 @@ namespace Mt {
 				_NBLOCK = 10,
 				_NEXPRESSIONSTATEMENT = 11,
 				_NFUNCTIONDECLARATION = 12,
-				_NLISTDECLARATION = 13
+				_NLISTDECLARATION = 13,
+				_NINTEGER = 14,
+				_NRETURNSTATEMENT = 15
 			};
 			/*! \class NRoot
 				\brief Lexical Expression Base
@@ -74,14 +81,65 @@ namespace Mt {
 			/*! \class NScalar
 				\brief SML Scalar Representation
 
-				This is a lexical object that represents the Mt::objects::Integer type
+				This is a lexical object that represents the Mt::objects::Integer type, literals read
+				from source text also keep the value correctly rounded for each precision tier so the
+				evaluator never has to round twice
 			*/
 			class NScalar : public NExpression {
 				public:
 					Mt::objects::Scalar _s;
-					NScalar(mtfloat_t val) : _s(val) {
+					double _d;
+					long double _e;
+					mtquad_t _q;
+					NScalar(mtfloat_t val) : _s(val), _d(static_cast<double>(val)), _e(static_cast<long double>(val)), _q(static_cast<mtquad_t>(val)) {
 						this->type = _NSCALAR;
 					}
+					/*!
+						A value the optimizer folded, already rounded for each tier
+					*/
+					NScalar(double d, long double e, mtquad_t q) : _s(static_cast<mtfloat_t>(e)), _d(d), _e(e), _q(q) {
+						this->type = _NSCALAR;
+					}
+					NScalar(const char* first, const char* last) {
+						Mt::core::NumberParser::Decimal dec;
+						Mt::core::NumberParser::Scan(first, last, dec);
+						this->Set(dec);
+						this->type = _NSCALAR;
+					}
+					void Set(Mt::core::NumberParser::Decimal const& dec) {
+						this->_s = Mt::objects::Scalar(Mt::core::NumberParser::Convert<mtfloat_t>(dec));
+						this->_d = Mt::core::NumberParser::Convert<double>(dec);
+						this->_e = Mt::core::NumberParser::Convert<long double>(dec);
+						this->_q = Mt::core::NumberParser::Convert<mtquad_t>(dec);
+					}
+					void Negate(void) {
+						this->_s = Mt::objects::Scalar(-this->_s.GetInternal());
+						this->_d = -this->_d;
+						this->_e = -this->_e;
+						this->_q = -this->_q;
+					}
+			};
+			/*! \class NInteger
+				\brief SML Integer Representation
+
+				This is a lexical object that represents the Mt::objects::Integer type, integer
+				literals are kept exact
+			*/
+			class NInteger : public NExpression {
+				public:
+					Mt::objects::Integer _i;
+					NInteger(const std::string val) : _i(val) {
+						this->type = _NINTEGER;
+					}
+					NInteger(const char* first, const char* last) : _i(first, last) {
+						this->type = _NINTEGER;
+					}
+					NInteger(Mt::objects::Integer const& i) : _i(i) {
+						this->type = _NINTEGER;
+					}
+					void Negate(void) {
+						this->_i = -this->_i;
+					}
 			};
 			/*! \class NComplexfind . -name '*.cc' -o -name '*.hh' | xargs wc -l
 				\brief SML Complex Representation
@@ -91,12 +149,52 @@ namespace Mt {
 			class NComplex : public NExpression {
 				public:
 					Mt::objects::Complex _c;
-					NComplex(const std::string cplx) : _c(cplx) {
+					// Real and imaginary parts rounded for each precision tier
+					double _d[2];
+					long double _e[2];
+					mtquad_t _q[2];
+					NComplex(const std::string cplx) : NComplex(cplx.data(), cplx.data() + cplx.size()) {
+
+					}
+					NComplex(const char* cplx) : NComplex(std::string(cplx)) {
+
+					}
+					/*!
+						A value the optimizer folded, real and imaginary parts already rounded for each tier
+					*/
+					NComplex(double const d[2], long double const e[2], mtquad_t const q[2]) {
+						this->_c.SetRealPart(Mt::objects::Scalar(static_cast<mtfloat_t>(e[0])));
+						this->_c.SetImaginaryPart(Mt::objects::Scalar(static_cast<mtfloat_t>(e[1])));
+						for(size_t i = 0; i < 2; i++) {
+							this->_d[i] = d[i];
+							this->_e[i] = e[i];
+							this->_q[i] = q[i];
+						}
 						this->type = _NCOMPLEX;
 					}
-					NComplex(const char* cplx) : _c(cplx) {
+					NComplex(const char* first, const char* last) {
+						Mt::core::NumberParser::Decimal re, im;
+						if(!Mt::core::NumberParser::ScanComplex(first, last, re, im))
+							throw std::invalid_argument("Invalid complex \"" + std::string(first, last) + "\"");
+						this->_c.SetRealPart(Mt::objects::Scalar(Mt::core::NumberParser::Convert<mtfloat_t>(re)));
+						this->_c.SetImaginaryPart(Mt::objects::Scalar(Mt::core::NumberParser::Convert<mtfloat_t>(im)));
+						this->_d[0] = Mt::core::NumberParser::Convert<double>(re);
+						this->_d[1] = Mt::core::NumberParser::Convert<double>(im);
+						this->_e[0] = Mt::core::NumberParser::Convert<long double>(re);
+						this->_e[1] = Mt::core::NumberParser::Convert<long double>(im);
+						this->_q[0] = Mt::core::NumberParser::Convert<mtquad_t>(re);
+						this->_q[1] = Mt::core::NumberParser::Convert<mtquad_t>(im);
 						this->type = _NCOMPLEX;
 					}
+					/*!
+						Negates the real part only, a leading minus binds to the first term of A+Bi
+					*/
+					void Negate(void) {
+						this->_c.SetRealPart(Mt::objects::Scalar(-this->_c.GetRealPart().GetInternal()));
+						this->_d[0] = -this->_d[0];
+						this->_e[0] = -this->_e[0];
+						this->_q[0] = -this->_q[0];
+					}
 			};
 			/*! \class NIdentifier
 				\brief SML Lexical Identifier
@@ -105,11 +203,14 @@ namespace Mt {
 
 				An SML identifier can be any alphanumeric string with any amount of underscores contained 
 				within as long as it starts only with an alpha that matches [a-zA-Z]
+
+				The name is interned as it is parsed, everything after the parser looks it up by _symbol.
 			*/
 			class NIdentifier : public NExpression {
 				public:
 					std::string _name;
-					NIdentifier(const std::string& name) : _name(name) {
+					Symbol _symbol;
+					NIdentifier(const std::string& name) : _name(name), _symbol(Symbols::Intern(name)) {
 						this->type = _NIDENTIFIER;
 					}
 			};
@@ -127,7 +228,7 @@ namespace Mt {
 					NIdentifier& _id;
 					NExpression* _assignmentExpr;
 					NVariableDeclaration(NIdentifier& id) :
-						_id(id) {
+						_id(id), _assignmentExpr(nullptr) {
 							this->type = _NVARIABLEDECLARATION;
 					}
 					NVariableDeclaration(NIdentifier& id, NExpression *assignmentExpr) :
@@ -151,15 +252,19 @@ namespace Mt {
 				~~~
 
 				where `ExpressionList` is `std::vector<Mt::core::lang::NExpression*>`
+
+				The callee is resolved against the builtin table when the node is built, so evaluating
+				the call never looks the name up again. `_builtin` is nullptr for unknown names.
 			*/
 			class NMethodCall : public NExpression {
 				public:
 					const NIdentifier& _id;
 					ExpressionList _arguments;
-					NMethodCall(const NIdentifier& id, ExpressionList& arguments) : _id(id), _arguments(arguments) { 
+					const Builtin* _builtin;
+					NMethodCall(const NIdentifier& id, ExpressionList& arguments) : _id(id), _arguments(arguments), _builtin(Builtins::Find(id._name)) { 
 						this->type = _NMETHODCALL;
 					}
-					NMethodCall(const NIdentifier& id) : _id(id) { 
+					NMethodCall(const NIdentifier& id) : _id(id), _builtin(Builtins::Find(id._name)) { 
 						this->type = _NMETHODCALL;
 					}
 			};
@@ -171,14 +276,16 @@ namespace Mt {
 				~~~
 				NExpression OPERATOR NExpression
 				~~~
+
+				The operands are pointers so the optimizer can replace them.
 			*/
 			class NBinaryOperator : public NExpression {
 				public:
-					NExpression& _lhs;
+					NExpression* _lhs;
 					int _op;
-					NExpression& _rhs;
+					NExpression* _rhs;
 					NBinaryOperator(NExpression& lhs, int op, NExpression& rhs) :
-						_lhs(lhs), _op(op), _rhs(rhs) {
+						_lhs(&lhs), _op(op), _rhs(&rhs) {
 							this->type = _NBINARYOPERATOR;
 					}
 			};
@@ -195,9 +302,9 @@ namespace Mt {
 			class NAssignment : public NExpression {
 				public:
 					NIdentifier& _lhs;
-					NExpression& _rhs;
+					NExpression* _rhs;
 					NAssignment(NIdentifier& lhs, NExpression& rhs) :
-						_lhs(lhs), _rhs(rhs) {
+						_lhs(lhs), _rhs(&rhs) {
 							this->type = _NASSIGNMENT;
 						}
 			};
@@ -221,12 +328,29 @@ namespace Mt {
 			*/
 			class NExpressionStatement : public NStatement {
 				public:
-					NExpression& _expression;
+					NExpression* _expression;
 					NExpressionStatement(NExpression& expression) :
-						_expression(expression) { 
+						_expression(&expression) { 
 							this->type = _NEXPRESSIONSTATEMENT;
 					}
 			};
+			/*! \class NReturnStatement
+				\brief SML Return Statement Representation
+
+				This class ends the function it is in with the value of the expression in the form of:
+
+				~~~
+				ret NExpression
+				~~~
+			*/
+			class NReturnStatement : public NStatement {
+				public:
+					NExpression* _expression;
+					NReturnStatement(NExpression& expression) :
+						_expression(&expression) {
+							this->type = _NRETURNSTATEMENT;
+					}
+			};
 			/*! \class NFunctionDeclaration
 				\brief SML Function Declaration Representation
 
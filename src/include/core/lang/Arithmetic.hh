@@ -0,0 +1,199 @@
+/*
+	Arithmetic.hh - Arithmetic kernels shared by the evaluator and the operator dispatch table
+*/
+#pragma once
+
+#include <cstdint>
+
+#include "core/HPN.hh"
+#include "core/Precision.hh"
+#include "core/lang/ObjectPool.hh"
+#include "core/lang/Value.hh"
+#include "core/symbolic/Dual.hh"
+#include "objects/Integer.hh"
+#include "objects/Rational.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \namespace Mt::core::lang::Arithmetic
+				\brief The four basic operations on the inline number representations
+
+				Every kernel knows how to do its operation on machine integers, exact numbers, each
+				float tier, complex numbers and dual numbers. The Apply functions pick the
+				representation, what pairs of types meet in the first place is decided by
+				Mt::core::lang::Dispatch.
+			*/
+			namespace Arithmetic {
+				using Mt::core::symbolic::Dual;
+
+				/*
+					Arithmetic kernels, each one is instantiated once per precision tier by ApplyKernel
+				*/
+				struct AddKernel {
+					static const bool IntegerClosed = true;
+					static bool SmallInteger(int64_t a, int64_t b, int64_t& r) {
+						return !Mt::core::hpn::AddOverflow(a, b, r);
+					}
+					template <class N>
+					static N Exact(N const& a, N const& b) {
+						return a + b;
+					}
+					template <class F>
+					static void Scalar(F a, F b, F& r) {
+						r = a + b;
+					}
+					template <class F>
+					static void Complex(F a, F b, F c, F d, F& re, F& im) {
+						re = a + c;
+						im = b + d;
+					}
+					static Mt::core::symbolic::Dual Dual(Mt::core::symbolic::Dual const& a, Mt::core::symbolic::Dual const& b) {
+						return a + b;
+					}
+				};
+
+				struct MinusKernel {
+					static const bool IntegerClosed = true;
+					static bool SmallInteger(int64_t a, int64_t b, int64_t& r) {
+						return !Mt::core::hpn::SubOverflow(a, b, r);
+					}
+					template <class N>
+					static N Exact(N const& a, N const& b) {
+						return a - b;
+					}
+					template <class F>
+					static void Scalar(F a, F b, F& r) {
+						r = a - b;
+					}
+					template <class F>
+					static void Complex(F a, F b, F c, F d, F& re, F& im) {
+						re = a - c;
+						im = b - d;
+					}
+					static Mt::core::symbolic::Dual Dual(Mt::core::symbolic::Dual const& a, Mt::core::symbolic::Dual const& b) {
+						return a - b;
+					}
+				};
+
+				struct MultiplyKernel {
+					static const bool IntegerClosed = true;
+					static bool SmallInteger(int64_t a, int64_t b, int64_t& r) {
+						return !Mt::core::hpn::MulOverflow(a, b, r);
+					}
+					template <class N>
+					static N Exact(N const& a, N const& b) {
+						return a * b;
+					}
+					template <class F>
+					static void Scalar(F a, F b, F& r) {
+						r = a * b;
+					}
+					// (a + bi)(c + di) = (ac - bd) + (ad + bc)i
+					template <class F>
+					static void Complex(F a, F b, F c, F d, F& re, F& im) {
+						re = (a * c) - (b * d);
+						im = (a * d) + (b * c);
+					}
+					static Mt::core::symbolic::Dual Dual(Mt::core::symbolic::Dual const& a, Mt::core::symbolic::Dual const& b) {
+						return a * b;
+					}
+				};
+
+				struct DivideKernel {
+					// Integers are not closed under division, the exact result is a rational
+					static const bool IntegerClosed = false;
+					// Only takes the fast path when the division is exact
+					static bool SmallInteger(int64_t a, int64_t b, int64_t& r) {
+						if(b == 0 || (a == INT64_MIN && b == -1) || (a % b) != 0)
+							return false;
+						r = a / b;
+						return true;
+					}
+					template <class N>
+					static N Exact(N const& a, N const& b) {
+						return a / b;
+					}
+					template <class F>
+					static void Scalar(F a, F b, F& r) {
+						r = a / b;
+					}
+					// (a + bi)/(c + di) = ((ac + bd) + (bc - ad)i) / (c^2 + d^2)
+					template <class F>
+					static void Complex(F a, F b, F c, F d, F& re, F& im) {
+						F denom = (c * c) + (d * d);
+						re = ((a * c) + (b * d)) / denom;
+						im = ((b * c) - (a * d)) / denom;
+					}
+					static Mt::core::symbolic::Dual Dual(Mt::core::symbolic::Dual const& a, Mt::core::symbolic::Dual const& b) {
+						return a / b;
+					}
+				};
+
+				/*
+					Exact arithmetic on integers and rationals. Two inline integers go through the machine
+					word fast path, results that overflow or leave the integers fall through to the
+					Mt::objects::Integer and Mt::objects::Rational implementations.
+				*/
+				template <class Kernel>
+				Value ApplyExact(Value const& lhs, Value const& rhs, ObjectPool& pool) {
+					if(lhs.type == Mt::core::TYPE::INTEGER && rhs.type == Mt::core::TYPE::INTEGER) {
+						int64_t r;
+						if(!lhs.big && !rhs.big && Kernel::SmallInteger(lhs.i[0], rhs.i[0], r))
+							return Value::MakeInteger(r);
+						if(Kernel::IntegerClosed)
+							return Value::FromInteger(Kernel::Exact(lhs.ToInteger(), rhs.ToInteger()), pool);
+					}
+					return Value::FromRational(Kernel::Exact(lhs.ToRational(), rhs.ToRational()), pool);
+				}
+
+				template <class Kernel, class F>
+				Value ApplyTier(Value const& lhs, Value const& rhs) {
+					if(lhs.type == Mt::core::TYPE::SCALAR) {
+						F r;
+						Kernel::Scalar(lhs.Get<F>(0), rhs.Get<F>(0), r);
+						return Value::MakeScalar(r);
+					}
+					F re, im;
+					Kernel::Complex(lhs.Get<F>(0), lhs.Get<F>(1), rhs.Get<F>(0), rhs.Get<F>(1), re, im);
+					return Value::MakeComplex(re, im);
+				}
+
+				/*
+					A dual operand as is, anything else as a constant
+				*/
+				inline Dual AsDual(Value const& v, PRECISION precision) {
+					if(v.type == Mt::core::TYPE::DUAL)
+						return *static_cast<Dual*>(v.object);
+					return Dual(v.IsExact() ? v.ToScalar(precision).Get<long double>(0) : v.Get<long double>(0));
+				}
+
+				/*
+					Arithmetic with a dual operand, the other one is lifted to a constant and the result
+					goes into the pool
+				*/
+				template <class Kernel>
+				Value ApplyDual(Value const& lhs, Value const& rhs, PRECISION precision, ObjectPool& pool) {
+					return Value::MakeObject(pool.Make<Dual>(Kernel::Dual(AsDual(lhs, precision), AsDual(rhs, precision))));
+				}
+
+				/*
+					Runs the kernel in the wider of the two operand tiers, the narrower operand is promoted
+				*/
+				template <class Kernel>
+				Value ApplyKernel(Value const& lhs, Value const& rhs) {
+					switch(Precision::Promote(lhs.precision, rhs.precision)) {
+						case PRECISION::DOUBLE:
+							return ApplyTier<Kernel, double>(lhs, rhs);
+#if defined(_MT_HAS_QUAD)
+						case PRECISION::QUAD:
+							return ApplyTier<Kernel, mtquad_t>(lhs, rhs);
+#endif
+						default:
+							return ApplyTier<Kernel, long double>(lhs, rhs);
+					}
+				}
+			}
+		}
+	}
+}
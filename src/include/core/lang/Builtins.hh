@@ -0,0 +1,109 @@
+/*
+	Builtins.hh - Builtin function table
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "core/IMtObject.hh"
+#include "core/Precision.hh"
+#include "core/lang/Value.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \class FunctionCaller
+				\brief Lets a builtin call back into SML functions
+			*/
+			class FunctionCaller {
+			public:
+				virtual ~FunctionCaller(void) { }
+				/*!
+					Calls a Mt::core::TYPE::FUNCTION value with the given arguments
+					\return the function's result, a NONE value if it failed (the error is already printed)
+				*/
+				virtual Value Call(Value const& function, Value const* args, size_t count) = 0;
+				/*!
+					Returns a caller with its own scratch state, so a worker thread can call functions
+					while this one is in use. Symbols are shared read only, nothing may define new
+					ones while a fork is in use.
+				*/
+				virtual std::unique_ptr<FunctionCaller> Fork(void) = 0;
+			};
+
+			/*! \struct CallContext
+				\brief What a builtin gets to work with besides its arguments
+			*/
+			struct CallContext {
+				// Objects the builtin allocates for its result are owned here
+				ObjectPool& pool;
+				// Session precision tier, exact arguments are rounded to it when a float is needed
+				PRECISION precision;
+				// Calls functions passed as arguments, nullptr if the builtin is called from outside SML
+				FunctionCaller* caller;
+
+				CallContext(ObjectPool& p, PRECISION prc, FunctionCaller* c = nullptr) : pool(p), precision(prc), caller(c) { }
+			};
+
+			typedef Value (*builtin_t)(Value const* args, size_t count, CallContext& context);
+
+			namespace Builtins {
+				// Most arguments any builtin takes, integrate takes a function, six pairs of bounds and a tolerance
+				const size_t MAX_ARITY = 14;
+			}
+
+			/*! \struct Builtin
+				\brief Builtin function table entry
+
+				signature[n] is a mask of the Mt::core::TYPE values accepted as argument n, bit t set
+				means TYPE t is accepted. A pure builtin's result depends on nothing but its arguments
+				and calling it changes nothing, SML functions that only call pure builtins can be
+				memoized.
+			*/
+			struct Builtin {
+				const char* name;
+				builtin_t function;
+				uint8_t minArity;
+				uint8_t maxArity;
+				uint16_t signature[Builtins::MAX_ARITY];
+				bool pure;
+			};
+
+			/*! \namespace Mt::core::lang::Builtins
+				\brief The builtin half of the Global Function Table
+
+				The table is laid out at compile time by a perfect hash of the function names, so
+				resolving a name is one hash and one string compare. Calls are resolved once when the
+				Mt::core::lang::NMethodCall node is built, evaluating a call never looks a name up.
+			*/
+			namespace Builtins {
+				// Argument type masks
+				const uint16_t ARG_REAL = (1u << TYPE::SCALAR) | (1u << TYPE::INTEGER) | (1u << TYPE::RATIONAL);
+				const uint16_t ARG_NUMBER = ARG_REAL | (1u << TYPE::COMPLEX);
+				const uint16_t ARG_LIST = (1u << TYPE::LIST);
+				const uint16_t ARG_MATRIX = (1u << TYPE::MATRIX);
+				const uint16_t ARG_FUNCTION = (1u << TYPE::FUNCTION);
+				// Dual numbers, only what a function being differentiated can pass on
+				const uint16_t ARG_DUAL = (1u << TYPE::DUAL);
+
+				// Values of Mt::core::lang::Builtin::pure, uniform and normal count as pure since they take their seed
+				const bool PURE = true;
+				const bool EFFECTS = false;
+
+				/*!
+					Returns the builtin with the given name, nullptr if there is none
+				*/
+				const Builtin* Find(std::string const& name);
+				/*!
+					Returns true if the value's type is one the mask accepts
+				*/
+				inline bool Accepts(uint16_t mask, Value const& v) {
+					return ((mask >> v.type) & 1u) != 0;
+				}
+			}
+		}
+	}
+}
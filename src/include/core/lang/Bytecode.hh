@@ -0,0 +1,110 @@
+/*
+	Bytecode.hh - Register bytecode for SML function bodies
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/Precision.hh"
+#include "core/lang/ASTObjs.hh"
+#include "core/lang/Builtins.hh"
+#include "core/lang/Symbols.hh"
+#include "core/lang/Value.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \namespace Mt::core::lang::Bytecode
+				\brief Register bytecode that function bodies are lowered to
+
+				A function body is compiled once, when the function is defined, into a flat array of
+				three address instructions over a frame of registers. The parameters are the first
+				registers of the frame, every name the body assigns gets the next ones and the
+				intermediate results of expressions take the rest. Literals are decoded into constants
+				for every precision tier up front, names the body does not assign are looked up in the
+				global symbol table when the instruction runs, exactly as the tree walker would.
+
+				Mt::core::lang::EvaluationEngine runs the instructions with threaded dispatch, so a
+				call costs a frame of registers instead of a symbol table and a walk over the AST.
+				Calls between compiled functions push a frame on the engine's own call stack instead
+				of recursing, and a call in tail position reuses the frame of the caller.
+			*/
+			namespace Bytecode {
+				enum OPCODE : uint8_t {
+					// target = constant a in the session tier
+					CONSTANT = 0,
+					// target = global named a
+					GLOBAL = 1,
+					// target = function named a, from register b - 1 if b is nonzero and from the globals otherwise
+					FUNCTION = 2,
+					// target = a
+					MOVE = 3,
+					// target = a op b
+					ADD = 4,
+					SUBTRACT = 5,
+					MULTIPLY = 6,
+					DIVIDE = 7,
+					// target = builtin b called with the count registers from a
+					BUILTIN = 8,
+					// target = function in register b called with the count registers from a, b was loaded by FUNCTION
+					CALL = 9,
+					// Returns register a
+					RETURN = 10,
+					// CALL whose result the frame returns, the callee runs in the caller's frame. Always
+					// followed by the RETURN of target for callees that are not compiled.
+					TAILCALL = 11,
+					OPCODES = 12,
+				};
+
+				/*! \struct Instruction
+					\brief One instruction, operands are register numbers unless the opcode says otherwise
+				*/
+				struct Instruction {
+					OPCODE op;
+					uint8_t count;
+					uint16_t target;
+					uint16_t a;
+					uint16_t b;
+				};
+
+				// Constants hold one value per precision tier, indexed by Mt::core::PRECISION
+				const size_t TIERS = 3;
+
+				/*! \class Program
+					\brief A compiled function body
+				*/
+				class Program {
+				public:
+					std::vector<Instruction> code;
+					// Constant k in tier t is constants[(k * TIERS) + t]
+					std::vector<Value> constants;
+					// Global and function symbols the body reads
+					std::vector<Symbol> names;
+					std::vector<const Builtin*> builtins;
+					// Frame size, the parameters come first
+					size_t registers;
+					// Integer literals too big to be held inline
+					ObjectPool objects;
+
+					Program(void) : registers(0) { }
+
+					/*!
+						Appends a listing of the instructions, one per line
+					*/
+					void Format(std::string& out) const;
+				};
+
+				/*!
+					Compiles the body of a function, nullptr if it uses anything the bytecode has no
+					instructions for (nested definitions, operators without a kernel, calls with the
+					wrong number of arguments, ...), those functions keep running on the tree walker
+				*/
+				std::unique_ptr<Program> Compile(NFunctionDeclaration const& decl);
+			}
+		}
+	}
+}
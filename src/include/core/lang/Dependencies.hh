@@ -0,0 +1,106 @@
+/*
+	Dependencies.hh - Which definitions and statements read which globals
+*/
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/lang/ASTObjs.hh"
+#include "core/lang/Symbols.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \namespace Mt::core::lang::Schedule
+				\brief Which top level statements of a block can be evaluated side by side
+
+				A statement has to wait for the ones before it that bind a name it reads, read the name it
+				binds or bind the same name. Statements that do not wait for each other share a level and
+				can be evaluated at the same time, each level once the ones below it have been bound.
+			*/
+			namespace Schedule {
+				/*!
+					Plans the statements from first on, up to the first one that has to wait for all of them:
+					function definitions, statements that assign on the way or call a builtin with effects and
+					calls to a function bound earlier in the plan. Writes the level of each one to levels and
+					returns how many were planned, 0 if the first has to run alone.
+				*/
+				size_t Plan(std::vector<NStatement*> const& statements, size_t first, SymbolTable const& globals, std::vector<size_t>& levels);
+			}
+
+			/*! \class DependencyGraph
+				\brief The top level definitions of the session and the globals each one reads
+
+				`B := A - 5` is recorded as B reading A, so when A changes B can be worked out again from
+				its definition instead of the whole worksheet being run again. A definition reads every
+				name in its expression, the functions it calls and, through their bodies, the globals
+				those functions read. Redefining a function recomputes everything that calls it.
+
+				A definition that reads its own name, like `C := C + 1`, builds on the value it replaces
+				and would drift further every time it ran, so it is not recorded. Neither are definitions
+				that assign anything on the way. Either way the name keeps its value until it is bound
+				again.
+			*/
+			class DependencyGraph {
+			public:
+				/*!
+					What the engine does with the dependents of a global that changes
+				*/
+				enum MODE {
+					// Nothing is recorded
+					OFF = 0,
+					// The dependents are evaluated again
+					ON = 1,
+					// The dependents are listed and left as they are
+					DRY = 2,
+				};
+			private:
+				struct Definition {
+					NVariableDeclaration* statement;
+					// The line the definition was made on, printed with its new value
+					std::string input;
+					std::vector<Symbol> reads;
+					// Dependents run in the order they were first defined when nothing else decides
+					unsigned long long order;
+				};
+				std::unordered_map<Symbol, Definition> definitions;
+				// The definitions that read each symbol
+				std::unordered_map<Symbol, std::vector<Symbol>> readers;
+				unsigned long long next;
+			public:
+				DependencyGraph(void) : next(0) { }
+
+				/*!
+					Records the statement as the definition of its name, replacing the one it had. Returns
+					false and forgets the name instead if the definition can not be recomputed.
+				*/
+				bool Define(NVariableDeclaration* statement, std::string const& input, SymbolTable const& globals);
+				/*!
+					Forgets the definition of a name that was bound some other way
+				*/
+				void Forget(Symbol symbol);
+				/*!
+					Returns the definitions to evaluate again after the given names changed, each one after
+					the definitions it reads. The changed names themselves are not in it. Definitions that
+					read each other in a cycle can not be ordered, they go in cyclic instead.
+				*/
+				std::vector<Symbol> Dependents(std::vector<Symbol> const& changed, std::vector<Symbol>& cyclic) const;
+				/*!
+					Returns the statement and the input line a name was defined by, nullptr if it has none
+				*/
+				NVariableDeclaration* Statement(Symbol symbol) const;
+				std::string const& Input(Symbol symbol) const;
+				/*!
+					Returns the number of recorded definitions
+				*/
+				size_t Size(void) const;
+				/*!
+					Forgets every definition
+				*/
+				void Clear(void);
+			};
+		}
+	}
+}
@@ -0,0 +1,68 @@
+/*
+	Dispatch.hh - Binary operator dispatch on the types of both operands
+*/
+#pragma once
+
+#include <cstddef>
+
+#include "core/IMtObject.hh"
+#include "core/lang/Builtins.hh"
+#include "core/lang/Value.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \namespace Mt::core::lang::Dispatch
+				\brief What each binary operator does for each pair of operand types
+
+				The table is indexed by the operator and the Mt::core::TYPE of both operands, so picking
+				the implementation is one load whatever the types are. It is laid out by the compiler,
+				nothing fills it in at startup. Pairs of different types get a handler that promotes one
+				side first:
+
+				 - Integers and rationals mixed with a float are rounded to the float's tier
+				 - Reals mixed with a complex number become complex numbers in their tier
+				 - Reals mixed with a dual number become constants
+				 - Reals mixed with a list or matrix are applied to every element
+
+				Empty slots are type errors. Modules fill in pairs of their own with Register.
+			*/
+			namespace Dispatch {
+				enum OPERATOR {
+					ADD = 0,
+					SUBTRACT = 1,
+					MULTIPLY = 2,
+					DIVIDE = 3,
+					OPERATORS = 4,
+				};
+
+				// One past the highest Mt::core::TYPE
+				const size_t TYPES = TYPE::DUAL + 1;
+
+				/*!
+					Returns lhs op rhs, prints what went wrong and returns a NONE value if it can not be
+					done. Objects the result needs go into the context's pool.
+				*/
+				typedef Value (*handler_t)(Value const& lhs, Value const& rhs, CallContext& context);
+
+				extern handler_t table[OPERATORS][TYPES][TYPES];
+
+				/*!
+					Returns the handler for the operand types, nullptr if they do not combine
+				*/
+				inline handler_t Find(OPERATOR op, TYPE lhs, TYPE rhs) {
+					return table[op][lhs][rhs];
+				}
+				/*!
+					Sets the handler for a pair of operand types, replacing the built in one if there is
+					one. Not thread safe, register before anything is evaluated.
+				*/
+				void Register(OPERATOR op, TYPE lhs, TYPE rhs, handler_t handler);
+				/*!
+					Returns the name of the operation for messages, "addition", ...
+				*/
+				const char* Name(OPERATOR op);
+			}
+		}
+	}
+}
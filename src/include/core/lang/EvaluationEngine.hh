@@ -5,11 +5,23 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <typeinfo>
+#include <unordered_map>
+#include <vector>
 	
 #include "core/IMtObject.hh"
 #include "ASTObjs.hh"
+#include "Builtins.hh"
+#include "Dependencies.hh"
+#include "Dispatch.hh"
+#include "Function.hh"
+#include "Memo.hh"
+#include "Native.hh"
+#include "Symbols.hh"
+#include "Value.hh"
+#include "core/Precision.hh"
 #include "Parser.hh"
 
 namespace Mt {
@@ -17,21 +29,188 @@ namespace Mt {
 		namespace lang {
 			/*! \class EvaluationEngine
 				\brief Mechanics for Resolving and evaluating the AST
+
+				SML function bodies run against a table of their own locals (the parameters and anything
+				assigned in the body), names that are not local resolve to the global symbol table.
 			*/
-			class EvaluationEngine {
+			class EvaluationEngine : public FunctionCaller {
 			private:
 				bool debug_evaluation;
+				// Precision tier new numbers in this session are evaluated in
+				PRECISION precision;
+				// Objects created while evaluating the current top level statement, function calls release what they created when they return
+				ObjectPool temporaries;
+				// Copies of objects that symbols in the GST reference, indexed by symbol
+				std::vector<std::unique_ptr<Mt::core::IMtObject>> persistent;
+				// Nesting depth of Evaluate, temporaries are released when the outermost call returns
+				int evaluation_depth;
+				// Nesting depth of SML function calls, nothing is persisted while it is nonzero
+				size_t call_depth;
+				// Bound on call_depth from max_scope_depth, SML has no conditionals yet so any recursion is runaway recursion
+				size_t max_depth;
+				// A local of the outermost CallFunction on this engine, nested calls are measured from it
+				char const* stack_base;
+				// Global symbol table of the statement being evaluated
+				SymbolTable* globals;
+				// Runs compiled function bodies on the bytecode machine, every call walks the AST otherwise
+				bool bytecode;
+				/*
+					A call to a compiled function that has not returned yet
+				*/
+				struct Frame {
+					Bytecode::Program const* program;
+					// Where the frame continues, the call it waits on while it is not the innermost one
+					Bytecode::Instruction const* ip;
+					// First register of the frame
+					size_t base;
+					// Temporaries created after this belong to the call
+					ObjectPool::Mark mark;
+					// The bodies the frame has run start at tails[chain], more than one after tail calls
+					size_t chain;
+					// Cache the result goes into when the frame returns, its arguments start at keys[key]
+					Memo* memo;
+					size_t key;
+				};
+				// Result caches of the functions that have been memoized, by declaration
+				std::unordered_map<NFunctionDeclaration const*, Memo> memos;
+				// Memoize every pure function, unless it is switched off by name
+				bool memoize;
+				// Functions switched on or off by name, whatever memoize says
+				std::unordered_map<Symbol, bool> memoized;
+				// Results each cache keeps
+				size_t memo_size;
+				// True if any function can be memoized, calls do not look for a cache otherwise
+				bool memoizing;
+				/*
+					Calls to a function so far and its native kernels by signature, those that could not
+					be built have no entry
+				*/
+				struct Profile {
+					unsigned long long calls;
+					std::vector<std::pair<uint64_t, Native::Kernel>> kernels;
+				};
+				// Compiles functions to native code once they have been called native_threshold times
+				bool native;
+				unsigned long long native_threshold;
+				std::unordered_map<NFunctionDeclaration const*, Profile> profiles;
+				// Shared with the forks, so a kernel is built once however many threads want it
+				std::shared_ptr<Native::Compiler> compiler;
+				// Top level definitions and the globals they read, recorded unless reactive is OFF
+				DependencyGraph dependencies;
+				DependencyGraph::MODE reactive;
+				// Globals bound by the top level statement being evaluated
+				std::vector<Symbol> changed;
+				// Evaluates top level statements that do not wait for each other side by side
+				bool parallel;
+				// Call stack of the bytecode machine, innermost last
+				std::vector<Frame> calls;
+				// Arguments of the memoized frames, the body may overwrite its own registers
+				std::vector<Value> keys;
+				/*
+					Bodies run by each frame. A tail call does not nest, so the depth can not catch a
+					body tail calling back into itself, this can.
+				*/
+				std::vector<Bytecode::Program const*> tails;
+				// Register frames of the calls, innermost last, and their total size
+				std::vector<Value> registers;
+				size_t frames;
+				// Reused between results so printing does not allocate once it has grown
+				std::string output;
 				std::string GetNameFromMagik(MAGIK m);
 				std::string GetTokenName(yy::SMLParser::token_type t);
-				Mt::core::IMtObject* ProcessExpression(NExpression* expr, std::map<std::string, Mt::core::IMtObject>& GST);
-				Mt::core::IMtObject* DoBinaryOperation(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs, yy::SMLParser::token_type oper, std::map<std::string, Mt::core::IMtObject>& GST);
-				
-				Mt::core::IMtObject* BinaryAdd(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs);
-				Mt::core::IMtObject* BinaryMinus(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs);		
-				Mt::core::IMtObject* BinaryMultiply(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs);
-				Mt::core::IMtObject* BinaryDivied(Mt::core::IMtObject* lhs, Mt::core::IMtObject* rhs);
+				/*
+					Worker engine for Fork, shares the parent's settings and global symbol table
+				*/
+				explicit EvaluationEngine(EvaluationEngine const* parent);
+				Value ProcessExpression(NExpression* expr, SymbolTable& GST);
+				/*
+					Returns the value bound to the symbol in the given scope or the globals, nullptr if there is none
+				*/
+				Value const* Lookup(Symbol symbol, SymbolTable& GST);
+				/*
+					Binds the symbol in the given scope, values bound outside of a function call are persisted
+				*/
+				void Bind(Symbol symbol, Value const& val, SymbolTable& GST);
+				/*
+					Binds the declared function to its name in the given scope
+				*/
+				void DefineFunction(NFunctionDeclaration const& decl, SymbolTable& GST);
+				/*
+					Calls the function, from its cache if it is memoized and the call is in there
+				*/
+				Value CallFunction(Function const& fn, Value const* args, size_t count);
+				/*
+					Runs the function's body with the arguments bound to its parameters, the result is
+					the value of the last statement
+				*/
+				Value Invoke(Function const& fn, Value const* args, size_t count);
+				/*
+					Returns the cache for the function, nullptr if it is not memoized or is not pure
+				*/
+				Memo* MemoFor(Function const& fn);
+				/*
+					Counts the call and runs the function's native kernel for the arguments if it has one,
+					building it if the function just got hot. False if the call has to be interpreted.
+				*/
+				bool CallNative(Function const& fn, Value const* args, size_t count, Value& result);
+				/*
+					Records the definition the top level statement made, forgets those of the other globals
+					it bound and then evaluates again, or lists, everything that depends on them
+				*/
+				void Propagate(NVariableDeclaration* definition, SymbolTable& GST, std::string const& input);
+				/*
+					Evaluates one top level statement, binding and printing its result
+				*/
+				void Statement(NStatement* statement, SymbolTable& GST, std::string const& rawInput);
+				/*
+					Evaluates the statements Schedule::Plan planned from first on, each level side by side
+					on forks of the engine. Results are bound and printed in program order, what a statement
+					prints while it is evaluated is held until the statements before it have printed.
+				*/
+				void EvaluatePlanned(std::vector<NStatement*> const& statements, size_t first, std::vector<size_t> const& levels, SymbolTable& GST, std::string const& rawInput);
+				/*
+					Drops every cached result, called whenever a global is bound since bodies read them
+				*/
+				void GlobalsChanged(void);
+				/*
+					Releases the temporaries back to the mark a call started at, a result that references
+					one of them is moved to a copy that stays
+				*/
+				Value Unwind(ObjectPool::Mark const& mark, Value const& result);
+				/*
+					Releases the temporaries back to the mark, the values that reference one of them are
+					moved to copies that stay. At most Builtins::MAX_ARITY values.
+				*/
+				void Carry(ObjectPool::Mark const& mark, Value* values, size_t count);
+				/*
+					Pushes a frame for a compiled function onto the call stack with its arguments in the
+					first registers, its result is stored in memo when it returns unless that is nullptr
+				*/
+				void PushFrame(Function const& fn, Value const* args, size_t count, Memo* memo = nullptr);
+				/*
+					Runs a compiled function on the bytecode machine, prints what went wrong and returns a
+					NONE value if an instruction fails. The compiled functions it calls run in the same
+					loop, only builtins calling back into SML nest another Execute.
+				*/
+				Value Execute(Function const& fn, Value const* args, size_t count);
+				Value DoBinaryOperation(Value const& lhs, Value const& rhs, yy::SMLParser::token_type oper, SymbolTable& GST);
+				/*
+					Returns the value to store for the given symbol, anything that references a temporary
+					object is copied so it outlives the statement
+				*/
+				Value Persist(Symbol symbol, Value const& val);
+
+				/*
+					Runs the operator's handler for the operand types from Mt::core::lang::Dispatch, prints
+					an error and returns a NONE value if there is none
+				*/
+				Value Binary(Dispatch::OPERATOR op, Value const& lhs, Value const& rhs);
+				Value BinaryPower(Value const& lhs, Value const& rhs);
 
-				void PrintResult(Mt::core::IMtObject* res, std::string input);
+				/*
+					Formats the whole result into the output buffer and writes it in one go
+				*/
+				void PrintResult(Value const& res, std::string const& input);
 			public:
 				/*!
 					Create a new instance of the Evaluation Engine with defaults
@@ -42,13 +221,91 @@ namespace Mt {
 					Toggles the debug trace flag
 				*/
 				void ToggleDebug(void);
+				/*!
+					Sets the precision tier literals are evaluated in for this session, values that already
+					exist keep their tier and are promoted when mixed with wider ones
+				*/
+				void SetPrecision(PRECISION p);
+				/*!
+					Returns the current session precision tier
+				*/
+				PRECISION GetPrecision(void);
+				/*!
+					Picks between the bytecode machine and the tree walker for function calls
+				*/
+				void SetBytecode(bool enabled);
+				/*!
+					Returns true if function calls run on the bytecode machine
+				*/
+				bool GetBytecode(void);
+				/*!
+					Turns memoization of every pure function on or off, functions switched on or off by
+					name keep their setting
+				*/
+				void SetMemoize(bool enabled);
+				/*!
+					Turns memoization of the named function on or off whatever the global setting is,
+					functions that are not pure are never memoized
+				*/
+				void SetMemoize(std::string const& function, bool enabled);
+				/*!
+					Sets how many results each function's cache keeps
+				*/
+				void SetMemoSize(size_t size);
+				/*!
+					Drops every cached result, the statistics are kept
+				*/
+				void ClearMemos(void);
+				/*!
+					Prints the memoization settings and each cache's hit rate
+				*/
+				void PrintMemoStatistics(void);
+				/*!
+					Turns compiling hot functions to native code on or off, kernels already built are kept
+				*/
+				void SetNative(bool enabled);
+				/*!
+					Prints the native compilation settings and each profiled function's kernels
+				*/
+				void PrintNativeStatistics(void);
+				/*!
+					Sets what happens to the definitions that read a global when it changes, switching it
+					OFF forgets every definition recorded so far
+				*/
+				void SetReactive(DependencyGraph::MODE mode);
+				/*!
+					Prints the reactive mode and the number of recorded definitions
+				*/
+				void PrintReactive(void);
+				/*!
+					Lists the definitions changing the named global would evaluate again, in order,
+					without changing anything
+				*/
+				void PrintDependents(std::string const& name);
+				/*!
+					Turns evaluating independent statements of a block side by side on or off, it stays off
+					while reactive is on since recomputed dependents would race the statements after them
+				*/
+				void SetParallel(bool enabled);
+				/*!
+					Returns true if independent statements of a block are evaluated side by side
+				*/
+				bool GetParallel(void);
 				/*!
 					Evaluates the given AST and places the results in the GST
 					\param[in] blk A pointer to the current AST block
 					\param[in] GST A reference to the global symbol table
 					\param[in] rawInput the raw unparsed expression
 				*/
-				void Evaluate(Mt::core::lang::NBlock* blk, std::map<std::string, Mt::core::IMtObject>& GST, std::string rawInput = "<<NONE>>");
+				void Evaluate(Mt::core::lang::NBlock* blk, SymbolTable& GST, std::string rawInput = "<<NONE>>");
+				/*!
+					Evaluates an expression of literals alone in the given tier, the session tier is left
+					as it was. Used by Mt::core::lang::Optimizer to fold constants.
+				*/
+				Value EvaluateConstant(NExpression* expr, PRECISION tier);
+
+				Value Call(Value const& function, Value const* args, size_t count) override;
+				std::unique_ptr<FunctionCaller> Fork(void) override;
 			};
 		}
 	}
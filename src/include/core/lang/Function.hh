@@ -0,0 +1,62 @@
+/*
+	Function.hh - SML function values
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "core/IMtObject.hh"
+#include "core/lang/ASTObjs.hh"
+#include "core/lang/Bytecode.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \class Function
+				\brief A user defined SML function
+
+				Defining `F := (x, y) { ... }` binds F to one of these, so functions are values like any
+				other and can be passed to builtins that call back into SML. The function refers to its
+				declaration in the AST, which lives for the rest of the session.
+
+				The body is compiled to bytecode when the function is defined, copies share the program
+				and never change it, so threads calling the same function need no locking.
+			*/
+			class Function : public Mt::core::IMtObject {
+			public:
+				NFunctionDeclaration const& declaration;
+				// nullptr if the body has to run on the tree walker
+				std::shared_ptr<const Bytecode::Program> program;
+
+				Function(NFunctionDeclaration const& decl) : declaration(decl), program(Bytecode::Compile(decl)) {
+					this->DerivedType = TYPE::FUNCTION;
+				}
+
+				std::string const& GetName(void) const {
+					return this->declaration._id._name;
+				}
+
+				size_t GetArity(void) const {
+					return this->declaration._arguments.size();
+				}
+
+				/*!
+					Appends the function's signature, I.E <F(x, y)>
+				*/
+				void Format(std::string& out) const {
+					out += '<';
+					out += this->GetName();
+					out += '(';
+					for(size_t i = 0; i < this->GetArity(); i++) {
+						if(i != 0)
+							out += ", ";
+						out += this->declaration._arguments[i]->_id._name;
+					}
+					out += ")>";
+				}
+			};
+		}
+	}
+}
@@ -0,0 +1,89 @@
+/*
+	Memo.hh - Result cache for pure SML functions
+*/
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "core/lang/ASTObjs.hh"
+#include "core/lang/Symbols.hh"
+#include "core/lang/Value.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \class Memo
+				\brief Least recently used cache of one function's results, keyed by its arguments
+
+				Only calls whose arguments and result are all inline numbers are cached, a call with a
+				list, a dual number or a boxed integer in it just runs. Arguments are compared bit for
+				bit in their own tier, so 1, 1.0 and 1.0 in another tier are different keys as they can
+				give different results.
+
+				Function bodies never write to the global symbol table but they do read it, so the
+				owner has to Clear every cache when a global is rebound.
+			*/
+			class Memo {
+			public:
+				/*!
+					Whether the function can be cached, worked out on its first call after a Clear
+				*/
+				enum PURITY {
+					UNKNOWN = 0,
+					PURE = 1,
+					IMPURE = 2,
+				};
+			private:
+				struct Entry {
+					std::string key;
+					Value result;
+				};
+				size_t capacity;
+				// Most recently used first
+				std::list<Entry> entries;
+				std::unordered_map<std::string, std::list<Entry>::iterator> index;
+				// Reused by every lookup so a hit does not allocate
+				std::string key;
+				unsigned long long hits;
+				unsigned long long misses;
+				// Calls with arguments that can not be keys
+				unsigned long long skipped;
+			public:
+				PURITY purity;
+
+				explicit Memo(size_t cap);
+				/*!
+					Sets result and returns true if the call is cached
+				*/
+				bool Find(Value const* args, size_t count, Value& result);
+				/*!
+					Caches the result of a call, dropping the least recently used one if the cache is full
+				*/
+				void Store(Value const* args, size_t count, Value const& result);
+				/*!
+					Drops every cached result and the purity, the statistics are kept
+				*/
+				void Clear(void);
+				/*!
+					Changes how many results are kept, dropping the least recently used ones if needed
+				*/
+				void SetCapacity(size_t cap);
+				size_t GetCapacity(void) const;
+				size_t Size(void) const;
+				unsigned long long GetHits(void) const;
+				unsigned long long GetMisses(void) const;
+				unsigned long long GetSkipped(void) const;
+
+				/*!
+					Returns true if a call to the function can be replaced by its cached result: every
+					builtin it calls is pure, so is every global function it references, and it does not
+					define functions of its own. Recursion is fine.
+				*/
+				static bool Pure(NFunctionDeclaration const& decl, SymbolTable const& globals);
+			};
+		}
+	}
+}
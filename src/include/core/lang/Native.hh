@@ -0,0 +1,135 @@
+/*
+	Native.hh - Compiles hot SML functions to native code through the host compiler
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/Precision.hh"
+#include "core/lang/Bytecode.hh"
+#include "core/lang/Value.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \namespace Mt::core::lang::Native
+				\brief The tier above the bytecode machine
+
+				A compiled function body that gets called often enough is translated to C++, built into
+				a shared object by the host compiler and loaded through Mt::core::ModuleEngine. The
+				translation is specialized on the session tier and on which arguments are complex, so
+				every register has one float type and the generated code is plain arithmetic.
+
+				Only bodies that are a straight line of arithmetic on real and complex scalars are
+				translated: parameters, literals, the four operators and abs, sin, sqrt, pow and nrt.
+				Anything that reads a global or calls another SML function stays on the bytecode
+				machine, as does every call with an argument that is not a float in the session tier.
+				The generated code does exactly what the interpreter's kernels do in the same order, and
+				the builtins call back into Mt::core::CoreMath, so the results are the same bit for bit.
+
+				Shared objects are named by a hash of their source and kept in a directory, so a kernel
+				is only ever built once and later sessions load it straight away. Each one has a stamp
+				with the hash of its bytes next to it, one that does not match is built again, and
+				nothing is built or loaded in a directory that anyone but the user can write to.
+			*/
+			namespace Native {
+				/*!
+					Builtins the generated code calls back into, all in mtfloat_t
+				*/
+				struct Host {
+					long double (*sin)(long double);
+					long double (*sqrt)(long double);
+					long double (*pow)(long double, long double);
+					long double (*nrt)(long double, long double);
+				};
+
+				/*!
+					Entry point of a generated kernel. in holds the arguments in the kernel's tier, two
+					parts for each complex one, and the result is written to out.
+				*/
+				typedef void (*entry_t)(const void* in, void* out, Host const* host);
+
+				/*! \struct Kernel
+					\brief A loaded specialization of a function body
+				*/
+				struct Kernel {
+					entry_t entry;
+					PRECISION tier;
+					bool complex;
+
+					/*!
+						Runs the kernel on arguments that match the specialization it was built for
+					*/
+					Value Run(Value const* args, size_t count) const;
+				};
+
+				/*!
+					Returns the specialization signature of the arguments in the tier, false if one of them
+					is not a real or complex float in it or the tier has no native float type
+				*/
+				bool Signature(Value const* args, size_t count, PRECISION tier, uint64_t& signature);
+
+				/*!
+					Writes the C++ source of the specialization to source, false if the body uses anything
+					outside of the subset Mt::core::lang::Native translates
+				*/
+				bool Translate(Bytecode::Program const& program, std::string const& name, size_t arity, uint64_t signature, std::string& source, bool& complex);
+
+				/*! \class Compiler
+					\brief Builds and loads kernels, shared by an engine and its forks
+
+					Building a kernel runs the host compiler, which takes a while, so it only happens once
+					per source. Safe to call from several threads, the compiler runs without the lock held.
+				*/
+				class Compiler {
+				private:
+					std::mutex lock;
+					// Host compiler and the directory the shared objects are cached in
+					std::string command;
+					std::string directory;
+					// Set once the directory is known to be safe to build and load from
+					bool claimed;
+					// Kernels loaded in this session by source hash, nullptr for the ones that failed to build
+					std::unordered_map<uint64_t, entry_t> loaded;
+					// Kernels a thread is building, anyone else that wants one waits on ready
+					std::unordered_set<uint64_t> building;
+					std::condition_variable ready;
+					size_t built;
+					/*
+						Returns the path of the shared object for the source, built if there is no cached
+						one that matches its stamp, or an empty string if it can not be had
+					*/
+					std::string Build(uint64_t hash, std::string const& name, std::string const& source, bool& fresh);
+					/*
+						Makes the directory and checks nobody else can write to it or above it, on Windows
+						it moves to a new directory of its own instead. Called with the lock held.
+					*/
+					bool Claim(void);
+				public:
+					/*!
+						An empty dir caches the shared objects per user, in $XDG_CACHE_HOME/mt/native or
+						~/.cache/mt/native. On Windows nothing is reused between sessions, each one builds
+						into a new directory under dir.
+					*/
+					Compiler(std::string const& cxx, std::string const& dir);
+					/*!
+						Returns the kernel for the body and the signature, entry is nullptr if it can not be
+						translated or built
+					*/
+					Kernel Compile(Bytecode::Program const& program, std::string const& name, size_t arity, uint64_t signature);
+					/*!
+						Returns the number of kernels loaded and how many of those had to be built
+					*/
+					size_t GetLoaded(void);
+					size_t GetBuilt(void);
+				};
+			}
+		}
+	}
+}
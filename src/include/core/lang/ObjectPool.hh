@@ -0,0 +1,97 @@
+/*
+	ObjectPool.hh - Arena for the objects the evaluator creates while it works
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "core/IMtObject.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \class ObjectPool
+				\brief Bump allocated arena for evaluation temporaries
+
+				Objects are constructed in place in large chunks and destroyed together, either all of
+				them when the statement is done or everything allocated since a mark when a function
+				call returns. The chunks are kept for the next statement, so once a session has seen
+				its largest statement it stops asking the allocator for memory altogether.
+
+				Anything that has to outlive the pool (symbols bound in the GST) is copied out with
+				Mt::core::lang::Value::CloneObject.
+			*/
+			class ObjectPool {
+			public:
+				/*! \struct Mark
+					\brief A point to release the pool back to
+				*/
+				struct Mark {
+					size_t objects;
+					size_t chunk;
+					size_t used;
+				};
+
+				ObjectPool(void);
+				~ObjectPool(void);
+				ObjectPool(ObjectPool const&) = delete;
+				ObjectPool& operator=(ObjectPool const&) = delete;
+
+				/*!
+					Constructs a T in the arena, it lives until the pool is released past it
+				*/
+				template <class T, class... Args>
+				T* Make(Args&&... args) {
+					T* object = new(this->Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+					this->entries.push_back(Entry{ object, false });
+					return object;
+				}
+				/*!
+					Takes ownership of a heap allocated object, it is deleted when the pool is released
+					past it
+				*/
+				Mt::core::IMtObject* Adopt(Mt::core::IMtObject* object);
+
+				Mark GetMark(void) const;
+				/*!
+					Destroys everything allocated since the mark, newest first
+				*/
+				void Release(Mark const& mark);
+				/*!
+					Destroys everything, the chunks are kept
+				*/
+				void Clear(void);
+				/*!
+					Returns true if the object was allocated after the mark
+				*/
+				bool Since(Mark const& mark, Mt::core::IMtObject const* object) const;
+				/*!
+					Returns the number of live objects
+				*/
+				size_t Size(void) const;
+			private:
+				struct Entry {
+					Mt::core::IMtObject* object;
+					// Heap allocated and adopted, deleted instead of just destroyed
+					bool adopted;
+				};
+				struct Chunk {
+					std::unique_ptr<char[]> data;
+					size_t size;
+				};
+
+				std::vector<Entry> entries;
+				std::vector<Chunk> chunks;
+				// Chunk being allocated from and the bytes of it in use
+				size_t chunk;
+				size_t used;
+
+				void* Allocate(size_t size);
+			};
+		}
+	}
+}
@@ -0,0 +1,67 @@
+/*
+	Optimizer.hh - Constant folding and simplification of the SML AST
+*/
+#pragma once
+
+#include <cstddef>
+
+#include "core/lang/ASTObjs.hh"
+#include "core/lang/EvaluationEngine.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*! \class Optimizer
+				\brief Rewrites a freshly parsed AST before it is evaluated
+
+				Runs between Mt::core::lang::SMLDriver and Mt::core::lang::EvaluationEngine, function
+				bodies included, so the bytecode compiled for them never sees the work that was done
+				here.
+
+				 - Operators on literals are folded into one literal. The literal is evaluated in every
+				   precision tier, so a later change of the session tier still gets the value the
+				   evaluator would have computed in it. Anything that would print an error or has no literal form (division by an exact
+				   zero, rational results, ...) is left for the evaluator.
+				 - x + 0, 0 + x, x - 0, x * 1, 1 * x, x / 1 and x ^ 1 become x, for exact 0 and 1 only
+				   since a float would change the type of an exact x. The operation is gone, so is the
+				   type mismatch it would have reported for an x that does not mix with integers.
+				 - What is left of a ^ b becomes a call to pow, which raises floats to small integer
+				   powers by squaring and compiles to a single bytecode instruction.
+			*/
+			class Optimizer {
+			private:
+				EvaluationEngine& engine;
+				bool enabled;
+				// Nodes eliminated over the whole session
+				size_t eliminated;
+
+				void Block(NBlock* block);
+				/*
+					Returns what replaces expr, expr itself if nothing does
+				*/
+				NExpression* Expression(NExpression* expr);
+				/*
+					Returns the folded literal, nullptr if the operator has to be left to the evaluator
+				*/
+				NExpression* Fold(NBinaryOperator* nbin);
+			public:
+				/*!
+					Folds constants with the engine's arithmetic, on unless optimize_sml is "no"
+				*/
+				explicit Optimizer(EvaluationEngine& engine);
+				/*!
+					Rewrites the block in place, what is replaced is deleted
+					\return the number of nodes eliminated
+				*/
+				size_t Run(NBlock* block);
+
+				void SetEnabled(bool enable);
+				bool GetEnabled(void) const;
+				/*!
+					Returns the number of nodes eliminated since the optimizer was created
+				*/
+				size_t GetEliminated(void) const;
+			};
+		}
+	}
+}
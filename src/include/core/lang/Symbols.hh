@@ -0,0 +1,86 @@
+/*
+	Symbols.hh - Interned identifiers and the symbol tables indexed by them
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/lang/Value.hh"
+
+namespace Mt {
+	namespace core {
+		namespace lang {
+			/*!
+				An interned identifier, the same name always gets the same symbol
+			*/
+			typedef uint32_t Symbol;
+
+			/*! \namespace Mt::core::lang::Symbols
+				\brief The session wide identifier intern table
+
+				Every identifier is interned when the parser builds its Mt::core::lang::NIdentifier, from
+				then on names are compared and looked up by symbol. Symbols are handed out densely from
+				zero, so they double as slot indices into a Mt::core::lang::SymbolTable.
+
+				Interning is not thread safe, it only happens while parsing and compiling on the main
+				thread. Reading names back is.
+			*/
+			namespace Symbols {
+				/*!
+					Returns the symbol for name, interning it if it is new
+				*/
+				Symbol Intern(std::string const& name);
+				/*!
+					Returns the name a symbol was interned from
+				*/
+				std::string const& Name(Symbol symbol);
+			}
+
+			/*! \class SymbolTable
+				\brief Values bound to symbols, one flat slot per symbol
+
+				A lookup is a bounds check and an index, unbound slots hold a NONE value. The slots only
+				grow as far as the highest symbol bound in the table, so a table of a few locals stays
+				small.
+			*/
+			class SymbolTable {
+			private:
+				std::vector<Value> slots;
+				// Slots that are not NONE
+				size_t bound;
+			public:
+				SymbolTable(void) : bound(0) { }
+
+				/*!
+					Returns the value bound to the symbol, nullptr if there is none
+				*/
+				Value const* Find(Symbol symbol) const {
+					return (symbol < this->slots.size() && !this->slots[symbol].IsNone()) ? &this->slots[symbol] : nullptr;
+				}
+				/*!
+					Binds the symbol, replacing what it was bound to. Binding a NONE value unbinds it.
+				*/
+				void Bind(Symbol symbol, Value const& value);
+				/*!
+					Returns the number of bound symbols
+				*/
+				size_t Size(void) const {
+					return this->bound;
+				}
+				/*!
+					Calls f(symbol, value) for every bound symbol in symbol order
+				*/
+				template <class F>
+				void ForEach(F f) const {
+					for(size_t i = 0; i < this->slots.size(); i++) {
+						if(!this->slots[i].IsNone())
+							f(static_cast<Symbol>(i), this->slots[i]);
+					}
+				}
+			};
+		}
+	}
+}
@@ -0,0 +1,231 @@
+/*
+	Value.hh - Compact value representation used by the evaluation engine
+*/
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/IMtObject.hh"
+#include "core/Types.hh"
+#include "core/Precision.hh"
+#include "core/lang/ObjectPool.hh"
+
+namespace Mt {
+	namespace objects {
+		class Integer;
+		class Rational;
+	}
+	namespace core {
+		namespace lang {
+			/*! \struct Value
+				\brief Evaluator value
+
+				This is what the Mt::core::lang::EvaluationEngine passes around while it walks the AST.
+				Scalars and complex numbers are held inline, so intermediate results never touch the heap
+				and are never boxed, anything bigger (lists, matrices, ...) is referenced by a handle to
+				the Mt::core::IMtObject that owns the data.
+
+				The tag is the same Mt::core::TYPE that the boxed objects carry, so checking what a value
+				holds is a plain integer compare instead of a dynamic_cast.
+
+				Inline numbers also carry the Mt::core::PRECISION tier they were computed in, the payload
+				is stored in the matching float type. Part 0 is the scalar or real part, part 1 the
+				imaginary part of a complex number.
+
+				Exact integers and rationals are held inline as int64_t (numerator and denominator) while
+				they fit, once they overflow the value is flagged big and references a boxed
+				Mt::objects::Integer or Mt::objects::Rational instead.
+			*/
+			struct Value {
+				TYPE type;
+				PRECISION precision;
+				// Exact number that did not fit inline and is referenced through object
+				bool big;
+				union {
+					double d[2];
+					long double e[2];
+					mtquad_t q[2];
+					int64_t i[2];
+					Mt::core::IMtObject* object;
+				};
+
+				Value(void) : type(TYPE::NONE), precision(PRECISION::EXTENDED), big(false), object(nullptr) { }
+
+				/*!
+					Returns a pointer to the payload parts for the float type F
+				*/
+				template <class F>
+				F* Parts(void);
+				/*!
+					Returns the given part converted to the float type F
+				*/
+				template <class F>
+				F Get(int part = 0) const {
+					switch(this->precision) {
+						case PRECISION::DOUBLE:
+							return static_cast<F>(this->d[part]);
+						case PRECISION::EXTENDED:
+							return static_cast<F>(this->e[part]);
+						default:
+							return static_cast<F>(this->q[part]);
+					}
+				}
+
+				/*!
+					Returns a value holding the given scalar in the tier matching F
+				*/
+				template <class F>
+				static Value MakeScalar(F s) {
+					Value v;
+					v.type = TYPE::SCALAR;
+					v.precision = PrecisionOf<F>::value;
+					v.Parts<F>()[0] = s;
+					return v;
+				}
+				/*!
+					Returns a value holding the complex number re + im*i in the tier matching F
+				*/
+				template <class F>
+				static Value MakeComplex(F re, F im) {
+					Value v;
+					v.type = TYPE::COMPLEX;
+					v.precision = PrecisionOf<F>::value;
+					v.Parts<F>()[0] = re;
+					v.Parts<F>()[1] = im;
+					return v;
+				}
+				/*!
+					Returns a scalar value from a build wide mtfloat_t, rounded to the given tier
+				*/
+				static Value MakeScalar(mtfloat_t s, PRECISION p);
+				/*!
+					Returns a complex value from build wide mtfloat_t parts, rounded to the given tier
+				*/
+				static Value MakeComplex(mtfloat_t re, mtfloat_t im, PRECISION p);
+				/*!
+					Returns a value referencing the given object, the value does not take ownership
+				*/
+				static Value MakeObject(Mt::core::IMtObject* obj) {
+					Value v;
+					if(obj != nullptr) {
+						v.type = obj->DerivedType;
+						v.big = (v.type == TYPE::INTEGER || v.type == TYPE::RATIONAL);
+						v.object = obj;
+					}
+					return v;
+				}
+				/*!
+					Returns an inline exact integer
+				*/
+				static Value MakeInteger(int64_t n) {
+					Value v;
+					v.type = TYPE::INTEGER;
+					v.i[0] = n;
+					v.i[1] = 1;
+					return v;
+				}
+				/*!
+					Returns an exact value for the integer, inline if it fits otherwise boxed into the pool
+				*/
+				static Value FromInteger(Mt::objects::Integer const& n, ObjectPool& pool);
+				/*!
+					Returns an exact value for the rational, integral rationals become integers, inline
+					if it fits otherwise boxed into the pool
+				*/
+				static Value FromRational(Mt::objects::Rational const& r, ObjectPool& pool);
+				/*!
+					Returns the exact integer held by the value
+				*/
+				Mt::objects::Integer ToInteger(void) const;
+				/*!
+					Returns the exact value as a rational, integers get a denominator of 1
+				*/
+				Mt::objects::Rational ToRational(void) const;
+				/*!
+					Returns an exact value rounded to a scalar in the given tier
+				*/
+				Value ToScalar(PRECISION p) const;
+				/*!
+					Returns a new copy of the referenced object, nullptr if the value is not a handle
+				*/
+				Mt::core::IMtObject* CloneObject(void) const;
+				/*!
+					Unboxes an object, scalars and complex numbers are copied inline, everything else is
+					referenced by handle
+				*/
+				static Value Unbox(Mt::core::IMtObject* obj);
+
+				/*!
+					Returns the same number converted to the given tier, handles are returned as is
+				*/
+				Value ToPrecision(PRECISION p) const;
+
+				/*!
+					Returns true if the value is an exact integer or rational
+				*/
+				bool IsExact(void) const {
+					return this->type == TYPE::INTEGER || this->type == TYPE::RATIONAL;
+				}
+				/*!
+					Returns true if the value is a float scalar or complex number
+				*/
+				bool IsFloat(void) const {
+					return this->type == TYPE::SCALAR || this->type == TYPE::COMPLEX;
+				}
+				/*!
+					Returns true for an exact zero
+				*/
+				bool IsExactZero(void) const {
+					// Big values are never zero, zero always fits inline
+					return this->IsExact() && !this->big && this->i[0] == 0;
+				}
+
+				/*!
+					Returns true if the value does not hold anything, I.E the result of an error
+				*/
+				bool IsNone(void) const {
+					return this->type == TYPE::NONE;
+				}
+				/*!
+					Returns true if the value is stored inline
+				*/
+				bool IsInline(void) const {
+					return this->IsFloat() || (this->IsExact() && !this->big);
+				}
+				/*!
+					Boxes the value into a newly allocated Mt::core::IMtObject, for handles this just
+					returns the referenced object
+				*/
+				Mt::core::IMtObject* Box(void) const;
+
+				/*!
+					Appends the value's printed form to out
+				*/
+				void Format(std::string& out) const;
+
+				friend std::ostream& operator<<(std::ostream& os, const Value& val);
+			};
+
+			template <>
+			inline double* Value::Parts<double>(void) {
+				return this->d;
+			}
+
+			template <>
+			inline long double* Value::Parts<long double>(void) {
+				return this->e;
+			}
+
+#if defined(_MT_HAS_QUAD)
+			template <>
+			inline mtquad_t* Value::Parts<mtquad_t>(void) {
+				return this->q;
+			}
+#endif
+		}
+	}
+}
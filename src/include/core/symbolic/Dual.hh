@@ -0,0 +1,61 @@
+/*
+	Dual.hh - Dual numbers for forward mode automatic differentiation
+*/
+#pragma once
+
+#include <cstddef>
+
+#include "core/INumeric.hh"
+
+namespace Mt {
+	namespace core {
+		namespace symbolic {
+			/*! \class Dual
+				\brief A value together with its derivatives along several directions at once
+
+				Seeding the arguments of a function with the unit tangents and evaluating it on duals
+				gives the value and the whole gradient in one pass, every operation applies the chain
+				rule to all of the directions together.
+
+				The value is a long double like any other scalar. The tangents are a fixed width array
+				of doubles, derivatives need less precision than the value and doubles go through SSE
+				two at a time. Directions that are not in use stay zero and are carried along, so the
+				loops never depend on how many are live.
+			*/
+			class Dual : public Mt::core::INumeric {
+			public:
+				static const size_t MAX_DIRECTIONS = 16;
+
+				long double value;
+				double tangent[MAX_DIRECTIONS];
+
+				/*!
+					A constant, its derivative is zero in every direction
+				*/
+				explicit Dual(long double v = 0.0L);
+				/*!
+					An independent variable, its derivative along direction is one
+				*/
+				Dual(long double v, size_t direction);
+				Dual(Dual const& other);
+				~Dual(void);
+
+				Dual& operator=(Dual const& rhs);
+
+				/*!
+					Returns f(x) for this x given f(x) and f'(x), every tangent is scaled by f'(x)
+				*/
+				Dual Chain(long double f, long double df) const;
+				/*!
+					Returns true if no direction has a nonzero derivative
+				*/
+				bool IsConstant(void) const;
+			};
+
+			Dual operator+(Dual const& a, Dual const& b);
+			Dual operator-(Dual const& a, Dual const& b);
+			Dual operator*(Dual const& a, Dual const& b);
+			Dual operator/(Dual const& a, Dual const& b);
+		}
+	}
+}
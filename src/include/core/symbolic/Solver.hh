@@ -0,0 +1,89 @@
+/*
+	Solver.hh - Numeric root finding and minimization
+*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "core/BatchFunction.hh"
+
+namespace Mt {
+	namespace core {
+		namespace symbolic {
+			/*!
+				How a solver run ended
+			*/
+			enum STATUS {
+				// Within tolerance
+				CONVERGED = 0,
+				// Out of iterations or no more progress, the solution is the best point found
+				STALLED = 1,
+				// The function has the same sign at both ends of the bracket
+				NO_BRACKET = 2,
+				// The function failed to evaluate, the error is already printed
+				FAILED = 3,
+			};
+
+			/*! \struct SolverOptions
+				\brief Solver limits
+			*/
+			struct SolverOptions {
+				// Root finders stop once the root is pinned down to this, relative to its size
+				long double tolerance;
+				// Minimizers stop once the gradient is this small, relative to the function value
+				long double gradientTolerance;
+				size_t maxIterations;
+				// Worker threads for multi start and bracket searches, 0 picks one per hardware thread
+				unsigned threads;
+
+				SolverOptions(void);
+			};
+
+			/*! \struct Solution
+				\brief Where a solver ended up
+			*/
+			struct Solution {
+				std::vector<long double> x;
+				// Function value at x
+				long double value;
+				size_t iterations;
+				size_t evaluations;
+			};
+
+			/*!
+				Root of a function of one argument in [a, b] by Brent's method, f(a) and f(b) need
+				opposite signs
+			*/
+			STATUS Brent(BatchFunction& f, long double a, long double b, SolverOptions const& options, Solution& solution);
+			/*!
+				Root of a function of one argument by Newton's method from x0. The derivative comes
+				from a five point stencil evaluated in the same batch as the function value.
+			*/
+			STATUS Newton(BatchFunction& f, long double x0, SolverOptions const& options, Solution& solution);
+			/*!
+				Every root in [a, b] the function changes sign at. The interval is sampled at samples
+				points in one batch and every bracket found is refined with Brent's method, brackets
+				are spread across worker threads. Roots where the function only touches zero are missed.
+			*/
+			STATUS Roots(BatchFunction& f, long double a, long double b, size_t samples, SolverOptions const& options, std::vector<long double>& roots);
+
+			/*!
+				Local minimum by the Nelder-Mead simplex method from start, no derivatives needed. The
+				simplex is shrunk until the function values at its vertices agree to rounding.
+			*/
+			STATUS NelderMead(BatchFunction& f, const long double* start, size_t dimension, SolverOptions const& options, Solution& solution);
+			/*!
+				Local minimum by limited memory BFGS from start. Gradients are central differences,
+				all 2n points of one gradient go out in one batch, and so do the candidate steps of
+				the backtracking line search.
+			*/
+			STATUS LBFGS(BatchFunction& f, const long double* start, size_t dimension, SolverOptions const& options, Solution& solution);
+			/*!
+				Runs L-BFGS from count starting points (count rows of dimension values) spread across
+				worker threads, the solution is the lowest minimum found
+			*/
+			STATUS MultiStart(BatchFunction& f, const long double* starts, size_t count, size_t dimension, SolverOptions const& options, Solution& solution);
+		}
+	}
+}
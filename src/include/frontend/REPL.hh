@@ -7,10 +7,12 @@
 #include <iostream>
 #include <string>
 #include <map>
+#include <fstream>
 
 
 #include "core/IMtObject.hh"
 #include "core/lang/EvaluationEngine.hh"
+#include "core/lang/Optimizer.hh"
 #include "core/lang/SMLDriver.hh"
 #include "third_party/linenoise.hh"
 
@@ -29,13 +31,15 @@ namespace Mt {
 				// Stores internal and module functions
 				//std::map<std::string,std::function<Mt::core::IMtObject(Mt::core::IMtObject obj...)>> GlobalFunctionTable;
 				// Stores the current list of symbols for this session
-				std::map<std::string, Mt::core::IMtObject> GlobalSymbolTable;
+				Mt::core::lang::SymbolTable GlobalSymbolTable;
 				// AST Block that is passed to the parser to hold the results
 				Mt::core::lang::NBlock* ASTBlock;
 				// Parser and scanner driver
 				Mt::core::lang::SMLDriver* driver;
 				// AST Evaluation Engine
 				Mt::core::lang::EvaluationEngine eengine;
+				// Folds and simplifies what was parsed before the engine sees it
+				Mt::core::lang::Optimizer optimizer;
 				// Evaluation line number
 				unsigned int LineNum;
 #if !defined(_DUMMY_REPL)
@@ -47,11 +51,18 @@ namespace Mt {
 				bool running;
 
 				void ProcessCommand(std::string command);
+				// Runs one line of input, a command if it starts with a ! and SML otherwise
+				void ProcessLine(std::string input);
 			public:
 				REPL(void);
 				~REPL(void);
 
 				void Start(void);
+				/*!
+					Runs an SML file as if it were typed in, false if it can not be read. Lines starting
+					with a # are comments, a statement with an open { continues on the following lines.
+				*/
+				bool Run(std::string const& path);
 
 		};
 	}
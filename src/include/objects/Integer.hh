@@ -0,0 +1,94 @@
+/*
+	Integer.hh - Exact integer implementation
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <iostream>
+
+#include "core/INumeric.hh"
+#include "core/HPN.hh"
+
+namespace Mt {
+	namespace objects {
+		/*! \class Integer
+			\brief Mt Exact Integer
+
+			An integer of unbounded size. Values that fit an int64_t are kept in a machine word and
+			operated on with overflow checked machine arithmetic, only when a result overflows does
+			the integer move into a Mt::core::hpn::BigInt, and it moves back as soon as it fits again.
+		*/
+		class Integer : public Mt::core::INumeric {
+			private:
+				int64_t Small;
+				Mt::core::hpn::BigInt Big;
+				// True while the value is held in Small
+				bool Inline;
+
+				void Demote(void);
+			public:
+				// Constructors
+				Integer(void);
+				Integer(int64_t val);
+				Integer(Mt::core::hpn::BigInt const& val);
+				/*!
+					Parses a decimal integer, throws std::invalid_argument if the string is not one
+				*/
+				Integer(std::string const& val);
+				/*!
+					Parses the decimal integer in [first, last), throws std::invalid_argument if it is not one
+				*/
+				Integer(const char* first, const char* last);
+				Integer(Integer const& i);
+				Integer(Integer&& i);
+
+				~Integer(void);
+
+				// Misc functions
+				bool IsSmall(void) const;
+				int64_t GetSmall(void) const;
+				/*!
+					Returns the value as a Mt::core::hpn::BigInt regardless of how it is stored
+				*/
+				Mt::core::hpn::BigInt ToBig(void) const;
+				bool IsZero(void) const;
+				bool IsNegative(void) const;
+				bool IsOne(void) const;
+				/*!
+					Returns the value converted to the float type F
+				*/
+				template <class F>
+				F ToFloat(void) const {
+					return this->Inline ? static_cast<F>(this->Small) : this->Big.ToFloat<F>();
+				}
+				std::string ToString(void) const;
+				/*!
+					Greatest common divisor of the magnitudes
+				*/
+				static Integer Gcd(Integer const& a, Integer const& b);
+
+				// Operator overloads
+				Integer& operator=(Integer const& rhs);
+
+				// Basic Arithmetic operations
+				Integer operator+(Integer const& rhs) const;
+				Integer operator-(Integer const& rhs) const;
+				Integer operator*(Integer const& rhs) const;
+				// Truncating division and remainder
+				Integer operator/(Integer const& rhs) const;
+				Integer operator%(Integer const& rhs) const;
+				Integer operator-() const;
+
+				// Comparison operators
+				bool operator==(Integer const& rhs) const;
+				bool operator!=(Integer const& rhs) const;
+				bool operator>(Integer const& rhs) const;
+				bool operator<(Integer const& rhs) const;
+				bool operator>=(Integer const& rhs) const;
+				bool operator<=(Integer const& rhs) const;
+
+				// Stream overloads
+				friend std::ostream& operator<<(std::ostream& os, const Integer& i);
+		};
+	}
+}
@@ -5,7 +5,11 @@
 #pragma once
 
 #include "core/IMtObject.hh"
+#include "objects/Storage.hh"
+#include "core/NumberFormatter.hh"
 
+#include <algorithm>
+#include <string>
 #include <vector>
 #include <initializer_list>
 
@@ -14,25 +18,63 @@ namespace Mt {
 		/*! \class List
 			\brief A collection of unordered non-unique objects
 
+			Elements are kept in a contiguous array of Mt::objects::Storage<T>::type, so a
+			List<Scalar> is a plain array of mtfloat_t that kernels can walk directly.
 		*/
 		template <class T>
-		class List : Mt::core::IMtObject {
+		class List : public Mt::core::IMtObject {
+		public:
+			typedef typename Storage<T>::type element_type;
 		private:
-			std::vector<T> elements;
+			std::vector<element_type> elements;
 		public:
 			List(void);
-			List(std::initializer_list<T>);
-			void Add(T value);
+			List(std::initializer_list<T> values);
+			void Add(T const& value);
+			void Reserve(int size);
 			int GetSize() const;
 
-			T& operator[](int i);
+			/*!
+				Returns the boxed element at the given index
+			*/
+			T Get(int i) const;
+			/*!
+				Returns a pointer to the raw element storage
+			*/
+			element_type* Data(void);
+			const element_type* Data(void) const;
+
+			element_type& operator[](int i);
+			const element_type& operator[](int i) const;
 
-			friend std::ostream& operator<<(std::ostream& os, List<T>& list){
-				os << "\n[";
-				for(int i = 0; i < list.GetSize(); i++)
-					os << list[i] << ",\t";
-				os << "]\n";
-				return os;
+			/*!
+				Appends the printed list to out, every element padded to the widest one
+			*/
+			void Format(std::string& out) const {
+				// Format each element once into a scratch buffer to find the widest
+				std::string cells;
+				std::vector<size_t> ends(this->elements.size());
+				size_t width = 0;
+				for(size_t i = 0; i < this->elements.size(); i++) {
+					size_t start = cells.size();
+					Mt::core::NumberFormatter::Append(cells, this->elements[i]);
+					ends[i] = cells.size();
+					width = std::max(width, ends[i] - start);
+				}
+				Mt::core::NumberFormatter::ALIGNMENT alignment = Mt::core::NumberFormatter::GetStyle().alignment;
+				out += "\n[";
+				for(size_t i = 0; i < this->elements.size(); i++) {
+					size_t start = (i == 0) ? 0 : ends[i - 1];
+					Mt::core::NumberFormatter::AppendPadded(out, cells.data() + start, ends[i] - start, width, alignment);
+					out += ", ";
+				}
+				out += "]\n";
+			}
+
+			friend std::ostream& operator<<(std::ostream& os, const List<T>& list){
+				std::string text;
+				list.Format(text);
+				return os.write(text.data(), static_cast<std::streamsize>(text.size()));
 			}
 		};
 
@@ -42,13 +84,21 @@ namespace Mt {
 		}
 
 		template <class T>
-		List<T>::List(std::initializer_list<T>) {
+		List<T>::List(std::initializer_list<T> values) {
 			this->DerivedType = Mt::core::TYPE::LIST;
+			elements.reserve(values.size());
+			for(auto& value : values)
+				elements.push_back(Storage<T>::Unbox(value));
+		}
+
+		template <class T>
+		void List<T>::Add(T const& value) {
+			elements.push_back(Storage<T>::Unbox(value));
 		}
 
 		template <class T>
-		void List<T>::Add(T value) {
-			elements.push_back(value);
+		void List<T>::Reserve(int size) {
+			elements.reserve(size);
 		}
 
 		template <class T>
@@ -57,7 +107,27 @@ namespace Mt {
 		}
 
 		template <class T>
-		T& List<T>::operator[](int i) {
+		T List<T>::Get(int i) const {
+			return Storage<T>::Box(elements[i]);
+		}
+
+		template <class T>
+		typename List<T>::element_type* List<T>::Data(void) {
+			return elements.data();
+		}
+
+		template <class T>
+		const typename List<T>::element_type* List<T>::Data(void) const {
+			return elements.data();
+		}
+
+		template <class T>
+		typename List<T>::element_type& List<T>::operator[](int i) {
+			return elements[i];
+		}
+
+		template <class T>
+		const typename List<T>::element_type& List<T>::operator[](int i) const {
 			return elements[i];
 		}
 	}
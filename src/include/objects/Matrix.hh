@@ -4,50 +4,68 @@
 #pragma once
 
 #include "objects/List.hh"
+#include "objects/Storage.hh"
 
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace Mt {
 	namespace objects {
 		/*! \class Matrix
 			\brief Represents an M by N matrix
+
+			The elements are stored row major in one contiguous block of Mt::objects::Storage<T>::type,
+			for numeric matrices that is a flat mtfloat_t array with no per element boxing.
 		*/
 		template <class T>
-		class Matrix : Mt::core::IMtObject {
+		class Matrix : public Mt::core::IMtObject {
+			public:
+				typedef typename Storage<T>::type element_type;
 			private:
 				int m, n;
 				int RowColumnToIndex(int row, int column) const;
-				T* data;
+				element_type* data;
 			public:
 				Matrix(void);
-				Matrix(int n);
-				Matrix(int m, int n);
+				Matrix(int size);
+				Matrix(int rows, int columns);
+				Matrix(Matrix<T> const& mtx);
+				Matrix(Matrix<T>&& mtx);
 				~Matrix();
 
+				Matrix<T>& operator=(Matrix<T> rhs);
+
 				int GetRows() const;
 				int GetColumns() const;
 				List<T> GetRow(int index);
 				List<T> GetColumn(int index);
-				T& GetAtLocation(int row, int column) const;
+				element_type& GetAtLocation(int row, int column) const;
 				void SetAtLocation(int row, int column, T value);
 				void SetAll(T value);
-				
+				/*!
+					Returns a pointer to the raw row major element storage
+				*/
+				element_type* Data(void);
+				const element_type* Data(void) const;
+
 				Matrix<T> operator+(Matrix<T>& rhs);
 				Matrix<T> operator*(Matrix<T>& rhs);
 
+				/*!
+					Appends the printed matrix to out, elements padded so each column lines up
+				*/
+				void Format(std::string& out) const;
+
 				friend std::ostream& operator<<(std::ostream& os, const Matrix<T>& matrix){
-					os << "\n[\n";
-					for(int row = 0; row < matrix.GetRows(); row++) {
-						for(int column = 0; column < matrix.GetColumns(); column++)
-							os << matrix.GetAtLocation(row,column) << "\t";
-						os << "\n";
-					}
-					os << "]\n";
-					return os;
+					std::string text;
+					matrix.Format(text);
+					return os.write(text.data(), static_cast<std::streamsize>(text.size()));
 				}
 		};
-		
+
 		template<class T>
 		Matrix<T>::Matrix(void) {
 			m = 0;
@@ -55,94 +73,169 @@ namespace Mt {
 			data = nullptr;
 			this->DerivedType = Mt::core::TYPE::MATRIX;
 		}
-		
+
+		template<class T>
+		Matrix<T>::Matrix(int size) {
+			m = size;
+			n = size;
+			data = new element_type[n * n]();
+			this->DerivedType = Mt::core::TYPE::MATRIX;
+		}
+
+		template<class T>
+		Matrix<T>::Matrix(int rows, int columns) {
+			m = rows;
+			n = columns;
+			data = new element_type[n * m]();
+			this->DerivedType = Mt::core::TYPE::MATRIX;
+		}
+
 		template<class T>
-		Matrix<T>::Matrix(int n) {
-			m = n;
-			this->n = n;
-			data = new T[n * n];
+		Matrix<T>::Matrix(Matrix<T> const& mtx) : Mt::core::IMtObject() {
+			m = mtx.m;
+			n = mtx.n;
+			data = (mtx.data == nullptr) ? nullptr : new element_type[n * m];
+			if(data != nullptr)
+				std::copy(mtx.data, mtx.data + (n * m), data);
 			this->DerivedType = Mt::core::TYPE::MATRIX;
 		}
-		
+
 		template<class T>
-		Matrix<T>::Matrix(int m, int n) {
-			this->m = m;
-			this->n = n;
-			data = new T[n * m];
+		Matrix<T>::Matrix(Matrix<T>&& mtx) {
+			m = mtx.m;
+			n = mtx.n;
+			data = mtx.data;
+			mtx.data = nullptr;
+			mtx.m = mtx.n = 0;
 			this->DerivedType = Mt::core::TYPE::MATRIX;
 		}
-		
+
 		template<class T>
 		Matrix<T>::~Matrix() {
 			delete [] data;
 		}
-		
+
+		template<class T>
+		Matrix<T>& Matrix<T>::operator=(Matrix<T> rhs) {
+			std::swap(m, rhs.m);
+			std::swap(n, rhs.n);
+			std::swap(data, rhs.data);
+			return *this;
+		}
+
 		template<class T>
 		int Matrix<T>::GetRows() const{
-			return m; 
+			return m;
 		}
-		
+
 		template<class T>
 		int Matrix<T>::GetColumns() const{
-			return n; 
+			return n;
 		}
-		
+
 		template<class T>
 		List<T> Matrix<T>::GetRow(int index) {
 			List<T> returnList;
+			returnList.Reserve(n);
 			for (int i = 0; i < n; ++i)
-				returnList.Add(data[RowColumnToIndex(i, index)]);
+				returnList.Add(Storage<T>::Box(data[RowColumnToIndex(index, i)]));
 			return returnList;
 		}
-		
+
 		template<class T>
 		List<T> Matrix<T>::GetColumn(int index) {
 			List<T> returnList;
+			returnList.Reserve(m);
 			for (int i = 0; i < m; ++i)
-				returnList.Add(data[RowColumnToIndex(index, i)]);
+				returnList.Add(Storage<T>::Box(data[RowColumnToIndex(i, index)]));
 			return returnList;
 		}
 
 		template<class T>
-		T& Matrix<T>::GetAtLocation(int row, int column) const {
+		typename Matrix<T>::element_type& Matrix<T>::GetAtLocation(int row, int column) const {
 			return data[RowColumnToIndex(row,column)];
 		}
-		
+
 		template<class T>
 		void Matrix<T>::SetAtLocation(int row, int column, T value) {
-			data[RowColumnToIndex(row, column)] = value; 
+			data[RowColumnToIndex(row, column)] = Storage<T>::Unbox(value);
 		}
-		
+
+		template<class T>
+		void Matrix<T>::Format(std::string& out) const {
+			// Format each element once into a scratch buffer, then pad them out column by column
+			size_t columns = static_cast<size_t>(n);
+			std::string cells;
+			std::vector<size_t> ends(static_cast<size_t>(m) * columns);
+			std::vector<size_t> widths(columns, 0);
+			for(size_t i = 0; i < ends.size(); i++) {
+				size_t start = cells.size();
+				Mt::core::NumberFormatter::Append(cells, data[i]);
+				ends[i] = cells.size();
+				widths[i % columns] = std::max(widths[i % columns], ends[i] - start);
+			}
+			Mt::core::NumberFormatter::ALIGNMENT alignment = Mt::core::NumberFormatter::GetStyle().alignment;
+			out.reserve(out.size() + cells.size() + (ends.size() * 2) + 8);
+			out += "\n[\n";
+			for(size_t i = 0; i < ends.size(); i++) {
+				size_t start = (i == 0) ? 0 : ends[i - 1];
+				Mt::core::NumberFormatter::AppendPadded(out, cells.data() + start, ends[i] - start, widths[i % columns], alignment);
+				out += ((i % columns) + 1 == columns) ? "\n" : "  ";
+			}
+			out += "]\n";
+		}
+
 		template<class T>
 		void Matrix<T>::SetAll(T value) {
-			for(int row = 0; row < m; row++) for(int column = 0; column < n; column++)
-				GetAtLocation(row, column) = value;
+			std::fill(data, data + (m * n), Storage<T>::Unbox(value));
+		}
+
+		template<class T>
+		typename Matrix<T>::element_type* Matrix<T>::Data(void) {
+			return data;
+		}
+
+		template<class T>
+		const typename Matrix<T>::element_type* Matrix<T>::Data(void) const {
+			return data;
 		}
 
 		template<class T>
 		int Matrix<T>::RowColumnToIndex(int row, int column) const {
 			return (row * n) + column;
 		}
-		
+
 		template<class T>
 		Matrix<T> Matrix<T>::operator+(Matrix<T>& rhs) {
-			if(rhs.n != n || rhs.m != m) 
+			if(rhs.n != n || rhs.m != m)
 				throw std::invalid_argument("When adding two matrix togeather, make sure they are of the same dimentions.");
-			
-			Matrix<T> returnMatrix(n, m);
-			for(int row = 0; row < m; row++) for(int column = 0; column < n; column++)
-				returnMatrix.GetAtLocation(row, column) = rhs.GetAtLocation(row,column) + GetAtLocation(row, column);
+
+			Matrix<T> returnMatrix(m, n);
+			// Both operands are contiguous, so this is one flat loop the compiler can vectorize
+			const element_type* MT_RESTRICT a = data;
+			const element_type* MT_RESTRICT b = rhs.data;
+			element_type* MT_RESTRICT c = returnMatrix.data;
+			for(int i = 0; i < (m * n); i++)
+				c[i] = a[i] + b[i];
 			return returnMatrix;
 		}
-		
+
 		template<class T>
 		Matrix<T> Matrix<T>::operator*(Matrix<T>& rhs) {
 			if(n != rhs.m)
 				throw std::invalid_argument("When multiplying two matrix togeather, make sure that Matrix A's n is Matrix B's m.");
-			Matrix<T> returnMatrix(m, rhs.GetColumns());
-			for(int row = 0; row < m; row++) for(int column = 0; column < rhs.GetColumns(); column++)
-				for(int inner = 0; inner < m; inner++)
-					returnMatrix.GetAtLocation(row, column) += GetAtLocation(row, inner) * rhs.GetAtLocation(inner, column);
+			const int p = rhs.GetColumns();
+			Matrix<T> returnMatrix(m, p);
+			// i-k-j order so the innermost loop streams over contiguous rows of rhs and the result
+			for(int row = 0; row < m; row++) {
+				element_type* MT_RESTRICT out = returnMatrix.data + (row * p);
+				for(int inner = 0; inner < n; inner++) {
+					const element_type a = data[RowColumnToIndex(row, inner)];
+					const element_type* MT_RESTRICT b = rhs.data + (inner * p);
+					for(int column = 0; column < p; column++)
+						out[column] += a * b[column];
+				}
+			}
 			return returnMatrix;
 		}
 	}
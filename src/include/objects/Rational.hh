@@ -0,0 +1,96 @@
+/*
+	Rational.hh - Exact rational number implementation
+*/
+#pragma once
+#include <string>
+#include <iostream>
+
+#include "core/INumeric.hh"
+#include "core/HPN.hh"
+#include "Integer.hh"
+
+namespace Mt {
+	namespace objects {
+		/*! \class Rational
+			\brief Mt Exact Rational Number
+
+			A fraction of two Mt::objects::Integer, always kept in lowest terms with a positive
+			denominator so equal values compare equal limb for limb. While both parts fit a machine
+			word the arithmetic runs on int64_t with overflow checks and the word sized binary GCD,
+			overflowing falls back to the Mt::core::hpn::BigInt path.
+		*/
+		class Rational : public Mt::core::INumeric {
+			private:
+				Mt::objects::Integer Numerator;
+				Mt::objects::Integer Denominator;
+
+				void Normalize(void);
+			public:
+				// Constructors
+				Rational(void);
+				Rational(Mt::objects::Integer const& num);
+				/*!
+					Creates num / den in lowest terms, throws std::domain_error if den is zero
+				*/
+				Rational(Mt::objects::Integer const& num, Mt::objects::Integer const& den);
+				Rational(Rational const& r);
+				Rational(Rational&& r);
+
+				~Rational(void);
+
+				// Misc functions
+				Mt::objects::Integer const& GetNumerator(void) const;
+				Mt::objects::Integer const& GetDenominator(void) const;
+				/*!
+					Returns true if the denominator is 1
+				*/
+				bool IsInteger(void) const;
+				bool IsZero(void) const;
+				/*!
+					Returns the value converted to the float type F
+				*/
+				template <class F>
+				F ToFloat(void) const {
+					if(this->Numerator.IsSmall() && this->Denominator.IsSmall())
+						return static_cast<F>(this->Numerator.GetSmall()) / static_cast<F>(this->Denominator.GetSmall());
+					// Scale the numerator so the integer quotient carries 128 significant bits, then
+					// scale the float back down by the same power of two
+					Mt::core::hpn::BigInt n = this->Numerator.ToBig();
+					Mt::core::hpn::BigInt d = this->Denominator.ToBig();
+					long shift = 128 + static_cast<long>(d.BitLength()) - static_cast<long>(n.BitLength());
+					Mt::core::hpn::BigInt q = (shift >= 0) ? (n.ShiftLeft(static_cast<size_t>(shift)) / d) : (n / d.ShiftLeft(static_cast<size_t>(-shift)));
+					F r = q.ToFloat<F>();
+					const F step = (shift >= 0) ? (static_cast<F>(1) / static_cast<F>(4294967296.0)) : static_cast<F>(4294967296.0);
+					const F bit = (shift >= 0) ? static_cast<F>(0.5) : static_cast<F>(2);
+					long count = (shift >= 0) ? shift : -shift;
+					for(; count >= 32; count -= 32)
+						r = r * step;
+					for(; count > 0; count--)
+						r = r * bit;
+					return r;
+				}
+				std::string ToString(void) const;
+
+				// Operator overloads
+				Rational& operator=(Rational const& rhs);
+
+				// Basic Arithmetic operations
+				Rational operator+(Rational const& rhs) const;
+				Rational operator-(Rational const& rhs) const;
+				Rational operator*(Rational const& rhs) const;
+				Rational operator/(Rational const& rhs) const;
+				Rational operator-() const;
+
+				// Comparison operators
+				bool operator==(Rational const& rhs) const;
+				bool operator!=(Rational const& rhs) const;
+				bool operator>(Rational const& rhs) const;
+				bool operator<(Rational const& rhs) const;
+				bool operator>=(Rational const& rhs) const;
+				bool operator<=(Rational const& rhs) const;
+
+				// Stream overloads
+				friend std::ostream& operator<<(std::ostream& os, const Rational& r);
+		};
+	}
+}
@@ -4,56 +4,70 @@
 #pragma once
 #include <iostream>
 #include "core/INumeric.hh"
+#include "core/Types.hh"
+#include "core/NumberFormatter.hh"
 
 namespace Mt {
 	namespace objects {
-		/*! \class Scalar
+		/*! \class BasicScalar
 			\brief Scalar Numeric Type
 
-			This abstract class is the base of all non-complex and non-intricate numerical types
-
+			This abstract class is the base of all non-complex and non-intricate numerical types,
+			templated over the float type that backs it so each precision tier has its own scalar.
+			Mt::objects::Scalar is the one backed by the build wide mtfloat_t.
 		*/
-		class Scalar : public core::INumeric {
+		template <class F>
+		class BasicScalar : public core::INumeric {
 		private:
-			mtfloat_t Internal;
+			F Internal;
 		public:
-			Scalar();
-			Scalar(mtfloat_t num);
-			Scalar(Scalar& s);
-			Scalar(Scalar const& s);
-			Scalar(Scalar&& s);
-			~Scalar();
-			mtfloat_t GetInternal();
-			Scalar& operator=(Scalar const& rhs);
-			Scalar& operator=(Scalar& rhs);
-			Scalar& operator=(mtfloat_t const& rhs);
-			Scalar 	operator+(Scalar& rhs);
-			Scalar 	operator+(mtfloat_t& rhs);
-			Scalar& operator+=(Scalar const& rhs);
-			Scalar 	operator-(Scalar& rhs);
-			Scalar 	operator-(mtfloat_t& rhs);
-			Scalar 	operator*(Scalar& rhs);
-			Scalar 	operator*(mtfloat_t& rhs);
-			Scalar 	operator/(Scalar& rhs);
-			Scalar 	operator/(mtfloat_t& rhs);
-			Scalar& operator++(int);
-			Scalar& operator--(int);
-			bool operator==(Scalar const& rhs);
-			bool operator==(mtfloat_t const& rhs);
-			bool operator!=(Scalar const& rhs);
-			bool operator!=(mtfloat_t const& rhs);
-			bool operator>(Scalar const& rhs);
-			bool operator>(mtfloat_t const& rhs);
-			bool operator<(Scalar const& rhs);
-			bool operator<(mtfloat_t const& rhs);
-			bool operator>=(Scalar const& rhs);
-			bool operator>=(mtfloat_t const& rhs);
-			bool operator<=(Scalar const& rhs);
-			bool operator<=(mtfloat_t const& rhs);
+			typedef F float_type;
+			BasicScalar();
+			BasicScalar(F num);
+			BasicScalar(BasicScalar& s);
+			BasicScalar(BasicScalar const& s);
+			BasicScalar(BasicScalar&& s);
+			~BasicScalar();
+			F GetInternal() const;
+			BasicScalar& operator=(BasicScalar const& rhs);
+			BasicScalar& operator=(BasicScalar& rhs);
+			BasicScalar& operator=(F const& rhs);
+			BasicScalar 	operator+(BasicScalar& rhs);
+			BasicScalar 	operator+(F& rhs);
+			BasicScalar& operator+=(BasicScalar const& rhs);
+			BasicScalar 	operator-(BasicScalar& rhs);
+			BasicScalar 	operator-(F& rhs);
+			BasicScalar 	operator*(BasicScalar& rhs);
+			BasicScalar 	operator*(F& rhs);
+			BasicScalar 	operator/(BasicScalar& rhs);
+			BasicScalar 	operator/(F& rhs);
+			BasicScalar& operator++(int);
+			BasicScalar& operator--(int);
+			bool operator==(BasicScalar const& rhs);
+			bool operator==(F const& rhs);
+			bool operator!=(BasicScalar const& rhs);
+			bool operator!=(F const& rhs);
+			bool operator>(BasicScalar const& rhs);
+			bool operator>(F const& rhs);
+			bool operator<(BasicScalar const& rhs);
+			bool operator<(F const& rhs);
+			bool operator>=(BasicScalar const& rhs);
+			bool operator>=(F const& rhs);
+			bool operator<=(BasicScalar const& rhs);
+			bool operator<=(F const& rhs);
 
 			// Stream overloads
-			friend std::ostream& operator<<(std::ostream& os, const Scalar& sclr);
+			friend std::ostream& operator<<(std::ostream& os, const BasicScalar& sclr) {
+				std::string text;
+				Mt::core::NumberFormatter::Append(text, sclr.Internal);
+				return os.write(text.data(), static_cast<std::streamsize>(text.size()));
+			}
 
 		};
+
+		typedef BasicScalar<mtfloat_t> Scalar;
+		typedef BasicScalar<double> DoubleScalar;
+		typedef BasicScalar<long double> ExtendedScalar;
+		typedef BasicScalar<mtquad_t> QuadScalar;
 	}
 }
@@ -0,0 +1,52 @@
+/*
+	Storage.hh - Element storage selection for Mt collections
+*/
+#pragma once
+
+#include "core/Types.hh"
+#include "objects/Scalar.hh"
+
+namespace Mt {
+	namespace objects {
+		/*! \struct Storage
+			\brief Collection element storage
+
+			Selects what a collection such as Mt::objects::List or Mt::objects::Matrix actually
+			keeps in memory for each element. By default the element is stored as is, numeric
+			types are specialized below so that the collection holds a flat array of raw numbers
+			and the boxed object is only built when an element crosses the Mt::core::IMtObject boundary.
+		*/
+		template <class T>
+		struct Storage {
+			typedef T type;
+			/*!
+				Converts an element into its stored representation
+			*/
+			static type Unbox(T const& value) {
+				return value;
+			}
+			/*!
+				Converts a stored element back into the element type
+			*/
+			static T Box(type const& value) {
+				return value;
+			}
+		};
+
+		/*!
+			Scalars are stored as their raw float type, dropping the vtable pointer and type tag
+			that every Mt::objects::BasicScalar carries around. A List<DoubleScalar> is therefore
+			a plain double array and a List<Scalar> a plain mtfloat_t array.
+		*/
+		template <class F>
+		struct Storage<BasicScalar<F>> {
+			typedef F type;
+			static type Unbox(BasicScalar<F> const& value) {
+				return value.GetInternal();
+			}
+			static BasicScalar<F> Box(type const& value) {
+				return BasicScalar<F>(value);
+			}
+		};
+	}
+}